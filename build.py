@@ -14,8 +14,11 @@ Commands:
     monitor   - Monitor serial output
     clean     - Clean build files
     all       - Build, upload, and monitor
+    footprint - Flash/RAM of each build profile (env:profile_*)
 """
 
+import configparser
+import re
 import subprocess
 import sys
 import time
@@ -68,6 +71,49 @@ def upload_spiffs():
     """Upload SPIFFS filesystem"""
     return run_command("pio run --target uploadfs --no-intellisense", "Uploading SPIFFS filesystem...")
 
+# Printed by "pio run" for the ESP8266: "RAM:   [===  ]  42.1% (used 34484 bytes from 81920 bytes)"
+SIZE_PATTERN = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)", re.MULTILINE)
+
+def profile_envs():
+    """The env:profile_* sections of platformio.ini, in file order"""
+    parser = configparser.ConfigParser(interpolation=None, strict=False)
+    parser.read("platformio.ini")
+    return [section[4:] for section in parser.sections() if section.startswith("env:profile_")]
+
+def profile_footprint(env):
+    """Build one profile and return {"RAM": (used, total), "Flash": (used, total)}"""
+    result = subprocess.run(f"pio run -e {env} --no-intellisense", shell=True, capture_output=True, text=True)
+    if result.returncode != 0:
+        print(f"❌ {env} failed to build")
+        print("STDERR:", result.stderr or result.stdout)
+        return None
+    return {name: (int(used), int(total)) for name, used, total in SIZE_PATTERN.findall(result.stdout)}
+
+def footprint_report():
+    """Build every profile and compare its flash and RAM with profile_full"""
+    envs = profile_envs()
+    if not envs:
+        print("❌ No env:profile_* sections in platformio.ini")
+        return False
+
+    sizes = {}
+    for env in envs:
+        print(f"🔄 Building {env}...")
+        footprint = profile_footprint(env)
+        if footprint is None or "RAM" not in footprint or "Flash" not in footprint:
+            return False
+        sizes[env] = footprint
+
+    # Free heap at boot is roughly the RAM left after static data (.data/.bss)
+    base = sizes.get("profile_full", sizes[envs[0]])
+    print(f"\n{'profile':<18}{'flash':>10}{'Δflash':>10}{'RAM':>10}{'ΔRAM':>10}{'free heap':>12}")
+    for env in envs:
+        flash_used, _ = sizes[env]["Flash"]
+        ram_used, ram_total = sizes[env]["RAM"]
+        print(f"{env:<18}{flash_used:>10}{flash_used - base['Flash'][0]:>+10}"
+              f"{ram_used:>10}{ram_used - base['RAM'][0]:>+10}{ram_total - ram_used:>12}")
+    return True
+
 def check_requirements():
     """Check if PlatformIO is installed"""
     try:
@@ -95,6 +141,7 @@ Commands:
     clean     - Clean build files
     spiffs    - Upload SPIFFS filesystem
     all       - Build, upload, and monitor
+    footprint - Build every profile and compare flash/RAM
     help      - Show this help
 
 Examples:
@@ -136,6 +183,10 @@ def main():
                 time.sleep(3)
                 monitor_device()
     
+    elif command == "footprint":
+        if not footprint_report():
+            sys.exit(1)
+    
     elif command == "help":
         show_help()
     
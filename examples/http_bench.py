@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""
+ESP8266 Sensor Network HTTP Benchmark
+
+Drives the web API with concurrent clients and a weighted request mix, against
+a device on the LAN or the simulator (pio run -e sim), and reports throughput,
+latency percentiles, error and timeout rates, and the device's heap over time
+(polled from /api/heap). Results are written as JSON so runs against different
+firmware versions can be compared.
+
+Requirements:
+    Python 3.7+ (standard library only)
+
+Usage:
+    python http_bench.py <device[:port]> [options]
+    python http_bench.py 192.168.1.50 --clients 6 --duration 60 \\
+        --mix /api/sensors=5,/api/config=2,/=1 --output v1.4.json --label v1.4
+    python http_bench.py --compare v1.4.json v1.5.json
+"""
+
+import argparse
+import http.client
+import json
+import random
+import socket
+import sys
+import threading
+import time
+from datetime import datetime, timezone
+
+RESULT_FORMAT = 1
+DEFAULT_MIX = "/api/sensors=5,/api/config=3,/=1"
+COMPARED = [("throughput_rps", "req/s"), ("p50_ms", "ms"), ("p95_ms", "ms"), ("p99_ms", "ms"),
+            ("error_rate", ""), ("timeout_rate", "")]
+
+
+def parse_mix(text):
+    """'/a=3,/b=1' -> [('/a', 3.0), ('/b', 1.0)]"""
+    mix = []
+    for item in text.split(","):
+        path, _, weight = item.strip().partition("=")
+        mix.append((path, float(weight or 1)))
+    return mix
+
+
+def percentile(sorted_values, p):
+    """Nearest-rank percentile of an already sorted list"""
+    if not sorted_values:
+        return None
+    rank = max(1, int(round(p / 100.0 * len(sorted_values) + 0.5)))
+    return sorted_values[min(rank, len(sorted_values)) - 1]
+
+
+class Recorder:
+    """Collects per-request outcomes from all client threads"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.samples = []  # (t_s, path, latency_ms, outcome, status)
+
+    def add(self, t, path, latency_ms, outcome, status):
+        with self.lock:
+            self.samples.append((t, path, latency_ms, outcome, status))
+
+
+def summarize(samples, elapsed):
+    latencies = sorted(s[2] for s in samples if s[3] == "ok")
+    count = len(samples)
+    errors = sum(1 for s in samples if s[3] == "error")
+    timeouts = sum(1 for s in samples if s[3] == "timeout")
+
+    def rounded(value):
+        return None if value is None else round(value, 2)
+
+    return {
+        "requests": count,
+        "ok": len(latencies),
+        "errors": errors,
+        "timeouts": timeouts,
+        "throughput_rps": round(len(latencies) / elapsed, 2) if elapsed > 0 else 0,
+        "error_rate": round(errors / count, 4) if count else 0,
+        "timeout_rate": round(timeouts / count, 4) if count else 0,
+        "min_ms": rounded(latencies[0] if latencies else None),
+        "mean_ms": rounded(sum(latencies) / len(latencies) if latencies else None),
+        "p50_ms": rounded(percentile(latencies, 50)),
+        "p95_ms": rounded(percentile(latencies, 95)),
+        "p99_ms": rounded(percentile(latencies, 99)),
+        "max_ms": rounded(latencies[-1] if latencies else None),
+    }
+
+
+def client(host, port, mix, args, recorder, start, stop):
+    """One dashboard/scraper: issues requests back to back until stop is set"""
+    paths = [path for path, _ in mix]
+    weights = [weight for _, weight in mix]
+    conn = None
+    while not stop.is_set():
+        path = random.choices(paths, weights)[0]
+        sent = time.monotonic()
+        outcome, status = "ok", None
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(host, port, timeout=args.timeout)
+            conn.request("GET", path, headers={"Connection": "keep-alive" if args.keep_alive else "close"})
+            response = conn.getresponse()
+            response.read()
+            status = response.status
+            if status >= 400:
+                outcome = "error"
+            if not args.keep_alive or response.will_close:
+                conn.close()
+                conn = None
+        except socket.timeout:
+            outcome = "timeout"
+        except (OSError, http.client.HTTPException):
+            outcome = "error"
+        if outcome != "ok" and conn is not None:
+            conn.close()
+            conn = None
+        now = time.monotonic()
+        if now - start >= args.warmup:
+            recorder.add(now - start - args.warmup, path, (now - sent) * 1000.0, outcome, status)
+        if args.think > 0:
+            stop.wait(args.think)
+    if conn is not None:
+        conn.close()
+
+
+def heap_poller(host, port, args, heap, start, stop):
+    """Samples /api/heap on its own connection; failures are counted, not fatal"""
+    while not stop.wait(args.heap_interval):
+        t = round(time.monotonic() - start - args.warmup, 2)
+        try:
+            conn = http.client.HTTPConnection(host, port, timeout=args.timeout)
+            conn.request("GET", "/api/heap", headers={"Connection": "close"})
+            payload = json.loads(conn.getresponse().read())
+            conn.close()
+            heap["samples"].append([t, payload.get("free"), payload.get("max_block"), payload.get("fragmentation")])
+        except (OSError, ValueError, http.client.HTTPException):
+            heap["failed_polls"] += 1
+
+
+def run(args):
+    host, _, port = args.target.partition(":")
+    port = int(port or 80)
+    mix = parse_mix(args.mix)
+    recorder = Recorder()
+    heap = {"samples": [], "failed_polls": 0}
+    stop = threading.Event()
+    started = datetime.now(timezone.utc).isoformat(timespec="seconds")
+    start = time.monotonic()
+
+    threads = [threading.Thread(target=client, args=(host, port, mix, args, recorder, start, stop), daemon=True)
+               for _ in range(args.clients)]
+    if args.heap_interval > 0:
+        threads.append(threading.Thread(target=heap_poller, args=(host, port, args, heap, start, stop), daemon=True))
+    for thread in threads:
+        thread.start()
+    try:
+        time.sleep(args.warmup + args.duration)
+    except KeyboardInterrupt:
+        pass
+    stop.set()
+    for thread in threads:
+        thread.join(args.timeout + 1)
+    elapsed = min(args.duration, max(0.0, time.monotonic() - start - args.warmup))
+
+    samples = recorder.samples
+    statuses = {}
+    for sample in samples:
+        key = str(sample[4]) if sample[4] is not None else sample[3]
+        statuses[key] = statuses.get(key, 0) + 1
+    timeline = []
+    for second in range(int(elapsed) + 1):
+        window = [s for s in samples if second <= s[0] < second + 1]
+        if window:
+            timeline.append([second, sum(1 for s in window if s[3] == "ok"),
+                             sum(1 for s in window if s[3] != "ok")])
+
+    heap_rows = [row for row in heap["samples"] if row[1] is not None]
+    return {
+        "format": RESULT_FORMAT,
+        "label": args.label,
+        "target": f"{host}:{port}",
+        "started": started,
+        "config": {"clients": args.clients, "duration_s": args.duration, "warmup_s": args.warmup,
+                   "timeout_s": args.timeout, "keep_alive": args.keep_alive, "think_s": args.think,
+                   "mix": {path: weight for path, weight in mix}},
+        "elapsed_s": round(elapsed, 2),
+        "totals": summarize(samples, elapsed),
+        "endpoints": {path: summarize([s for s in samples if s[1] == path], elapsed) for path, _ in mix},
+        "status_codes": statuses,
+        # Columns: [t_s, ok, failed]
+        "timeline": timeline,
+        "heap": {
+            # Columns: [t_s, free, max_block, fragmentation]
+            "samples": heap_rows,
+            "failed_polls": heap["failed_polls"],
+            "min_free": min((row[1] for row in heap_rows), default=None),
+            "min_max_block": min((row[2] for row in heap_rows), default=None),
+            "max_fragmentation": max((row[3] for row in heap_rows), default=None),
+        },
+    }
+
+
+def print_report(result):
+    totals = result["totals"]
+    print(f"{result['target']} {result['label'] or ''}: {result['config']['clients']} clients, "
+          f"{result['elapsed_s']} s, keep-alive {'on' if result['config']['keep_alive'] else 'off'}")
+    header = f"{'endpoint':<24}{'req':>7}{'req/s':>9}{'p50':>9}{'p95':>9}{'p99':>9}{'err%':>7}{'tmo%':>7}"
+    print(header)
+    rows = list(result["endpoints"].items()) + [("total", totals)]
+    for name, stats in rows:
+        def ms(key):
+            return "-" if stats[key] is None else f"{stats[key]:.1f}"
+        print(f"{name:<24}{stats['requests']:>7}{stats['throughput_rps']:>9.1f}{ms('p50_ms'):>9}{ms('p95_ms'):>9}"
+              f"{ms('p99_ms'):>9}{stats['error_rate'] * 100:>7.1f}{stats['timeout_rate'] * 100:>7.1f}")
+    heap = result["heap"]
+    if heap["samples"]:
+        print(f"heap: min free {heap['min_free']} B, min max block {heap['min_max_block']} B, "
+              f"max fragmentation {heap['max_fragmentation']}% ({len(heap['samples'])} samples, "
+              f"{heap['failed_polls']} failed polls)")
+
+
+def compare(base_path, new_path):
+    """Prints per-endpoint changes; exit status 1 if p95 grew >10% or the error rate >1 point"""
+    with open(base_path) as f:
+        base = json.load(f)
+    with open(new_path) as f:
+        new = json.load(f)
+    print(f"{base.get('label') or base_path} -> {new.get('label') or new_path}")
+    regressed = False
+    names = [name for name in new["endpoints"] if name in base["endpoints"]] + ["total"]
+    for name in names:
+        old_stats = base["totals"] if name == "total" else base["endpoints"][name]
+        new_stats = new["totals"] if name == "total" else new["endpoints"][name]
+        changes = []
+        for key, unit in COMPARED:
+            old, cur = old_stats.get(key), new_stats.get(key)
+            if old is None or cur is None:
+                continue
+            delta = (cur - old) / old * 100 if old else 0.0
+            changes.append(f"{key} {old}->{cur}{unit} ({delta:+.0f}%)")
+            if key == "p95_ms" and cur > old * 1.1 and cur - old > 1:
+                regressed = True
+            if key == "error_rate" and cur - old > 0.01:
+                regressed = True
+        print(f"  {name}: " + ", ".join(changes))
+    base_heap, new_heap = base["heap"].get("min_free"), new["heap"].get("min_free")
+    if base_heap is not None and new_heap is not None:
+        print(f"  heap min free: {base_heap} -> {new_heap} B ({new_heap - base_heap:+d})")
+    return 1 if regressed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="HTTP load and latency benchmark for the sensor web API")
+    parser.add_argument("target", nargs="?", help="device address, host[:port]")
+    parser.add_argument("--clients", type=int, default=5, help="concurrent clients (default 5)")
+    parser.add_argument("--duration", type=float, default=30, help="measured seconds (default 30)")
+    parser.add_argument("--warmup", type=float, default=2, help="unmeasured seconds first (default 2)")
+    parser.add_argument("--mix", default=DEFAULT_MIX, help=f"weighted paths (default {DEFAULT_MIX})")
+    parser.add_argument("--timeout", type=float, default=5, help="per-request timeout in seconds (default 5)")
+    parser.add_argument("--think", type=float, default=0, help="pause between a client's requests, seconds")
+    parser.add_argument("--keep-alive", action="store_true", help="reuse connections (default: one per request)")
+    parser.add_argument("--heap-interval", type=float, default=2, help="/api/heap poll period, 0 = off")
+    parser.add_argument("--label", default="", help="firmware version or note stored with the results")
+    parser.add_argument("--output", help="write the JSON results here")
+    parser.add_argument("--compare", nargs=2, metavar=("BASE", "NEW"), help="compare two result files")
+    args = parser.parse_args()
+
+    if args.compare:
+        sys.exit(compare(*args.compare))
+    if not args.target:
+        parser.error("target is required")
+
+    result = run(args)
+    print_report(result)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=1)
+        print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
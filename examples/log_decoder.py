@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+ESP8266 Sensor Network Log Decoder
+
+Fetches raw entries from /api/logs?raw=1 and formats them on the host, looking
+up each entry's format string in the firmware ELF by address. Useful when the
+on-device formatter truncates long messages, or to decode a saved dump.
+
+Requirements:
+    pip install requests
+
+Usage:
+    python log_decoder.py <device_ip> <firmware.elf> [--follow]
+    python log_decoder.py --file dump.json <firmware.elf>
+"""
+
+import json
+import re
+import struct
+import sys
+import time
+
+ARG_INT, ARG_UINT, ARG_FLOAT, ARG_TEXT, ARG_LITERAL = range(5)
+SPEC = re.compile(r"%%|%([-+ #0-9.]*)[hlLqjzt]*([a-zA-Z])")
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings from the loadable sections of an ELF32 file"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1:
+            raise ValueError(f"{path} is not an ELF32 file")
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            sh_type, = struct.unpack_from("<I", self.data, base + 4)
+            addr, offset, size = struct.unpack_from("<III", self.data, base + 12)
+            if addr and sh_type == 1:  # SHT_PROGBITS
+                self.sections.append((addr, offset, size))
+
+    def string_at(self, address):
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + (address - addr)
+                end = self.data.index(b"\0", start)
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+def format_entry(fmt, args, elf):
+    """Mirrors logFormat() in src/debug/log_ring.cpp"""
+    values = iter(args)
+
+    def convert(match):
+        if match.group(0) == "%%":
+            return "%"
+        flags, conversion = match.group(1), match.group(2)
+        try:
+            arg_type, value = next(values)
+        except StopIteration:
+            return "?"
+        if arg_type == ARG_LITERAL:
+            value = elf.string_at(value) or f"<0x{value:08x}>"
+        is_string = arg_type in (ARG_TEXT, ARG_LITERAL)
+        if arg_type == ARG_FLOAT:
+            value = struct.unpack("<f", struct.pack("<I", value))[0]
+        elif arg_type == ARG_INT:
+            value = struct.unpack("<i", struct.pack("<I", value))[0]
+        if conversion == "v":
+            if is_string:
+                conversion = "s"
+            elif arg_type == ARG_FLOAT:
+                flags, conversion = flags + ".2", "f"
+            else:
+                conversion = "d"
+        if (conversion == "s") != is_string:
+            return "?"
+        if conversion in "fFeEgG":
+            value = float(value)
+        elif conversion in "cdiuxXo":
+            value = int(value)
+            conversion = "d" if conversion in "iu" else conversion
+        elif conversion == "p":
+            return f"0x{value:x}"
+        return ("%" + flags + conversion) % value
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode(payload, elf):
+    for entry in payload.get("entries", []):
+        fmt = elf.string_at(int(entry["fmt"], 16))
+        if fmt is None:
+            message = f"<unknown format {entry['fmt']}>"
+        else:
+            message = format_entry(fmt, entry.get("args", []), elf)
+        print(f"{entry['t']:>10} {entry['category']:<7} {entry['level']:<5} {message.rstrip()}")
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    follow = "--follow" in sys.argv
+    if "--file" in sys.argv:
+        with open(args[0]) as f:
+            decode(json.load(f), ElfStrings(args[1]))
+        return
+    if len(args) != 2:
+        print(__doc__)
+        sys.exit(1)
+
+    import requests
+
+    device_ip, elf_path = args
+    elf = ElfStrings(elf_path)
+    since = None
+    while True:
+        params = {"raw": "1"}
+        if since is not None:
+            params["since"] = since
+        payload = requests.get(f"http://{device_ip}/api/logs", params=params, timeout=10).json()
+        decode(payload, elf)
+        if payload.get("entries"):
+            since = payload["entries"][-1]["seq"]
+        if not follow:
+            break
+        time.sleep(2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+typedef struct
+{
+    char name[12];
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    float max_value;
+    float min_value;
+    float resolution;
+    int32_t min_delay;
+} sensor_t;
+
+typedef struct
+{
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    int32_t reserved0;
+    int32_t timestamp;
+    union
+    {
+        float data[4];
+        float light;
+        float temperature;
+        float relative_humidity;
+        float pressure;
+    };
+} sensors_event_t;
+
+#define SENSOR_TYPE_LIGHT 5
+
+class Adafruit_Sensor
+{
+public:
+    virtual ~Adafruit_Sensor() {}
+    virtual bool getEvent(sensors_event_t *event) = 0;
+    virtual void getSensor(sensor_t *sensor) = 0;
+};
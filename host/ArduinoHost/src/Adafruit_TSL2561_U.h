@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include "Adafruit_Sensor.h"
+
+#define TSL2561_ADDR_LOW 0x29
+#define TSL2561_ADDR_FLOAT 0x39
+#define TSL2561_ADDR_HIGH 0x49
+
+typedef enum
+{
+    TSL2561_INTEGRATIONTIME_13MS = 0x00,
+    TSL2561_INTEGRATIONTIME_101MS = 0x01,
+    TSL2561_INTEGRATIONTIME_402MS = 0x02
+} tsl2561IntegrationTime_t;
+
+typedef enum
+{
+    TSL2561_GAIN_1X = 0x00,
+    TSL2561_GAIN_16X = 0x10
+} tsl2561Gain_t;
+
+// TSL2561 with a host-set lux value. A missing sensor fails begin(); like
+// the Adafruit driver, getEvent() fails for a missing or saturated one.
+class Adafruit_TSL2561_Unified : public Adafruit_Sensor
+{
+public:
+    Adafruit_TSL2561_Unified(uint8_t addr, int32_t sensorID = -1) : _addr(addr), _sensorID(sensorID) {}
+
+    bool begin() { return _initialised = _present; }
+    void enableAutoRange(bool enable) { _autoRange = enable; }
+    void setIntegrationTime(tsl2561IntegrationTime_t time) { _integration = time; }
+    void setGain(tsl2561Gain_t gain) { _gain = gain; }
+    bool getEvent(sensors_event_t *event) override;
+    void getSensor(sensor_t *sensor) override;
+
+    // Host side
+    void hostSetPresent(bool present) { _present = present; }
+    void hostSetLux(float lux) { _lux = lux; }
+
+private:
+    uint8_t _addr;
+    int32_t _sensorID;
+    bool _present = true;
+    bool _initialised = false;
+    bool _autoRange = false;
+    tsl2561IntegrationTime_t _integration = TSL2561_INTEGRATIONTIME_13MS;
+    tsl2561Gain_t _gain = TSL2561_GAIN_1X;
+    float _lux = 250.0f;
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+
+// Host-side controls for the Arduino/ESP8266 mocks. Firmware code never
+// includes this; tests and host programs use it to drive time, pins and the
+// network the firmware sees.
+
+// One open network connection, as seen by a WiFiClient
+class HostConnection
+{
+public:
+    virtual ~HostConnection() {}
+    virtual size_t write(const uint8_t *buf, size_t size) = 0;
+    virtual int available() = 0; // Bytes readable without blocking
+    virtual int read(uint8_t *buf, size_t size) = 0;
+    virtual bool connected() = 0;
+    virtual void close() = 0;
+};
+
+// Inbound connections for a WiFiServer
+class HostListener
+{
+public:
+    virtual ~HostListener() {}
+    virtual HostConnection *accept() = 0; // nullptr when nobody is waiting
+};
+
+// Where WiFiClient connections, WiFiServer listeners and DNS lookups go.
+// Without one installed every connect is refused and every lookup fails.
+class HostNetwork
+{
+public:
+    virtual ~HostNetwork() {}
+    virtual HostConnection *connect(const char *host, uint16_t port) = 0; // nullptr = refused
+    virtual bool resolve(const char *host, uint32_t &address) = 0;        // address in WiFi byte order
+    virtual HostListener *listen(uint16_t port) { return (void)port, nullptr; }
+};
+
+// A device on the I2C bus, addressed through Wire
+class HostI2cDevice
+{
+public:
+    virtual ~HostI2cDevice() {}
+    virtual void receive(const uint8_t *data, size_t length) = 0; // Master write
+    virtual size_t request(uint8_t *data, size_t length) = 0;     // Master read
+};
+
+namespace host
+{
+    // Power-on state: clock at 0, pins floating, RTC memory and EEPROM cleared.
+    // Files under the LittleFS root are left alone.
+    void reset();
+    // Reset with the given REASON_* code; RTC memory, EEPROM and files survive
+    void restart(uint32_t reason);
+
+    // Virtual clock behind millis()/micros(); only delay() and esp_delay() advance
+    // it, so code between two delays takes no simulated time
+    uint64_t nowMicros();
+    void advanceMicros(uint64_t us);
+    void advanceMillis(uint32_t ms);
+    // Called on every delay()/yield()/esp_delay() step, e.g. to pump sockets
+    void onYield(std::function<void()> hook);
+    // Called instead of returning from ESP.restart()/ESP.deepSleep(); the
+    // default exits the process
+    void onRestart(std::function<void(uint32_t reason, uint64_t sleepUs)> hook);
+
+    // GPIO: drive an input (runs attached interrupt handlers) or read an output
+    void setPin(uint8_t pin, int level);
+    int pinOutput(uint8_t pin);
+    int pinMode(uint8_t pin);
+    void setAnalog(int value);
+
+    // ESP.getChipId(), which the firmware derives its MQTT client ID from;
+    // give each simulated device its own (default 0x00C0FFEE)
+    void setChipId(uint32_t id);
+
+    // ESP heap figures reported by ESP.getFreeHeap() and friends
+    void setHeap(uint32_t freeBytes, uint32_t maxBlock, uint8_t fragmentation);
+
+    // Serial: echo to stdout (default on) and/or capture for inspection
+    void serialEcho(bool enabled);
+    void serialCapture(bool enabled);
+    std::string serialTake();
+    void serialInject(const std::string &data);
+
+    // WiFi station: whether WiFi.begin()/autoConnect() succeed
+    void wifiReachable(bool reachable);
+    // What a user would type into the WiFiManager portal field with this id;
+    // replaces the parameter's default whenever the firmware adds it
+    void setPortalValue(const std::string &id, const std::string &value);
+
+    void attachI2c(uint8_t address, HostI2cDevice *device);
+
+    void setNetwork(HostNetwork *network);
+    HostNetwork *network();
+
+    // State that outlives a reset (EEPROM flash, RTC memory), for host programs
+    // that restart the firmware by re-executing themselves
+    bool saveRetained(const std::string &path);
+    bool loadRetained(const std::string &path);
+
+    // Directory holding the LittleFS contents (default: ./.host_fs)
+    void setFsRoot(const std::string &path);
+    const std::string &fsRoot();
+}
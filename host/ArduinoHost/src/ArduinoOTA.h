@@ -0,0 +1,49 @@
+#pragma once
+#include <functional>
+#include "Arduino.h"
+#include "Updater.h"
+
+typedef enum
+{
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+// Espota over UDP has no host counterpart: the callbacks are kept but
+// handle() never sees an invitation
+class ArduinoOTAClass
+{
+public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    void setPort(uint16_t port) { _port = port; }
+    void setHostname(const char *hostname) { _hostname = hostname ? hostname : ""; }
+    String getHostname() { return _hostname; }
+    void setPassword(const char *password) { (void)password; }
+    void setPasswordHash(const char *hash) { (void)hash; }
+    void setRebootOnSuccess(bool reboot) { (void)reboot; }
+    void onStart(THandlerFunction fn) { _startCallback = fn; }
+    void onEnd(THandlerFunction fn) { _endCallback = fn; }
+    void onError(THandlerFunction_Error fn) { _errorCallback = fn; }
+    void onProgress(THandlerFunction_Progress fn) { _progressCallback = fn; }
+    void begin(bool useMDNS = true) { (void)useMDNS; }
+    void end() {}
+    void handle() {}
+    int getCommand() { return U_FLASH; }
+    uint16_t port() const { return _port; }
+
+private:
+    uint16_t _port = 8266;
+    String _hostname;
+    THandlerFunction _startCallback;
+    THandlerFunction _endCallback;
+    THandlerFunction_Error _errorCallback;
+    THandlerFunction_Progress _progressCallback;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
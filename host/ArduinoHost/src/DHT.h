@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include "Arduino.h"
+
+#define DHT11 11
+#define DHT12 12
+#define DHT21 21
+#define DHT22 22
+#define AM2301 21
+
+// DHT sensor with host-set readings. Like the Adafruit driver, a reading is
+// only taken every 2 s; calls in between return the previous result.
+class DHT
+{
+public:
+    DHT(uint8_t pin, uint8_t type, uint8_t count = 6) : _pin(pin), _type(type) { (void)count; }
+
+    void begin(uint8_t usec = 55) { (void)usec, _begun = true; }
+    bool read(bool force = false);
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+    float convertCtoF(float c) { return c * 1.8f + 32; }
+    float convertFtoC(float f) { return (f - 32) * 0.55555f; }
+
+    // Host side
+    void hostSet(float temperature, float humidity);
+    void hostFail(bool failing) { _failing = failing; }
+    unsigned long hostReadCount() const { return _reads; }
+
+private:
+    uint8_t _pin;
+    uint8_t _type;
+    bool _begun = false;
+    bool _failing = false;
+    float _temperature = 21.0f;
+    float _humidity = 45.0f;
+    bool _lastResult = false;
+    unsigned long _lastReadTime = 0;
+    bool _everRead = false;
+    unsigned long _reads = 0;
+};
@@ -0,0 +1,67 @@
+#include "EEPROM.h"
+#include "host_internal.h"
+
+EEPROMClass EEPROM;
+
+// The emulated flash sector
+static std::vector<uint8_t> flash(4096, 0xFF);
+
+namespace host
+{
+    void resetEeprom()
+    {
+        EEPROM = EEPROMClass();
+        flash.assign(flash.size(), 0xFF);
+    }
+
+    std::vector<uint8_t> &eepromFlash()
+    {
+        return flash;
+    }
+}
+
+void EEPROMClass::begin(size_t size)
+{
+    if (size == 0 || size > flash.size())
+    {
+        return;
+    }
+    _data.assign(flash.begin(), flash.begin() + size);
+    _dirty = false;
+}
+
+bool EEPROMClass::commit()
+{
+    if (_data.empty())
+    {
+        return false;
+    }
+    if (_dirty)
+    {
+        memcpy(flash.data(), _data.data(), _data.size());
+        _commits++;
+        _dirty = false;
+    }
+    return true;
+}
+
+bool EEPROMClass::end()
+{
+    bool ok = _data.empty() || commit();
+    _data.clear();
+    return ok;
+}
+
+uint8_t EEPROMClass::read(int address) const
+{
+    return address >= 0 && (size_t)address < _data.size() ? _data[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if (address >= 0 && (size_t)address < _data.size() && _data[address] != value)
+    {
+        _data[address] = value;
+        _dirty = true;
+    }
+}
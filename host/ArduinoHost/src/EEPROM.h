@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+// Flash-sector EEPROM emulation: begin() maps a RAM copy, commit() writes it
+// back. The "flash" copy lives for the whole process and survives
+// host::restart(); host::reset() erases it to 0xFF.
+class EEPROMClass
+{
+public:
+    void begin(size_t size);
+    bool commit();
+    bool end();
+
+    uint8_t read(int address) const;
+    void write(int address, uint8_t value);
+
+    template <typename T>
+    T &get(int address, T &value) const
+    {
+        if (address >= 0 && address + sizeof(T) <= _data.size())
+        {
+            memcpy(&value, &_data[address], sizeof(T));
+        }
+        return value;
+    }
+
+    template <typename T>
+    const T &put(int address, const T &value)
+    {
+        if (address >= 0 && address + sizeof(T) <= _data.size())
+        {
+            if (memcmp(&_data[address], &value, sizeof(T)) != 0)
+            {
+                memcpy(&_data[address], &value, sizeof(T));
+                _dirty = true;
+            }
+        }
+        return value;
+    }
+
+    uint8_t *getDataPtr()
+    {
+        _dirty = true;
+        return _data.data();
+    }
+    const uint8_t *getConstDataPtr() const { return _data.data(); }
+    size_t length() const { return _data.size(); }
+
+    // Host only: flash writes since power-on, for wear measurements
+    unsigned long commitCount() const { return _commits; }
+
+private:
+    std::vector<uint8_t> _data;
+    bool _dirty = false;
+    unsigned long _commits = 0;
+};
+
+extern EEPROMClass EEPROM;
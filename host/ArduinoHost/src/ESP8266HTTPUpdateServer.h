@@ -0,0 +1,121 @@
+#pragma once
+#include "ESP8266WebServer.h"
+#include "Updater.h"
+
+// The core's /update form and upload handler, writing into Update
+class ESP8266HTTPUpdateServer
+{
+public:
+    void setup(ESP8266WebServer *server) { setup(server, emptyValue(), emptyValue()); }
+    void setup(ESP8266WebServer *server, const String &path) { setup(server, path, emptyValue(), emptyValue()); }
+    void setup(ESP8266WebServer *server, const String &username, const String &password)
+    {
+        setup(server, "/update", username, password);
+    }
+    void setup(ESP8266WebServer *server, const String &path, const String &username, const String &password)
+    {
+        _server = server;
+        _username = username;
+        _password = password;
+
+        _server->on(path, HTTP_GET, [this]()
+                    {
+            if (!authorized())
+            {
+                return _server->requestAuthentication();
+            }
+            _server->send(200, "text/html", "<html><body><form method='POST' action='' enctype='multipart/form-data'>"
+                                            "<input type='file' accept='.bin,.bin.gz' name='firmware'>"
+                                            "<input type='submit' value='Update Firmware'></form></body></html>"); });
+
+        _server->on(path, HTTP_POST, [this]()
+                    {
+            if (!_authenticated)
+            {
+                return _server->requestAuthentication();
+            }
+            if (Update.hasError())
+            {
+                _server->send(200, "text/html", String("Update error: ") + _updaterError);
+                return;
+            }
+            _server->send(200, "text/html", "<META http-equiv=\"refresh\" content=\"15;URL=/\">Update Success! Rebooting...");
+            delay(100);
+            ESP.restart(); }, [this]()
+                    {
+            HTTPUpload &upload = _server->upload();
+            if (upload.status == UPLOAD_FILE_START)
+            {
+                _updaterError = String();
+                _authenticated = authorized();
+                if (!_authenticated)
+                {
+                    return;
+                }
+                uint32_t maxSketchSpace = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
+                int command = upload.name == "filesystem" ? U_FS : U_FLASH;
+                if (!Update.begin(command == U_FS ? (size_t)2 * 1024 * 1024 : maxSketchSpace, command))
+                {
+                    setUpdaterError();
+                }
+            }
+            else if (_authenticated && upload.status == UPLOAD_FILE_WRITE && !_updaterError.length())
+            {
+                if (Update.write(upload.buf, upload.currentSize) != upload.currentSize)
+                {
+                    setUpdaterError();
+                }
+            }
+            else if (_authenticated && upload.status == UPLOAD_FILE_END && !_updaterError.length())
+            {
+                if (!Update.end(true))
+                {
+                    setUpdaterError();
+                }
+            } });
+    }
+
+    void updateCredentials(const String &username, const String &password)
+    {
+        _username = username;
+        _password = password;
+    }
+
+private:
+    static const String &emptyValue()
+    {
+        static const String empty;
+        return empty;
+    }
+
+    bool authorized()
+    {
+        return _username.length() == 0 || _password.length() == 0 ||
+               _server->authenticate(_username.c_str(), _password.c_str());
+    }
+
+    void setUpdaterError()
+    {
+        StreamString error;
+        Update.printError(error);
+        _updaterError = error;
+    }
+
+    // Collects printError() output
+    class StreamString : public Print, public String
+    {
+    public:
+        size_t write(uint8_t c) override
+        {
+            String::operator+=((char)c);
+            return 1;
+        }
+        using Print::write;
+    };
+
+    ESP8266WebServer *_server = nullptr;
+    String _username;
+    String _password;
+    String _updaterError;
+    bool _authenticated = false;
+};
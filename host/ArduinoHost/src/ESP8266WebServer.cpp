@@ -0,0 +1,702 @@
+#include "ESP8266WebServer.h"
+
+static const String emptyString;
+
+static String lowerCase(String text)
+{
+    text.toLowerCase();
+    return text;
+}
+
+static const char *methodName(HTTPMethod method)
+{
+    switch (method)
+    {
+    case HTTP_GET:
+        return "GET";
+    case HTTP_HEAD:
+        return "HEAD";
+    case HTTP_POST:
+        return "POST";
+    case HTTP_PUT:
+        return "PUT";
+    case HTTP_PATCH:
+        return "PATCH";
+    case HTTP_DELETE:
+        return "DELETE";
+    case HTTP_OPTIONS:
+        return "OPTIONS";
+    default:
+        return "ANY";
+    }
+}
+
+static String contentTypeFor(const String &path)
+{
+    static const char *const types[][2] = {
+        {".html", "text/html"}, {".htm", "text/html"}, {".css", "text/css"}, {".js", "application/javascript"}, {".json", "application/json"}, {".png", "image/png"}, {".ico", "image/x-icon"}, {".svg", "image/svg+xml"}, {".txt", "text/plain"}, {".gz", "application/x-gzip"}};
+    for (const auto &type : types)
+    {
+        if (path.endsWith(type[0]))
+        {
+            return type[1];
+        }
+    }
+    return "application/octet-stream";
+}
+
+static String base64Encode(const String &text)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    String out;
+    const uint8_t *data = (const uint8_t *)text.c_str();
+    size_t length = text.length();
+    for (size_t i = 0; i < length; i += 3)
+    {
+        uint32_t block = (uint32_t)data[i] << 16;
+        if (i + 1 < length)
+        {
+            block |= (uint32_t)data[i + 1] << 8;
+        }
+        if (i + 2 < length)
+        {
+            block |= data[i + 2];
+        }
+        out += alphabet[(block >> 18) & 0x3F];
+        out += alphabet[(block >> 12) & 0x3F];
+        out += i + 1 < length ? alphabet[(block >> 6) & 0x3F] : '=';
+        out += i + 2 < length ? alphabet[block & 0x3F] : '=';
+    }
+    return out;
+}
+
+// Value of "key=value" or key="value" inside a header such as Content-Disposition
+static String headerParameter(const String &header, const char *key)
+{
+    String needle = String(key) + "=";
+    int start = header.indexOf(needle);
+    if (start < 0)
+    {
+        return String();
+    }
+    start += needle.length();
+    if (header[start] == '"')
+    {
+        int end = header.indexOf('"', start + 1);
+        return header.substring(start + 1, end < 0 ? header.length() : end);
+    }
+    int end = header.indexOf(';', start);
+    String value = header.substring(start, end < 0 ? header.length() : end);
+    value.trim();
+    return value;
+}
+
+void ESP8266WebServer::close()
+{
+    closeClient();
+    _server.close();
+}
+
+void ESP8266WebServer::closeClient()
+{
+    _currentClient.stop();
+    _received.clear();
+}
+
+void ESP8266WebServer::handleClient()
+{
+    if (!_currentClient.connected())
+    {
+        closeClient();
+        _currentClient = _server.accept();
+        if (!_currentClient.connected())
+        {
+            return;
+        }
+        _stateStart = millis();
+    }
+
+    bool wasIdle = _received.empty();
+    uint8_t buffer[512];
+    while (_currentClient.available() > 0)
+    {
+        int n = _currentClient.read(buffer, sizeof(buffer));
+        if (n <= 0)
+        {
+            break;
+        }
+        _received.append((const char *)buffer, n);
+    }
+    if (wasIdle && !_received.empty())
+    {
+        _stateStart = millis();
+    }
+
+    size_t length;
+    if (!requestComplete(length))
+    {
+        unsigned long limit = _received.empty() ? HTTP_MAX_CLOSE_WAIT : HTTP_MAX_DATA_WAIT;
+        if (millis() - _stateStart > limit)
+        {
+            closeClient();
+        }
+        return;
+    }
+
+    std::string request = _received.substr(0, length);
+    _received.erase(0, length);
+    if (!parseRequest(request))
+    {
+        _keepAlive = false;
+        send(400, "text/plain", "Bad Request");
+        closeClient();
+        return;
+    }
+    handleRequest();
+
+    if (_keepAlive && _responseSent && _currentClient.connected())
+    {
+        _stateStart = millis();
+    }
+    else
+    {
+        closeClient();
+    }
+}
+
+bool ESP8266WebServer::requestComplete(size_t &length) const
+{
+    size_t headerEnd = _received.find("\r\n\r\n");
+    if (headerEnd == std::string::npos)
+    {
+        return false;
+    }
+    size_t bodyLength = 0;
+    String head = lowerCase(String(_received.substr(0, headerEnd + 2).c_str()));
+    int field = head.indexOf("\r\ncontent-length:");
+    if (field >= 0)
+    {
+        bodyLength = strtoul(head.c_str() + field + 17, nullptr, 10);
+    }
+    length = headerEnd + 4 + bodyLength;
+    return _received.size() >= length;
+}
+
+bool ESP8266WebServer::parseRequest(const std::string &request)
+{
+    _args.clear();
+    _headers.clear();
+    _currentUpload.reset();
+
+    size_t headerEnd = request.find("\r\n\r\n");
+    size_t lineEnd = request.find("\r\n");
+    String requestLine = request.substr(0, lineEnd).c_str();
+    int firstSpace = requestLine.indexOf(' ');
+    int secondSpace = requestLine.indexOf(' ', firstSpace + 1);
+    if (firstSpace < 0 || secondSpace < 0)
+    {
+        return false;
+    }
+
+    String method = requestLine.substring(0, firstSpace);
+    String url = requestLine.substring(firstSpace + 1, secondSpace);
+    _http11 = requestLine.substring(secondSpace + 1) == "HTTP/1.1";
+    _currentMethod = HTTP_ANY;
+    for (int m = HTTP_GET; m <= HTTP_OPTIONS; m++)
+    {
+        if (method == methodName((HTTPMethod)m))
+        {
+            _currentMethod = (HTTPMethod)m;
+        }
+    }
+    if (_currentMethod == HTTP_ANY)
+    {
+        return false;
+    }
+
+    int search = url.indexOf('?');
+    _currentUri = search < 0 ? url : url.substring(0, search);
+    if (search >= 0)
+    {
+        parseArguments(url.substring(search + 1));
+    }
+
+    size_t position = lineEnd + 2;
+    while (position < headerEnd)
+    {
+        size_t next = request.find("\r\n", position);
+        String line = request.substr(position, next - position).c_str();
+        position = next + 2;
+        int colon = line.indexOf(':');
+        if (colon > 0)
+        {
+            String value = line.substring(colon + 1);
+            value.trim();
+            _headers.push_back({line.substring(0, colon), value});
+        }
+    }
+
+    String connection = lowerCase(header("Connection"));
+    _keepAlive = _http11 ? connection != "close" : connection == "keep-alive";
+
+    std::string body = request.substr(headerEnd + 4);
+    if (body.empty())
+    {
+        return true;
+    }
+    String contentType = header("Content-Type");
+    if (contentType.startsWith("multipart/form-data"))
+    {
+        parseMultipart(body, headerParameter(contentType, "boundary"));
+        return true;
+    }
+    if (contentType.startsWith("application/x-www-form-urlencoded"))
+    {
+        parseArguments(body.c_str());
+    }
+    _args.push_back({"plain", String(body.c_str())});
+    return true;
+}
+
+void ESP8266WebServer::parseArguments(const String &data)
+{
+    int start = 0;
+    while (start < (int)data.length())
+    {
+        int end = data.indexOf('&', start);
+        if (end < 0)
+        {
+            end = data.length();
+        }
+        String pair = data.substring(start, end);
+        int equals = pair.indexOf('=');
+        if (pair.length() > 0)
+        {
+            if (equals < 0)
+            {
+                _args.push_back({urlDecode(pair), String()});
+            }
+            else
+            {
+                _args.push_back({urlDecode(pair.substring(0, equals)), urlDecode(pair.substring(equals + 1))});
+            }
+        }
+        start = end + 1;
+    }
+}
+
+void ESP8266WebServer::parseMultipart(const std::string &body, const String &boundary)
+{
+    std::string delimiter = std::string("--") + boundary.c_str();
+    const Route *route = findRoute();
+    size_t position = body.find(delimiter);
+    while (position != std::string::npos)
+    {
+        position += delimiter.size();
+        if (body.compare(position, 2, "--") == 0)
+        {
+            break; // Closing delimiter
+        }
+        size_t partHeaderEnd = body.find("\r\n\r\n", position);
+        size_t next = body.find("\r\n" + delimiter, partHeaderEnd);
+        if (partHeaderEnd == std::string::npos || next == std::string::npos)
+        {
+            break;
+        }
+
+        String partHeaders = body.substr(position, partHeaderEnd - position).c_str();
+        String disposition;
+        String type = "text/plain";
+        int lineStart = 0;
+        while (lineStart < (int)partHeaders.length())
+        {
+            int lineEnd = partHeaders.indexOf("\r\n", lineStart);
+            if (lineEnd < 0)
+            {
+                lineEnd = partHeaders.length();
+            }
+            String line = partHeaders.substring(lineStart, lineEnd);
+            String lower = lowerCase(line);
+            if (lower.startsWith("content-disposition:"))
+            {
+                disposition = line;
+            }
+            else if (lower.startsWith("content-type:"))
+            {
+                type = line.substring(13);
+                type.trim();
+            }
+            lineStart = lineEnd + 2;
+        }
+
+        const char *content = body.data() + partHeaderEnd + 4;
+        size_t contentLength = next - (partHeaderEnd + 4);
+        String name = headerParameter(disposition, "name");
+        if (disposition.indexOf("filename=") >= 0)
+        {
+            _currentUpload.reset(new HTTPUpload());
+            _currentUpload->name = name;
+            _currentUpload->filename = headerParameter(disposition, "filename");
+            _currentUpload->type = type;
+            _currentUpload->contentLength = body.size();
+            runUpload(*_currentUpload, route, (const uint8_t *)content, contentLength);
+            _args.push_back({name, _currentUpload->filename});
+        }
+        else
+        {
+            _args.push_back({name, String(std::string(content, contentLength).c_str())});
+        }
+        position = next + 2;
+    }
+}
+
+void ESP8266WebServer::runUpload(HTTPUpload &upload, const Route *route, const uint8_t *data, size_t length)
+{
+    THandlerFunction handler = route && route->uploadHandler ? route->uploadHandler : _fileUploadHandler;
+    if (!handler)
+    {
+        return;
+    }
+    upload.totalSize = 0;
+    upload.currentSize = 0;
+    upload.status = UPLOAD_FILE_START;
+    handler();
+    for (size_t offset = 0; offset < length; offset += HTTP_UPLOAD_BUFLEN)
+    {
+        upload.currentSize = std::min((size_t)HTTP_UPLOAD_BUFLEN, length - offset);
+        memcpy(upload.buf, data + offset, upload.currentSize);
+        upload.status = UPLOAD_FILE_WRITE;
+        handler();
+        upload.totalSize += upload.currentSize;
+    }
+    upload.currentSize = 0;
+    upload.status = UPLOAD_FILE_END;
+    handler();
+}
+
+const ESP8266WebServer::Route *ESP8266WebServer::findRoute() const
+{
+    for (const Route &route : _routes)
+    {
+        if (route.fs)
+        {
+            if ((_currentMethod == HTTP_GET || _currentMethod == HTTP_HEAD) && _currentUri.startsWith(route.uri))
+            {
+                return &route;
+            }
+        }
+        else if ((route.method == HTTP_ANY || route.method == _currentMethod) && route.uri == _currentUri)
+        {
+            return &route;
+        }
+    }
+    return nullptr;
+}
+
+bool ESP8266WebServer::serveStaticRoute(const Route &route)
+{
+    String path = route.path + _currentUri.substring(route.uri.length());
+    path.replace("//", "/");
+    if (path.endsWith("/"))
+    {
+        path += "index.htm";
+    }
+    if (!route.fs->exists(path))
+    {
+        return false;
+    }
+    File file = route.fs->open(path, "r");
+    if (!file)
+    {
+        return false;
+    }
+    if (route.cacheHeader.length() > 0)
+    {
+        sendHeader("Cache-Control", route.cacheHeader);
+    }
+    streamFile(file, contentTypeFor(path), _currentMethod);
+    file.close();
+    return true;
+}
+
+void ESP8266WebServer::handleRequest()
+{
+    _responseHeaders = String();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _responseSent = false;
+    _chunked = false;
+
+    for (const HookFunction &hook : _hooks)
+    {
+        ClientFuture future = hook(methodName(_currentMethod), _currentUri, &_currentClient, contentTypeFor);
+        if (future == CLIENT_MUST_STOP)
+        {
+            _keepAlive = false;
+            return;
+        }
+        if (future != CLIENT_REQUEST_CAN_CONTINUE)
+        {
+            _responseSent = future == CLIENT_REQUEST_IS_HANDLED;
+            _keepAlive = _keepAlive && _responseSent;
+            return;
+        }
+    }
+
+    // Handlers may register routes (serveStatic), so work on copies
+    const Route *found = findRoute();
+    bool handled = false;
+    if (found && found->fs)
+    {
+        Route route = *found;
+        handled = serveStaticRoute(route);
+    }
+    else if (found)
+    {
+        THandlerFunction handler = found->handler;
+        handler();
+        handled = true;
+    }
+    if (!handled)
+    {
+        if (_notFoundHandler)
+        {
+            _notFoundHandler();
+        }
+        else
+        {
+            send(404, "text/html", String("Not found: ") + _currentUri);
+        }
+    }
+    finishResponse();
+}
+
+void ESP8266WebServer::finishResponse()
+{
+    if (_chunked)
+    {
+        sendContent("", 0);
+    }
+    if (!_responseSent)
+    {
+        _keepAlive = false;
+    }
+}
+
+void ESP8266WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn)
+{
+    Route route;
+    route.uri = uri;
+    route.method = method;
+    route.handler = fn;
+    route.uploadHandler = ufn;
+    _routes.push_back(route);
+}
+
+void ESP8266WebServer::serveStatic(const char *uri, FS &fs, const char *path, const char *cacheHeader)
+{
+    Route route;
+    route.uri = uri;
+    route.method = HTTP_GET;
+    route.fs = &fs;
+    route.path = path;
+    route.cacheHeader = cacheHeader ? cacheHeader : "";
+    _routes.push_back(route);
+}
+
+bool ESP8266WebServer::authenticate(const char *username, const char *password)
+{
+    String authorization = header("Authorization");
+    if (!authorization.startsWith("Basic "))
+    {
+        return false;
+    }
+    String expected = base64Encode(String(username) + ":" + password);
+    return authorization.substring(6) == expected;
+}
+
+void ESP8266WebServer::requestAuthentication(HTTPAuthMethod mode, const char *realm, const String &authFailMsg)
+{
+    (void)mode; // Digest is answered with Basic on the host
+    sendHeader("WWW-Authenticate", String("Basic realm=\"") + (realm ? realm : "Login Required") + "\"");
+    send(401, "text/html", authFailMsg);
+}
+
+const String &ESP8266WebServer::arg(const String &name) const
+{
+    for (const auto &entry : _args)
+    {
+        if (entry.first == name)
+        {
+            return entry.second;
+        }
+    }
+    return emptyString;
+}
+
+const String &ESP8266WebServer::arg(int i) const
+{
+    return i >= 0 && i < (int)_args.size() ? _args[i].second : emptyString;
+}
+
+const String &ESP8266WebServer::argName(int i) const
+{
+    return i >= 0 && i < (int)_args.size() ? _args[i].first : emptyString;
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const
+{
+    for (const auto &entry : _args)
+    {
+        if (entry.first == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const String &ESP8266WebServer::header(const String &name) const
+{
+    String wanted = lowerCase(name);
+    for (const auto &entry : _headers)
+    {
+        if (lowerCase(entry.first) == wanted)
+        {
+            return entry.second;
+        }
+    }
+    return emptyString;
+}
+
+bool ESP8266WebServer::hasHeader(const String &name) const
+{
+    return &header(name) != &emptyString;
+}
+
+void ESP8266WebServer::sendHeader(const String &name, const String &value, bool first)
+{
+    String line = name + ": " + value + "\r\n";
+    _responseHeaders = first ? line + _responseHeaders : _responseHeaders + line;
+}
+
+void ESP8266WebServer::send(int code, const char *contentType, const String &content)
+{
+    String head = String("HTTP/1.") + (_http11 ? "1 " : "0 ") + String(code) + " " + responseCodeToString(code) + "\r\n";
+    if (contentType && *contentType)
+    {
+        head += String("Content-Type: ") + contentType + "\r\n";
+    }
+    if (_contentLength == CONTENT_LENGTH_NOT_SET)
+    {
+        head += "Content-Length: " + String((unsigned long)content.length()) + "\r\n";
+    }
+    else if (_contentLength == CONTENT_LENGTH_UNKNOWN)
+    {
+        // Without chunking only closing the connection ends the body
+        _chunked = _http11;
+        if (_chunked)
+        {
+            head += "Transfer-Encoding: chunked\r\n";
+        }
+        else
+        {
+            _keepAlive = false;
+        }
+    }
+    else
+    {
+        head += "Content-Length: " + String((unsigned long)_contentLength) + "\r\n";
+    }
+    head += _responseHeaders;
+    head += _keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    _currentClient.write((const uint8_t *)head.c_str(), head.length());
+    _responseHeaders = String();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _responseSent = true;
+
+    if (content.length() > 0 && _currentMethod != HTTP_HEAD)
+    {
+        sendContent(content);
+    }
+}
+
+void ESP8266WebServer::sendContent(const char *content, size_t size)
+{
+    if (!_chunked)
+    {
+        _currentClient.write((const uint8_t *)content, size);
+        return;
+    }
+    char prefix[12];
+    snprintf(prefix, sizeof(prefix), "%zx\r\n", size);
+    _currentClient.write((const uint8_t *)prefix, strlen(prefix));
+    _currentClient.write((const uint8_t *)content, size);
+    _currentClient.write((const uint8_t *)"\r\n", 2);
+    if (size == 0)
+    {
+        _chunked = false; // An empty chunk ends the body
+    }
+}
+
+String ESP8266WebServer::urlDecode(const String &text)
+{
+    String decoded;
+    for (unsigned int i = 0; i < text.length(); i++)
+    {
+        char c = text[i];
+        if (c == '+')
+        {
+            decoded += ' ';
+        }
+        else if (c == '%' && i + 2 < text.length() && isxdigit(text[i + 1]) && isxdigit(text[i + 2]))
+        {
+            char hex[3] = {text[i + 1], text[i + 2], 0};
+            decoded += (char)strtol(hex, nullptr, 16);
+            i += 2;
+        }
+        else
+        {
+            decoded += c;
+        }
+    }
+    return decoded;
+}
+
+String ESP8266WebServer::responseCodeToString(int code)
+{
+    switch (code)
+    {
+    case 200:
+        return "OK";
+    case 201:
+        return "Created";
+    case 204:
+        return "No Content";
+    case 301:
+        return "Moved Permanently";
+    case 302:
+        return "Found";
+    case 304:
+        return "Not Modified";
+    case 400:
+        return "Bad Request";
+    case 401:
+        return "Unauthorized";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 413:
+        return "Payload Too Large";
+    case 429:
+        return "Too Many Requests";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "";
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "WiFiServer.h"
+#include "FS.h"
+#include "Updater.h"
+
+// HTTP/1.1 server over WiFiServer with the parts of the core's
+// ESP8266WebServer API the firmware uses: one client at a time, keep-alive,
+// query/form/"plain" arguments, multipart uploads, chunked responses, hooks
+// and static files
+
+enum HTTPMethod
+{
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+enum HTTPUploadStatus
+{
+    UPLOAD_FILE_START,
+    UPLOAD_FILE_WRITE,
+    UPLOAD_FILE_END,
+    UPLOAD_FILE_ABORTED
+};
+
+enum HTTPAuthMethod
+{
+    BASIC_AUTH,
+    DIGEST_AUTH
+};
+
+#define HTTP_DOWNLOAD_UNIT_SIZE 1460
+#define HTTP_UPLOAD_BUFLEN 2048
+#define HTTP_MAX_DATA_WAIT 5000  // ms to wait for the rest of a request
+#define HTTP_MAX_CLOSE_WAIT 2000 // ms an idle keep-alive connection stays open
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+struct HTTPUpload
+{
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;   // Bytes received so far
+    size_t currentSize; // Bytes in buf
+    size_t contentLength;
+    uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+class ESP8266WebServer
+{
+public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<String(const String &)> ContentTypeFunction;
+    enum ClientFuture
+    {
+        CLIENT_REQUEST_CAN_CONTINUE,
+        CLIENT_REQUEST_IS_HANDLED,
+        CLIENT_MUST_STOP,
+        CLIENT_IS_GIVEN
+    };
+    typedef std::function<ClientFuture(const String &method, const String &url, WiFiClient *client,
+                                       ContentTypeFunction contentType)>
+        HookFunction;
+
+    explicit ESP8266WebServer(int port = 80) : _server(port) {}
+
+    void begin() { _server.begin(); }
+    void begin(uint16_t port) { _server.begin(port); }
+    void close();
+    void stop() { close(); }
+    void handleClient();
+
+    bool authenticate(const char *username, const char *password);
+    void requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH, const char *realm = nullptr,
+                               const String &authFailMsg = String());
+
+    void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn) { on(uri, method, fn, nullptr); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void serveStatic(const char *uri, FS &fs, const char *path, const char *cacheHeader = nullptr);
+    void onNotFound(THandlerFunction fn) { _notFoundHandler = fn; }
+    void onFileUpload(THandlerFunction fn) { _fileUploadHandler = fn; }
+    void addHook(HookFunction hook) { _hooks.push_back(hook); }
+
+    const String &uri() const { return _currentUri; }
+    HTTPMethod method() const { return _currentMethod; }
+    WiFiClient &client() { return _currentClient; }
+    HTTPUpload &upload() { return *_currentUpload; }
+
+    const String &arg(const String &name) const;
+    const String &arg(int i) const;
+    const String &argName(int i) const;
+    int args() const { return (int)_args.size(); }
+    bool hasArg(const String &name) const;
+    const String &header(const String &name) const;
+    bool hasHeader(const String &name) const;
+    const String &hostHeader() const { return header("Host"); }
+
+    void send(int code, const char *contentType = nullptr, const String &content = String());
+    void send(int code, char *contentType, const String &content) { send(code, (const char *)contentType, content); }
+    void send(int code, const String &contentType, const String &content) { send(code, contentType.c_str(), content); }
+    void send(int code, const char *contentType, const char *content) { send(code, contentType, String(content)); }
+    void send_P(int code, PGM_P contentType, PGM_P content) { send(code, contentType, String(content)); }
+    void setContentLength(size_t contentLength) { _contentLength = contentLength; }
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char *content) { sendContent(content, strlen(content)); }
+    void sendContent(const char *content, size_t size);
+
+    template <typename T>
+    size_t streamFile(T &file, const String &contentType, HTTPMethod requestMethod = HTTP_GET)
+    {
+        setContentLength(file.size());
+        send(200, contentType.c_str(), String());
+        if (requestMethod == HTTP_HEAD)
+        {
+            return 0;
+        }
+        uint8_t buffer[HTTP_DOWNLOAD_UNIT_SIZE];
+        size_t sent = 0;
+        int n;
+        while ((n = file.read(buffer, sizeof(buffer))) > 0)
+        {
+            sent += _currentClient.write(buffer, n);
+        }
+        return sent;
+    }
+
+    static String urlDecode(const String &text);
+    static String responseCodeToString(int code);
+
+private:
+    struct Route
+    {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+        THandlerFunction uploadHandler;
+        FS *fs = nullptr; // Static route: uri is a prefix mapped onto path
+        String path;
+        String cacheHeader;
+    };
+
+    bool requestComplete(size_t &length) const;
+    bool parseRequest(const std::string &request);
+    void parseArguments(const String &data);
+    void parseMultipart(const std::string &body, const String &boundary);
+    void runUpload(HTTPUpload &upload, const Route *route, const uint8_t *data, size_t length);
+    const Route *findRoute() const;
+    bool serveStaticRoute(const Route &route);
+    void handleRequest();
+    void finishResponse();
+    void closeClient();
+
+    WiFiServer _server;
+    WiFiClient _currentClient;
+    std::string _received;
+    unsigned long _stateStart = 0;
+
+    std::vector<Route> _routes;
+    std::vector<HookFunction> _hooks;
+    THandlerFunction _notFoundHandler;
+    THandlerFunction _fileUploadHandler;
+
+    HTTPMethod _currentMethod = HTTP_ANY;
+    String _currentUri;
+    bool _http11 = true;
+    bool _keepAlive = false;
+    std::vector<std::pair<String, String>> _args;
+    std::vector<std::pair<String, String>> _headers;
+    std::unique_ptr<HTTPUpload> _currentUpload;
+
+    String _responseHeaders;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool _responseSent = false;
+    bool _chunked = false;
+};
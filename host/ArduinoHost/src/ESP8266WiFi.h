@@ -0,0 +1,102 @@
+#pragma once
+#include <stdint.h>
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+typedef enum
+{
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+typedef enum WiFiMode
+{
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum WiFiSleepType
+{
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+// Station interface. Joins succeed at once unless host::wifiReachable(false);
+// the network itself is whatever HostNetwork is installed.
+class ESP8266WiFiClass
+{
+public:
+    wl_status_t begin(const char *ssid, const char *passphrase = nullptr, int32_t channel = 0,
+                      const uint8_t *bssid = nullptr, bool connect = true);
+    wl_status_t begin(const String &ssid, const String &passphrase = String(), int32_t channel = 0,
+                      const uint8_t *bssid = nullptr, bool connect = true)
+    {
+        return begin(ssid.c_str(), passphrase.c_str(), channel, bssid, connect);
+    }
+    wl_status_t begin();
+    bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+    bool disconnect(bool wifiOff = false);
+    bool reconnect();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    wl_status_t status() { return _status; }
+
+    bool mode(WiFiMode_t mode);
+    WiFiMode_t getMode() { return _mode; }
+    void persistent(bool persistent) { _persistent = persistent; }
+    bool setAutoReconnect(bool autoReconnect) { return (void)autoReconnect, true; }
+    bool setSleepMode(WiFiSleepType_t type, uint8_t listenInterval = 0);
+    WiFiSleepType_t getSleepMode() { return _sleepType; }
+    bool forceSleepBegin(uint32_t sleepUs = 0);
+    bool forceSleepWake();
+    bool hostname(const char *name);
+    const char *getHostname() { return _hostname.c_str(); }
+
+    IPAddress localIP();
+    IPAddress subnetMask();
+    IPAddress gatewayIP();
+    IPAddress dnsIP(uint8_t index = 0);
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    String macAddress() { return String("5C:CF:7F:C0:FF:EE"); }
+    String SSID() { return _ssid; }
+    String psk() { return _psk; }
+    uint8_t *BSSID();
+    String BSSIDstr();
+    int32_t channel() { return _status == WL_CONNECTED ? 6 : 0; }
+    int32_t RSSI() { return _status == WL_CONNECTED ? -58 : 31; }
+
+    int hostByName(const char *hostName, IPAddress &result);
+    int hostByName(const char *hostName, IPAddress &result, uint32_t timeoutMs)
+    {
+        (void)timeoutMs;
+        return hostByName(hostName, result);
+    }
+
+    void hostReset();
+
+private:
+    wl_status_t _status = WL_DISCONNECTED;
+    WiFiMode_t _mode = WIFI_STA;
+    WiFiSleepType_t _sleepType = WIFI_NONE_SLEEP;
+    bool _persistent = true;
+    String _ssid = "host-network"; // Saved credentials, as if provisioned earlier
+    String _psk;
+    String _hostname = "esp8266-host";
+    uint32_t _staticIP = 0;
+    uint32_t _staticGateway = 0;
+    uint32_t _staticSubnet = 0;
+    uint32_t _staticDns = 0;
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include "Arduino.h"
+
+class MDNSResponder
+{
+public:
+    bool begin(const char *hostname) { return (void)hostname, true; }
+    bool begin(const String &hostname) { return begin(hostname.c_str()); }
+    bool addService(const char *service, const char *proto, uint16_t port)
+    {
+        return (void)service, (void)proto, (void)port, true;
+    }
+    bool update() { return true; }
+    void announce() {}
+    bool end() { return true; }
+};
+
+extern MDNSResponder MDNS;
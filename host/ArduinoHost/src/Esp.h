@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+struct rst_info;
+
+enum RFMode
+{
+    RF_DEFAULT = 0,
+    RF_CAL = 1,
+    RF_NO_CAL = 2,
+    RF_DISABLED = 4
+};
+#define WAKE_RF_DEFAULT RF_DEFAULT
+#define WAKE_RFCAL RF_CAL
+#define WAKE_NO_RFCAL RF_NO_CAL
+#define WAKE_RF_DISABLED RF_DISABLED
+
+class EspClass
+{
+public:
+    void wdtEnable(uint32_t timeoutMs = 0) { (void)timeoutMs; }
+    void wdtDisable() {}
+    void wdtFeed() {}
+
+    // Never return on the device; see host::onRestart()
+    void restart();
+    void reset() { restart(); }
+    void deepSleep(uint64_t timeUs, RFMode mode = RF_DEFAULT);
+    uint64_t deepSleepMax() { return 0x0FFFFFFFULL * 1000ULL; }
+
+    bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+    bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+    uint32_t getFreeHeap();
+    uint32_t getMaxFreeBlockSize();
+    uint8_t getHeapFragmentation();
+    void getHeapStats(uint32_t *freeHeap, uint32_t *maxBlock = nullptr, uint8_t *fragmentation = nullptr);
+    uint32_t getFreeContStack() { return 2048; }
+    void resetFreeContStack() {}
+
+    uint32_t getChipId();
+    uint32_t getFlashChipId() { return 0x001640E0; }
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint32_t getSketchSize() { return 0; }
+    uint32_t getFreeSketchSpace() { return 1024 * 1024; }
+    uint8_t getCpuFreqMHz() { return 80; }
+    // Host monotonic clock at 80 MHz, so profiles measure real host time
+    uint32_t getCycleCount();
+
+    String getResetReason();
+    String getResetInfo() { return getResetReason(); }
+    struct rst_info *getResetInfoPtr();
+    String getCoreVersion() { return String("host"); }
+    const char *getSdkVersion() { return "host"; }
+};
+
+extern EspClass ESP;
@@ -0,0 +1,185 @@
+#include <sys/stat.h>
+#include <errno.h>
+#include <ftw.h>
+#include "FS.h"
+#include "LittleFS.h"
+#include "ArduinoHost.h"
+
+FS LittleFS;
+
+static std::string fsRootPath = "./.host_fs";
+
+namespace host
+{
+    void setFsRoot(const std::string &path)
+    {
+        fsRootPath = path;
+    }
+
+    const std::string &fsRoot()
+    {
+        return fsRootPath;
+    }
+}
+
+static bool makeDirectories(const std::string &path)
+{
+    for (size_t pos = 1; pos <= path.length(); pos++)
+    {
+        if (pos == path.length() || path[pos] == '/')
+        {
+            std::string prefix = path.substr(0, pos);
+            if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+File::File(FILE *handle, const String &name) : _handle(handle, fclose), _name(name) {}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    return _handle ? fwrite(buf, 1, size, _handle.get()) : 0;
+}
+
+int File::available()
+{
+    if (!_handle)
+    {
+        return 0;
+    }
+    long remaining = (long)size() - (long)position();
+    return remaining > 0 ? (int)remaining : 0;
+}
+
+int File::read()
+{
+    return _handle ? fgetc(_handle.get()) : -1;
+}
+
+int File::read(uint8_t *buf, size_t size)
+{
+    return _handle ? (int)fread(buf, 1, size, _handle.get()) : -1;
+}
+
+int File::peek()
+{
+    if (!_handle)
+    {
+        return -1;
+    }
+    int c = fgetc(_handle.get());
+    if (c != EOF)
+    {
+        ungetc(c, _handle.get());
+    }
+    return c;
+}
+
+void File::flush()
+{
+    if (_handle)
+    {
+        fflush(_handle.get());
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _handle && fseek(_handle.get(), pos, whence[mode]) == 0;
+}
+
+size_t File::position() const
+{
+    return _handle ? (size_t)ftell(_handle.get()) : 0;
+}
+
+size_t File::size() const
+{
+    if (!_handle)
+    {
+        return 0;
+    }
+    struct stat info;
+    fflush(_handle.get());
+    return fstat(fileno(_handle.get()), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+std::string FS::hostPath(const char *path) const
+{
+    std::string full = fsRootPath;
+    if (path[0] != '/')
+    {
+        full += '/';
+    }
+    return full + path;
+}
+
+bool FS::begin()
+{
+    _mounted = makeDirectories(fsRootPath);
+    return _mounted;
+}
+
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *walk)
+{
+    // Depth-first, so directories are empty by the time they are visited; keep the root
+    return walk->level == 0 ? 0 : ::remove(path);
+}
+
+bool FS::format()
+{
+    struct stat info;
+    if (stat(fsRootPath.c_str(), &info) == 0 &&
+        nftw(fsRootPath.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS) != 0)
+    {
+        return false;
+    }
+    return begin();
+}
+
+File FS::open(const char *path, const char *mode)
+{
+    if (!_mounted)
+    {
+        return File();
+    }
+    std::string full = hostPath(path);
+    if (mode[0] != 'r')
+    {
+        size_t slash = full.rfind('/');
+        if (slash != std::string::npos)
+        {
+            makeDirectories(full.substr(0, slash));
+        }
+    }
+    // Binary modes; "r+"/"w+"/"a+" map directly
+    std::string hostMode = std::string(mode) + "b";
+    FILE *handle = fopen(full.c_str(), hostMode.c_str());
+    return handle ? File(handle, String(path)) : File();
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat info;
+    return _mounted && stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return _mounted && ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    return _mounted && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    return _mounted && makeDirectories(hostPath(path));
+}
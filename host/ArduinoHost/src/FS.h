@@ -0,0 +1,64 @@
+#pragma once
+#include <stdio.h>
+#include <memory>
+#include "Arduino.h"
+
+// Files are plain host files below host::fsRoot()
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File : public Stream
+{
+public:
+    File() {}
+    File(FILE *handle, const String &name);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    using Stream::read;
+    int peek() override;
+    void flush() override;
+
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close() { _handle.reset(); }
+    operator bool() const { return (bool)_handle; }
+    const char *name() const { return _name.c_str(); }
+    bool isDirectory() const { return false; }
+
+private:
+    std::shared_ptr<FILE> _handle; // Copies share the open file, like the core
+    String _name;
+};
+
+class FS
+{
+public:
+    bool begin();
+    void end() { _mounted = false; }
+    bool format();
+    File open(const char *path, const char *mode);
+    File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char *path);
+
+private:
+    std::string hostPath(const char *path) const;
+    bool _mounted = false;
+};
+
@@ -0,0 +1,28 @@
+#pragma once
+#include "Stream.h"
+
+// UART0: output goes to stdout, input comes from host::serialInject()
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) { _baud = baud; }
+    void end() {}
+    unsigned long baudRate() const { return _baud; }
+    void setDebugOutput(bool) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override { return 128; } // Hardware FIFO size
+    int available() override;
+    int read() override;
+    int peek() override;
+    using Stream::read;
+
+    operator bool() const { return true; }
+
+private:
+    unsigned long _baud = 0;
+};
+
+extern HardwareSerial Serial;
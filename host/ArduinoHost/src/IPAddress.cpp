@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include "IPAddress.h"
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    uint8_t *bytes = (uint8_t *)&_address;
+    bytes[0] = a;
+    bytes[1] = b;
+    bytes[2] = c;
+    bytes[3] = d;
+}
+
+IPAddress::IPAddress(const uint8_t *address)
+{
+    memcpy(&_address, address, sizeof(_address));
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    uint8_t bytes[4];
+    int part = 0;
+    int value = -1;
+    for (const char *p = address; ; p++)
+    {
+        if (*p >= '0' && *p <= '9')
+        {
+            value = (value < 0 ? 0 : value * 10) + (*p - '0');
+            if (value > 255)
+            {
+                return false;
+            }
+        }
+        else if ((*p == '.' || *p == '\0') && value >= 0 && part < 4)
+        {
+            bytes[part++] = (uint8_t)value;
+            value = -1;
+            if (*p == '\0')
+            {
+                break;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (part != 4)
+    {
+        return false;
+    }
+    memcpy(&_address, bytes, sizeof(_address));
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    const uint8_t *bytes = (const uint8_t *)&_address;
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(text);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include "Print.h"
+
+// IPv4 only; stored in network byte order like the ESP8266 core
+class IPAddress : public Printable
+{
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+    IPAddress(uint32_t address) : _address(address) {}
+    IPAddress(const uint8_t *address);
+
+    operator uint32_t() const { return _address; }
+    uint8_t operator[](int index) const { return ((const uint8_t *)&_address)[index]; }
+    uint8_t &operator[](int index) { return ((uint8_t *)&_address)[index]; }
+    bool operator==(const IPAddress &other) const { return _address == other._address; }
+    bool operator!=(const IPAddress &other) const { return _address != other._address; }
+
+    bool isSet() const { return _address != 0; }
+    bool fromString(const char *address);
+    bool fromString(const String &address) { return fromString(address.c_str()); }
+    String toString() const;
+    size_t printTo(Print &p) const override { return p.print(toString()); }
+
+    uint8_t *raw_address() { return (uint8_t *)&_address; }
+
+private:
+    uint32_t _address;
+};
+
+extern const IPAddress INADDR_NONE;
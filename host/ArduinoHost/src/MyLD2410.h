@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "Arduino.h"
+
+// LD2410 driver with the MyLD2410 API. It parses the radar's real UART
+// framing from the stream, so a SoftwareSerial fed with recorded or
+// synthesised frames drives it exactly like the sensor would.
+class MyLD2410
+{
+public:
+    enum Response
+    {
+        FAIL = 0,
+        ACK,
+        DATA
+    };
+
+    MyLD2410(Stream &serial, bool debug = false) : _serial(serial) { (void)debug; }
+
+    bool begin()
+    {
+        _frameLength = 0; // A partial frame from before does not survive a restart
+        return _begun = true;
+    }
+    void end() { _begun = false; }
+    Response check();
+
+    bool presenceDetected() const { return _status != 0; }
+    bool movingTargetDetected() const { return _status & 0x01; }
+    bool stationaryTargetDetected() const { return _status & 0x02; }
+    unsigned long movingTargetDistance() const { return _movingDistance; }
+    byte movingTargetSignal() const { return _movingSignal; }
+    unsigned long stationaryTargetDistance() const { return _stationaryDistance; }
+    byte stationaryTargetSignal() const { return _stationarySignal; }
+    unsigned long detectedDistance() const { return _detectedDistance; }
+    bool inEnhancedMode() const { return _enhanced; }
+    byte getStatus() const { return _status; }
+    const char *statusString() const;
+
+    // Bytes of one basic-mode report frame for the given target state, for
+    // host code that synthesises radar traffic
+    static size_t buildDataFrame(uint8_t *frame, size_t capacity, uint8_t status, uint16_t movingDistance,
+                                 uint8_t movingSignal, uint16_t stationaryDistance, uint8_t stationarySignal,
+                                 uint16_t detectedDistance);
+
+private:
+    bool processFrame();
+
+    Stream &_serial;
+    bool _begun = false;
+
+    uint8_t _frame[64];
+    size_t _frameLength = 0;
+    bool _ackFrame = false;
+
+    uint8_t _status = 0;
+    uint16_t _movingDistance = 0;
+    uint8_t _movingSignal = 0;
+    uint16_t _stationaryDistance = 0;
+    uint8_t _stationarySignal = 0;
+    uint16_t _detectedDistance = 0;
+    bool _enhanced = false;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include "Arduino.h"
+#include "WiFiUdp.h"
+
+// Serves time from the virtual clock, starting at host epoch
+// NTPClient::hostEpochBase (2024-01-01 by default)
+class NTPClient
+{
+public:
+    explicit NTPClient(WiFiUDP &udp) { (void)udp; }
+    NTPClient(WiFiUDP &udp, long timeOffset) : _timeOffset(timeOffset) { (void)udp; }
+
+    void begin() {}
+    void begin(unsigned int port) { (void)port; }
+    void end() {}
+    bool update() { return true; }
+    bool forceUpdate() { return true; }
+    bool isTimeSet() const { return true; }
+    void setTimeOffset(int timeOffset) { _timeOffset = timeOffset; }
+    void setUpdateInterval(unsigned long updateInterval) { (void)updateInterval; }
+    void setPoolServerName(const char *poolServerName) { (void)poolServerName; }
+
+    unsigned long getEpochTime() const { return hostEpochBase + _timeOffset + millis() / 1000; }
+    int getDay() const { return ((getEpochTime() / 86400L) + 4) % 7; }
+    int getHours() const { return (getEpochTime() % 86400L) / 3600; }
+    int getMinutes() const { return (getEpochTime() % 3600) / 60; }
+    int getSeconds() const { return getEpochTime() % 60; }
+    String getFormattedTime() const
+    {
+        char text[9];
+        snprintf(text, sizeof(text), "%02d:%02d:%02d", getHours(), getMinutes(), getSeconds());
+        return String(text);
+    }
+
+    static unsigned long hostEpochBase;
+
+private:
+    long _timeOffset = 0;
+};
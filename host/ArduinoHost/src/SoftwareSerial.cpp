@@ -0,0 +1,71 @@
+#include "SoftwareSerial.h"
+
+size_t SoftwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t SoftwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (!_started)
+    {
+        return 0;
+    }
+    _tx.append((const char *)buffer, size);
+    return size;
+}
+
+int SoftwareSerial::available()
+{
+    return (int)_rx.size();
+}
+
+int SoftwareSerial::read()
+{
+    if (_rx.empty())
+    {
+        return -1;
+    }
+    uint8_t c = _rx.front();
+    _rx.pop_front();
+    return c;
+}
+
+int SoftwareSerial::read(uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size && !_rx.empty())
+    {
+        buffer[n++] = _rx.front();
+        _rx.pop_front();
+    }
+    return (int)n;
+}
+
+int SoftwareSerial::peek()
+{
+    return _rx.empty() ? -1 : _rx.front();
+}
+
+void SoftwareSerial::hostInject(const uint8_t *data, size_t length)
+{
+    if (_started)
+    {
+        _rx.insert(_rx.end(), data, data + length);
+    }
+}
+
+std::string SoftwareSerial::hostTakeWritten()
+{
+    std::string written;
+    written.swap(_tx);
+    return written;
+}
+
+void SoftwareSerial::hostReset()
+{
+    _started = false;
+    _baud = 0;
+    _rx.clear();
+    _tx.clear();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include "Stream.h"
+
+// Bit-banged UART; the host side feeds the receive queue and drains what the
+// firmware transmitted
+class SoftwareSerial : public Stream
+{
+public:
+    SoftwareSerial(int8_t rxPin, int8_t txPin, bool invert = false) : _rxPin(rxPin), _txPin(txPin) { (void)invert; }
+
+    void begin(uint32_t baud)
+    {
+        _baud = baud;
+        _started = true;
+    }
+    void end() { _started = false; }
+    bool listen() { return true; }
+    bool isListening() { return _started; }
+    bool overflow() { return false; }
+    uint32_t baudRate() const { return _baud; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    using Stream::read;
+    int peek() override;
+    int availableForWrite() override { return 64; }
+
+    // Host side. Bytes injected before begin() are dropped, like a UART that
+    // is not yet listening.
+    void hostInject(const uint8_t *data, size_t length);
+    std::string hostTakeWritten();
+    void hostReset();
+
+private:
+    int8_t _rxPin;
+    int8_t _txPin;
+    uint32_t _baud = 0;
+    bool _started = false;
+    std::deque<uint8_t> _rx;
+    std::string _tx;
+};
@@ -0,0 +1,43 @@
+#include "Stream.h"
+
+int Stream::read(uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size && available() > 0)
+    {
+        int c = read();
+        if (c < 0)
+        {
+            break;
+        }
+        buffer[n++] = (uint8_t)c;
+    }
+    return (int)n;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    return (size_t)read(buffer, length);
+}
+
+String Stream::readString()
+{
+    String result;
+    int c;
+    while (available() > 0 && (c = read()) >= 0)
+    {
+        result.concat((char)c);
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String result;
+    int c;
+    while (available() > 0 && (c = read()) >= 0 && c != terminator)
+    {
+        result.concat((char)c);
+    }
+    return result;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    // No blocking on the host: reads stop at the first missing byte
+    virtual int read(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    size_t readBytes(uint8_t *buffer, size_t length);
+    String readString();
+    String readStringUntil(char terminator);
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+
+protected:
+    unsigned long _timeout = 1000;
+};
@@ -0,0 +1,80 @@
+#include "Updater.h"
+
+UpdaterClass Update;
+
+bool UpdaterClass::begin(size_t size, int command, int ledPin, uint8_t ledOn)
+{
+    (void)ledPin;
+    (void)ledOn;
+    if (_size > 0)
+    {
+        return false; // Already running
+    }
+    _error = UPDATE_ERROR_OK;
+    _finished = false;
+    _image.clear();
+    _command = command;
+    if (size == 0)
+    {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    if (size > (command == U_FS ? (size_t)2 * 1024 * 1024 : (size_t)ESP.getFreeSketchSpace()))
+    {
+        _error = UPDATE_ERROR_SPACE;
+        return false;
+    }
+    _size = size;
+    return true;
+}
+
+size_t UpdaterClass::write(uint8_t *data, size_t length)
+{
+    if (hasError() || !isRunning())
+    {
+        return 0;
+    }
+    if (length > remaining())
+    {
+        _error = UPDATE_ERROR_SPACE;
+        return 0;
+    }
+    _image.insert(_image.end(), data, data + length);
+    return length;
+}
+
+bool UpdaterClass::end(bool evenIfRemaining)
+{
+    if (!isRunning())
+    {
+        return false;
+    }
+    if (hasError() || (remaining() > 0 && !evenIfRemaining))
+    {
+        if (!hasError())
+        {
+            _error = UPDATE_ERROR_READ;
+        }
+        _size = 0;
+        return false;
+    }
+    if (_image.empty())
+    {
+        _error = UPDATE_ERROR_NO_DATA;
+        _size = 0;
+        return false;
+    }
+    _size = 0;
+    _finished = true;
+    return true;
+}
+
+void UpdaterClass::printError(Print &out)
+{
+    static const char *const messages[] = {"No Error", "Flash Write Failed", "Flash Erase Failed", "Flash Read Failed",
+                                           "Not Enough Space", "Bad Size Given", "Stream Read Timeout", "MD5 Failed",
+                                           "Flash config wrong", "new Flash config wrong", "Magic byte is wrong",
+                                           "Invalid bootstrapping state", "Signature verification failed",
+                                           "No data supplied"};
+    out.printf("ERROR[%u]: %s\n", _error, _error < 14 ? messages[_error] : "UNKNOWN");
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include "Arduino.h"
+
+// Firmware/filesystem image writer. The host keeps the last image in memory
+// instead of flashing it; sizes and error codes follow the core.
+
+#define U_FLASH 0
+#define U_FS 100
+#define U_AUTH 200
+
+#define UPDATE_ERROR_OK (0)
+#define UPDATE_ERROR_WRITE (1)
+#define UPDATE_ERROR_ERASE (2)
+#define UPDATE_ERROR_READ (3)
+#define UPDATE_ERROR_SPACE (4)
+#define UPDATE_ERROR_SIZE (5)
+#define UPDATE_ERROR_STREAM (6)
+#define UPDATE_ERROR_MD5 (7)
+#define UPDATE_ERROR_FLASH_CONFIG (8)
+#define UPDATE_ERROR_NEW_FLASH_CONFIG (9)
+#define UPDATE_ERROR_MAGIC_BYTE (10)
+#define UPDATE_ERROR_BOOTSTRAP (11)
+#define UPDATE_ERROR_SIGN (12)
+#define UPDATE_ERROR_NO_DATA (13)
+
+class UpdaterClass
+{
+public:
+    bool begin(size_t size, int command = U_FLASH, int ledPin = -1, uint8_t ledOn = LOW);
+    size_t write(uint8_t *data, size_t length);
+    bool end(bool evenIfRemaining = false);
+    void printError(Print &out);
+    void clearError() { _error = UPDATE_ERROR_OK; }
+    bool hasError() const { return _error != UPDATE_ERROR_OK; }
+    uint8_t getError() const { return _error; }
+    bool isRunning() const { return _size > 0; }
+    bool isFinished() const { return _finished; }
+    size_t size() const { return _size; }
+    size_t progress() const { return _image.size(); }
+    size_t remaining() const { return _size - _image.size(); }
+    int command() const { return _command; }
+    bool setMD5(const char *expected) { return expected != nullptr; }
+
+    // Host only: the most recently written image
+    const std::vector<uint8_t> &hostImage() const { return _image; }
+
+private:
+    std::vector<uint8_t> _image;
+    size_t _size = 0;
+    int _command = U_FLASH;
+    uint8_t _error = UPDATE_ERROR_OK;
+    bool _finished = false;
+};
+
+extern UpdaterClass Update;
@@ -0,0 +1,236 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include "WString.h"
+
+static std::string formatInteger(unsigned long long value, bool negative, unsigned char base)
+{
+    if (base < 2 || base > 36)
+    {
+        base = 10;
+    }
+    char digits[72];
+    int pos = sizeof(digits);
+    digits[--pos] = '\0';
+    do
+    {
+        unsigned int digit = value % base;
+        digits[--pos] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    if (negative)
+    {
+        digits[--pos] = '-';
+    }
+    return std::string(digits + pos);
+}
+
+static std::string formatSigned(long long value, unsigned char base)
+{
+    // Like the core, only base 10 gets a sign; other bases show the bit pattern
+    if (base == 10 && value < 0)
+    {
+        return formatInteger(0ULL - (unsigned long long)value, true, base);
+    }
+    return formatInteger((unsigned long long)value, false, base);
+}
+
+String::String(unsigned char value, unsigned char base) : _buf(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : _buf(base == 10 ? formatSigned(value, base) : formatInteger((unsigned int)value, false, base)) {}
+String::String(unsigned int value, unsigned char base) : _buf(formatInteger(value, false, base)) {}
+// long is 32 bits on the ESP8266: keep the device's bit patterns for non-decimal bases
+String::String(long value, unsigned char base) : _buf(base == 10 ? formatSigned(value, base) : formatInteger((uint32_t)value, false, base)) {}
+String::String(unsigned long value, unsigned char base) : _buf(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base) : _buf(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : _buf(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned char decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    _buf = text;
+}
+
+bool String::concat(const String &str)
+{
+    _buf += str._buf;
+    return true;
+}
+
+bool String::concat(const char *cstr)
+{
+    if (!cstr)
+    {
+        return false;
+    }
+    _buf += cstr;
+    return true;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+    if (!cstr)
+    {
+        return false;
+    }
+    _buf.append(cstr, length);
+    return true;
+}
+
+bool String::concat(char c)
+{
+    _buf += c;
+    return true;
+}
+
+bool String::equalsIgnoreCase(const String &other) const
+{
+    return _buf.length() == other._buf.length() && strcasecmp(c_str(), other.c_str()) == 0;
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+    return offset <= _buf.length() && _buf.compare(offset, prefix._buf.length(), prefix._buf) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return suffix._buf.length() <= _buf.length() &&
+           _buf.compare(_buf.length() - suffix._buf.length(), suffix._buf.length(), suffix._buf) == 0;
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= _buf.length())
+    {
+        dummy = 0;
+        return dummy;
+    }
+    return _buf[index];
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t pos = _buf.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &str, unsigned int from) const
+{
+    size_t pos = _buf.find(str._buf, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const
+{
+    size_t pos = _buf.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    size_t pos = _buf.rfind(str._buf);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+    {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from >= _buf.length())
+    {
+        return String();
+    }
+    if (to > _buf.length())
+    {
+        to = _buf.length();
+    }
+    return String(_buf.substr(from, to - from));
+}
+
+void String::replace(char find, char replacement)
+{
+    for (char &c : _buf)
+    {
+        if (c == find)
+        {
+            c = replacement;
+        }
+    }
+}
+
+void String::replace(const String &find, const String &replacement)
+{
+    if (find._buf.empty())
+    {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = _buf.find(find._buf, pos)) != std::string::npos)
+    {
+        _buf.replace(pos, find._buf.length(), replacement._buf);
+        pos += replacement._buf.length();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < _buf.length())
+    {
+        _buf.erase(index, count);
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : _buf)
+    {
+        c = tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : _buf)
+    {
+        c = toupper((unsigned char)c);
+    }
+}
+
+void String::trim()
+{
+    size_t first = 0;
+    while (first < _buf.length() && isspace((unsigned char)_buf[first]))
+    {
+        first++;
+    }
+    size_t last = _buf.length();
+    while (last > first && isspace((unsigned char)_buf[last - 1]))
+    {
+        last--;
+    }
+    _buf = _buf.substr(first, last - first);
+}
+
+long String::toInt() const
+{
+    return atol(c_str());
+}
+
+float String::toFloat() const
+{
+    return (float)atof(c_str());
+}
+
+double String::toDouble() const
+{
+    return atof(c_str());
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// Flash strings are ordinary pointers on the host
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s) FPSTR(s)
+
+// Arduino String on top of std::string, with the ESP8266 core's API
+class String
+{
+public:
+    String() {}
+    String(const char *cstr) : _buf(cstr ? cstr : "") {}
+    String(const char *cstr, size_t length) : _buf(cstr, length) {}
+    String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+    String(const std::string &str) : _buf(str) {}
+    explicit String(char c) : _buf(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimals = 2);
+    explicit String(double value, unsigned char decimals = 2);
+
+    const char *c_str() const { return _buf.c_str(); }
+    unsigned int length() const { return _buf.length(); }
+    bool isEmpty() const { return _buf.empty(); }
+    bool reserve(unsigned int size)
+    {
+        _buf.reserve(size);
+        return true;
+    }
+    char *begin() { return &_buf[0]; }
+    char *end() { return &_buf[0] + _buf.length(); }
+    const char *begin() const { return _buf.data(); }
+    const char *end() const { return _buf.data() + _buf.length(); }
+
+    bool concat(const String &str);
+    bool concat(const char *cstr);
+    bool concat(const char *cstr, unsigned int length);
+    bool concat(const __FlashStringHelper *str) { return concat(reinterpret_cast<const char *>(str)); }
+    bool concat(char c);
+    bool concat(unsigned char value) { return concat(String(value)); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(long long value) { return concat(String(value)); }
+    bool concat(unsigned long long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    bool equals(const String &other) const { return _buf == other._buf; }
+    bool equals(const char *cstr) const { return _buf == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String &other) const;
+    int compareTo(const String &other) const { return _buf.compare(other._buf); }
+    bool startsWith(const String &prefix, unsigned int offset = 0) const;
+    bool endsWith(const String &suffix) const;
+
+    char charAt(unsigned int index) const { return index < _buf.length() ? _buf[index] : 0; }
+    void setCharAt(unsigned int index, char c)
+    {
+        if (index < _buf.length())
+        {
+            _buf[index] = c;
+        }
+    }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index);
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String &str) const;
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void replace(char find, char replacement);
+    void replace(const String &find, const String &replacement);
+    void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    const std::string &str() const { return _buf; }
+
+private:
+    std::string _buf;
+};
+
+inline bool operator==(const String &a, const String &b) { return a.equals(b); }
+inline bool operator==(const String &a, const char *b) { return a.equals(b); }
+inline bool operator==(const char *a, const String &b) { return b.equals(a); }
+inline bool operator!=(const String &a, const String &b) { return !a.equals(b); }
+inline bool operator!=(const String &a, const char *b) { return !a.equals(b); }
+inline bool operator!=(const char *a, const String &b) { return !b.equals(a); }
+inline bool operator<(const String &a, const String &b) { return a.compareTo(b) < 0; }
+inline bool operator>(const String &a, const String &b) { return a.compareTo(b) > 0; }
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+template <typename T>
+String operator+(const String &lhs, const T &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(char lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
@@ -0,0 +1,346 @@
+#include "ESP8266WiFi.h"
+#include "ArduinoHost.h"
+#include "host_internal.h"
+
+ESP8266WiFiClass WiFi;
+
+static HostNetwork *installedNetwork = nullptr;
+static bool stationReachable = true;
+static uint8_t hostBssid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+namespace host
+{
+    void setNetwork(HostNetwork *network)
+    {
+        installedNetwork = network;
+    }
+
+    HostNetwork *network()
+    {
+        return installedNetwork;
+    }
+
+    void wifiReachable(bool reachable)
+    {
+        stationReachable = reachable;
+        if (!reachable && WiFi.status() == WL_CONNECTED)
+        {
+            WiFi.disconnect();
+        }
+    }
+
+    void resetWifi()
+    {
+        WiFi.hostReset();
+    }
+}
+
+// Station
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel,
+                                    const uint8_t *bssid, bool connect)
+{
+    (void)channel;
+    (void)bssid;
+    _ssid = ssid ? ssid : "";
+    _psk = passphrase ? passphrase : "";
+    if (!connect)
+    {
+        return _status;
+    }
+    return begin();
+}
+
+wl_status_t ESP8266WiFiClass::begin()
+{
+    if (_mode == WIFI_OFF)
+    {
+        _mode = WIFI_STA;
+    }
+    if (_ssid.length() == 0)
+    {
+        _status = WL_NO_SSID_AVAIL;
+    }
+    else
+    {
+        _status = stationReachable ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+    }
+    return _status;
+}
+
+bool ESP8266WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2)
+{
+    (void)dns2;
+    _staticIP = local;
+    _staticGateway = gateway;
+    _staticSubnet = subnet;
+    _staticDns = dns1;
+    return true;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff)
+{
+    _status = WL_DISCONNECTED;
+    if (wifiOff)
+    {
+        _mode = WIFI_OFF;
+    }
+    return true;
+}
+
+bool ESP8266WiFiClass::reconnect()
+{
+    return begin() == WL_CONNECTED;
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode)
+{
+    _mode = mode;
+    if (mode == WIFI_OFF)
+    {
+        _status = WL_DISCONNECTED;
+    }
+    return true;
+}
+
+bool ESP8266WiFiClass::setSleepMode(WiFiSleepType_t type, uint8_t listenInterval)
+{
+    (void)listenInterval;
+    _sleepType = type;
+    return true;
+}
+
+bool ESP8266WiFiClass::forceSleepBegin(uint32_t sleepUs)
+{
+    (void)sleepUs;
+    _mode = WIFI_OFF;
+    _status = WL_DISCONNECTED;
+    return true;
+}
+
+bool ESP8266WiFiClass::forceSleepWake()
+{
+    _mode = WIFI_STA;
+    return true;
+}
+
+bool ESP8266WiFiClass::hostname(const char *name)
+{
+    _hostname = name;
+    return true;
+}
+
+IPAddress ESP8266WiFiClass::localIP()
+{
+    if (_status != WL_CONNECTED)
+    {
+        return IPAddress();
+    }
+    return _staticIP ? IPAddress(_staticIP) : IPAddress(10, 0, 0, 2);
+}
+
+IPAddress ESP8266WiFiClass::subnetMask()
+{
+    if (_status != WL_CONNECTED)
+    {
+        return IPAddress();
+    }
+    return _staticSubnet ? IPAddress(_staticSubnet) : IPAddress(255, 255, 255, 0);
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP()
+{
+    if (_status != WL_CONNECTED)
+    {
+        return IPAddress();
+    }
+    return _staticGateway ? IPAddress(_staticGateway) : IPAddress(10, 0, 0, 1);
+}
+
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t index)
+{
+    if (_status != WL_CONNECTED || index > 0)
+    {
+        return IPAddress();
+    }
+    return _staticDns ? IPAddress(_staticDns) : IPAddress(10, 0, 0, 1);
+}
+
+uint8_t *ESP8266WiFiClass::BSSID()
+{
+    return hostBssid;
+}
+
+String ESP8266WiFiClass::BSSIDstr()
+{
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+             hostBssid[0], hostBssid[1], hostBssid[2], hostBssid[3], hostBssid[4], hostBssid[5]);
+    return String(text);
+}
+
+int ESP8266WiFiClass::hostByName(const char *hostName, IPAddress &result)
+{
+    if (result.fromString(hostName))
+    {
+        return 1;
+    }
+    uint32_t address;
+    if (_status == WL_CONNECTED && installedNetwork && installedNetwork->resolve(hostName, address))
+    {
+        result = IPAddress(address);
+        return 1;
+    }
+    return 0;
+}
+
+void ESP8266WiFiClass::hostReset()
+{
+    // Credentials live in the SDK's flash config and survive resets
+    _status = WL_DISCONNECTED;
+    _mode = WIFI_STA;
+    _sleepType = WIFI_NONE_SLEEP;
+    _persistent = true;
+    _staticIP = _staticGateway = _staticSubnet = _staticDns = 0;
+}
+
+// Client
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    if (WiFi.status() != WL_CONNECTED || !installedNetwork)
+    {
+        return 0;
+    }
+    HostConnection *connection = installedNetwork->connect(host, port);
+    if (!connection)
+    {
+        return 0;
+    }
+    _connection.reset(connection);
+    _remoteIP.fromString(host);
+    _remotePort = port;
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+    if (!_connection || !_connection->connected())
+    {
+        return 0;
+    }
+    return _connection->write(buf, size);
+}
+
+int WiFiClient::available()
+{
+    if (!_connection)
+    {
+        return 0;
+    }
+    return _connection->available() + (_peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+    if (!_connection || size == 0)
+    {
+        return -1;
+    }
+    size_t n = 0;
+    if (_peeked >= 0)
+    {
+        buf[n++] = (uint8_t)_peeked;
+        _peeked = -1;
+    }
+    if (n < size && _connection->available() > 0)
+    {
+        int got = _connection->read(buf + n, size - n);
+        if (got > 0)
+        {
+            n += got;
+        }
+    }
+    return n > 0 ? (int)n : -1;
+}
+
+int WiFiClient::peek()
+{
+    if (_peeked < 0 && _connection && _connection->available() > 0)
+    {
+        uint8_t c;
+        if (_connection->read(&c, 1) == 1)
+        {
+            _peeked = c;
+        }
+    }
+    return _peeked;
+}
+
+void WiFiClient::stop()
+{
+    if (_connection)
+    {
+        _connection->close();
+        _connection.reset();
+    }
+    _peeked = -1;
+}
+
+uint8_t WiFiClient::connected()
+{
+    if (!_connection)
+    {
+        return 0;
+    }
+    // Like lwIP, buffered data keeps a closed connection readable
+    return _connection->connected() || available() > 0;
+}
+
+// Server
+
+void WiFiServer::begin()
+{
+    close();
+    if (installedNetwork)
+    {
+        _listener.reset(installedNetwork->listen(_port));
+    }
+}
+
+void WiFiServer::begin(uint16_t port)
+{
+    _port = port;
+    begin();
+}
+
+void WiFiServer::close()
+{
+    _listener.reset();
+}
+
+WiFiClient WiFiServer::accept()
+{
+    if (!_listener || WiFi.status() != WL_CONNECTED)
+    {
+        return WiFiClient();
+    }
+    HostConnection *connection = _listener->accept();
+    if (!connection)
+    {
+        return WiFiClient();
+    }
+    return WiFiClient(std::shared_ptr<HostConnection>(connection));
+}
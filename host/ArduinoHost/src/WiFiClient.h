@@ -0,0 +1,43 @@
+#pragma once
+#include <memory>
+#include "Client.h"
+
+class HostConnection;
+
+// TCP client over the installed HostNetwork (see ArduinoHost.h)
+class WiFiClient : public Client
+{
+public:
+    WiFiClient() {}
+    explicit WiFiClient(std::shared_ptr<HostConnection> connection) : _connection(connection) {}
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    int connect(const String &host, uint16_t port) { return connect(host.c_str(), port); }
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+    int availableForWrite() override { return 1460; }
+
+    void setNoDelay(bool noDelay) { (void)noDelay; }
+    void keepAlive(uint16_t idleSec = 7200, uint16_t intvSec = 75, uint8_t count = 9)
+    {
+        (void)idleSec, (void)intvSec, (void)count;
+    }
+    IPAddress remoteIP() const { return _remoteIP; }
+    uint16_t remotePort() const { return _remotePort; }
+
+protected:
+    std::shared_ptr<HostConnection> _connection;
+    IPAddress _remoteIP;
+    uint16_t _remotePort = 0;
+    int _peeked = -1;
+};
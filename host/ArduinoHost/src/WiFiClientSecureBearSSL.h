@@ -0,0 +1,26 @@
+#pragma once
+#include "WiFiClient.h"
+
+// No TLS on the host: the secure client is a plain WiFiClient that accepts the
+// BearSSL configuration calls, so TLS builds compile and talk to a plaintext
+// broker
+namespace BearSSL
+{
+    class Session
+    {
+    };
+
+    class WiFiClientSecure : public WiFiClient
+    {
+    public:
+        void setInsecure() {}
+        bool setFingerprint(const char *fingerprint) { return (void)fingerprint, true; }
+        bool setFingerprint(const uint8_t fingerprint[20]) { return (void)fingerprint, true; }
+        void setSession(Session *session) { (void)session; }
+        bool setBufferSizes(int recv, int xmit) { return (void)recv, (void)xmit, true; }
+        bool probeMaxFragmentLength(IPAddress ip, uint16_t port, uint16_t len)
+        {
+            return (void)ip, (void)port, (void)len, true;
+        }
+    };
+}
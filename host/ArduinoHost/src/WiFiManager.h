@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+
+class WiFiManagerParameter
+{
+public:
+    WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length);
+
+    const char *getID() const { return _id; }
+    const char *getLabel() const { return _label; }
+    const char *getValue() const { return _value.c_str(); }
+    int getValueLength() const { return _length; }
+    void setValue(const char *value, int length);
+
+private:
+    const char *_id;
+    const char *_label;
+    String _value;
+    int _length;
+};
+
+// No captive portal on the host: autoConnect() joins with the saved
+// credentials and parameters keep their defaults unless host::setPortalValue()
+// supplied what the user would have typed
+class WiFiManager
+{
+public:
+    void addParameter(WiFiManagerParameter *parameter);
+    void setConfigPortalTimeout(unsigned long seconds) { _portalTimeout = seconds; }
+    void setConnectTimeout(unsigned long seconds) { (void)seconds; }
+    void setAPCallback(std::function<void(WiFiManager *)> callback) { _apCallback = callback; }
+    void setSaveConfigCallback(std::function<void()> callback) { _saveCallback = callback; }
+    bool autoConnect(const char *apName = nullptr, const char *apPassword = nullptr);
+    bool startConfigPortal(const char *apName = nullptr, const char *apPassword = nullptr);
+    String getConfigPortalSSID() { return _portalSsid; }
+    void resetSettings();
+
+private:
+    std::vector<WiFiManagerParameter *> _parameters;
+    std::function<void(WiFiManager *)> _apCallback;
+    std::function<void()> _saveCallback;
+    unsigned long _portalTimeout = 0;
+    String _portalSsid;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include "WiFiClient.h"
+
+class HostListener;
+
+// TCP server over the installed HostNetwork; without a listener from
+// HostNetwork::listen() it never accepts anything
+class WiFiServer
+{
+public:
+    explicit WiFiServer(uint16_t port) : _port(port) {}
+
+    void begin();
+    void begin(uint16_t port);
+    void close();
+    void stop() { close(); }
+    WiFiClient accept();
+    WiFiClient available() { return accept(); }
+    uint8_t status() const { return _listener ? 1 : 0; }
+    uint16_t port() const { return _port; }
+    void setNoDelay(bool noDelay) { (void)noDelay; }
+
+private:
+    uint16_t _port;
+    std::shared_ptr<HostListener> _listener;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include "IPAddress.h"
+#include "Stream.h"
+
+// Datagrams go nowhere on the host; NTPClient is mocked above this layer
+class WiFiUDP : public Stream
+{
+public:
+    uint8_t begin(uint16_t port) { return (void)port, 1; }
+    void stop() {}
+    int beginPacket(IPAddress ip, uint16_t port) { return (void)ip, (void)port, 1; }
+    int beginPacket(const char *host, uint16_t port) { return (void)host, (void)port, 1; }
+    int endPacket() { return 1; }
+    int parsePacket() { return 0; }
+    size_t write(uint8_t c) override { return (void)c, 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { return (void)buffer, size; }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    using Stream::read;
+};
@@ -0,0 +1,96 @@
+#include <map>
+#include "Wire.h"
+#include "ArduinoHost.h"
+
+TwoWire Wire;
+
+static std::map<uint8_t, HostI2cDevice *> devices;
+
+namespace host
+{
+    void attachI2c(uint8_t address, HostI2cDevice *device)
+    {
+        if (device)
+        {
+            devices[address] = device;
+        }
+        else
+        {
+            devices.erase(address);
+        }
+    }
+}
+
+static HostI2cDevice *findDevice(uint8_t address)
+{
+    auto it = devices.find(address);
+    return it == devices.end() ? nullptr : it->second;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _txAddress = address;
+    _transmitting = true;
+    _tx.clear();
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    (void)sendStop;
+    _transmitting = false;
+    HostI2cDevice *device = findDevice(_txAddress);
+    if (!device)
+    {
+        return 2; // Address NACK
+    }
+    device->receive(_tx.data(), _tx.size());
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool sendStop)
+{
+    (void)sendStop;
+    _rx.assign(quantity, 0);
+    _rxIndex = 0;
+    HostI2cDevice *device = findDevice(address);
+    size_t received = device ? device->request(_rx.data(), quantity) : 0;
+    _rx.resize(received);
+    return (uint8_t)received;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (!_transmitting)
+    {
+        return 0;
+    }
+    _tx.push_back(data);
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+    for (size_t i = 0; i < quantity; i++)
+    {
+        if (!write(data[i]))
+        {
+            return i;
+        }
+    }
+    return quantity;
+}
+
+int TwoWire::available()
+{
+    return (int)(_rx.size() - _rxIndex);
+}
+
+int TwoWire::read()
+{
+    return _rxIndex < _rx.size() ? _rx[_rxIndex++] : -1;
+}
+
+int TwoWire::peek()
+{
+    return _rxIndex < _rx.size() ? _rx[_rxIndex] : -1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "Stream.h"
+
+// I2C master; transfers go to devices attached with host::attachI2c()
+class TwoWire : public Stream
+{
+public:
+    void begin(int sda, int scl) { (void)sda, (void)scl; }
+    void begin() {}
+    void setClock(uint32_t frequency) { (void)frequency; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, size_t quantity, bool sendStop = true);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *data, size_t quantity) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    using Stream::read;
+
+private:
+    uint8_t _txAddress = 0;
+    bool _transmitting = false;
+    std::vector<uint8_t> _tx;
+    std::vector<uint8_t> _rx;
+    size_t _rxIndex = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,8 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+
+// Waits up to timeoutMs of simulated time while blocked() holds, checking it
+// every intervalMs
+void esp_delay(const uint32_t timeoutMs, const std::function<bool()> &blocked, const uint32_t intervalMs);
+void esp_delay(const uint32_t timeoutMs);
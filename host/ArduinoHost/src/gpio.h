@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// Light-sleep GPIO wake configuration; recorded but has no effect on the host
+
+typedef enum
+{
+    GPIO_PIN_INTR_DISABLE = 0,
+    GPIO_PIN_INTR_POSEDGE = 1,
+    GPIO_PIN_INTR_NEGEDGE = 2,
+    GPIO_PIN_INTR_ANYEDGE = 3,
+    GPIO_PIN_INTR_LOLEVEL = 4,
+    GPIO_PIN_INTR_HILEVEL = 5
+} GPIO_INT_TYPE;
+
+#define GPIO_ID_PIN(n) (n)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void gpio_pin_wakeup_enable(uint32_t pin, GPIO_INT_TYPE intr_state);
+void gpio_pin_wakeup_disable(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,592 @@
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+#include "Arduino.h"
+#include "ArduinoHost.h"
+#include "host_internal.h"
+#include "coredecls.h"
+#include "user_interface.h"
+#include "gpio.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+struct PinState
+{
+    uint8_t mode;
+    uint8_t input;  // Level driven from outside
+    uint8_t output; // Level written by the firmware
+    int interruptMode;
+    std::function<void(void)> handler;
+};
+
+static uint64_t clockUs = 0;
+static std::function<void()> yieldHook;
+static std::function<void(uint32_t, uint64_t)> restartHook;
+static PinState pins[NUM_DIGITAL_PINS];
+static int analogValue = 0;
+static bool interruptsEnabled = true;
+
+static uint32_t chipId = 0x00C0FFEE;
+static uint32_t heapFree = 40000;
+static uint32_t heapMaxBlock = 30000;
+static uint8_t heapFragmentation = 10;
+
+static bool serialEchoEnabled = true;
+static bool serialCaptureEnabled = false;
+static std::string serialCaptured;
+static std::deque<uint8_t> serialInput;
+
+// 512 bytes of RTC user memory; blocks 0-31 belong to eboot on the device
+static uint32_t rtcMemory[128];
+static rst_info resetInfo = {REASON_DEFAULT_RST, 0, 0, 0, 0, 0, 0};
+
+namespace host
+{
+    static void resetRam(uint32_t reason)
+    {
+        clockUs = 0;
+        for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++)
+        {
+            pins[i] = PinState();
+            pins[i].input = LOW;
+        }
+        analogValue = 0;
+        interruptsEnabled = true;
+        serialInput.clear();
+        memset(&resetInfo, 0, sizeof(resetInfo));
+        resetInfo.reason = reason;
+        resetWifi();
+    }
+
+    void reset()
+    {
+        memset(rtcMemory, 0, sizeof(rtcMemory));
+        resetEeprom();
+        resetRam(REASON_DEFAULT_RST);
+    }
+
+    void restart(uint32_t reason)
+    {
+        resetRam(reason);
+    }
+
+    // Retained file layout: magic, RTC user memory, EEPROM flash sector
+    static const uint32_t retainedMagic = 0x52544E31; // "RTN1"
+
+    bool saveRetained(const std::string &path)
+    {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        std::vector<uint8_t> &flash = eepromFlash();
+        bool ok = fwrite(&retainedMagic, sizeof(retainedMagic), 1, file) == 1 &&
+                  fwrite(rtcMemory, sizeof(rtcMemory), 1, file) == 1 &&
+                  fwrite(flash.data(), flash.size(), 1, file) == 1;
+        return fclose(file) == 0 && ok;
+    }
+
+    bool loadRetained(const std::string &path)
+    {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            return false;
+        }
+        uint32_t magic = 0;
+        uint32_t rtc[sizeof(rtcMemory) / 4];
+        std::vector<uint8_t> flash(eepromFlash().size());
+        bool ok = fread(&magic, sizeof(magic), 1, file) == 1 && magic == retainedMagic &&
+                  fread(rtc, sizeof(rtc), 1, file) == 1 &&
+                  fread(flash.data(), flash.size(), 1, file) == 1;
+        fclose(file);
+        if (ok)
+        {
+            memcpy(rtcMemory, rtc, sizeof(rtcMemory));
+            eepromFlash() = flash;
+        }
+        return ok;
+    }
+
+    uint64_t nowMicros()
+    {
+        return clockUs;
+    }
+
+    void advanceMicros(uint64_t us)
+    {
+        clockUs += us;
+    }
+
+    void advanceMillis(uint32_t ms)
+    {
+        clockUs += (uint64_t)ms * 1000;
+    }
+
+    void onYield(std::function<void()> hook)
+    {
+        yieldHook = hook;
+    }
+
+    void onRestart(std::function<void(uint32_t, uint64_t)> hook)
+    {
+        restartHook = hook;
+    }
+
+    void runYieldHook()
+    {
+        if (yieldHook)
+        {
+            yieldHook();
+        }
+    }
+
+    void requestRestart(uint32_t reason, uint64_t sleepUs)
+    {
+        Serial.flush();
+        if (restartHook)
+        {
+            restartHook(reason, sleepUs);
+        }
+        // The device never comes back from here, and neither does the host
+        fprintf(stderr, "[host] %s requested, exiting\n", reason == REASON_DEEP_SLEEP_AWAKE ? "deep sleep" : "restart");
+        exit(0);
+    }
+
+    void setPin(uint8_t pin, int level)
+    {
+        if (pin >= NUM_DIGITAL_PINS)
+        {
+            return;
+        }
+        PinState &state = pins[pin];
+        uint8_t previous = state.input;
+        state.input = level ? HIGH : LOW;
+        if (!state.handler || !interruptsEnabled)
+        {
+            return;
+        }
+
+        bool rising = previous == LOW && state.input == HIGH;
+        bool falling = previous == HIGH && state.input == LOW;
+        bool fire = (state.interruptMode == RISING && rising) ||
+                    (state.interruptMode == FALLING && falling) ||
+                    (state.interruptMode == CHANGE && (rising || falling)) ||
+                    (state.interruptMode == ONHIGH && state.input == HIGH) ||
+                    (state.interruptMode == ONLOW && state.input == LOW);
+        if (fire)
+        {
+            state.handler();
+        }
+    }
+
+    int pinOutput(uint8_t pin)
+    {
+        return pin < NUM_DIGITAL_PINS ? pins[pin].output : LOW;
+    }
+
+    int pinMode(uint8_t pin)
+    {
+        return pin < NUM_DIGITAL_PINS ? pins[pin].mode : INPUT;
+    }
+
+    void setAnalog(int value)
+    {
+        analogValue = value;
+    }
+
+    void setChipId(uint32_t id)
+    {
+        chipId = id;
+    }
+
+    void setHeap(uint32_t freeBytes, uint32_t maxBlock, uint8_t fragmentation)
+    {
+        heapFree = freeBytes;
+        heapMaxBlock = maxBlock;
+        heapFragmentation = fragmentation;
+    }
+
+    void serialEcho(bool enabled)
+    {
+        serialEchoEnabled = enabled;
+    }
+
+    void serialCapture(bool enabled)
+    {
+        serialCaptureEnabled = enabled;
+    }
+
+    std::string serialTake()
+    {
+        std::string captured;
+        captured.swap(serialCaptured);
+        return captured;
+    }
+
+    void serialInject(const std::string &data)
+    {
+        serialInput.insert(serialInput.end(), data.begin(), data.end());
+    }
+}
+
+// Time
+
+unsigned long millis()
+{
+    return (unsigned long)(clockUs / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)clockUs;
+}
+
+uint64_t micros64()
+{
+    return clockUs;
+}
+
+void delay(unsigned long ms)
+{
+    clockUs += (uint64_t)ms * 1000;
+    host::runYieldHook();
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    clockUs += us;
+}
+
+void yield()
+{
+    host::runYieldHook();
+}
+
+void optimistic_yield(uint32_t intervalUs)
+{
+    (void)intervalUs;
+    host::runYieldHook();
+}
+
+void esp_delay(const uint32_t timeoutMs, const std::function<bool()> &blocked, const uint32_t intervalMs)
+{
+    uint64_t start = clockUs;
+    uint64_t end = start + (uint64_t)timeoutMs * 1000;
+    uint64_t step = (uint64_t)(intervalMs ? intervalMs : 1) * 1000;
+    while (clockUs < end && blocked())
+    {
+        clockUs = std::min(clockUs + step, end);
+        host::runYieldHook();
+    }
+}
+
+void esp_delay(const uint32_t timeoutMs)
+{
+    delay(timeoutMs);
+}
+
+uint32_t system_get_time(void)
+{
+    return (uint32_t)clockUs;
+}
+
+// GPIO
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].mode = mode;
+        if (mode == INPUT_PULLUP)
+        {
+            pins[pin].input = HIGH;
+        }
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].output = value ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= NUM_DIGITAL_PINS)
+    {
+        return LOW;
+    }
+    const PinState &state = pins[pin];
+    return (state.mode == OUTPUT || state.mode == OUTPUT_OPEN_DRAIN) ? state.output : state.input;
+}
+
+int analogRead(uint8_t pin)
+{
+    (void)pin;
+    return analogValue;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    digitalWrite(pin, value > 0 ? HIGH : LOW);
+}
+
+void attachInterrupt(uint8_t pin, voidFuncPtr handler, int mode)
+{
+    attachInterrupt(pin, std::function<void(void)>(handler), mode);
+}
+
+void attachInterrupt(uint8_t pin, std::function<void(void)> handler, int mode)
+{
+    // GPIO16 has no interrupt on the ESP8266
+    if (pin < 16)
+    {
+        pins[pin].handler = handler;
+        pins[pin].interruptMode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].handler = nullptr;
+        pins[pin].interruptMode = 0;
+    }
+}
+
+void interrupts()
+{
+    interruptsEnabled = true;
+}
+
+void noInterrupts()
+{
+    interruptsEnabled = false;
+}
+
+// Serial
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (serialEchoEnabled)
+    {
+        fwrite(buffer, 1, size, stdout);
+        fflush(stdout);
+    }
+    if (serialCaptureEnabled)
+    {
+        serialCaptured.append((const char *)buffer, size);
+    }
+    return size;
+}
+
+int HardwareSerial::available()
+{
+    return (int)serialInput.size();
+}
+
+int HardwareSerial::read()
+{
+    if (serialInput.empty())
+    {
+        return -1;
+    }
+    uint8_t c = serialInput.front();
+    serialInput.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek()
+{
+    return serialInput.empty() ? -1 : serialInput.front();
+}
+
+// ESP
+
+void EspClass::restart()
+{
+    host::requestRestart(REASON_SOFT_RESTART, 0);
+}
+
+void EspClass::deepSleep(uint64_t timeUs, RFMode mode)
+{
+    (void)mode;
+    host::requestRestart(REASON_DEEP_SLEEP_AWAKE, timeUs);
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(rtcMemory) || size == 0)
+    {
+        return false;
+    }
+    memcpy(data, (uint8_t *)rtcMemory + offset * 4, size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(rtcMemory) || size == 0)
+    {
+        return false;
+    }
+    memcpy((uint8_t *)rtcMemory + offset * 4, data, size);
+    return true;
+}
+
+uint32_t EspClass::getChipId()
+{
+    return chipId;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return heapFree;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize()
+{
+    return heapMaxBlock;
+}
+
+uint8_t EspClass::getHeapFragmentation()
+{
+    return heapFragmentation;
+}
+
+void EspClass::getHeapStats(uint32_t *freeHeap, uint32_t *maxBlock, uint8_t *fragmentation)
+{
+    if (freeHeap)
+    {
+        *freeHeap = heapFree;
+    }
+    if (maxBlock)
+    {
+        *maxBlock = heapMaxBlock;
+    }
+    if (fragmentation)
+    {
+        *fragmentation = heapFragmentation;
+    }
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    return (uint32_t)(ns * 80 / 1000);
+}
+
+String EspClass::getResetReason()
+{
+    static const char *const names[] = {"Power On", "Hardware Watchdog", "Exception", "Software Watchdog",
+                                        "Software/System restart", "Deep-Sleep Wake", "External System"};
+    return String(resetInfo.reason < 7 ? names[resetInfo.reason] : "Unknown");
+}
+
+struct rst_info *EspClass::getResetInfoPtr()
+{
+    return &resetInfo;
+}
+
+struct rst_info *system_get_rst_info(void)
+{
+    return &resetInfo;
+}
+
+// libc gaps
+
+size_t arduino_host_strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t length = strlen(src);
+    if (size > 0)
+    {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+size_t arduino_host_strlcat(char *dst, const char *src, size_t size)
+{
+    size_t used = strnlen(dst, size);
+    if (used == size)
+    {
+        return size + strlen(src);
+    }
+    return used + arduino_host_strlcpy(dst + used, src, size - used);
+}
+
+long random(long howbig)
+{
+    return howbig > 0 ? (long)(::random() % howbig) : 0;
+}
+
+long random(long howsmall, long howbig)
+{
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0)
+    {
+        srandom(seed);
+    }
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static char *formatInto(char *result, const String &text)
+{
+    memcpy(result, text.c_str(), text.length() + 1);
+    return result;
+}
+
+char *itoa(int value, char *result, int base)
+{
+    return formatInto(result, String(value, (unsigned char)base));
+}
+
+char *ltoa(long value, char *result, int base)
+{
+    return formatInto(result, String(value, (unsigned char)base));
+}
+
+char *utoa(unsigned int value, char *result, int base)
+{
+    return formatInto(result, String(value, (unsigned char)base));
+}
+
+char *ultoa(unsigned long value, char *result, int base)
+{
+    return formatInto(result, String(value, (unsigned char)base));
+}
+
+char *dtostrf(double value, signed char width, unsigned char prec, char *buffer)
+{
+    sprintf(buffer, "%*.*f", width, prec, value);
+    return buffer;
+}
+
+void gpio_pin_wakeup_enable(uint32_t pin, GPIO_INT_TYPE intr_state)
+{
+    (void)pin;
+    (void)intr_state;
+}
+
+void gpio_pin_wakeup_disable(void)
+{
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+// Shared between the mock modules; not part of the host control API
+
+namespace host
+{
+    void runYieldHook();
+    [[noreturn]] void requestRestart(uint32_t reason, uint64_t sleepUs);
+
+    // Module state: flash (EEPROM) is cleared by host::reset() only, the WiFi
+    // connection by host::restart() as well
+    void resetEeprom();
+    void resetWifi();
+
+    // The emulated EEPROM flash sector, for host::saveRetained()/loadRetained()
+    std::vector<uint8_t> &eepromFlash();
+}
@@ -0,0 +1,80 @@
+#include <map>
+#include <string>
+#include "ArduinoOTA.h"
+#include "ESP8266mDNS.h"
+#include "NTPClient.h"
+#include "WiFiManager.h"
+#include "ArduinoHost.h"
+
+MDNSResponder MDNS;
+ArduinoOTAClass ArduinoOTA;
+
+unsigned long NTPClient::hostEpochBase = 1704067200UL; // 2024-01-01T00:00:00Z
+
+static std::map<std::string, std::string> portalValues;
+
+namespace host
+{
+    void setPortalValue(const std::string &id, const std::string &value)
+    {
+        portalValues[id] = value;
+    }
+}
+
+WiFiManagerParameter::WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length)
+    : _id(id), _label(label), _length(length)
+{
+    setValue(defaultValue, length);
+}
+
+void WiFiManagerParameter::setValue(const char *value, int length)
+{
+    _value = String(value ? value : "");
+    if ((int)_value.length() > length)
+    {
+        _value = _value.substring(0, length);
+    }
+}
+
+void WiFiManager::addParameter(WiFiManagerParameter *parameter)
+{
+    auto entry = portalValues.find(parameter->getID());
+    if (entry != portalValues.end())
+    {
+        parameter->setValue(entry->second.c_str(), parameter->getValueLength());
+    }
+    _parameters.push_back(parameter);
+}
+
+bool WiFiManager::autoConnect(const char *apName, const char *apPassword)
+{
+    (void)apPassword;
+    if (WiFi.begin() == WL_CONNECTED)
+    {
+        return true;
+    }
+    return startConfigPortal(apName, apPassword);
+}
+
+bool WiFiManager::startConfigPortal(const char *apName, const char *apPassword)
+{
+    (void)apPassword;
+    _portalSsid = apName ? apName : "ESP-host";
+    if (_apCallback)
+    {
+        _apCallback(this);
+    }
+    // Nobody is there to fill in the form: behave like a portal timeout
+    // unless the network is reachable with the saved credentials
+    bool connected = WiFi.begin() == WL_CONNECTED;
+    if (connected && _saveCallback)
+    {
+        _saveCallback();
+    }
+    return connected;
+}
+
+void WiFiManager::resetSettings()
+{
+    WiFi.disconnect();
+}
@@ -0,0 +1,196 @@
+#include <math.h>
+#include <string.h>
+#include "DHT.h"
+#include "Adafruit_TSL2561_U.h"
+#include "MyLD2410.h"
+
+// DHT
+
+void DHT::hostSet(float temperature, float humidity)
+{
+    _temperature = temperature;
+    _humidity = humidity;
+    _failing = false;
+}
+
+bool DHT::read(bool force)
+{
+    unsigned long now = millis();
+    if (!force && _everRead && now - _lastReadTime < 2000)
+    {
+        return _lastResult;
+    }
+    _everRead = true;
+    _lastReadTime = now;
+    _reads++;
+    _lastResult = _begun && !_failing;
+    return _lastResult;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force)
+{
+    if (!read(force))
+    {
+        return NAN;
+    }
+    // DHT11 resolution is whole degrees
+    float t = _type == DHT11 ? roundf(_temperature) : _temperature;
+    return fahrenheit ? convertCtoF(t) : t;
+}
+
+float DHT::readHumidity(bool force)
+{
+    if (!read(force))
+    {
+        return NAN;
+    }
+    return _type == DHT11 ? roundf(_humidity) : _humidity;
+}
+
+// TSL2561
+
+bool Adafruit_TSL2561_Unified::getEvent(sensors_event_t *event)
+{
+    memset(event, 0, sizeof(*event));
+    event->version = sizeof(sensors_event_t);
+    event->sensor_id = _sensorID;
+    event->type = SENSOR_TYPE_LIGHT;
+    event->timestamp = (int32_t)millis();
+    if (!_initialised || !_present)
+    {
+        return false;
+    }
+    // Without auto-range the 1x gain saturates around 40k lux at 13 ms
+    if (!_autoRange && _lux > 40000)
+    {
+        return false;
+    }
+    event->light = _lux;
+    return true;
+}
+
+void Adafruit_TSL2561_Unified::getSensor(sensor_t *sensor)
+{
+    memset(sensor, 0, sizeof(*sensor));
+    strncpy(sensor->name, "TSL2561", sizeof(sensor->name) - 1);
+    sensor->version = 1;
+    sensor->sensor_id = _sensorID;
+    sensor->type = SENSOR_TYPE_LIGHT;
+    sensor->min_delay = 0;
+    sensor->max_value = 17000.0f;
+    sensor->min_value = 1.0f;
+    sensor->resolution = 1.0f;
+}
+
+// LD2410
+
+static const uint8_t dataHeader[4] = {0xF4, 0xF3, 0xF2, 0xF1};
+static const uint8_t dataFooter[4] = {0xF8, 0xF7, 0xF6, 0xF5};
+static const uint8_t ackHeader[4] = {0xFD, 0xFC, 0xFB, 0xFA};
+static const uint8_t ackFooter[4] = {0x04, 0x03, 0x02, 0x01};
+
+MyLD2410::Response MyLD2410::check()
+{
+    while (_serial.available() > 0)
+    {
+        int c = _serial.read();
+        if (c < 0)
+        {
+            break;
+        }
+
+        if (_frameLength == 0)
+        {
+            if (c != dataHeader[0] && c != ackHeader[0])
+            {
+                continue;
+            }
+            _ackFrame = c == ackHeader[0];
+        }
+        else if (_frameLength < 4)
+        {
+            const uint8_t *header = _ackFrame ? ackHeader : dataHeader;
+            if (c != header[_frameLength])
+            {
+                // Resynchronise; this byte may start the next frame
+                _frameLength = 0;
+                if (c == dataHeader[0] || c == ackHeader[0])
+                {
+                    _ackFrame = c == ackHeader[0];
+                    _frame[_frameLength++] = (uint8_t)c;
+                }
+                continue;
+            }
+        }
+        _frame[_frameLength++] = (uint8_t)c;
+
+        if (_frameLength < 6)
+        {
+            continue;
+        }
+        size_t payload = _frame[4] | (_frame[5] << 8);
+        if (payload + 10 > sizeof(_frame))
+        {
+            _frameLength = 0;
+            continue;
+        }
+        if (_frameLength < payload + 10)
+        {
+            continue;
+        }
+
+        bool ack = _ackFrame;
+        bool valid = memcmp(_frame + 6 + payload, ack ? ackFooter : dataFooter, 4) == 0 && (ack || processFrame());
+        _frameLength = 0;
+        if (valid)
+        {
+            return ack ? ACK : DATA;
+        }
+    }
+    return FAIL;
+}
+
+bool MyLD2410::processFrame()
+{
+    const uint8_t *data = _frame + 6;
+    size_t length = _frame[4] | (_frame[5] << 8);
+    if (length < 13 || (data[0] != 0x01 && data[0] != 0x02) || data[1] != 0xAA)
+    {
+        return false;
+    }
+    _enhanced = data[0] == 0x01;
+    _status = data[2];
+    _movingDistance = data[3] | (data[4] << 8);
+    _movingSignal = data[5];
+    _stationaryDistance = data[6] | (data[7] << 8);
+    _stationarySignal = data[8];
+    _detectedDistance = data[9] | (data[10] << 8);
+    return true;
+}
+
+const char *MyLD2410::statusString() const
+{
+    static const char *const names[] = {"No target", "Moving only", "Stationary only", "Both moving and stationary"};
+    return _status < 4 ? names[_status] : "Unknown";
+}
+
+size_t MyLD2410::buildDataFrame(uint8_t *frame, size_t capacity, uint8_t status, uint16_t movingDistance,
+                                uint8_t movingSignal, uint16_t stationaryDistance, uint8_t stationarySignal,
+                                uint16_t detectedDistance)
+{
+    const uint8_t body[13] = {0x02, 0xAA, status,
+                              (uint8_t)movingDistance, (uint8_t)(movingDistance >> 8), movingSignal,
+                              (uint8_t)stationaryDistance, (uint8_t)(stationaryDistance >> 8), stationarySignal,
+                              (uint8_t)detectedDistance, (uint8_t)(detectedDistance >> 8), 0x55, 0x00};
+    const size_t total = 4 + 2 + sizeof(body) + 4;
+    if (capacity < total)
+    {
+        return 0;
+    }
+    memcpy(frame, dataHeader, 4);
+    frame[4] = sizeof(body);
+    frame[5] = 0;
+    memcpy(frame + 6, body, sizeof(body));
+    memcpy(frame + 6 + sizeof(body), dataFooter, 4);
+    return total;
+}
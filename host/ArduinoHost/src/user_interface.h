@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+
+// Subset of the NONOS SDK's user_interface.h used by the firmware
+
+enum rst_reason
+{
+    REASON_DEFAULT_RST = 0,
+    REASON_WDT_RST = 1,
+    REASON_EXCEPTION_RST = 2,
+    REASON_SOFT_WDT_RST = 3,
+    REASON_SOFT_RESTART = 4,
+    REASON_DEEP_SLEEP_AWAKE = 5,
+    REASON_EXT_SYS_RST = 6
+};
+
+struct rst_info
+{
+    uint32_t reason;
+    uint32_t exccause;
+    uint32_t epc1;
+    uint32_t epc2;
+    uint32_t epc3;
+    uint32_t excvaddr;
+    uint32_t depc;
+};
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct rst_info *system_get_rst_info(void);
+uint32_t system_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""
+Fleet simulation: many simulated nodes against one MQTT broker
+
+Starts N copies of the device simulator (pio run -e sim), each with its own
+location, chip ID (and so MQTT client ID), state directory, HTTP port and a
+perturbed copy of the sensor trace, all pointed at one broker. An observer
+subscribed to the broker measures:
+
+- aggregate and per-node publish rate
+- publish-to-delivery latency of the combined "<location>/all" messages,
+  from the payload's uptime and the node's boot.json
+- reconnect storms: after --broker-restart-at, how fast each node is back
+  "online", and how many connects per second the broker had to absorb
+
+The firmware keeps its state in globals, so each node is its own process
+rather than an instance on a shared event loop.
+
+Requirements:
+    pip install paho-mqtt
+
+Usage:
+    python host/DeviceSim/fleet.py --nodes 200 --broker 127.0.0.1:1883 \\
+        --trace host/DeviceSim/traces/office_day.trace --duration 300 \\
+        --broker-restart-at 120 --broker-restart-cmd "sudo systemctl restart mosquitto" \\
+        --output fleet.json
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import threading
+import time
+from datetime import datetime, timezone
+
+import paho.mqtt.client as mqtt
+
+RESULT_FORMAT = 1
+NUMERIC_DEVICES = {"dht", "tsl", "analog"}
+
+
+def percentile(sorted_values, p):
+    """Nearest-rank percentile of an already sorted list"""
+    if not sorted_values:
+        return None
+    rank = max(1, int(round(p / 100.0 * len(sorted_values) + 0.5)))
+    return round(sorted_values[min(rank, len(sorted_values)) - 1], 2)
+
+
+def distribution(values):
+    values = sorted(values)
+    return {"count": len(values), "p50": percentile(values, 50), "p95": percentile(values, 95),
+            "p99": percentile(values, 99), "max": round(values[-1], 2) if values else None}
+
+
+def vary_trace(source, destination, rng, shift_s, noise):
+    """Copies a trace with later events shifted by up to shift_s and readings scaled by +-noise"""
+    offset = rng.uniform(0, shift_s)
+    with open(source) as f, open(destination, "w") as out:
+        for line in f:
+            words = line.split("#")[0].split()
+            if len(words) < 2:
+                continue
+            at = float(words[0])
+            words[0] = f"{at + offset if at > 0 else 0:.3f}"  # Initial state stays at 0
+            if words[1] in NUMERIC_DEVICES:
+                for i in range(2, len(words)):
+                    if re.fullmatch(r"-?\d+(\.\d+)?", words[i]):
+                        words[i] = f"{float(words[i]) * (1 + rng.uniform(-noise, noise)):.1f}"
+            out.write(" ".join(words) + "\n")
+
+
+class Node:
+    def __init__(self, index, args, work_dir, rng):
+        self.index = index
+        self.location = f"{args.site}-n{index:03d}"
+        self.chip_id = args.chip_id_base + index
+        self.state_dir = os.path.join(work_dir, self.location)
+        self.http_port = args.http_base_port + index
+        self.process = None
+        os.makedirs(self.state_dir, exist_ok=True)
+        self.trace = None
+        if args.trace:
+            self.trace = os.path.join(self.state_dir, "sensors.trace")
+            vary_trace(args.trace, self.trace, rng, args.trace_shift, args.trace_noise)
+
+    def start(self, args, broker_host, broker_port):
+        command = [args.program, "--state-dir", self.state_dir, "--chip-id", f"{self.chip_id:x}",
+                   "--http-port", str(self.http_port), "--speed", str(args.speed),
+                   "--param", f"mqtt_broker={broker_host}", "--param", f"mqtt_port={broker_port}",
+                   "--param", f"location={self.location}", "--param", "mqtt_enabled=1"]
+        if self.trace:
+            command += ["--trace", self.trace]
+        if not args.keep_state:
+            command.append("--fresh")
+        log = open(os.path.join(self.state_dir, "console.log"), "w")
+        self.process = subprocess.Popen(command, stdout=log, stderr=subprocess.STDOUT)
+
+    def send_time(self, uptime_ms):
+        """Wall time a payload with this uptime was published, from the current boot's clock"""
+        try:
+            with open(os.path.join(self.state_dir, "boot.json")) as f:
+                clock = json.load(f)
+        except (OSError, ValueError):
+            return None
+        if clock.get("speed", 0) <= 0:
+            return None
+        return clock["wall_s"] + uptime_ms / 1000.0 / clock["speed"]
+
+
+class Observer:
+    """Subscribes to everything and timestamps each message on arrival"""
+
+    def __init__(self, host, port, nodes):
+        self.nodes = {node.location: node for node in nodes}
+        self.lock = threading.Lock()
+        self.messages = []  # (wall_s, location, subtopic, retained)
+        self.latencies = []  # (wall_s, latency_ms)
+        self.online = []  # (wall_s, location)
+        self.clients_connected = []  # (wall_s, count) from $SYS
+        self.client = mqtt.Client(client_id=f"fleet-observer-{os.getpid()}", clean_session=True)
+        self.client.on_connect = self.on_connect
+        self.client.on_message = self.on_message
+        self.client.reconnect_delay_set(min_delay=1, max_delay=2)
+        self.client.connect_async(host, port, keepalive=30)
+        self.client.loop_start()
+
+    def on_connect(self, client, userdata, flags, rc):
+        client.subscribe([("#", 0), ("$SYS/broker/clients/connected", 0)])
+
+    def on_message(self, client, userdata, message):
+        now = time.time()
+        if message.topic == "$SYS/broker/clients/connected":
+            with self.lock:
+                self.clients_connected.append((now, int(message.payload or 0)))
+            return
+        location, _, subtopic = message.topic.partition("/")
+        node = self.nodes.get(location)
+        if node is None:
+            return
+        with self.lock:
+            self.messages.append((now, location, subtopic, bool(message.retain)))
+            if subtopic == "status" and message.payload == b"online" and not message.retain:
+                self.online.append((now, location))
+        if subtopic == "all" and not message.retain:
+            try:
+                uptime = json.loads(message.payload)["uptime"]
+            except (ValueError, KeyError, TypeError):
+                return
+            sent = node.send_time(uptime)
+            if sent is not None:
+                with self.lock:
+                    self.latencies.append((now, (now - sent) * 1000.0))
+
+    def stop(self):
+        self.client.loop_stop()
+        self.client.disconnect()
+
+
+def storm_report(observer, restart_at, nodes, window_end):
+    """Per-node time back online after a broker restart, and the connect rate the broker saw"""
+    first_online = {}
+    for t, location in observer.online:
+        if restart_at <= t < window_end and location not in first_online:
+            first_online[location] = t - restart_at
+    per_second = {}
+    for t, _ in observer.online:
+        if restart_at <= t < window_end:
+            second = int(t - restart_at)
+            per_second[second] = per_second.get(second, 0) + 1
+    return {
+        "recovered": len(first_online),
+        "not_recovered": len(nodes) - len(first_online),
+        "recovery_s": distribution(list(first_online.values())),
+        "peak_connects_per_s": max(per_second.values(), default=0),
+        # Columns: [s_after_restart, nodes_back_online]
+        "connects_timeline": sorted([s, n] for s, n in per_second.items()),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run a fleet of simulated nodes against one MQTT broker")
+    parser.add_argument("--nodes", type=int, default=50)
+    parser.add_argument("--broker", default="127.0.0.1:1883", help="host[:port] the nodes and observer use")
+    parser.add_argument("--program", default=".pio/build/sim/program", help="simulator binary")
+    parser.add_argument("--trace", help="base sensor trace; each node gets a perturbed copy")
+    parser.add_argument("--trace-shift", type=float, default=60, help="max per-node trace time shift, s")
+    parser.add_argument("--trace-noise", type=float, default=0.05, help="relative noise on readings")
+    parser.add_argument("--duration", type=float, default=120, help="wall seconds to observe after startup")
+    parser.add_argument("--stagger", type=float, default=10, help="spread node boots over this many seconds")
+    parser.add_argument("--speed", type=float, default=1, help="simulated time per wall second (latency needs > 0)")
+    parser.add_argument("--site", default="site1", help="location prefix; nodes are <site>-nNNN")
+    parser.add_argument("--chip-id-base", type=lambda v: int(v, 0), default=0x5100000)
+    parser.add_argument("--http-base-port", type=int, default=18000)
+    parser.add_argument("--work-dir", default=".fleet")
+    parser.add_argument("--keep-state", action="store_true", help="boot from the previous run's flash")
+    parser.add_argument("--broker-restart-at", type=float, action="append", default=[],
+                        help="seconds after startup to restart the broker (repeatable)")
+    parser.add_argument("--broker-restart-cmd", help="shell command that restarts the broker")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--output", help="write the JSON results here")
+    args = parser.parse_args()
+
+    if args.broker_restart_at and not args.broker_restart_cmd:
+        parser.error("--broker-restart-at needs --broker-restart-cmd")
+    if not os.path.exists(args.program):
+        parser.error(f"{args.program} not found; build it with: pio run -e sim")
+    broker_host, _, broker_port = args.broker.partition(":")
+    broker_port = int(broker_port or 1883)
+
+    if not args.keep_state:
+        shutil.rmtree(args.work_dir, ignore_errors=True)
+    rng = random.Random(args.seed)
+    nodes = [Node(i, args, args.work_dir, rng) for i in range(args.nodes)]
+    observer = Observer(broker_host, broker_port, nodes)
+
+    started = datetime.now(timezone.utc).isoformat(timespec="seconds")
+    start = time.time()
+    for i, node in enumerate(nodes):
+        node.start(args, broker_host, broker_port)
+        time.sleep(args.stagger / max(1, args.nodes) if i + 1 < len(nodes) else 0)
+    boot_done = time.time()
+    print(f"{args.nodes} nodes started in {boot_done - start:.1f} s", file=sys.stderr)
+
+    restarts = []
+    pending = sorted(args.broker_restart_at)
+    try:
+        while time.time() - boot_done < args.duration:
+            if pending and time.time() - boot_done >= pending[0]:
+                pending.pop(0)
+                restarts.append(time.time())
+                print(f"restarting broker: {args.broker_restart_cmd}", file=sys.stderr)
+                subprocess.run(shlex.split(args.broker_restart_cmd), check=False)
+            time.sleep(0.2)
+    except KeyboardInterrupt:
+        pass
+    end = time.time()
+    observer.stop()
+    crashed = [node.location for node in nodes if node.process.poll() is not None]
+    for node in nodes:
+        if node.process.poll() is None:
+            node.process.terminate()
+    for node in nodes:
+        node.process.wait()
+
+    window = end - boot_done
+    steady = [m for m in observer.messages if m[0] >= boot_done and not m[3]]
+    per_node = {}
+    per_topic = {}
+    for _, location, subtopic, _ in steady:
+        per_node[location] = per_node.get(location, 0) + 1
+        per_topic[subtopic] = per_topic.get(subtopic, 0) + 1
+    node_rates = [per_node.get(node.location, 0) / window * 60 for node in nodes]
+    result = {
+        "format": RESULT_FORMAT,
+        "started": started,
+        "config": {"nodes": args.nodes, "broker": args.broker, "speed": args.speed, "stagger_s": args.stagger,
+                   "duration_s": args.duration, "trace": args.trace, "broker_restart_at": args.broker_restart_at},
+        "observed_s": round(window, 2),
+        "publish": {
+            "messages": len(steady),
+            "rate_per_s": round(len(steady) / window, 2) if window > 0 else 0,
+            "per_node_per_min": distribution(node_rates),
+            "silent_nodes": [node.location for node in nodes if node.location not in per_node],
+            "by_topic": per_topic,
+        },
+        "latency_ms": distribution([latency for t, latency in observer.latencies if t >= boot_done]),
+        "broker_restarts": [dict(at_s=round(t - boot_done, 2),
+                                 **storm_report(observer, t, nodes, restarts[i + 1] if i + 1 < len(restarts) else end))
+                            for i, t in enumerate(restarts)],
+        # Columns: [t_s, clients] from $SYS/broker/clients/connected
+        "broker_clients": [[round(t - start, 1), n] for t, n in observer.clients_connected],
+        "exited_nodes": crashed,
+    }
+
+    publish = result["publish"]
+    print(f"{len(steady)} messages in {window:.0f} s: {publish['rate_per_s']} msg/s, "
+          f"per node p50 {publish['per_node_per_min']['p50']} msg/min, {len(publish['silent_nodes'])} silent")
+    latency = result["latency_ms"]
+    if latency["count"]:
+        print(f"latency p50 {latency['p50']} ms, p95 {latency['p95']} ms, p99 {latency['p99']} ms")
+    for storm in result["broker_restarts"]:
+        print(f"broker restart at {storm['at_s']} s: {storm['recovered']}/{args.nodes} back online, "
+              f"recovery p50 {storm['recovery_s']['p50']} s, p95 {storm['recovery_s']['p95']} s, "
+              f"peak {storm['peak_connects_per_s']} connects/s")
+    if crashed:
+        print(f"{len(crashed)} nodes exited early; see {args.work_dir}/<location>/console.log")
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=1)
+        print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
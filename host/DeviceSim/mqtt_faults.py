@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""
+QoS 1 fault injection: one simulated node against a broker that misbehaves
+
+Runs a minimal MQTT 3.1.1 broker in this process and the device simulator
+(pio run -e sim) against it. The broker drops a share of the PUBACKs it owes
+and cuts the connection while publishes are in flight, then checks the
+node's at-least-once delivery:
+
+- every QoS 1 publish is eventually acknowledged; one never acknowledged by
+  the end of the run is lost
+- a resend after a reconnect carries DUP, the original packet ID and the same
+  topic and payload
+- no packet ID is reused for a new publish while the old one is in flight
+
+Before stopping, the broker cuts the connection once more and waits for the
+node to resend its window. Duplicate deliveries, which QoS 1 allows, are
+counted but not an error. The exit status is 1 on any violation.
+
+No dependencies beyond the simulator.
+
+Usage:
+    python host/DeviceSim/mqtt_faults.py --duration 120 --speed 5 \\
+        --drop-puback 0.3 --cut-every 20 --output faults.json
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+RESULT_FORMAT = 1
+
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK = 8, 9, 10, 11
+PINGREQ, PINGRESP, DISCONNECT = 12, 13, 14
+
+
+def read_exact(sock, n):
+    data = b""
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise ConnectionError("closed")
+        data += chunk
+    return data
+
+
+def read_packet(sock):
+    """(header byte, body) of the next packet"""
+    header = read_exact(sock, 1)[0]
+    remaining, shift = 0, 0
+    while True:
+        digit = read_exact(sock, 1)[0]
+        remaining |= (digit & 0x7F) << shift
+        shift += 7
+        if not digit & 0x80:
+            break
+    return header, read_exact(sock, remaining)
+
+
+def packet(header, body=b""):
+    length, encoded = len(body), bytearray()
+    while True:
+        digit = length & 0x7F
+        length >>= 7
+        encoded.append(digit | 0x80 if length else digit)
+        if not length:
+            break
+    return bytes([header]) + bytes(encoded) + body
+
+
+def utf8(body, offset):
+    """String at offset and the offset after it"""
+    length = (body[offset] << 8) | body[offset + 1]
+    return body[offset + 2:offset + 2 + length].decode("utf-8", "replace"), offset + 2 + length
+
+
+class FaultyBroker:
+    """Accepts one client at a time; drops PUBACKs and cuts connections on request"""
+
+    def __init__(self, port, drop_puback, rng):
+        self.drop_puback = drop_puback
+        self.rng = rng
+        self.lock = threading.Lock()
+        self.sessions = set()  # Client IDs with a persistent session
+        self.connection = None
+        self.inflight = {}  # Packet ID -> (topic, payload, first_seen) of unacknowledged publishes
+        self.stats = {"connects": 0, "sessions_resumed": 0, "qos1": 0, "qos0": 0, "pubacks": 0,
+                      "pubacks_dropped": 0, "resends": 0, "duplicates": 0, "cuts": 0}
+        self.errors = []
+        self.server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.server.bind(("127.0.0.1", port))
+        self.server.listen(4)
+        self.port = self.server.getsockname()[1]
+        threading.Thread(target=self.accept_loop, daemon=True).start()
+
+    def accept_loop(self):
+        while True:
+            try:
+                sock, _ = self.server.accept()
+            except OSError:
+                return
+            threading.Thread(target=self.serve, args=(sock,), daemon=True).start()
+
+    def serve(self, sock):
+        try:
+            while True:
+                header, body = read_packet(sock)
+                kind = header >> 4
+                if kind == CONNECT:
+                    self.on_connect(sock, body)
+                elif kind == PUBLISH:
+                    self.on_publish(sock, header, body)
+                elif kind == SUBSCRIBE:
+                    granted = bytes(min(body[i], 1) for i in self.subscribe_qos_offsets(body))
+                    sock.sendall(packet(SUBACK << 4, body[:2] + granted))
+                elif kind == UNSUBSCRIBE:
+                    sock.sendall(packet(UNSUBACK << 4, body[:2]))
+                elif kind == PINGREQ:
+                    sock.sendall(packet(PINGRESP << 4))
+                elif kind == DISCONNECT:
+                    break
+        except (ConnectionError, OSError, IndexError):
+            pass
+        finally:
+            with self.lock:
+                if self.connection is sock:
+                    self.connection = None
+            sock.close()
+
+    @staticmethod
+    def subscribe_qos_offsets(body):
+        offset = 2
+        while offset < len(body):
+            _, offset = utf8(body, offset)
+            yield offset
+            offset += 1
+
+    def on_connect(self, sock, body):
+        _, offset = utf8(body, 0)  # Protocol name
+        flags = body[offset + 1]
+        client_id, _ = utf8(body, offset + 4)
+        clean = bool(flags & 0x02)
+        with self.lock:
+            present = not clean and client_id in self.sessions
+            if clean:
+                self.sessions.discard(client_id)
+            else:
+                self.sessions.add(client_id)
+            self.stats["connects"] += 1
+            self.stats["sessions_resumed"] += present
+            if self.connection is not None:
+                self.connection.close()  # Takeover by the same client ID
+            self.connection = sock
+        sock.sendall(packet(CONNACK << 4, bytes([1 if present else 0, 0])))
+
+    def on_publish(self, sock, header, body):
+        qos = (header >> 1) & 0x03
+        dup = bool(header & 0x08)
+        topic, offset = utf8(body, 0)
+        if qos == 0:
+            with self.lock:
+                self.stats["qos0"] += 1
+            return
+        packet_id = (body[offset] << 8) | body[offset + 1]
+        payload = body[offset + 2:]
+        with self.lock:
+            known = self.inflight.get(packet_id)
+            if not dup:
+                if known is not None:
+                    self.errors.append(f"packet ID {packet_id} reused for a new publish to {topic} while in flight")
+                self.stats["qos1"] += 1
+            else:
+                # A resend of one we hold, or of one whose PUBACK the cut swallowed
+                if known is not None and (topic, payload) != known[:2]:
+                    self.errors.append(f"packet ID {packet_id} resent with a different topic or payload")
+                self.stats["resends"] += 1
+                self.stats["duplicates"] += 1
+            if known is None or not dup:
+                self.inflight[packet_id] = (topic, payload, time.time())
+            if self.rng.random() < self.drop_puback:
+                self.stats["pubacks_dropped"] += 1
+                return
+            self.stats["pubacks"] += 1
+            del self.inflight[packet_id]
+        sock.sendall(packet(PUBACK << 4, bytes([packet_id >> 8, packet_id & 0xFF])))
+
+    def cut(self, only_mid_window):
+        """Closes the client connection; with only_mid_window, only while a publish is unacknowledged"""
+        with self.lock:
+            if self.connection is None or (only_mid_window and not self.inflight):
+                return False
+            self.stats["cuts"] += 1
+            self.connection.shutdown(socket.SHUT_RDWR)
+            return True
+
+    def close(self):
+        self.server.close()
+        with self.lock:
+            if self.connection is not None:
+                self.connection.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check QoS 1 delivery of a simulated node against a faulty broker")
+    parser.add_argument("--program", default=".pio/build/sim/program", help="simulator binary")
+    parser.add_argument("--trace", help="sensor trace for the node")
+    parser.add_argument("--duration", type=float, default=120, help="wall seconds of faults")
+    parser.add_argument("--speed", type=float, default=5, help="simulated time per wall second")
+    parser.add_argument("--drop-puback", type=float, default=0.3, help="share of PUBACKs never sent")
+    parser.add_argument("--cut-every", type=float, default=20,
+                        help="cut the connection this often (wall s), at the next moment a publish is in flight")
+    parser.add_argument("--settle", type=float, default=15, help="wall seconds after the final cut for resends")
+    parser.add_argument("--port", type=int, default=0, help="broker port (0 picks a free one)")
+    parser.add_argument("--http-port", type=int, default=18099)
+    parser.add_argument("--work-dir", default=".faults")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--output", help="write the JSON results here")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.program):
+        parser.error(f"{args.program} not found; build it with: pio run -e sim")
+    shutil.rmtree(args.work_dir, ignore_errors=True)
+    os.makedirs(args.work_dir)
+
+    broker = FaultyBroker(args.port, args.drop_puback, random.Random(args.seed))
+    command = [args.program, "--state-dir", args.work_dir, "--http-port", str(args.http_port),
+               "--speed", str(args.speed), "--param", "mqtt_broker=127.0.0.1",
+               "--param", f"mqtt_port={broker.port}", "--param", "location=faults",
+               "--param", "mqtt_enabled=1", "--fresh"]
+    if args.trace:
+        command += ["--trace", args.trace]
+    log = open(os.path.join(args.work_dir, "console.log"), "w")
+    node = subprocess.Popen(command, stdout=log, stderr=subprocess.STDOUT)
+
+    start = time.time()
+    next_cut = start + args.cut_every
+    try:
+        while time.time() - start < args.duration and node.poll() is None:
+            if time.time() >= next_cut and broker.cut(only_mid_window=True):
+                next_cut = time.time() + args.cut_every
+            time.sleep(0.05)
+
+        # Stop dropping, force one more reconnect and let the node resend its window
+        broker.drop_puback = 0
+        settle_end = time.time() + args.settle
+        while not broker.cut(only_mid_window=False) and time.time() < settle_end:
+            time.sleep(0.05)
+        while time.time() < settle_end and node.poll() is None:
+            time.sleep(0.1)
+    except KeyboardInterrupt:
+        pass
+    exited = node.poll() is not None
+    if not exited:
+        node.terminate()
+    node.wait()
+    broker.close()
+
+    with broker.lock:
+        lost = [{"packet_id": packet_id, "topic": topic, "age_s": round(time.time() - first_seen, 1)}
+                for packet_id, (topic, _, first_seen) in sorted(broker.inflight.items())]
+        errors = list(broker.errors)
+        stats = dict(broker.stats)
+    if exited:
+        errors.append(f"node exited early; see {args.work_dir}/console.log")
+    if stats["qos1"] == 0:
+        errors.append("no QoS 1 publishes seen")
+    if stats["cuts"] and stats["connects"] < 2:
+        errors.append("node never reconnected after a cut")
+
+    result = {
+        "format": RESULT_FORMAT,
+        "config": {"duration_s": args.duration, "speed": args.speed, "drop_puback": args.drop_puback,
+                   "cut_every_s": args.cut_every, "settle_s": args.settle, "seed": args.seed},
+        "stats": stats,
+        "lost": lost,
+        "errors": errors,
+    }
+    print(f"{stats['qos1']} QoS 1 publishes, {stats['pubacks_dropped']} PUBACKs dropped, {stats['cuts']} cuts, "
+          f"{stats['connects']} connects ({stats['sessions_resumed']} resumed), {stats['resends']} resends, "
+          f"{stats['duplicates']} duplicate deliveries")
+    print(f"{len(lost)} lost, {len(errors)} errors")
+    for message in errors:
+        print(f"  {message}")
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=1)
+        print(f"results written to {args.output}")
+    sys.exit(1 if lost or errors else 0)
+
+
+if __name__ == "__main__":
+    main()
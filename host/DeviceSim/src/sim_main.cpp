@@ -0,0 +1,291 @@
+// Device simulator: boots the real firmware (setup()/loop() from src/main.cpp)
+// on Linux. The web server and MQTT run over real sockets, sensors follow a
+// trace file, and simulated time runs at --speed times wall-clock time.
+// ESP.restart()/ESP.deepSleep() re-execute the simulator with the retained
+// EEPROM/RTC state, so each boot starts from fresh firmware RAM.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <NTPClient.h>
+#include <user_interface.h>
+#include "config.h"
+#include "socket_network.h"
+#include "virtual_devices.h"
+
+struct SimOptions
+{
+    double speed = 1.0;     // Simulated seconds per wall-clock second; 0 = unpaced
+    double durationS = 0;   // 0 = run until interrupted
+    std::string stateDir = ".sim";
+    std::string fsRoot;     // Default: <stateDir>/fs
+    std::string tracePath;
+    bool fresh = false;     // Erase the retained EEPROM/RTC state first
+    uint32_t resumeReason = REASON_DEFAULT_RST;
+    uint64_t resumeSimUs = 0;
+    bool resumed = false;
+};
+
+static SimOptions options;
+static std::vector<std::string> launchArgs; // argv without --resume, for re-exec
+static SocketNetwork network;
+static VirtualDevices devices;
+static struct timespec wallStart;
+static uint64_t wallStartSimUs = 0;
+
+static uint64_t simMicros()
+{
+    return options.resumeSimUs + host::nowMicros();
+}
+
+static uint64_t wallMicros()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - wallStart.tv_sec) * 1000000ULL + (now.tv_nsec - wallStart.tv_nsec) / 1000;
+}
+
+// Sleeps until the wall clock catches up with simulated time
+static void pace()
+{
+    if (options.speed <= 0)
+    {
+        return;
+    }
+    uint64_t target = (uint64_t)((simMicros() - wallStartSimUs) / options.speed);
+    uint64_t wall = wallMicros();
+    if (target > wall)
+    {
+        usleep(target - wall);
+    }
+}
+
+static void onYield()
+{
+    devices.update(simMicros());
+    pace();
+}
+
+static std::string retainedPath()
+{
+    return options.stateDir + "/retained.bin";
+}
+
+// Where millis() == 0 of this boot falls on the wall clock, so observers can
+// turn the uptime in a published payload into a send time
+static void writeBootClock()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    FILE *file = fopen((options.stateDir + "/boot.json").c_str(), "w");
+    if (file)
+    {
+        fprintf(file, "{\"wall_s\": %ld.%06ld, \"speed\": %g, \"sim_s\": %.3f, \"reason\": %u}\n", (long)now.tv_sec,
+                now.tv_nsec / 1000, options.speed, options.resumeSimUs / 1e6, options.resumeReason);
+        fclose(file);
+    }
+}
+
+[[noreturn]] static void reboot(uint32_t reason, uint64_t sleepUs)
+{
+    if (!host::saveRetained(retainedPath()))
+    {
+        fprintf(stderr, "[sim] cannot save %s\n", retainedPath().c_str());
+        exit(1);
+    }
+    uint64_t resumeUs = simMicros() + sleepUs;
+    if (sleepUs > 0 && options.speed > 0)
+    {
+        usleep((useconds_t)(sleepUs / options.speed));
+    }
+    fprintf(stderr, "[sim] %s at %.3f s, rebooting\n", reason == REASON_DEEP_SLEEP_AWAKE ? "deep sleep" : "restart",
+            simMicros() / 1e6);
+    fflush(stdout);
+
+    std::vector<std::string> args = launchArgs;
+    args.push_back("--resume");
+    args.push_back(std::to_string(reason) + ":" + std::to_string(resumeUs));
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+    {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    execv("/proc/self/exe", argv.data());
+    fprintf(stderr, "[sim] re-exec failed: %s\n", strerror(errno));
+    exit(1);
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --speed X          simulated seconds per wall second (default 1, 0 = as fast as possible)\n"
+            "  --duration S       stop after S simulated seconds\n"
+            "  --trace FILE       sensor/environment trace (see host/DeviceSim/src/virtual_devices.h)\n"
+            "  --http-port P      host port for the device's port 80 (default 8080)\n"
+            "  --port D:H         host port H for device port D\n"
+            "  --param ID=VALUE   WiFiManager portal field, e.g. mqtt_broker=127.0.0.1\n"
+            "  --chip-id HEX      ESP.getChipId(), and so the MQTT client ID (default c0ffee)\n"
+            "  --state-dir DIR    retained EEPROM/RTC state and boot.json (default .sim)\n"
+            "  --fs DIR           LittleFS contents (default <state-dir>/fs)\n"
+            "  --fresh            start from erased flash\n",
+            program);
+}
+
+static bool parseArgs(int argc, char **argv)
+{
+    launchArgs.push_back(argv[0]);
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool takesValue = arg != "--fresh" && arg != "--help";
+        if (takesValue && !value)
+        {
+            fprintf(stderr, "[sim] %s needs a value\n", arg.c_str());
+            return false;
+        }
+        if (arg == "--resume")
+        {
+            unsigned long long us = 0;
+            sscanf(value, "%u:%llu", &options.resumeReason, &us);
+            options.resumeSimUs = us;
+            options.resumed = true;
+            i++;
+            continue;
+        }
+        launchArgs.push_back(arg);
+        if (takesValue)
+        {
+            launchArgs.push_back(value);
+            i++;
+        }
+
+        if (arg == "--speed")
+        {
+            options.speed = atof(value);
+        }
+        else if (arg == "--duration")
+        {
+            options.durationS = atof(value);
+        }
+        else if (arg == "--trace")
+        {
+            options.tracePath = value;
+        }
+        else if (arg == "--http-port")
+        {
+            network.mapPort(80, (uint16_t)atoi(value));
+        }
+        else if (arg == "--port")
+        {
+            unsigned int devicePort, hostPort;
+            if (sscanf(value, "%u:%u", &devicePort, &hostPort) != 2)
+            {
+                return false;
+            }
+            network.mapPort(devicePort, hostPort);
+        }
+        else if (arg == "--param")
+        {
+            const char *equals = strchr(value, '=');
+            if (!equals)
+            {
+                return false;
+            }
+            host::setPortalValue(std::string(value, equals - value), equals + 1);
+        }
+        else if (arg == "--chip-id")
+        {
+            host::setChipId((uint32_t)strtoul(value, nullptr, 16));
+        }
+        else if (arg == "--state-dir")
+        {
+            options.stateDir = value;
+        }
+        else if (arg == "--fs")
+        {
+            options.fsRoot = value;
+        }
+        else if (arg == "--fresh")
+        {
+            options.fresh = true;
+            launchArgs.pop_back(); // Only the first boot starts erased
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parseArgs(argc, argv))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    mkdir(options.stateDir.c_str(), 0755);
+    if (options.fsRoot.empty())
+    {
+        options.fsRoot = options.stateDir + "/fs";
+    }
+    mkdir(options.fsRoot.c_str(), 0755);
+    host::setFsRoot(options.fsRoot);
+
+    if (!options.tracePath.empty())
+    {
+        std::string error;
+        if (!devices.loadTrace(options.tracePath.c_str(), error))
+        {
+            fprintf(stderr, "[sim] %s\n", error.c_str());
+            return 2;
+        }
+    }
+
+    // Power-on keeps flash but not RTC memory; a reboot keeps both
+    host::reset();
+    if (!options.fresh && host::loadRetained(retainedPath()) && !options.resumed)
+    {
+        static uint32_t cleared[128];
+        ESP.rtcUserMemoryWrite(0, cleared, sizeof(cleared));
+    }
+    host::restart(options.resumeReason);
+    host::setPin(BUTTON_PIN, HIGH); // Released; the pull-up holds it high
+    NTPClient::hostEpochBase += (unsigned long)(options.resumeSimUs / 1000000);
+
+    host::setNetwork(&network);
+    host::onYield(onYield);
+    host::onRestart(reboot);
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    wallStartSimUs = simMicros();
+    writeBootClock();
+    devices.update(simMicros());
+
+    setup();
+    uint64_t endUs = (uint64_t)(options.durationS * 1e6);
+    while (endUs == 0 || simMicros() < endUs)
+    {
+        uint64_t before = host::nowMicros();
+        loop();
+        if (host::nowMicros() == before)
+        {
+            host::advanceMillis(1); // A loop pass is never free on the device
+        }
+        onYield();
+    }
+    fprintf(stderr, "[sim] %.3f simulated seconds done\n", simMicros() / 1e6);
+    host::saveRetained(retainedPath());
+    return 0;
+}
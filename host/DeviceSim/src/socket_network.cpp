@@ -0,0 +1,215 @@
+#include "socket_network.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+
+#define SOCKET_CONNECT_TIMEOUT_MS 1000
+#define SOCKET_SEND_TIMEOUT_MS 5000
+
+// Sockets are non-blocking and close-on-exec, so a re-executed firmware
+// starts without the previous boot's connections
+class SocketConnection : public HostConnection
+{
+public:
+    explicit SocketConnection(int fd) : _fd(fd)
+    {
+        int one = 1;
+        setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ~SocketConnection() override { close(); }
+
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        size_t sent = 0;
+        while (_fd >= 0 && sent < size)
+        {
+            ssize_t n = send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+            if (n > 0)
+            {
+                sent += n;
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                struct pollfd p = {_fd, POLLOUT, 0};
+                if (poll(&p, 1, SOCKET_SEND_TIMEOUT_MS) > 0)
+                {
+                    continue;
+                }
+            }
+            _open = false;
+            break;
+        }
+        return sent;
+    }
+
+    int available() override
+    {
+        fill();
+        return (int)_rx.size();
+    }
+
+    int read(uint8_t *buf, size_t size) override
+    {
+        fill();
+        size_t n = std::min(size, _rx.size());
+        memcpy(buf, _rx.data(), n);
+        _rx.erase(0, n);
+        return (int)n;
+    }
+
+    bool connected() override
+    {
+        fill();
+        return _open;
+    }
+
+    void close() override
+    {
+        if (_fd >= 0)
+        {
+            ::close(_fd);
+            _fd = -1;
+        }
+        _open = false;
+    }
+
+private:
+    void fill()
+    {
+        uint8_t buffer[1460];
+        while (_open && _fd >= 0)
+        {
+            ssize_t n = recv(_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n > 0)
+            {
+                _rx.append((const char *)buffer, n);
+            }
+            else
+            {
+                if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                {
+                    _open = false; // Peer closed; buffered bytes stay readable
+                }
+                break;
+            }
+        }
+    }
+
+    int _fd;
+    bool _open = true;
+    std::string _rx;
+};
+
+class SocketListener : public HostListener
+{
+public:
+    explicit SocketListener(int fd) : _fd(fd) {}
+    ~SocketListener() override { ::close(_fd); }
+
+    HostConnection *accept() override
+    {
+        int fd = accept4(_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        return fd >= 0 ? new SocketConnection(fd) : nullptr;
+    }
+
+private:
+    int _fd;
+};
+
+static bool lookup(const char *host, uint16_t port, struct addrinfo **result)
+{
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    std::string service = std::to_string(port);
+    return getaddrinfo(host, service.c_str(), &hints, result) == 0;
+}
+
+HostConnection *SocketNetwork::connect(const char *host, uint16_t port)
+{
+    struct addrinfo *addresses;
+    if (!lookup(host, port, &addresses))
+    {
+        return nullptr;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    bool ok = fd >= 0;
+    if (ok && ::connect(fd, addresses->ai_addr, addresses->ai_addrlen) != 0)
+    {
+        // Bounded wait so an unreachable broker stalls the loop like lwIP
+        // would, not for the kernel's minutes-long SYN timeout
+        struct pollfd p = {fd, POLLOUT, 0};
+        int error = 0;
+        socklen_t length = sizeof(error);
+        ok = errno == EINPROGRESS && poll(&p, 1, SOCKET_CONNECT_TIMEOUT_MS) > 0 &&
+             getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+    }
+    freeaddrinfo(addresses);
+    if (!ok)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return nullptr;
+    }
+    return new SocketConnection(fd);
+}
+
+bool SocketNetwork::resolve(const char *host, uint32_t &address)
+{
+    struct addrinfo *addresses;
+    if (!lookup(host, 0, &addresses))
+    {
+        return false;
+    }
+    // s_addr is in network order, which is IPAddress's uint32_t layout
+    address = ((struct sockaddr_in *)addresses->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(addresses);
+    return true;
+}
+
+uint16_t SocketNetwork::hostPort(uint16_t devicePort) const
+{
+    auto mapped = _ports.find(devicePort);
+    if (mapped != _ports.end())
+    {
+        return mapped->second;
+    }
+    return devicePort < 1024 ? devicePort + 8000 : devicePort;
+}
+
+HostListener *SocketNetwork::listen(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(hostPort(port));
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || ::listen(fd, 16) != 0)
+    {
+        fprintf(stderr, "[sim] cannot listen on port %u (device port %u): %s\n", hostPort(port), port, strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+    fprintf(stderr, "[sim] device port %u listening on host port %u\n", port, hostPort(port));
+    return new SocketListener(fd);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <map>
+#include <ArduinoHost.h>
+
+// Real TCP sockets behind WiFiClient and WiFiServer. A server the firmware
+// opens on device port N listens on host port hostPort(N): mapped ports as
+// given, otherwise privileged ports move up by 8000 (80 -> 8080).
+class SocketNetwork : public HostNetwork
+{
+public:
+    HostConnection *connect(const char *host, uint16_t port) override;
+    bool resolve(const char *host, uint32_t &address) override;
+    HostListener *listen(uint16_t port) override;
+
+    void mapPort(uint16_t devicePort, uint16_t hostPort) { _ports[devicePort] = hostPort; }
+    uint16_t hostPort(uint16_t devicePort) const;
+
+private:
+    std::map<uint16_t, uint16_t> _ports;
+};
@@ -0,0 +1,147 @@
+#include "virtual_devices.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sstream>
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include "config.h"
+#include "sensors/dht_sensor.h"
+#include "sensors/ld2410_sensor.h"
+#include "sensors/tsl2561_sensor.h"
+
+#define RADAR_FRAME_INTERVAL_US 100000 // LD2410 basic-mode report rate
+#define RADAR_SIGNAL 60
+#define SOFTWARE_SERIAL_RX_BUFFER 64 // Frames beyond this are lost, like an RX overflow
+
+bool VirtualDevices::loadTrace(const char *path, std::string &error)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    char text[256];
+    int line = 0;
+    while (fgets(text, sizeof(text), file))
+    {
+        line++;
+        std::string content(text);
+        content = content.substr(0, content.find('#'));
+        std::istringstream words(content);
+        double seconds;
+        Event event;
+        if (!(words >> seconds))
+        {
+            continue; // Blank or comment line
+        }
+        if (!(words >> event.device) || seconds < 0)
+        {
+            error = std::string(path) + ":" + std::to_string(line) + ": expected <time_s> <device> <values...>";
+            fclose(file);
+            return false;
+        }
+        std::string value;
+        while (words >> value)
+        {
+            event.values.push_back(value);
+        }
+        event.atUs = (uint64_t)(seconds * 1e6);
+        event.line = line;
+        _events.push_back(event);
+    }
+    fclose(file);
+    std::stable_sort(_events.begin(), _events.end(), [](const Event &a, const Event &b)
+                     { return a.atUs < b.atUs; });
+    return true;
+}
+
+void VirtualDevices::update(uint64_t simUs)
+{
+    while (_next < _events.size() && _events[_next].atUs <= simUs)
+    {
+        apply(_events[_next++]);
+    }
+    if (simUs >= _nextRadarFrameUs)
+    {
+        sendRadarFrame();
+        _nextRadarFrameUs = simUs + RADAR_FRAME_INTERVAL_US;
+    }
+}
+
+void VirtualDevices::apply(const Event &event)
+{
+    const std::vector<std::string> &v = event.values;
+    auto number = [&](size_t i, double fallback)
+    { return i < v.size() ? atof(v[i].c_str()) : fallback; };
+    auto word = [&](size_t i)
+    { return i < v.size() ? v[i] : std::string(); };
+
+    if (event.device == "dht")
+    {
+        dht.hostFail(word(0) == "fail");
+        if (word(0) != "fail")
+        {
+            dht.hostSet(number(0, 0), number(1, 0));
+        }
+    }
+    else if (event.device == "tsl")
+    {
+        tsl.hostSetPresent(word(0) != "absent");
+        if (word(0) != "absent")
+        {
+            tsl.hostSetLux(number(0, 0));
+        }
+    }
+    else if (event.device == "pir")
+    {
+        host::setPin(PIR_PIN, number(0, 0) != 0 ? HIGH : LOW);
+    }
+    else if (event.device == "ld2410")
+    {
+        static const char *const states[] = {"none", "moving", "stationary", "both"};
+        for (uint8_t status = 0; status < 4; status++)
+        {
+            if (word(0) == states[status])
+            {
+                _radarStatus = status;
+            }
+        }
+        _radarMoving = (uint16_t)number(1, _radarMoving);
+        _radarStationary = (uint16_t)number(2, _radarStationary);
+    }
+    else if (event.device == "button")
+    {
+        host::setPin(BUTTON_PIN, word(0) == "press" ? LOW : HIGH); // Active low
+    }
+    else if (event.device == "wifi")
+    {
+        host::wifiReachable(word(0) != "down");
+    }
+    else if (event.device == "heap")
+    {
+        host::setHeap((uint32_t)number(0, 40000), (uint32_t)number(1, 30000), (uint8_t)number(2, 10));
+    }
+    else if (event.device == "analog")
+    {
+        host::setAnalog((int)number(0, 0));
+    }
+    else
+    {
+        fprintf(stderr, "[sim] trace line %d: unknown device '%s'\n", event.line, event.device.c_str());
+    }
+}
+
+void VirtualDevices::sendRadarFrame()
+{
+    uint8_t frame[32];
+    uint16_t moving = _radarStatus & 0x01 ? _radarMoving : 0;
+    uint16_t stationary = _radarStatus & 0x02 ? _radarStationary : 0;
+    uint16_t detected = moving ? moving : stationary;
+    size_t length = MyLD2410::buildDataFrame(frame, sizeof(frame), _radarStatus, moving, moving ? RADAR_SIGNAL : 0,
+                                             stationary, stationary ? RADAR_SIGNAL : 0, detected);
+    if (length > 0 && ld2410Serial.available() + length <= SOFTWARE_SERIAL_RX_BUFFER)
+    {
+        ld2410Serial.hostInject(frame, length);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Sensor and environment state driven by a trace file. One event per line:
+//
+//   <time_s> <device> <values...>      # comment
+//
+//   dht <temp_c> <humidity> | dht fail
+//   tsl <lux> | tsl absent
+//   pir 0|1
+//   ld2410 none|moving|stationary|both [moving_cm [stationary_cm]]
+//   button press|release
+//   wifi up|down
+//   heap <free> <max_block> <fragmentation>
+//   analog <value>
+//
+// Times are seconds of simulated time since the first power-on.
+class VirtualDevices
+{
+public:
+    bool loadTrace(const char *path, std::string &error);
+    // Applies every event up to simUs; the radar keeps reporting at its
+    // 10 Hz frame rate in between
+    void update(uint64_t simUs);
+    bool traceFinished() const { return _next >= _events.size(); }
+
+private:
+    struct Event
+    {
+        uint64_t atUs;
+        std::string device;
+        std::vector<std::string> values;
+        int line;
+    };
+
+    void apply(const Event &event);
+    void sendRadarFrame();
+
+    std::vector<Event> _events;
+    size_t _next = 0;
+
+    uint8_t _radarStatus = 0;
+    uint16_t _radarMoving = 0;
+    uint16_t _radarStationary = 0;
+    uint64_t _nextRadarFrameUs = 0;
+};
@@ -0,0 +1,8 @@
+# Builds env:fuzz with clang: libFuzzer plus AddressSanitizer and
+# UndefinedBehaviorSanitizer. Pre-script, so the firmware sources and the
+# libraries are instrumented as well, not just the fuzz targets.
+Import("env")
+
+sanitize = ["-fsanitize=address,undefined", "-fno-sanitize-recover=undefined", "-fno-omit-frame-pointer", "-g", "-O1"]
+env.Replace(CC="clang", CXX="clang++", LINK="clang++")
+env.Append(CCFLAGS=sanitize + ["-fsanitize=fuzzer-no-link"], LINKFLAGS=sanitize + ["-fsanitize=fuzzer"])
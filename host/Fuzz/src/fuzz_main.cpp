@@ -0,0 +1,163 @@
+// Entry points for the parser fuzz targets (fuzz_targets.cpp).
+//
+// env:fuzz (FUZZ_LIBFUZZER, clang, ASan/UBSan): libFuzzer's own main; the
+// target is chosen with FUZZ_TARGET, e.g.
+//   FUZZ_TARGET=config .pio/build/fuzz/program -dict=host/Fuzz/json.dict host/Fuzz/corpus/config
+//
+// env:fuzz_bench (optimised, no sanitizers): runs each target over its seed
+// corpus for a fixed time and prints execs/sec, one JSON line per target.
+//   .pio/build/fuzz_bench/program [--seconds S] [--target NAME] [CORPUS_DIR]
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "fuzz_targets.h"
+
+#if FUZZ_LIBFUZZER
+
+static const FuzzTarget *target = nullptr;
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    const char *name = getenv("FUZZ_TARGET");
+    target = findFuzzTarget(name ? name : "");
+    if (!target)
+    {
+        fprintf(stderr, "set FUZZ_TARGET to one of:\n");
+        for (size_t i = 0; i < fuzzTargetCount; i++)
+        {
+            fprintf(stderr, "  %-8s %s\n", fuzzTargets[i].name, fuzzTargets[i].description);
+        }
+        exit(2);
+    }
+    target->init();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    target->run(data, size);
+    return 0;
+}
+
+#else
+
+static double nowSeconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static std::vector<std::string> loadCorpus(const std::string &dir)
+{
+    std::vector<std::string> inputs;
+    DIR *handle = opendir(dir.c_str());
+    if (!handle)
+    {
+        return inputs;
+    }
+    while (struct dirent *entry = readdir(handle))
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+        FILE *file = fopen((dir + "/" + entry->d_name).c_str(), "rb");
+        if (!file)
+        {
+            continue;
+        }
+        std::string input;
+        char chunk[1024];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            input.append(chunk, n);
+        }
+        fclose(file);
+        inputs.push_back(input);
+    }
+    closedir(handle);
+    return inputs;
+}
+
+static void bench(const FuzzTarget &target, const std::string &corpusRoot, double seconds)
+{
+    std::vector<std::string> inputs = loadCorpus(corpusRoot + "/" + target.name);
+    if (inputs.empty())
+    {
+        fprintf(stderr, "[fuzz_bench] no inputs in %s/%s\n", corpusRoot.c_str(), target.name);
+        return;
+    }
+    target.init();
+
+    // Exact-size copies, so the benchmark reads the same memory the fuzzer does
+    std::vector<std::vector<uint8_t>> buffers;
+    size_t bytes = 0;
+    for (const std::string &input : inputs)
+    {
+        buffers.emplace_back(input.begin(), input.end());
+        bytes += input.size();
+    }
+
+    unsigned long execs = 0;
+    double start = nowSeconds();
+    double elapsed = 0;
+    do
+    {
+        for (const std::vector<uint8_t> &buffer : buffers)
+        {
+            target.run(buffer.data(), buffer.size());
+        }
+        execs += buffers.size();
+        elapsed = nowSeconds() - start;
+    } while (elapsed < seconds);
+
+    printf("{\"target\": \"%s\", \"inputs\": %zu, \"bytes\": %zu, \"execs\": %lu, \"seconds\": %.3f, "
+           "\"execs_per_s\": %.0f}\n",
+           target.name, inputs.size(), bytes, execs, elapsed, execs / elapsed);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 2;
+    const char *only = nullptr;
+    std::string corpusRoot = "host/Fuzz/corpus";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (argv[i][0] != '-')
+        {
+            corpusRoot = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seconds S] [--target NAME] [CORPUS_DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (size_t i = 0; i < fuzzTargetCount; i++)
+    {
+        if (!only || strcmp(only, fuzzTargets[i].name) == 0)
+        {
+            bench(fuzzTargets[i], corpusRoot, seconds);
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include "config.h"
+#include "fuzz_targets.h"
+#include "comm/command_parser.h"
+#include "comm/mqtt.h"
+#include "model/config_manager.h"
+#include "model/data_structs.h"
+
+static ConfigData baseConfig;
+
+// Power-on state with the default configuration; LittleFS goes to a scratch
+// directory because some MQTT commands save the config
+static void bootDefaults()
+{
+    static std::string fsRoot;
+    if (fsRoot.empty())
+    {
+        char pattern[] = "/tmp/fuzz-fs-XXXXXX";
+        const char *dir = mkdtemp(pattern);
+        fsRoot = dir ? dir : "/tmp";
+    }
+    host::reset();
+    host::setFsRoot(fsRoot);
+    loadConfig();
+    baseConfig = config;
+}
+
+static void runConfigPatch(const uint8_t *data, size_t size)
+{
+    ConfigData target = baseConfig;
+    applyConfigPatch((const char *)data, size, target);
+}
+
+static void runEnabledFlag(const uint8_t *data, size_t size)
+{
+    bool enabled;
+    parseEnabledFlag((const char *)data, size, enabled);
+}
+
+static void runRelay(const uint8_t *data, size_t size)
+{
+    parseRelayCommand((const char *)data, size);
+    parseRelayRequest((const char *)data, size);
+}
+
+static void initMqtt()
+{
+    bootDefaults();
+    config.mqtt_enabled = true;
+    config.use_relay = true;
+    setupMQTT(); // Registers the command routes; connecting waits for loop()
+}
+
+// "<topic>\n<payload>", delivered the way PubSubClient hands it over
+static void runMqtt(const uint8_t *data, size_t size)
+{
+    const uint8_t *newline = (const uint8_t *)memchr(data, '\n', size);
+    size_t topicLength = newline ? newline - data : size;
+    std::string topic((const char *)data, topicLength);
+    size_t payloadOffset = newline ? topicLength + 1 : size;
+    size_t payloadLength = size - payloadOffset;
+    // An exact-size heap copy, never nullptr, as PubSubClient's buffer would be
+    std::unique_ptr<uint8_t[]> payload(new uint8_t[payloadLength]);
+    memcpy(payload.get(), data + payloadOffset, payloadLength);
+    mqttCallback(&topic[0], payload.get(), (unsigned int)payloadLength);
+}
+
+const FuzzTarget fuzzTargets[] = {
+    {"config", "/api/config POST body", bootDefaults, runConfigPatch},
+    {"enabled", "/api/sensorless and /api/debug POST body", bootDefaults, runEnabledFlag},
+    {"relay", "MQTT relay/command payload and /api/relay POST body", bootDefaults, runRelay},
+    {"mqtt", "mqttCallback(): topic routing and every command handler", initMqtt, runMqtt},
+};
+const size_t fuzzTargetCount = sizeof(fuzzTargets) / sizeof(fuzzTargets[0]);
+
+const FuzzTarget *findFuzzTarget(const char *name)
+{
+    for (size_t i = 0; i < fuzzTargetCount; i++)
+    {
+        if (strcmp(fuzzTargets[i].name, name) == 0)
+        {
+            return &fuzzTargets[i];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// One parser entry point per target. Inputs are passed exactly as received,
+// without a terminator, so AddressSanitizer sees any read past the end.
+struct FuzzTarget
+{
+    const char *name;
+    const char *description;
+    void (*init)();
+    void (*run)(const uint8_t *data, size_t size);
+};
+
+extern const FuzzTarget fuzzTargets[];
+extern const size_t fuzzTargetCount;
+
+const FuzzTarget *findFuzzTarget(const char *name);
@@ -0,0 +1,348 @@
+// LD2410 replay: feeds recordings made with /api/ld2410/capture through the
+// firmware's readLD2410() (radar frame parser and presence logic) on the
+// virtual clock. Each read happens at the millisecond it happened on the
+// device with the bytes it saw then, so a run is deterministic and its
+// outcome can be pinned in a golden file.
+//
+//   program [--repeat N] [--expect DIR [--update]] FILE.rec...
+//
+// Prints one JSON line per recording. With --expect, DIR/<name>.json holds
+// the expected outcome of <name>.rec; mismatches (or missing files) make the
+// exit status 1, and --update rewrites them instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include "config.h"
+#include "model/data_structs.h"
+#include "sensors/ld2410_capture.h"
+#include "sensors/ld2410_sensor.h"
+
+struct Record
+{
+    uint32_t t_ms;
+    bool tx;
+    size_t offset;
+    size_t length;
+};
+
+struct Recording
+{
+    std::string path;
+    std::vector<uint8_t> data;
+    uint32_t baud = 0;
+    uint32_t chipId = 0;
+    std::vector<Record> records;
+    uint32_t bytesRx = 0;
+    uint32_t bytesTx = 0;
+};
+
+// The deterministic part of a replay, compared against golden files
+struct Outcome
+{
+    uint32_t reads = 0;
+    uint32_t frames = 0; // Reads that produced a report frame
+    uint32_t presenceChanges = 0;
+    uint32_t presenceMs = 0;
+    uint32_t durationMs = 0;
+    uint32_t digest = 2166136261u; // FNV-1a over every frame's decoded state
+};
+
+static uint32_t get32(const uint8_t *in)
+{
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static void mix(uint32_t &digest, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        digest = (digest ^ ((value >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+}
+
+static bool load(const char *path, Recording &recording, std::string &error)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        error = std::string(path) + ": cannot open";
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        recording.data.insert(recording.data.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    recording.path = path;
+
+    const std::vector<uint8_t> &data = recording.data;
+    if (data.size() < 12 || memcmp(data.data(), LD2410_REC_MAGIC, 4) != 0)
+    {
+        error = std::string(path) + ": not an LD2410 recording";
+        return false;
+    }
+    recording.baud = get32(&data[4]);
+    recording.chipId = get32(&data[8]);
+    size_t at = 12;
+    while (at + 6 <= data.size())
+    {
+        Record record;
+        record.t_ms = get32(&data[at]);
+        uint16_t length = data[at + 4] | (data[at + 5] << 8);
+        record.tx = length & LD2410_REC_TX;
+        record.length = length & LD2410_REC_MAX_LENGTH;
+        record.offset = at + 6;
+        if (record.offset + record.length > data.size())
+        {
+            break; // Capture cut off mid-record; replay what is whole
+        }
+        (record.tx ? recording.bytesTx : recording.bytesRx) += record.length;
+        recording.records.push_back(record);
+        at = record.offset + record.length;
+    }
+    return true;
+}
+
+static void advanceTo(uint32_t t_ms)
+{
+    uint64_t target = (uint64_t)t_ms * 1000;
+    if (target > host::nowMicros())
+    {
+        host::advanceMicros(target - host::nowMicros());
+    }
+}
+
+static double nowSeconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// One pass over the recording from a fresh radar state. Returns the seconds
+// spent inside readLD2410(), the part being measured.
+static double replay(const Recording &recording, Outcome &outcome)
+{
+    outcome = Outcome();
+    host::reset();
+    ld2410Serial.hostReset();
+    memset(&sensorData, 0, sizeof(sensorData));
+    setupLD2410();
+
+    // The first read after the warm-up opens the UART; the recording can
+    // only start after that on the device too
+    uint32_t first = recording.records.empty() ? 0 : recording.records.front().t_ms;
+    advanceTo(first > LD2410_WARMUP_MS ? first : LD2410_WARMUP_MS);
+    readLD2410();
+
+    double busy = 0;
+    bool presence = false;
+    uint32_t presenceSince = 0;
+    uint32_t lastT = first;
+    size_t i = 0;
+    while (i < recording.records.size())
+    {
+        // Everything read at one millisecond came from one readLD2410() call
+        uint32_t t = recording.records[i].t_ms;
+        advanceTo(t);
+        for (; i < recording.records.size() && recording.records[i].t_ms == t; i++)
+        {
+            const Record &record = recording.records[i];
+            if (!record.tx)
+            {
+                ld2410Serial.hostInject(&recording.data[record.offset], record.length);
+            }
+        }
+        if (!ld2410Serial.available())
+        {
+            continue; // Only commands were written at this point
+        }
+
+        double start = nowSeconds();
+        readLD2410();
+        busy += nowSeconds() - start;
+        ld2410Serial.hostTakeWritten();
+
+        outcome.reads++;
+        if (sensorData.radar_available)
+        {
+            outcome.frames++;
+            mix(outcome.digest, t);
+            mix(outcome.digest, radar.getStatus());
+            mix(outcome.digest, radar.movingTargetDistance());
+            mix(outcome.digest, radar.stationaryTargetDistance());
+            mix(outcome.digest, radar.detectedDistance());
+        }
+        if (sensorData.radar_presence != presence)
+        {
+            if (presence)
+            {
+                outcome.presenceMs += t - presenceSince;
+            }
+            presence = sensorData.radar_presence;
+            presenceSince = t;
+            outcome.presenceChanges++;
+        }
+        lastT = t;
+    }
+    if (presence)
+    {
+        outcome.presenceMs += lastT - presenceSince;
+    }
+    outcome.durationMs = lastT - first;
+    return busy;
+}
+
+static std::string describe(const Recording &recording, const Outcome &outcome)
+{
+    char text[256];
+    snprintf(text, sizeof(text),
+             "{\"bytes_rx\": %u, \"records\": %zu, \"duration_ms\": %u, \"reads\": %u, \"frames\": %u, "
+             "\"presence_changes\": %u, \"presence_ms\": %u, \"digest\": \"%08x\"}",
+             recording.bytesRx, recording.records.size(), outcome.durationMs, outcome.reads, outcome.frames,
+             outcome.presenceChanges, outcome.presenceMs, outcome.digest);
+    return text;
+}
+
+static std::string expectationPath(const std::string &dir, const std::string &recordingPath)
+{
+    size_t slash = recordingPath.find_last_of('/');
+    std::string name = recordingPath.substr(slash == std::string::npos ? 0 : slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos)
+    {
+        name.resize(dot);
+    }
+    return dir + "/" + name + ".json";
+}
+
+static std::string readText(const std::string &path)
+{
+    std::string text;
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file)
+    {
+        return text;
+    }
+    char chunk[512];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        text.append(chunk, n);
+    }
+    fclose(file);
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' '))
+    {
+        text.pop_back();
+    }
+    return text;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options] FILE.rec...\n"
+            "  --repeat N     replay each recording N times for the throughput figures (default 1)\n"
+            "  --expect DIR   compare with DIR/<name>.json; exit status 1 on any mismatch\n"
+            "  --update       write DIR/<name>.json from this run instead of comparing\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    int repeat = 1;
+    std::string expectDir;
+    bool update = false;
+    std::vector<const char *> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+        {
+            repeat = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc)
+        {
+            expectDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--update") == 0)
+        {
+            update = true;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || repeat < 1 || (update && expectDir.empty()))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    for (const char *path : paths)
+    {
+        Recording recording;
+        std::string error;
+        if (!load(path, recording, error))
+        {
+            fprintf(stderr, "[replay] %s\n", error.c_str());
+            failures++;
+            continue;
+        }
+
+        Outcome outcome;
+        double busy = 0;
+        for (int r = 0; r < repeat; r++)
+        {
+            busy += replay(recording, outcome);
+        }
+        std::string expected = describe(recording, outcome);
+        double bytes = (double)recording.bytesRx * repeat;
+        printf("{\"file\": \"%s\", \"baud\": %u, \"chip_id\": \"%06x\", \"bytes_tx\": %u, \"result\": %s, "
+               "\"repeat\": %d, \"parse_s\": %.6f, \"bytes_per_s\": %.0f, \"frames_per_s\": %.0f}\n",
+               path, recording.baud, recording.chipId, recording.bytesTx, expected.c_str(), repeat, busy,
+               busy > 0 ? bytes / busy : 0.0, busy > 0 ? outcome.frames * (double)repeat / busy : 0.0);
+
+        if (expectDir.empty())
+        {
+            continue;
+        }
+        std::string goldenPath = expectationPath(expectDir, path);
+        if (update)
+        {
+            FILE *file = fopen(goldenPath.c_str(), "w");
+            if (!file)
+            {
+                fprintf(stderr, "[replay] cannot write %s\n", goldenPath.c_str());
+                failures++;
+                continue;
+            }
+            fprintf(file, "%s\n", expected.c_str());
+            fclose(file);
+            continue;
+        }
+        std::string golden = readText(goldenPath);
+        if (golden != expected)
+        {
+            fprintf(stderr, "[replay] %s: %s\n  expected %s\n  got      %s\n", path,
+                    golden.empty() ? "no expectation (run with --update)" : "mismatch", golden.c_str(),
+                    expected.c_str());
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+// Payload budgets: builds every budgeted HTTP response and MQTT payload
+// (comm/payloads.h) from worst-case state and checks the serialized size and
+// JSON document usage against budgets.txt, and that the largest valid request
+// bodies fit their documents.
+//
+//   program [--update] [BUDGETS]
+//
+// Prints one JSON line per payload. Any figure over its budget, a document
+// that overflowed its capacity or an MQTT packet larger than the PubSubClient
+// buffer makes the exit status 1; --update rewrites BUDGETS from this run.
+// test/test_payload_budget runs the same checks in env:native.
+
+#if PAYLOAD_BUDGET_PROGRAM
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "payload_budget.h"
+
+int main(int argc, char **argv)
+{
+    std::string budgetPath = PAYLOAD_BUDGET_FILE;
+    bool update = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--update") == 0)
+        {
+            update = true;
+        }
+        else if (argv[i][0] != '-')
+        {
+            budgetPath = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--update] [BUDGETS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    setupWorstCase();
+    std::vector<PayloadBudget> budgets = loadPayloadBudgets(budgetPath);
+
+    PayloadMeasurement results[PAYLOAD_COUNT];
+    bool ok = true;
+    for (size_t i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        PayloadId id = (PayloadId)i;
+        const char *name = getPayloadName(id);
+        PayloadMeasurement &result = results[i] = measurePayload(id);
+        printf("{\"payload\": \"%s\", \"bytes\": %ld, \"used\": %ld, \"capacity\": %zu, \"packet\": %zu}\n",
+               name, result.bytes, result.used, result.capacity, result.packet);
+
+        // Limits that hold whatever the budgets say
+        ok &= checkPayloadLimits(id, result);
+        if (!update)
+        {
+            ok &= checkPayloadBudget(id, result, findPayloadBudget(budgets, name));
+        }
+    }
+    ok &= checkRequestCapacities();
+
+    if (update && !writePayloadBudgets(budgetPath, results))
+    {
+        fprintf(stderr, "[payload_budget] cannot write %s\n", budgetPath.c_str());
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
+
+#endif
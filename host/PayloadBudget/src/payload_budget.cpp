@@ -0,0 +1,600 @@
+// Worst case means every integer at the widest value of its type, floats with
+// as many digits as ArduinoJson prints, every optional field present,
+// 31-character location, broker and username, and booleans false wherever the
+// value doesn't decide which fields appear. Document usage is in host bytes
+// (64-bit slots).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <ArduinoJson.h>
+#include <ESP8266WiFi.h>
+#include <user_interface.h>
+#include "config.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_qos.h"
+#include "comm/mqtt_router.h"
+#include "comm/publish_filter.h"
+#include "comm/wifi_manager.h"
+#include "model/config_store.h"
+#include "model/data_structs.h"
+#include "power/power_manager.h"
+#include "power/rtc_ring.h"
+#include "sensors/ld2410_capture.h"
+#include "sensors/sensor_health.h"
+#include "sensors/sensor_manager.h"
+#include "sensors/sensor_sampling.h"
+#include "debug/boot_timing.h"
+#include "debug/crash_diag.h"
+#include "debug/heap_monitor.h"
+#include "debug/log_ring.h"
+#include "debug/profiler.h"
+#include "payload_budget.h"
+
+struct Payload
+{
+    PayloadId id;
+    const char *topic; // MQTT topic under {location}/, nullptr for HTTP only
+    void (*build)(JsonDocument &doc);
+    bool pretty;
+};
+
+static SleepRing worstRing;
+static LogEntry worstLogEntry;
+
+static void buildConfigWithRing(JsonDocument &doc)
+{
+    buildConfigPayload(doc, &worstRing);
+}
+
+// A full message with NTP time and the TSL2561 enabled, the only flag that
+// adds a field
+static void buildSleepBatchWithRing(JsonDocument &doc)
+{
+    config.use_tsl2561 = true;
+    buildSleepBatchPayload(doc, worstRing, DEEP_SLEEP_SAMPLES_PER_MESSAGE, UINT32_MAX - 1);
+    config.use_tsl2561 = false;
+}
+
+static void buildLogEntry(JsonDocument &doc)
+{
+    buildLogEntryPayload(doc, worstLogEntry, false);
+}
+
+static void buildLogEntryRaw(JsonDocument &doc)
+{
+    buildLogEntryPayload(doc, worstLogEntry, true);
+}
+
+// An exception reset adds the exception object, more than the longer reset
+// reason name takes away
+static void buildDiagAfterException(JsonDocument &doc)
+{
+    rst_info *info = ESP.getResetInfoPtr();
+    rst_info saved = *info;
+    info->reason = REASON_EXCEPTION_RST;
+    info->exccause = UINT32_MAX;
+    info->epc1 = UINT32_MAX;
+    info->excvaddr = UINT32_MAX;
+    buildDiagPayload(doc);
+    *info = saved;
+}
+
+static void buildRelayAfterPost(JsonDocument &doc)
+{
+    buildRelayPayload(doc, "Relay turned OFF");
+}
+
+static const Payload payloads[] = {
+    {PAYLOAD_SENSORS, nullptr, buildSensorsPayload, false},
+    {PAYLOAD_CONFIG, nullptr, buildConfigWithRing, false},
+    {PAYLOAD_ALL, MQTT_TOPIC_ALL, buildAllPayload, false},
+    {PAYLOAD_RELAY_STATE, MQTT_TOPIC_RELAY_STATUS, buildRelayStatePayload, false},
+    {PAYLOAD_DIAG_RESET, MQTT_TOPIC_DIAG "/reset", buildResetDiagPayload, false},
+    {PAYLOAD_DIAG_PERF, MQTT_TOPIC_DIAG "/perf", buildPerfDiagPayload, false},
+    {PAYLOAD_SLEEP_BATCH, MQTT_TOPIC_BATCH, buildSleepBatchWithRing, false},
+    {PAYLOAD_SENSOR_CONFIG, nullptr, buildSensorConfigPayload, false},
+    {PAYLOAD_SENSOR_METRICS, nullptr, buildSensorMetricsPayload, false},
+    {PAYLOAD_DEBUG_SENSORS, nullptr, buildDebugSensorsPayload, false},
+    {PAYLOAD_HEALTH, nullptr, buildHealthPayload, false},
+    {PAYLOAD_CONFIG_FULL, nullptr, buildConfigFullPayload, false},
+    {PAYLOAD_CONFIG_EXPORT, nullptr, buildConfigExportPayload, true},
+    {PAYLOAD_BOOT, nullptr, buildBootPayload, false},
+    {PAYLOAD_PERF, nullptr, buildPerfPayload, false},
+    {PAYLOAD_HEAP, nullptr, buildHeapPayload, false},
+    {PAYLOAD_LOG_ENTRY, nullptr, buildLogEntry, false},
+    {PAYLOAD_LOG_ENTRY_RAW, nullptr, buildLogEntryRaw, false},
+    {PAYLOAD_DIAG, nullptr, buildDiagAfterException, false},
+    {PAYLOAD_LD2410_CAPTURE, nullptr, buildLd2410CapturePayload, false},
+    {PAYLOAD_POWER, nullptr, buildPowerPayload, false},
+    {PAYLOAD_MQTT, nullptr, buildMqttPayload, false},
+    {PAYLOAD_PAYLOADS, nullptr, buildPayloadsPayload, false},
+    {PAYLOAD_RELAY, nullptr, buildRelayAfterPost, false},
+};
+
+static_assert(sizeof(payloads) / sizeof(payloads[0]) == PAYLOAD_COUNT, "every PayloadId needs a budget entry");
+
+static void fill(char *dest, size_t size, const char *pattern)
+{
+    for (size_t i = 0; i + 1 < size; i++)
+    {
+        dest[i] = pattern[i % strlen(pattern)];
+    }
+    dest[size - 1] = '\0';
+}
+
+static void noCommand(const char *payload, unsigned int length)
+{
+}
+
+// The previous run reset in the section with the longest name, after a full
+// length URI, with every counter at its limit
+static void setupCrashDiag()
+{
+    uint8_t longest = 0;
+    for (uint8_t i = 0; i < PERF_SECTION_COUNT; i++)
+    {
+        if (strlen(getPerfSectionName((PerfSectionId)i)) > strlen(getPerfSectionName((PerfSectionId)longest)))
+        {
+            longest = i;
+        }
+    }
+    crashDiagBegin();
+    host::advanceMillis(UINT32_MAX);
+    crashDiagEnter(longest);
+    crashDiagExit(); // in_section: false
+    crashDiagLoop(UINT32_MAX);
+    crashDiagHeap(UINT32_MAX, UINT8_MAX, UINT16_MAX);
+    crashDiagUri("/api/sensors/tsl2561/reset");
+
+    // "Software/System restart" is the longest reset reason name
+    host::restart(REASON_SOFT_RESTART);
+    crashDiagBegin();
+    const_cast<RtcDiagRecord &>(getCurrentDiag()).boot_count = UINT32_MAX;
+
+    // A full event ring of the longest event name
+    for (int i = 0; i < DIAG_EVENT_CAPACITY; i++)
+    {
+        crashDiagEvent(DIAG_EVENT_WIFI_CONNECTED, UINT16_MAX);
+    }
+}
+
+// Counters that would take years to reach are set directly
+static void setupProfiler()
+{
+    for (int i = 0; i < PERF_SECTION_COUNT; i++)
+    {
+        PerfSection &section = const_cast<PerfSection &>(getPerfSection((PerfSectionId)i));
+        section.count = UINT32_MAX;
+        section.total_cycles = (uint64_t)UINT32_MAX * UINT32_MAX;
+        section.max_cycles = UINT32_MAX;
+        for (int b = 0; b < PERF_HISTOGRAM_BUCKETS; b++)
+        {
+            section.histogram[b] = UINT16_MAX;
+        }
+    }
+    PerfLoopStats &loop = const_cast<PerfLoopStats &>(getPerfLoopStats());
+    loop.count = UINT32_MAX;
+    loop.min_cycles = UINT32_MAX;
+    loop.max_cycles = UINT32_MAX;
+    loop.mean_us = 4294967040.0f; // Largest float below 2^32
+    loop.m2_us = 1.0e27f;
+}
+
+// Every phase and event slot used; names are literals held by pointer, so
+// only their length matters
+static void setupBootTiming()
+{
+    static const char *const phaseNames[BOOT_MAX_PHASES] = {
+        "phase-00-padded", "phase-01-padded", "phase-02-padded", "phase-03-padded",
+        "phase-04-padded", "phase-05-padded", "phase-06-padded", "phase-07-padded",
+        "phase-08-padded", "phase-09-padded", "phase-10-padded", "phase-11-padded"};
+    static const char *const eventNames[BOOT_MAX_EVENTS] = {
+        "event-00-padded", "event-01-padded", "event-02-padded", "event-03-padded",
+        "event-04-padded", "event-05-padded", "event-06-padded", "event-07-padded",
+        "event-08-padded", "event-09-padded", "event-10-padded", "event-11-padded"};
+    for (int i = 0; i < BOOT_MAX_PHASES; i++)
+    {
+        bootPhase(phaseNames[i]);
+        host::advanceMillis(UINT32_MAX / BOOT_MAX_PHASES);
+    }
+    bootFinished();
+    for (int i = 0; i < BOOT_MAX_EVENTS; i++)
+    {
+        bootEvent(eventNames[i]);
+    }
+
+    WifiConnectStats &wifi = const_cast<WifiConnectStats &>(getWifiConnectStats());
+    wifi.fast_path = false;
+    wifi.fast_path_attempted = false;
+    wifi.connect_ms = UINT32_MAX;
+    wifi.fast_fail_ms = UINT32_MAX;
+}
+
+static void setupHeapMonitor()
+{
+    for (int i = 0; i < HEAP_HISTORY_SIZE; i++)
+    {
+        heapMonitorSample();
+    }
+    HeapStats &stats = const_cast<HeapStats &>(getHeapStats());
+    stats.min_free = UINT32_MAX;
+    stats.min_max_block = UINT32_MAX;
+    stats.max_fragmentation = 100;
+    stats.min_free_cont_stack = UINT32_MAX;
+}
+
+// Formatted: a message of quotes, each escaped to two characters, cut at the
+// buffer size. Raw: every argument an unsigned integer at its widest
+static void setupLogEntry()
+{
+    static char quotes[2 * LOG_ENTRY_MESSAGE_BYTES];
+    memset(quotes, '"', sizeof(quotes) - 1);
+    worstLogEntry = LogEntry();
+    worstLogEntry.t_ms = UINT32_MAX;
+    worstLogEntry.fmt = quotes;
+    worstLogEntry.seq = UINT16_MAX;
+    worstLogEntry.category = LOG_CAT_GENERAL; // "general"
+    worstLogEntry.level = LOG_LEVEL_DEBUG;    // "debug"
+    worstLogEntry.argc = LOG_MAX_ARGS;
+    for (int i = 0; i < LOG_MAX_ARGS; i++)
+    {
+        worstLogEntry.types[i] = LOG_ARG_UINT;
+        worstLogEntry.args[i].raw = UINT32_MAX;
+    }
+}
+
+static void setupSensorStats()
+{
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        SensorMetrics &metrics = const_cast<SensorMetrics &>(getSensorMetrics((SensorId)i));
+        metrics.polls = UINT32_MAX;
+        metrics.readings = UINT32_MAX;
+        metrics.failures = UINT32_MAX;
+        metrics.last_reading_ms = UINT32_MAX;
+        metrics.max_poll_us = UINT32_MAX;
+
+        SensorSampling &sampling = const_cast<SensorSampling &>(getSensorSampling((SensorId)i));
+        sampling.period_ms = UINT32_MAX;
+        sampling.lag_max_ms = UINT32_MAX;
+        sampling.achieved_hz = -1234.5677f;
+
+        // FAILED adds retry_in_ms; the quotients keep ten digits each
+        SensorHealthState &health = const_cast<SensorHealthState &>(getSensorHealth((SensorId)i));
+        health.state = SENSOR_FAILED;
+        health.retry_at = millis() + INT32_MAX;
+        health.outages = UINT32_MAX;
+        health.recoveries = UINT32_MAX;
+        health.recovery_attempts = UINT32_MAX;
+        health.up_total_ms = (unsigned long)UINT32_MAX * UINT32_MAX;
+        health.down_total_ms = (unsigned long)UINT32_MAX * UINT32_MAX;
+    }
+}
+
+// Route dispatch counts can only grow by dispatching, so they stay at 0
+static void setupMqttStats()
+{
+    static const char *const routeFilters[MQTT_MAX_ROUTES] = {
+        "command/route-0-padded", "command/route-1-padded", "command/route-2-padded",
+        "command/route-3-padded", "command/route-4-padded", "command/route-5-padded",
+        "command/route-6-padded", "command/route-7-padded"};
+    for (int i = 0; i < MQTT_MAX_ROUTES; i++)
+    {
+        mqttRegisterRoute(routeFilters[i], noCommand);
+    }
+    host::setChipId(UINT32_MAX);
+
+    MqttConnectionStats &connection = const_cast<MqttConnectionStats &>(getMqttConnectionStats());
+    connection.attempts = UINT32_MAX;
+    connection.connects = UINT32_MAX;
+    connection.resumed_sessions = UINT32_MAX;
+    connection.dns_lookups = UINT32_MAX;
+    connection.dns_failures = UINT32_MAX;
+    connection.dns_fallbacks = UINT32_MAX;
+    connection.last_connect_ms = UINT32_MAX;
+    connection.first_connect_ms = UINT32_MAX;
+    connection.tls_heap_bytes = UINT32_MAX;
+
+    // The totals are unsigned long on the device too
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        PublishFilterState &state = const_cast<PublishFilterState &>(getPublishFilterState((PublishMetric)i));
+        state.published = UINT32_MAX / PUBLISH_METRIC_COUNT;
+        state.suppressed = UINT32_MAX / PUBLISH_METRIC_COUNT;
+    }
+
+    MqttQosStats &qos = const_cast<MqttQosStats &>(getMqttQosStats());
+    qos.sent = UINT32_MAX;
+    qos.acked = UINT32_MAX;
+    qos.retransmitted = UINT32_MAX;
+    qos.deferred = UINT32_MAX;
+    qos.fallback_qos0 = UINT32_MAX;
+    qos.unknown_acks = UINT32_MAX;
+    qos.max_ack_ms = UINT32_MAX;
+}
+
+static void setupDeviceStats()
+{
+    PowerStats &power = const_cast<PowerStats &>(getPowerStats());
+    power.idle_calls = UINT32_MAX;
+    power.busy_ms = UINT32_MAX;
+    power.modem_sleep_ms = UINT32_MAX;
+    power.light_sleep_ms = UINT32_MAX;
+    power.early_wakes = UINT32_MAX;
+    power.capped_waits = UINT32_MAX;
+    power.last_mode = POWER_IDLE_MODEM;
+    power.last_wait_ms = UINT32_MAX;
+
+#if ENABLE_LD2410_CAPTURE
+    Ld2410CaptureStats &capture = const_cast<Ld2410CaptureStats &>(getLd2410CaptureStats());
+    capture.sink = LD2410_CAPTURE_TO_FILE;
+    capture.started_ms = millis() - UINT32_MAX;
+    capture.bytes_rx = UINT32_MAX;
+    capture.bytes_tx = UINT32_MAX;
+    capture.records = UINT32_MAX;
+    capture.written = UINT32_MAX;
+    capture.dropped = UINT32_MAX;
+    capture.limit_reached = false;
+#endif
+
+    ConfigStoreStats &store = const_cast<ConfigStoreStats &>(getConfigStoreStats());
+    store.sequence = UINT32_MAX;
+    store.writes = UINT32_MAX;
+    store.skipped = UINT32_MAX;
+    store.loaded_version = UINT16_MAX;
+
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        PayloadStats &stats = const_cast<PayloadStats &>(getPayloadStats((PayloadId)i));
+        stats.max_bytes = UINT16_MAX;
+        stats.max_used = UINT16_MAX;
+        stats.overflows = UINT16_MAX;
+    }
+}
+
+void setupWorstCase()
+{
+    host::reset();
+    host::serialEcho(false);
+    setupCrashDiag();
+    setupProfiler();
+    setupBootTiming();
+    host::advanceMillis(UINT32_MAX);
+    host::setHeap(UINT32_MAX, UINT32_MAX, 100);
+    setupHeapMonitor();
+    setupLogEntry();
+    setupSensorStats();
+    setupMqttStats();
+    setupDeviceStats();
+
+    // Connected, so /health reports an address; the widest one
+    WiFi.config(IPAddress(255, 255, 255, 255), IPAddress(255, 255, 255, 254), IPAddress(255, 255, 255, 0));
+    WiFi.begin("budget", "budget");
+
+    // Distinct strings, so ArduinoJson's string deduplication can't share them
+    fill(config.location, sizeof(config.location), "location-");
+    fill(config.mqtt_broker, sizeof(config.mqtt_broker), "broker.");
+    fill(config.mqtt_username, sizeof(config.mqtt_username), "username_");
+    fill(config.mqtt_password, sizeof(config.mqtt_password), "password+");
+    deviceHostname = "esp8266-" + sanitizeLocation(String(config.location));
+    config.mqtt_port = 65535;
+    config.mqtt_enabled = false;
+    config.sensorless_mode = false;
+    config.use_dht = false;
+    config.use_tsl2561 = false;
+    config.use_pir = false;
+    config.use_ld2410 = true; // motion_source: "radar"
+    config.use_relay = false;
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        config.publish[i].deadband = -1234.5677f;
+        config.publish[i].rate_threshold = -1234.5677f;
+        config.publish[i].min_interval = UINT32_MAX;
+        config.publish[i].max_interval = UINT32_MAX;
+    }
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        config.sampling[i].min_ms = UINT32_MAX;
+        config.sampling[i].max_ms = UINT32_MAX;
+        config.sampling[i].change = -1234.5677f;
+    }
+    config.deep_sleep_enabled = false;
+    config.deep_sleep_interval_s = UINT16_MAX;
+    config.deep_sleep_flush_every = UINT8_MAX;
+
+    sensorData.temperature = -1234.5677f;
+    sensorData.humidity = -1234.5677f;
+    sensorData.lux = -1234.5677f;
+    sensorData.timestamp = UINT32_MAX;
+    sensorData.presence = false;
+    sensorData.radar_presence = false;
+    sensorData.radar_available = true;
+    sensorData.dht_available = false;
+    sensorData.tsl_available = false;
+    sensorData.pir_available = false;
+    sensorData.dht_error_count = INT32_MIN;
+    sensorData.tsl_error_count = INT32_MIN;
+    sensorData.pir_error_count = INT32_MIN;
+
+    sleepRingReset(worstRing);
+    worstRing.wake_count = UINT32_MAX;
+    worstRing.count = UINT16_MAX;
+    worstRing.dropped = UINT16_MAX;
+    worstRing.samples = 3;
+    worstRing.awake_ms = 1234567;
+    // Oldest sample at the wrap of the virtual clock, so age_s and t both
+    // take ten digits
+    worstRing.clock_s = UINT32_MAX;
+    for (int i = 0; i < RTC_SLEEP_RING_CAPACITY; i++)
+    {
+        worstRing.data[i].t_s = 0;
+        worstRing.data[i].temperature_c10 = INT16_MIN + 1;
+        worstRing.data[i].humidity_c10 = INT16_MIN + 1;
+        worstRing.data[i].lux_c10 = UINT32_MAX;
+    }
+}
+
+PayloadMeasurement measurePayload(PayloadId id)
+{
+    const Payload &payload = payloads[id];
+    PayloadMeasurement result = {};
+    DynamicJsonDocument doc(getPayloadCapacity(id));
+    payload.build(doc);
+    String output;
+    serializePayload(id, doc, output, payload.pretty);
+    result.bytes = output.length();
+    result.used = doc.memoryUsage();
+    result.capacity = doc.capacity();
+    result.overflowed = doc.overflowed();
+    if (payload.topic)
+    {
+        result.packet = mqttQos1PacketSize(getTopicWithLocation(payload.topic).length(), result.bytes);
+    }
+    return result;
+}
+
+static long parseLimit(const char *field)
+{
+    return strcmp(field, "-") == 0 ? -1 : atol(field);
+}
+
+std::vector<PayloadBudget> loadPayloadBudgets(const std::string &path)
+{
+    std::vector<PayloadBudget> budgets;
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file)
+    {
+        return budgets;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[32], bytes[16], used[16];
+        if (line[0] == '#' || sscanf(line, "%31s %15s %15s", name, bytes, used) != 3)
+        {
+            continue;
+        }
+        PayloadBudget budget;
+        budget.name = name;
+        budget.bytes = parseLimit(bytes);
+        budget.used = parseLimit(used);
+        budgets.push_back(budget);
+    }
+    fclose(file);
+    return budgets;
+}
+
+const PayloadBudget *findPayloadBudget(const std::vector<PayloadBudget> &budgets, const char *name)
+{
+    for (const PayloadBudget &budget : budgets)
+    {
+        if (budget.name == name)
+        {
+            return &budget;
+        }
+    }
+    return nullptr;
+}
+
+bool writePayloadBudgets(const std::string &path, const PayloadMeasurement *results)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+    fprintf(file, "# Payload budgets checked by host/PayloadBudget (env:payload_budget, and\n"
+                  "# test/test_payload_budget in env:native).\n"
+                  "# bytes: serialized size, used: JsonDocument memoryUsage() on the host;\n"
+                  "# '-' is not checked.\n"
+                  "# name            bytes  used\n");
+    for (size_t i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        fprintf(file, "%-16s  %5ld  %4ld\n", getPayloadName((PayloadId)i), results[i].bytes, results[i].used);
+    }
+    fclose(file);
+    return true;
+}
+
+bool checkPayloadLimits(PayloadId id, const PayloadMeasurement &result)
+{
+    const char *name = getPayloadName(id);
+    bool ok = true;
+    if (result.overflowed)
+    {
+        fprintf(stderr, "[payload_budget] %s: document overflowed its %zu bytes\n", name, result.capacity);
+        ok = false;
+    }
+    if (result.packet > MQTT_QOS1_MAX_PACKET)
+    {
+        fprintf(stderr, "[payload_budget] %s: %zu byte packet exceeds MQTT_QOS1_MAX_PACKET (%d)\n", name,
+                result.packet, MQTT_QOS1_MAX_PACKET);
+        ok = false;
+    }
+    return ok;
+}
+
+// Prints the problem and returns false if value is over a set limit
+static bool withinBudget(const char *name, const char *what, long value, long limit)
+{
+    if (limit >= 0 && value > limit)
+    {
+        fprintf(stderr, "[payload_budget] %s: %s %ld over budget %ld\n", name, what, value, limit);
+        return false;
+    }
+    return true;
+}
+
+bool checkPayloadBudget(PayloadId id, const PayloadMeasurement &result, const PayloadBudget *budget)
+{
+    const char *name = getPayloadName(id);
+    if (!budget)
+    {
+        fprintf(stderr, "[payload_budget] %s: no budget (run the payload_budget program with --update)\n", name);
+        return false;
+    }
+    bool ok = withinBudget(name, "bytes", result.bytes, budget->bytes);
+    ok &= withinBudget(name, "used", result.used, budget->used);
+    return ok;
+}
+
+// Prints the problem and returns false if body does not parse into capacity
+static bool requestFits(const char *name, size_t capacity, const std::string &body)
+{
+    DynamicJsonDocument doc(capacity);
+    DeserializationError error = deserializeJson(doc, body);
+    if (error)
+    {
+        fprintf(stderr, "[payload_budget] %s request: %s parsing %zu bytes into %zu\n", name, error.c_str(),
+                body.size(), capacity);
+        return false;
+    }
+    return true;
+}
+
+bool checkRequestCapacities()
+{
+    bool ok = true;
+#if ENABLE_LOG_RING
+    // Every category at a different level, so no string is shared
+    static const uint8_t levels[] = {LOG_LEVEL_ERROR, LOG_LEVEL_WARN, LOG_LEVEL_INFO, LOG_LEVEL_DEBUG,
+                                     LOG_LEVEL_NONE};
+    std::string logs = "{\"serial\": true, \"levels\": {";
+    for (uint8_t i = 0; i < LOG_CAT_COUNT; i++)
+    {
+        logs += std::string(i ? ", \"" : "\"") + getLogCategoryName(i) + "\": \"" +
+                getLogLevelName(levels[i % sizeof(levels)]) + "\"";
+    }
+    logs += "}}";
+    ok &= requestFits("logs", JSON_CAPACITY_LOG_SETTINGS, logs);
+#endif
+#if ENABLE_LD2410_CAPTURE
+    std::string capture = "{\"action\": \"start\", \"host\": \"" + std::string(LD2410_CAPTURE_HOST_BYTES, 'h') +
+                          "\", \"port\": 65535}";
+    ok &= requestFits("ld2410_capture", JSON_CAPACITY_LD2410_CAPTURE_REQUEST, capture);
+#endif
+    return ok;
+}
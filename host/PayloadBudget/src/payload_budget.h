@@ -0,0 +1,44 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "comm/payloads.h"
+
+// Worst-case payload measurements shared by the payload_budget program and
+// the native unit tests (test/test_payload_budget).
+
+#define PAYLOAD_BUDGET_FILE "host/PayloadBudget/budgets.txt"
+
+struct PayloadMeasurement
+{
+    long bytes;
+    long used;
+    size_t capacity;
+    bool overflowed;
+    size_t packet; // QoS 1 PUBLISH packet, 0 for HTTP
+};
+
+// Budget columns; -1 is '-' in the file, not enforced
+struct PayloadBudget
+{
+    std::string name;
+    long bytes = -1;
+    long used = -1;
+};
+
+// Puts every module in the state that makes each payload its largest
+void setupWorstCase();
+PayloadMeasurement measurePayload(PayloadId id);
+
+std::vector<PayloadBudget> loadPayloadBudgets(const std::string &path);
+const PayloadBudget *findPayloadBudget(const std::vector<PayloadBudget> &budgets, const char *name);
+bool writePayloadBudgets(const std::string &path, const PayloadMeasurement *results);
+
+// Prints each problem to stderr and returns false if there is any: an
+// overflowed document, an MQTT packet over MQTT_QOS1_MAX_PACKET, a missing
+// budget or a figure over it.
+bool checkPayloadLimits(PayloadId id, const PayloadMeasurement &result);
+bool checkPayloadBudget(PayloadId id, const PayloadMeasurement &result, const PayloadBudget *budget);
+// Parses the largest valid body of each request into its JSON_CAPACITY_*
+// document; false, with the problem on stderr, if one does not fit
+bool checkRequestCapacities();
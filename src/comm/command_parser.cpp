@@ -0,0 +1,316 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "comm/command_parser.h"
+#include "comm/publish_filter.h"
+#include "model/config_manager.h"
+#include "sensors/sensor_manager.h"
+#include "sensors/sensor_sampling.h"
+#include "power/deep_sleep.h"
+
+// Wrong-typed strings would come back as nullptr and crash strlcpy()
+static bool readString(JsonVariantConst value, char *dest, size_t size)
+{
+    if (!value.is<const char *>())
+    {
+        return false;
+    }
+    strlcpy(dest, value.as<const char *>(), size);
+    return true;
+}
+
+// true/false, or a number where 0 is false
+static bool readFlag(JsonVariantConst value, bool &dest)
+{
+    if (value.is<bool>())
+    {
+        dest = value.as<bool>();
+    }
+    else if (value.is<long>())
+    {
+        dest = value.as<long>() != 0;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool readFlagSetting(JsonObjectConst settings, const char *key, bool &dest, bool &found)
+{
+    JsonVariantConst value = settings[key];
+    if (value.isNull())
+    {
+        return true;
+    }
+    found = true;
+    return readFlag(value, dest);
+}
+
+static bool readStringSetting(JsonObjectConst settings, const char *key, char *dest, size_t size, bool &found)
+{
+    JsonVariantConst value = settings[key];
+    if (value.isNull())
+    {
+        return true;
+    }
+    found = true;
+    return readString(value, dest, size);
+}
+
+static ConfigPatchStatus applyPublishThresholds(JsonVariantConst publish, ConfigData &patched)
+{
+    if (!publish.is<JsonObjectConst>())
+    {
+        return CONFIG_PATCH_INVALID_VALUE;
+    }
+    for (JsonPairConst entry : publish.as<JsonObjectConst>())
+    {
+        int metric = findPublishMetric(entry.key().c_str());
+        if (metric < 0)
+        {
+            continue;
+        }
+        JsonObjectConst values = entry.value().as<JsonObjectConst>();
+        PublishThreshold &threshold = patched.publish[metric];
+        threshold.deadband = values["deadband"] | threshold.deadband;
+        threshold.rate_threshold = values["rate_threshold"] | threshold.rate_threshold;
+        threshold.min_interval = values["min_interval"] | threshold.min_interval;
+        threshold.max_interval = values["max_interval"] | threshold.max_interval;
+    }
+    return validatePublishThresholds(patched.publish) ? CONFIG_PATCH_APPLIED : CONFIG_PATCH_INVALID_PUBLISH;
+}
+
+static ConfigPatchStatus applySampling(JsonVariantConst sampling, ConfigData &patched)
+{
+    if (!sampling.is<JsonObjectConst>())
+    {
+        return CONFIG_PATCH_INVALID_VALUE;
+    }
+    for (JsonPairConst entry : sampling.as<JsonObjectConst>())
+    {
+        int sensor = findSensor(entry.key().c_str());
+        if (sensor < 0)
+        {
+            continue;
+        }
+        JsonObjectConst values = entry.value().as<JsonObjectConst>();
+        SamplingConfig &period = patched.sampling[sensor];
+        period.min_ms = values["min_ms"] | period.min_ms;
+        period.max_ms = values["max_ms"] | period.max_ms;
+        period.change = values["change"] | period.change;
+    }
+    return validateSampling(patched.sampling) ? CONFIG_PATCH_APPLIED : CONFIG_PATCH_INVALID_SAMPLING;
+}
+
+static ConfigPatchStatus applyDeepSleep(JsonVariantConst deepSleep, ConfigData &patched)
+{
+    if (!deepSleep.is<JsonObjectConst>())
+    {
+        return CONFIG_PATCH_INVALID_VALUE;
+    }
+    JsonObjectConst values = deepSleep.as<JsonObjectConst>();
+    unsigned long interval = values["interval_s"] | (unsigned long)patched.deep_sleep_interval_s;
+    unsigned long flushEvery = values["flush_every"] | (unsigned long)patched.deep_sleep_flush_every;
+    if (interval > UINT16_MAX || flushEvery > UINT8_MAX)
+    {
+        return CONFIG_PATCH_INVALID_DEEP_SLEEP;
+    }
+    if (!values["enabled"].isNull() && !readFlag(values["enabled"], patched.deep_sleep_enabled))
+    {
+        return CONFIG_PATCH_INVALID_VALUE;
+    }
+    patched.deep_sleep_interval_s = interval;
+    patched.deep_sleep_flush_every = flushEvery;
+    return validateDeepSleep(patched) ? CONFIG_PATCH_APPLIED : CONFIG_PATCH_INVALID_DEEP_SLEEP;
+}
+
+ConfigPatchStatus applyConfigPatch(const char *json, size_t length, ConfigData &target)
+{
+    DynamicJsonDocument doc(CONFIG_PATCH_JSON_CAPACITY);
+    if (deserializeJson(doc, json, length) || !doc.is<JsonObject>())
+    {
+        return CONFIG_PATCH_INVALID_JSON;
+    }
+    JsonObjectConst settings = doc.as<JsonObjectConst>();
+
+    ConfigData patched = target;
+    bool found = false;
+    bool valid = readStringSetting(settings, "mqtt_broker", patched.mqtt_broker, sizeof(patched.mqtt_broker), found) &&
+                 readStringSetting(settings, "mqtt_username", patched.mqtt_username, sizeof(patched.mqtt_username), found) &&
+                 readStringSetting(settings, "mqtt_password", patched.mqtt_password, sizeof(patched.mqtt_password), found) &&
+                 readStringSetting(settings, "location", patched.location, sizeof(patched.location), found) &&
+                 readFlagSetting(settings, "mqtt_enabled", patched.mqtt_enabled, found) &&
+                 readFlagSetting(settings, "sensorless_mode", patched.sensorless_mode, found) &&
+                 readFlagSetting(settings, "use_dht", patched.use_dht, found) &&
+                 readFlagSetting(settings, "use_tsl2561", patched.use_tsl2561, found) &&
+                 readFlagSetting(settings, "use_pir", patched.use_pir, found) &&
+                 readFlagSetting(settings, "use_ld2410", patched.use_ld2410, found) &&
+                 readFlagSetting(settings, "use_relay", patched.use_relay, found);
+    if (!valid)
+    {
+        return CONFIG_PATCH_INVALID_VALUE;
+    }
+
+    JsonVariantConst port = settings["mqtt_port"];
+    if (!port.isNull())
+    {
+        if (!port.is<long>() || port.as<long>() < 1 || port.as<long>() > 65535)
+        {
+            return CONFIG_PATCH_INVALID_VALUE;
+        }
+        patched.mqtt_port = port.as<long>();
+        found = true;
+    }
+
+    // e.g. {"publish": {"temperature": {"deadband": 1.0}}}
+    if (!settings["publish"].isNull())
+    {
+        ConfigPatchStatus status = applyPublishThresholds(settings["publish"], patched);
+        if (status != CONFIG_PATCH_APPLIED)
+        {
+            return status;
+        }
+        found = true;
+    }
+
+    // e.g. {"sampling": {"ld2410": {"min_ms": 100, "max_ms": 1000, "change": 0.5}}}
+    if (!settings["sampling"].isNull())
+    {
+        ConfigPatchStatus status = applySampling(settings["sampling"], patched);
+        if (status != CONFIG_PATCH_APPLIED)
+        {
+            return status;
+        }
+        found = true;
+    }
+
+    // e.g. {"deep_sleep": {"enabled": true, "interval_s": 300, "flush_every": 6}};
+    // takes effect on the next boot
+    if (!settings["deep_sleep"].isNull())
+    {
+        ConfigPatchStatus status = applyDeepSleep(settings["deep_sleep"], patched);
+        if (status != CONFIG_PATCH_APPLIED)
+        {
+            return status;
+        }
+        found = true;
+    }
+
+    if (!found)
+    {
+        return CONFIG_PATCH_EMPTY;
+    }
+    applyBuildProfile(patched);
+    target = patched;
+    return CONFIG_PATCH_APPLIED;
+}
+
+const char *getConfigPatchError(ConfigPatchStatus status)
+{
+    switch (status)
+    {
+    case CONFIG_PATCH_EMPTY:
+        return "No valid configuration parameters provided";
+    case CONFIG_PATCH_INVALID_JSON:
+        return "Invalid JSON";
+    case CONFIG_PATCH_INVALID_VALUE:
+        return "Invalid configuration value";
+    case CONFIG_PATCH_INVALID_PUBLISH:
+        return "Invalid publish thresholds";
+    case CONFIG_PATCH_INVALID_DEEP_SLEEP:
+        return "Invalid deep sleep settings";
+    case CONFIG_PATCH_INVALID_SAMPLING:
+        return "Invalid sampling settings";
+    default:
+        return "";
+    }
+}
+
+bool parseEnabledFlag(const char *json, size_t length, bool &enabled)
+{
+    StaticJsonDocument<COMMAND_JSON_CAPACITY> doc;
+    if (deserializeJson(doc, json, length))
+    {
+        return false;
+    }
+    JsonVariantConst value = doc.as<JsonObjectConst>()["enabled"];
+    return !value.isNull() && readFlag(value, enabled);
+}
+
+// Case-insensitive whole-payload match without needing a terminator
+static bool payloadIs(const char *message, size_t length, const char *word)
+{
+    return strlen(word) == length && strncasecmp(message, word, length) == 0;
+}
+
+RelayCommand parseRelayCommand(const char *message, size_t length)
+{
+    if (payloadIs(message, length, "toggle"))
+    {
+        return RELAY_COMMAND_TOGGLE;
+    }
+    if (payloadIs(message, length, "on") || payloadIs(message, length, "1") || payloadIs(message, length, "true"))
+    {
+        return RELAY_COMMAND_ON;
+    }
+    if (payloadIs(message, length, "off") || payloadIs(message, length, "0") || payloadIs(message, length, "false"))
+    {
+        return RELAY_COMMAND_OFF;
+    }
+
+    StaticJsonDocument<COMMAND_JSON_CAPACITY> doc;
+    if (deserializeJson(doc, message, length))
+    {
+        return RELAY_COMMAND_INVALID;
+    }
+
+    JsonObjectConst root = doc.as<JsonObjectConst>();
+    bool state;
+    JsonVariantConst command = root["command"];
+    if (!command.isNull())
+    {
+        const char *name = command | "";
+        if (strcmp(name, "toggle") == 0)
+        {
+            return RELAY_COMMAND_TOGGLE;
+        }
+        // Unknown commands, or "set" without a state, leave the relay alone
+        if (strcmp(name, "set") != 0 || !readFlag(root["state"], state))
+        {
+            return RELAY_COMMAND_INVALID;
+        }
+        return state ? RELAY_COMMAND_ON : RELAY_COMMAND_OFF;
+    }
+    // Direct state setting for backward compatibility
+    if (readFlag(root["state"], state))
+    {
+        return state ? RELAY_COMMAND_ON : RELAY_COMMAND_OFF;
+    }
+    return RELAY_COMMAND_INVALID;
+}
+
+RelayCommand parseRelayRequest(const char *json, size_t length)
+{
+    if (length == 0)
+    {
+        return RELAY_COMMAND_TOGGLE;
+    }
+    StaticJsonDocument<COMMAND_JSON_CAPACITY> doc;
+    if (deserializeJson(doc, json, length))
+    {
+        return RELAY_COMMAND_INVALID;
+    }
+    JsonVariantConst value = doc.as<JsonObjectConst>()["state"];
+    if (value.isNull())
+    {
+        return RELAY_COMMAND_TOGGLE;
+    }
+    bool state;
+    if (!readFlag(value, state))
+    {
+        return RELAY_COMMAND_INVALID;
+    }
+    return state ? RELAY_COMMAND_ON : RELAY_COMMAND_OFF;
+}
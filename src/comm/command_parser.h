@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include "model/data_structs.h"
+
+// Parsers for untrusted HTTP request bodies and MQTT command payloads. They
+// depend on neither the web server nor the MQTT client, so host/Fuzz drives
+// them directly. Input is (pointer, length) and need not be NUL-terminated.
+
+#define CONFIG_PATCH_JSON_CAPACITY 1024
+#define COMMAND_JSON_CAPACITY 128
+
+enum ConfigPatchStatus : uint8_t
+{
+    CONFIG_PATCH_APPLIED,
+    CONFIG_PATCH_EMPTY,        // Valid JSON without any known setting
+    CONFIG_PATCH_INVALID_JSON,
+    CONFIG_PATCH_INVALID_VALUE, // A known setting with the wrong type or out of range
+    CONFIG_PATCH_INVALID_PUBLISH,
+    CONFIG_PATCH_INVALID_DEEP_SLEEP,
+    CONFIG_PATCH_INVALID_SAMPLING
+};
+
+enum RelayCommand : uint8_t
+{
+    RELAY_COMMAND_INVALID,
+    RELAY_COMMAND_OFF,
+    RELAY_COMMAND_ON,
+    RELAY_COMMAND_TOGGLE
+};
+
+// /api/config POST. The patch is applied to a copy and written back only if
+// every setting in it is valid, so a rejected request changes nothing.
+ConfigPatchStatus applyConfigPatch(const char *json, size_t length, ConfigData &target);
+const char *getConfigPatchError(ConfigPatchStatus status);
+
+// {"enabled": true}, as taken by /api/sensorless and /api/debug
+bool parseEnabledFlag(const char *json, size_t length, bool &enabled);
+
+// MQTT relay/command: ON/OFF, 1/0, true/false, toggle, or JSON
+// {"command": "toggle"}, {"command": "set", "state": true}, {"state": true}
+RelayCommand parseRelayCommand(const char *message, size_t length);
+
+// /api/relay POST: {"state": true}; an empty body or one without "state" toggles
+RelayCommand parseRelayRequest(const char *json, size_t length);
@@ -8,38 +8,178 @@
 #include <ESP8266WiFi.h>
 #include "sensors/sensor_manager.h"
 #include "actuators/relay.h"
-
+#include "comm/publish_filter.h"
+#include "comm/mqtt_qos.h"
+#include "comm/mqtt_tap.h"
+#include "comm/mqtt_router.h"
+#include "comm/command_parser.h"
+#include "comm/payloads.h"
+#include "debug/boot_timing.h"
+#include "power/deep_sleep.h"
+#include "debug/profiler.h"
+#include "debug/heap_monitor.h"
+#include "debug/crash_diag.h"
+
+#if MQTT_USE_TLS
+#include <WiFiClientSecureBearSSL.h>
+BearSSL::WiFiClientSecure espClient;
+static BearSSL::Session tlsSession;
+static bool mflnProbed = false;
+#else
 WiFiClient espClient;
-PubSubClient mqttClient(espClient);
+#endif
+MqttClientTap mqttTransport(espClient);
+PubSubClient mqttClient(mqttTransport);
 bool mqttConnected = false;
 unsigned long lastMqttPublish = 0;
 
+static MqttConnectionStats connectionStats;
+static unsigned long lastConnectAttempt = 0;
+
+// Broker address cache: PubSubClient would otherwise resolve the hostname on
+// every connect attempt
+static char resolvedBrokerName[sizeof(config.mqtt_broker)] = "";
+static IPAddress resolvedBrokerIP;
+static unsigned long resolvedBrokerAt = 0;
+static bool brokerResolved = false;
+
+static bool resolveBroker(IPAddress &address)
+{
+    unsigned long now = millis();
+
+    if (strcmp(resolvedBrokerName, config.mqtt_broker) != 0)
+    {
+        // Broker changed through the config API; forget the old address
+        strlcpy(resolvedBrokerName, config.mqtt_broker, sizeof(resolvedBrokerName));
+        brokerResolved = false;
+    }
+
+    // Literal addresses never need DNS
+    if (address.fromString(config.mqtt_broker))
+    {
+        return true;
+    }
+
+    if (brokerResolved && now - resolvedBrokerAt < MQTT_DNS_CACHE_TTL)
+    {
+        address = resolvedBrokerIP;
+        return true;
+    }
+
+    IPAddress fresh;
+    connectionStats.dns_lookups++;
+    if (WiFi.hostByName(config.mqtt_broker, fresh) == 1)
+    {
+        resolvedBrokerIP = fresh;
+        resolvedBrokerAt = now;
+        brokerResolved = true;
+        address = fresh;
+        return true;
+    }
+
+    connectionStats.dns_failures++;
+    if (brokerResolved)
+    {
+        // DNS is down but the broker probably has not moved
+        MQTT_WARN_PRINTLN(LOG_LITERAL("DNS lookup failed, using last known broker address"));
+        connectionStats.dns_fallbacks++;
+        address = resolvedBrokerIP;
+        return true;
+    }
+    return false;
+}
+
+static void invalidateBrokerAddress()
+{
+    // Re-resolve on the next attempt but keep the old address as fallback
+    resolvedBrokerAt = millis() - MQTT_DNS_CACHE_TTL;
+}
+
+#if MQTT_USE_TLS
+static void setupTLS()
+{
+    if (strlen(MQTT_TLS_FINGERPRINT) > 0)
+    {
+        espClient.setFingerprint(MQTT_TLS_FINGERPRINT);
+    }
+    else
+    {
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("WARNING: MQTT TLS without certificate pinning"));
+        espClient.setInsecure();
+    }
+
+    // Reconnects present the cached session and skip the full handshake
+    espClient.setSession(&tlsSession);
+}
+
+static void negotiateTLSBuffers(const IPAddress &brokerIP)
+{
+    if (mflnProbed)
+    {
+        return;
+    }
+
+    // Without MFLN the receive buffer must hold a full 16 KB record
+    connectionStats.mfln_supported = espClient.probeMaxFragmentLength(brokerIP, config.mqtt_port, MQTT_TLS_BUFFER_SIZE);
+    if (connectionStats.mfln_supported)
+    {
+        espClient.setBufferSizes(MQTT_TLS_BUFFER_SIZE, MQTT_TLS_BUFFER_SIZE);
+    }
+    MQTT_DEBUG_PRINTF("TLS max fragment length %s\n", connectionStats.mfln_supported ? "supported" : "not supported");
+    mflnProbed = true;
+}
+#endif
+
+String getMqttClientId()
+{
+    // Stable across reboots so the broker can resume the persistent session
+    return String(MQTT_CLIENT_ID) + "-" + String(ESP.getChipId(), HEX);
+}
+
 void setupMQTT()
 {
     if (!config.mqtt_enabled)
     {
-        MQTT_DEBUG_PRINTLN("MQTT disabled in configuration");
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("MQTT disabled in configuration"));
         return;
     }
 
-    MQTT_DEBUG_PRINTLN("Setting up MQTT...");
+    MQTT_DEBUG_PRINTLN(LOG_LITERAL("Setting up MQTT..."));
 
-    // Set MQTT server and callback
-    mqttClient.setServer(config.mqtt_broker, config.mqtt_port);
+    // Set MQTT callback; the server address is resolved on each connect
     mqttClient.setCallback(mqttCallback);
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE);
+#if MQTT_USE_TLS
+    setupTLS();
+#endif
+
+    // Register inbound commands once; subscriptions follow the route table
+    static bool routesRegistered = false;
+    if (!routesRegistered)
+    {
+#if USE_RELAY
+        mqttRegisterRoute(MQTT_TOPIC_RELAY_COMMAND, handleRelayPayload, relayCommandsEnabled);
+#endif
+        mqttRegisterRoute(MQTT_TOPIC_COMMAND_PUBLISH, handlePublishNowCommand);
+#if ENABLE_DEEP_SLEEP
+        mqttRegisterRoute(MQTT_TOPIC_COMMAND_DEEP_SLEEP, handleDeepSleepCommand);
+#endif
+        routesRegistered = true;
+    }
 
     // Set buffer size for larger messages
-    mqttClient.setBufferSize(512);
+    mqttClient.setBufferSize(MQTT_QOS1_MAX_PACKET);
+    mqttTransport.setPubackCallback(mqttHandlePuback);
 
-    MQTT_DEBUG_PRINT("MQTT broker: ");
+    MQTT_DEBUG_PRINT(LOG_LITERAL("MQTT broker: "));
     MQTT_DEBUG_PRINT(config.mqtt_broker);
-    MQTT_DEBUG_PRINT(":");
+    MQTT_DEBUG_PRINT(LOG_LITERAL(":"));
     MQTT_DEBUG_PRINTLN(config.mqtt_port);
-    MQTT_DEBUG_PRINT("Location: ");
+    MQTT_DEBUG_PRINT(LOG_LITERAL("Location: "));
     MQTT_DEBUG_PRINTLN(config.location);
 
-    // Try to connect
-    connectMQTT();
+    // The first connect happens from maintainMQTT() in loop(), so a slow
+    // broker does not hold up the rest of setup()
 }
 
 bool connectMQTT()
@@ -47,36 +187,113 @@ bool connectMQTT()
     if (!config.mqtt_enabled)
         return false;
 
-    MQTT_DEBUG_PRINT("Connecting to MQTT broker...");
+    MQTT_DEBUG_PRINTLN(LOG_LITERAL("Connecting to MQTT broker..."));
 
-    // Create a random client ID
-    String clientId = String(MQTT_CLIENT_ID) + "-" + String(random(0xffff), HEX);
+    unsigned long start = millis();
+    lastConnectAttempt = start;
+    connectionStats.attempts++;
 
-    // Attempt to connect
-    if (mqttClient.connect(clientId.c_str(), config.mqtt_username, config.mqtt_password))
+    IPAddress brokerIP;
+    if (!resolveBroker(brokerIP))
     {
-        MQTT_DEBUG_PRINTLN(" connected!");
+        MQTT_ERROR_PRINTLN(LOG_LITERAL("MQTT connect failed, broker name not resolved"));
+        mqttConnected = false;
+        return false;
+    }
+    mqttClient.setServer(brokerIP, config.mqtt_port);
+#if MQTT_USE_TLS
+    negotiateTLSBuffers(brokerIP);
+    uint32_t heapBefore = ESP.getFreeHeap();
+#endif
+
+    String clientId = getMqttClientId();
+    String statusTopic = getTopicWithLocation(MQTT_TOPIC_STATUS);
+
+    // Persistent session (clean session off) with an "offline" last will
+    if (mqttClient.connect(clientId.c_str(), config.mqtt_username, config.mqtt_password,
+                           statusTopic.c_str(), 1, true, "offline", false))
+    {
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("MQTT connected"));
         mqttConnected = true;
+        lastConnectAttempt = 0; // Retry immediately after the next drop
+        connectionStats.connects++;
+        connectionStats.last_connect_ms = millis() - start;
+        connectionStats.session_present = mqttTransport.sessionPresent();
+#if MQTT_USE_TLS
+        connectionStats.tls_heap_bytes = heapBefore - ESP.getFreeHeap();
+#endif
+        if (connectionStats.connects == 1)
+        {
+            connectionStats.first_connect_ms = connectionStats.last_connect_ms;
+        }
 
-        // Subscribe to command topics
-        if (USE_RELAY)
+        // A resumed session still holds our subscriptions, unless the
+        // location or the enabled routes changed since it was created
+        if (connectionStats.session_present)
         {
-            mqttClient.subscribe(getTopicWithLocation(MQTT_TOPIC_RELAY_COMMAND).c_str());
+            connectionStats.resumed_sessions++;
         }
+        mqttSyncSubscriptions(connectionStats.session_present);
+
+        // Resend anything the broker never acknowledged before the drop
+        mqttRetransmitInflight();
+
+        // Retained, so it replaces the "offline" will the broker may have sent
+        mqttClient.publish(statusTopic.c_str(), "online", true);
 
-        // Publish initial status
-        mqttClient.publish(getTopicWithLocation(MQTT_TOPIC_STATUS).c_str(), "online");
+        // The broker may have missed values while we were away; publish a
+        // full snapshot on the next loop pass instead of waiting an interval
+        resetPublishFilters();
+        lastMqttPublish = millis() - MQTT_PUBLISH_INTERVAL;
+        bootEvent("mqtt_connected");
+#if ENABLE_CRASH_DIAG
+        crashDiagEvent(DIAG_EVENT_MQTT_CONNECTED);
+        publishResetDiagnostics();
+#endif
 
         return true;
     }
     else
     {
-        MQTT_DEBUG_PRINTF(" failed, rc=%d\n", mqttClient.state());
+        MQTT_ERROR_PRINTF("MQTT connect failed, rc=%d\n", mqttClient.state());
+#if ENABLE_CRASH_DIAG
+        crashDiagEvent(DIAG_EVENT_MQTT_FAILED, (uint16_t)mqttClient.state());
+#endif
         mqttConnected = false;
+        // Only a failed TCP connect suggests a stale address; the broker
+        // answering with a refusal (rc > 0, e.g. bad credentials) does not
+        if (mqttClient.state() == MQTT_CONNECT_FAILED)
+        {
+            invalidateBrokerAddress();
+        }
         return false;
     }
 }
 
+void maintainMQTT()
+{
+    if (config.mqtt_enabled && !mqttClient.connected())
+    {
+        mqttConnected = false;
+        bool due = lastConnectAttempt == 0 || millis() - lastConnectAttempt >= MQTT_RECONNECT_INTERVAL;
+        if (due && WiFi.status() == WL_CONNECTED)
+        {
+            connectMQTT();
+        }
+    }
+    else if (mqttClient.connected())
+    {
+        // Location or use_relay changed through the config API
+        mqttSyncSubscriptions(true);
+    }
+    mqttClient.loop();
+}
+
+const MqttConnectionStats &getMqttConnectionStats()
+{
+    return connectionStats;
+}
+
 void subscribe(char *topic)
 {
     mqttClient.subscribe(getTopicWithLocation(topic).c_str());
@@ -86,70 +303,41 @@ void mqttCallback(char *topic, byte *payload, unsigned int length)
 {
     MQTT_DEBUG_PRINTF("Message arrived on topic: %s\n", topic);
 
-    // Convert payload to string
-    char message[length + 1];
-    memcpy(message, payload, length);
-    message[length] = '\0';
-
-    MQTT_DEBUG_PRINTF("Message: %s\n", message);
-
-    // Check if this is a relay command
-    String topicStr = String(topic);
-    String relayCommandTopic = getTopicWithLocation(MQTT_TOPIC_RELAY_COMMAND);
-
-    if (topicStr == relayCommandTopic)
+    if (!mqttDispatch(topic, payload, length))
     {
-        handleRelayCommand(message);
-        return;
+        MQTT_DEBUG_PRINTF("No handler for topic: %s\n", topic);
     }
+}
 
-    // Handle other topics if needed
-    // Example: if (String(topic) == "sensors/command") { ... }
+void handlePublishNowCommand(const char *payload, unsigned int length)
+{
+    // Publish everything on the next loop pass, bypassing suppression
+    resetPublishFilters();
+    lastMqttPublish = millis() - MQTT_PUBLISH_INTERVAL;
+}
+
+#if USE_RELAY
+bool relayCommandsEnabled()
+{
+    return config.use_relay;
+}
+
+void handleRelayPayload(const char *payload, unsigned int length)
+{
+    handleRelayCommand(payload);
 }
 
 void handleRelayCommand(const char *message)
 {
     MQTT_DEBUG_PRINTF("Processing relay command: %s\n", message);
 
-    DynamicJsonDocument doc(128);
-    DeserializationError error = deserializeJson(doc, message);
-
-    if (error)
+    RelayCommand command = parseRelayCommand(message, strlen(message));
+    if (command == RELAY_COMMAND_INVALID)
     {
-        MQTT_DEBUG_PRINTF("Failed to parse relay command JSON: %s\n", error.c_str());
+        MQTT_DEBUG_PRINT(LOG_LITERAL("Invalid relay command format\n"));
         return;
     }
-
-    bool newState = false;
-    bool shouldToggle = false;
-
-    if (doc.containsKey("command"))
-    {
-        String command = doc["command"];
-        if (command == "toggle")
-        {
-            shouldToggle = true;
-        }
-        else if (command == "set" && doc.containsKey("state"))
-        {
-            newState = doc["state"];
-        }
-    }
-    else if (doc.containsKey("state"))
-    {
-        // Direct state setting for backward compatibility
-        newState = doc["state"];
-    }
-    else
-    {
-        MQTT_DEBUG_PRINT("Invalid relay command format\n");
-        return;
-    }
-
-    if (shouldToggle)
-    {
-        newState = !getRelayState();
-    }
+    bool newState = command == RELAY_COMMAND_TOGGLE ? !getRelayState() : command == RELAY_COMMAND_ON;
 
     // Set the relay state
     setRelayState(newState);
@@ -160,95 +348,192 @@ void handleRelayCommand(const char *message)
     MQTT_DEBUG_PRINTF("Relay set to: %s\n", newState ? "ON" : "OFF");
 }
 
-void publishRelayState()
+bool publishRelayState()
 {
     if (!mqttClient.connected())
     {
-        MQTT_DEBUG_PRINTLN("MQTT not connected, skipping publish");
-        return;
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("MQTT not connected, skipping publish"));
+        return false;
     }
 
-    DynamicJsonDocument doc(256);
-    doc["state"] = getRelayState();
-    doc["pin"] = getRelayPin();
-    doc["timestamp"] = millis();
-    doc["location"] = config.location;
+    DynamicJsonDocument doc(JSON_CAPACITY_RELAY_STATE);
+    buildRelayStatePayload(doc);
 
     String message;
-    serializeJson(doc, message);
+    serializePayload(PAYLOAD_RELAY_STATE, doc, message);
 
     String topic = getTopicWithLocation(MQTT_TOPIC_RELAY_STATUS);
-    mqttClient.publish(topic.c_str(), message.c_str());
+    if (!mqttPublish(topic.c_str(), message.c_str()))
+    {
+        return false; // Left unmarked, so the next cycle retries
+    }
+    markPublished(PUBLISH_RELAY, getRelayState() ? 1 : 0, millis());
 
     MQTT_DEBUG_PRINTF("Published relay state: %s to topic: %s\n", message.c_str(), topic.c_str());
+    return true;
 }
+#endif
+
+#if USE_DHT || USE_TSL2561 || USE_PIR || USE_LD2410
+// Publish a single value if it passes the metric's suppression thresholds
+static bool publishFiltered(PublishMetric metric, const char *topicName, float value, const String &payload, unsigned long now)
+{
+    if (!shouldPublish(metric, value, now))
+    {
+        return false;
+    }
+    String topic = getTopicWithLocation(topicName);
+    if (!mqttPublish(topic.c_str(), payload.c_str()))
+    {
+        return false; // Left unmarked, so the next cycle retries
+    }
+    markPublished(metric, value, now);
+    return true;
+}
+#endif
 
 void publishData()
 {
     if (!mqttClient.connected())
     {
-        MQTT_DEBUG_PRINTLN("MQTT not connected, skipping publish");
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("MQTT not connected, skipping publish"));
         return;
     }
 
+    unsigned long now = millis();
+    bool anyPublished = false;
+
     // Publish individual sensor data
+#if USE_DHT
     if (config.use_dht && sensorData.dht_available)
     {
-        String topic = getTopicWithLocation(MQTT_TOPIC_TEMPERATURE);
-        mqttClient.publish(topic.c_str(), String(sensorData.temperature).c_str());
-
-        topic = getTopicWithLocation(MQTT_TOPIC_HUMIDITY);
-        mqttClient.publish(topic.c_str(), String(sensorData.humidity).c_str());
+        anyPublished |= publishFiltered(PUBLISH_TEMPERATURE, MQTT_TOPIC_TEMPERATURE, sensorData.temperature, String(sensorData.temperature), now);
+        anyPublished |= publishFiltered(PUBLISH_HUMIDITY, MQTT_TOPIC_HUMIDITY, sensorData.humidity, String(sensorData.humidity), now);
     }
+#endif
 
+#if USE_TSL2561
     if (config.use_tsl2561 && sensorData.tsl_available)
     {
-        String topic = getTopicWithLocation(MQTT_TOPIC_LUMINESCENCE);
-        mqttClient.publish(topic.c_str(), String(sensorData.lux).c_str());
+        anyPublished |= publishFiltered(PUBLISH_LUMINESCENCE, MQTT_TOPIC_LUMINESCENCE, sensorData.lux, String(sensorData.lux), now);
     }
+#endif
 
+#if USE_PIR
     if (config.use_pir && sensorData.pir_available)
     {
-        String topic = getTopicWithLocation(MQTT_TOPIC_MOTION);
-        mqttClient.publish(topic.c_str(), sensorData.presence ? "1" : "0");
+        anyPublished |= publishFiltered(PUBLISH_MOTION, MQTT_TOPIC_MOTION, sensorData.presence ? 1 : 0, sensorData.presence ? "1" : "0", now);
     }
+#endif
 
+#if USE_LD2410
     if (config.use_ld2410 && sensorData.radar_available)
     {
-        String topic = getTopicWithLocation(MQTT_TOPIC_RADAR_PRESENCE);
-        mqttClient.publish(topic.c_str(), sensorData.radar_presence ? "1" : "0");
+        anyPublished |= publishFiltered(PUBLISH_RADAR, MQTT_TOPIC_RADAR_PRESENCE, sensorData.radar_presence ? 1 : 0, sensorData.radar_presence ? "1" : "0", now);
+    }
+#endif
+
+#if USE_RELAY
+    // Marked by publishRelayState() only once it went out, like publishFiltered()
+    if (config.use_relay && shouldPublish(PUBLISH_RELAY, getRelayState() ? 1 : 0, now))
+    {
+        anyPublished |= publishRelayState();
     }
+#endif
 
-    if (config.use_relay)
+    // The combined JSON goes out whenever any metric did, or as a heartbeat
+    if (!shouldPublishEvent(PUBLISH_ALL, anyPublished, now))
     {
-        publishRelayState();
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("No significant change, combined publish suppressed"));
+        return;
     }
 
     // Publish all sensor data as JSON
-    DynamicJsonDocument doc(512);
-    doc["temperature"] = sensorData.temperature;
-    doc["humidity"] = sensorData.humidity;
-    doc["motion"] = sensorData.presence;
-    doc["luminescence"] = sensorData.lux;
-    doc["radar_presence"] = sensorData.radar_presence;
-    doc["relay_state"] = getRelayState();
-    doc["relay_pin"] = getRelayPin();
-    doc["timestamp"] = sensorData.timestamp;
-    doc["location"] = config.location;
-    doc["uptime"] = millis();
-    doc["free_heap"] = ESP.getFreeHeap();
-    doc["wifi_rssi"] = WiFi.RSSI();
-    doc["firmware_version"] = FIRMWARE_VERSION;
+    DynamicJsonDocument doc(JSON_CAPACITY_ALL);
+    buildAllPayload(doc);
 
     String message;
-    serializeJson(doc, message);
+    serializePayload(PAYLOAD_ALL, doc, message);
 
     String topic = getTopicWithLocation(MQTT_TOPIC_ALL);
-    mqttClient.publish(topic.c_str(), message.c_str());
+    if (!mqttPublish(topic.c_str(), message.c_str()))
+    {
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("Combined publish deferred"));
+        return;
+    }
+    markPublished(PUBLISH_ALL, 1, now);
+    bootEvent("first_publish");
 
     MQTT_DEBUG_PRINTF("Published all sensor data: %s\n", message.c_str());
 }
 
+#if ENABLE_CRASH_DIAG
+// Once per boot: what the previous run was doing when it reset. Retained so a
+// collector that subscribes later still sees the last reset
+void publishResetDiagnostics()
+{
+    static bool published = false;
+    if (published)
+    {
+        return;
+    }
+    published = true;
+
+    DynamicJsonDocument doc(JSON_CAPACITY_DIAG_RESET);
+    buildResetDiagPayload(doc);
+    String payload;
+    serializePayload(PAYLOAD_DIAG_RESET, doc, payload);
+    String topic = getTopicWithLocation(MQTT_TOPIC_DIAG) + "/reset";
+    mqttClient.publish(topic.c_str(), payload.c_str(), true);
+}
+#endif
+
+// Compact diagnostics under {location}/diag/...; the full data is on the HTTP API
+void publishDiagnostics()
+{
+    if (!config.mqtt_enabled || !mqttClient.connected())
+    {
+        return;
+    }
+#if ENABLE_PROFILER
+    {
+        DynamicJsonDocument doc(JSON_CAPACITY_DIAG_PERF);
+        buildPerfDiagPayload(doc);
+        String payload;
+        serializePayload(PAYLOAD_DIAG_PERF, doc, payload);
+        String topic = getTopicWithLocation(MQTT_TOPIC_DIAG) + "/perf";
+        mqttClient.publish(topic.c_str(), payload.c_str());
+    }
+#endif
+#if ENABLE_HEAP_MONITOR
+    {
+        const HeapStats &heap = getHeapStats();
+        char payload[160];
+        snprintf(payload, sizeof(payload),
+                 "{\"free\":%u,\"max_block\":%u,\"fragmentation\":%u,\"min_free\":%u,\"min_max_block\":%u,\"min_free_stack\":%u}",
+                 ESP.getFreeHeap(), ESP.getMaxFreeBlockSize(), ESP.getHeapFragmentation(),
+                 heap.min_free, heap.min_max_block, heap.min_free_cont_stack);
+        String topic = getTopicWithLocation(MQTT_TOPIC_DIAG) + "/heap";
+        mqttClient.publish(topic.c_str(), payload);
+    }
+#endif
+}
+
+// Unread broker traffic; lets the power manager end an idle wait early
+bool mqttInboundPending()
+{
+    return mqttTransport.available() > 0;
+}
+
+bool mqttPublish(const char *topic, const char *payload, bool retained)
+{
+#if MQTT_PUBLISH_QOS >= 1
+    return mqttPublishQos1(topic, payload, retained);
+#else
+    return mqttClient.publish(topic, payload, retained);
+#endif
+}
+
 String getTopicWithLocation(const char *topic)
 {
     String fullTopic = String(config.location) + "/" + String(topic);
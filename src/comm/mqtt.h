@@ -1,13 +1,45 @@
 #pragma once
 #include <PubSubClient.h>
+#include "config.h"
+
+// Connection and broker resolution counters
+struct MqttConnectionStats
+{
+    unsigned long attempts;
+    unsigned long connects;
+    unsigned long resumed_sessions; // CONNACK reported an existing session
+    unsigned long dns_lookups;
+    unsigned long dns_failures;
+    unsigned long dns_fallbacks;    // Connected using the last known address
+    unsigned long last_connect_ms;  // Duration of the last successful connect
+    bool session_present;
+
+    // TLS transport (MQTT_USE_TLS)
+    bool mfln_supported;           // Broker accepted reduced TLS buffers
+    unsigned long tls_heap_bytes;  // Heap held by the TLS connection
+    unsigned long first_connect_ms; // Full handshake; later connects resume the TLS session
+};
+
 extern PubSubClient mqttClient;
 extern unsigned long lastMqttPublish;
 extern bool mqttConnected;
 void setupMQTT();
 bool connectMQTT();
+void maintainMQTT();
+bool mqttInboundPending();
+String getMqttClientId();
+const MqttConnectionStats &getMqttConnectionStats();
 void publishData();
+void publishDiagnostics();
+void publishResetDiagnostics();
+bool mqttPublish(const char *topic, const char *payload, bool retained = false);
 void mqttCallback(char *topic, byte *payload, unsigned int length);
 String getTopicWithLocation(const char *topic);
+void handlePublishNowCommand(const char *payload, unsigned int length);
+#if USE_RELAY
 void handleRelayCommand(const char *message);
-void publishRelayState();
+void handleRelayPayload(const char *payload, unsigned int length);
+bool relayCommandsEnabled();
+bool publishRelayState(); // False if not connected or deferred
+#endif
 void subscribe(char *topic);
\ No newline at end of file
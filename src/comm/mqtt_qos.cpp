@@ -0,0 +1,179 @@
+#include <Arduino.h>
+#include "config.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_qos.h"
+#include "debug/debug_macros.h"
+
+#define MQTT_PUBLISH_QOS1_HEADER 0x32
+#define MQTT_FLAG_RETAIN 0x01
+#define MQTT_FLAG_DUP 0x08
+
+// One in-flight publish, stored fully encoded so a retransmit only flips DUP
+struct InflightSlot
+{
+    uint8_t packet[MQTT_QOS1_MAX_PACKET];
+    uint16_t length;
+    uint16_t packetId;
+    unsigned long sentAt;
+    unsigned long sequence; // Send order, so retransmits keep the original order
+    bool inUse;
+};
+
+static InflightSlot inflight[MQTT_QOS1_WINDOW];
+static uint16_t nextPacketId = 1;
+static unsigned long nextSequence = 0;
+static MqttQosStats qosStats;
+
+static InflightSlot *acquireSlot()
+{
+    for (int i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        if (!inflight[i].inUse)
+        {
+            return &inflight[i];
+        }
+    }
+    return nullptr;
+}
+
+static uint16_t allocatePacketId()
+{
+    uint16_t id = nextPacketId++;
+    if (nextPacketId == 0)
+    {
+        nextPacketId = 1; // Packet ID 0 is not allowed
+    }
+    return id;
+}
+
+size_t mqttQos1PacketSize(size_t topicLength, size_t payloadLength)
+{
+    size_t remaining = 2 + topicLength + 2 + payloadLength; // Topic length, topic, packet ID, payload
+    return 1 + (remaining < 128 ? 1 : remaining < 16384 ? 2 : 3) + remaining;
+}
+
+bool mqttPublishQos1(const char *topic, const char *payload, bool retained)
+{
+    size_t topicLength = strlen(topic);
+    size_t payloadLength = strlen(payload);
+    size_t remaining = 2 + topicLength + 2 + payloadLength;
+
+    if (mqttQos1PacketSize(topicLength, payloadLength) > MQTT_QOS1_MAX_PACKET)
+    {
+        qosStats.fallback_qos0++;
+        return mqttClient.publish(topic, payload, retained);
+    }
+
+    InflightSlot *slot = acquireSlot();
+    if (!slot)
+    {
+        // Window full: dropping an unacknowledged publish would break
+        // at-least-once, so defer this one; the caller retries next cycle
+        MQTT_DEBUG_PRINTF("QoS1 window full, deferring publish to %s\n", topic);
+        qosStats.deferred++;
+        return false;
+    }
+    uint8_t *p = slot->packet;
+
+    *p++ = MQTT_PUBLISH_QOS1_HEADER | (retained ? MQTT_FLAG_RETAIN : 0);
+    do
+    {
+        uint8_t digit = remaining & 0x7F;
+        remaining >>= 7;
+        *p++ = remaining ? (digit | 0x80) : digit;
+    } while (remaining);
+
+    *p++ = topicLength >> 8;
+    *p++ = topicLength & 0xFF;
+    memcpy(p, topic, topicLength);
+    p += topicLength;
+
+    slot->packetId = allocatePacketId();
+    *p++ = slot->packetId >> 8;
+    *p++ = slot->packetId & 0xFF;
+    memcpy(p, payload, payloadLength);
+    p += payloadLength;
+
+    slot->length = p - slot->packet;
+
+    // Written straight to the transport; PubSubClient only builds QoS 0 publishes.
+    // A short write leaves the slot free: the caller keeps the reading and
+    // retries it, so queueing it for retransmit as well would send it twice
+    if (mqttClient.write(slot->packet, slot->length) != slot->length)
+    {
+        MQTT_DEBUG_PRINTF("QoS1 write to %s failed\n", topic);
+        return false;
+    }
+    slot->sentAt = millis();
+    slot->sequence = nextSequence++;
+    slot->inUse = true;
+    qosStats.sent++;
+    return true;
+}
+
+void mqttHandlePuback(uint16_t packetId)
+{
+    for (int i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        if (inflight[i].inUse && inflight[i].packetId == packetId)
+        {
+            unsigned long rtt = millis() - inflight[i].sentAt;
+            if (rtt > qosStats.max_ack_ms)
+            {
+                qosStats.max_ack_ms = rtt;
+            }
+            inflight[i].inUse = false;
+            qosStats.acked++;
+            return;
+        }
+    }
+    qosStats.unknown_acks++;
+}
+
+void mqttRetransmitInflight()
+{
+    // Resend in original order; each sent slot gets a fresh sequence number,
+    // so repeatedly picking the smallest below 'limit' walks the window in order
+    unsigned long limit = nextSequence;
+    while (true)
+    {
+        InflightSlot *next = nullptr;
+        for (int i = 0; i < MQTT_QOS1_WINDOW; i++)
+        {
+            if (inflight[i].inUse && inflight[i].sequence < limit &&
+                (next == nullptr || inflight[i].sequence < next->sequence))
+            {
+                next = &inflight[i];
+            }
+        }
+        if (next == nullptr)
+        {
+            break;
+        }
+
+        next->packet[0] |= MQTT_FLAG_DUP;
+        next->sentAt = millis();
+        next->sequence = nextSequence++;
+        mqttClient.write(next->packet, next->length);
+        qosStats.retransmitted++;
+        MQTT_DEBUG_PRINTF("Retransmitted QoS1 packet %u\n", next->packetId);
+    }
+}
+
+uint8_t mqttInflightCount()
+{
+    uint8_t count = 0;
+    for (int i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        if (inflight[i].inUse)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+const MqttQosStats &getMqttQosStats()
+{
+    return qosStats;
+}
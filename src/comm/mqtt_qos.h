@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+// QoS 1 publish counters
+struct MqttQosStats
+{
+    unsigned long sent;          // QoS 1 publishes written to the transport
+    unsigned long acked;         // PUBACKs matched to an in-flight publish
+    unsigned long retransmitted; // Publishes resent with DUP after a reconnect
+    unsigned long deferred;      // Publishes refused because the window was full
+    unsigned long fallback_qos0; // Packets too large for a window slot, sent at QoS 0
+    unsigned long unknown_acks;  // PUBACKs with no matching in-flight publish
+    unsigned long max_ack_ms;    // Slowest PUBACK round trip seen
+};
+
+// Whole PUBLISH packet as written to a window slot; above MQTT_QOS1_MAX_PACKET
+// the publish falls back to QoS 0 through PubSubClient's buffer of the same size
+size_t mqttQos1PacketSize(size_t topicLength, size_t payloadLength);
+bool mqttPublishQos1(const char *topic, const char *payload, bool retained);
+void mqttHandlePuback(uint16_t packetId);
+void mqttRetransmitInflight();
+uint8_t mqttInflightCount();
+const MqttQosStats &getMqttQosStats();
@@ -0,0 +1,202 @@
+#include <Arduino.h>
+#include "config.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_router.h"
+#include "model/data_structs.h"
+#include "debug/debug_macros.h"
+
+struct MqttRoute
+{
+    const char *filter;
+    uint32_t hash; // FNV-1a of the filter, only meaningful for exact filters
+    bool wildcard;
+    MqttCommandHandler handler;
+    MqttRouteEnabled enabled;
+    unsigned long dispatched;
+};
+
+static MqttRoute routes[MQTT_MAX_ROUTES];
+static uint8_t routeCount = 0;
+static unsigned long unmatchedCount = 0;
+static unsigned long droppedCount = 0;
+
+// Handlers get a NUL-terminated copy; callbacks come from mqttClient.loop(),
+// so a single static buffer is enough and keeps network-sized data off the stack
+static char commandBuffer[MQTT_COMMAND_MAX_PAYLOAD + 1];
+
+static uint32_t fnv1a(const char *s)
+{
+    uint32_t hash = 2166136261UL;
+    while (*s)
+    {
+        hash ^= (uint8_t)*s++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static bool filterMatches(const char *filter, const char *topic)
+{
+    while (*filter)
+    {
+        if (*filter == '#')
+        {
+            return true;
+        }
+        if (*filter == '+')
+        {
+            while (*topic && *topic != '/')
+            {
+                topic++;
+            }
+            filter++;
+            continue;
+        }
+        if (*filter != *topic)
+        {
+            return false;
+        }
+        filter++;
+        topic++;
+    }
+    return *topic == '\0';
+}
+
+bool mqttRegisterRoute(const char *filter, MqttCommandHandler handler, MqttRouteEnabled enabled)
+{
+    if (routeCount >= MQTT_MAX_ROUTES)
+    {
+        MQTT_DEBUG_PRINTF("Route table full, cannot register %s\n", filter);
+        return false;
+    }
+
+    MqttRoute &route = routes[routeCount++];
+    route.filter = filter;
+    route.hash = fnv1a(filter);
+    route.wildcard = strpbrk(filter, "+#") != nullptr;
+    route.handler = handler;
+    route.enabled = enabled;
+    route.dispatched = 0;
+    return true;
+}
+
+// Topic set the broker session was built with: the location prefix and one
+// bit per subscribed route. Unknown after a reboot, so a resumed session is
+// re-subscribed once
+static char subscribedLocation[sizeof(ConfigData::location)];
+static uint32_t subscribedMask = 0;
+static bool subscriptionsKnown = false;
+
+static uint32_t enabledRouteMask()
+{
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        if (routes[i].enabled == nullptr || routes[i].enabled())
+        {
+            mask |= 1UL << i;
+        }
+    }
+    return mask;
+}
+
+bool mqttSyncSubscriptions(bool sessionPresent)
+{
+    uint32_t mask = enabledRouteMask();
+    bool moved = strcmp(subscribedLocation, config.location) != 0;
+    if (sessionPresent && subscriptionsKnown && !moved && mask == subscribedMask)
+    {
+        return false;
+    }
+
+    // A resumed session still holds the old set; drop what the new one lacks
+    if (sessionPresent && subscriptionsKnown)
+    {
+        for (uint8_t i = 0; i < routeCount; i++)
+        {
+            if ((subscribedMask & (1UL << i)) && (moved || !(mask & (1UL << i))))
+            {
+                String topic = String(subscribedLocation) + "/" + routes[i].filter;
+                mqttClient.unsubscribe(topic.c_str());
+                MQTT_DEBUG_PRINTF("Unsubscribed %s\n", topic.c_str());
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        if (mask & (1UL << i))
+        {
+            // QoS 0 so the persistent session does not queue commands while we
+            // are offline: a relay toggle or sleep order replayed on reconnect
+            // would act on a state it was never meant for
+            mqttClient.subscribe(getTopicWithLocation(routes[i].filter).c_str(), 0);
+        }
+    }
+
+    strlcpy(subscribedLocation, config.location, sizeof(subscribedLocation));
+    subscribedMask = mask;
+    subscriptionsKnown = true;
+    return true;
+}
+
+bool mqttDispatch(const char *topic, const byte *payload, unsigned int length)
+{
+    // Strip "<location>/" without building Strings
+    size_t prefixLength = strlen(config.location);
+    if (strncmp(topic, config.location, prefixLength) != 0 || topic[prefixLength] != '/')
+    {
+        unmatchedCount++;
+        return false;
+    }
+    const char *suffix = topic + prefixLength + 1;
+
+    if (length > MQTT_COMMAND_MAX_PAYLOAD)
+    {
+        MQTT_DEBUG_PRINTF("Dropping %u byte command on %s\n", length, topic);
+        droppedCount++;
+        return false;
+    }
+
+    uint32_t hash = fnv1a(suffix);
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        MqttRoute &route = routes[i];
+        bool match = route.wildcard ? filterMatches(route.filter, suffix)
+                                    : (route.hash == hash && strcmp(route.filter, suffix) == 0);
+        if (!match || (route.enabled != nullptr && !route.enabled()))
+        {
+            continue;
+        }
+
+        memcpy(commandBuffer, payload, length);
+        commandBuffer[length] = '\0';
+        route.dispatched++;
+        route.handler(commandBuffer, length);
+        return true;
+    }
+
+    unmatchedCount++;
+    return false;
+}
+
+uint8_t mqttRouteCount()
+{
+    return routeCount;
+}
+
+MqttRouteStats getMqttRouteStats(uint8_t index)
+{
+    MqttRouteStats stats = {routes[index].filter, routes[index].dispatched};
+    return stats;
+}
+
+unsigned long mqttUnmatchedCount()
+{
+    return unmatchedCount;
+}
+
+unsigned long mqttDroppedCount()
+{
+    return droppedCount;
+}
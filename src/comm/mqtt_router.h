@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+
+// Inbound command routing. Filters are relative to the location prefix and
+// may use MQTT wildcards: '+' matches one level, a trailing '#' the rest.
+typedef void (*MqttCommandHandler)(const char *payload, unsigned int length);
+typedef bool (*MqttRouteEnabled)();
+
+struct MqttRouteStats
+{
+    const char *filter;
+    unsigned long dispatched;
+};
+
+bool mqttRegisterRoute(const char *filter, MqttCommandHandler handler, MqttRouteEnabled enabled = nullptr);
+// Brings the broker's subscriptions in line with the enabled routes under the
+// current location; with a resumed session only when the topic set changed.
+// Returns true if anything was sent
+bool mqttSyncSubscriptions(bool sessionPresent);
+bool mqttDispatch(const char *topic, const byte *payload, unsigned int length);
+
+uint8_t mqttRouteCount();
+MqttRouteStats getMqttRouteStats(uint8_t index);
+unsigned long mqttUnmatchedCount();
+unsigned long mqttDroppedCount();
@@ -0,0 +1,154 @@
+#include "comm/mqtt_tap.h"
+
+#define MQTT_PACKET_CONNACK 2
+#define MQTT_PACKET_PUBACK 4
+
+MqttClientTap::MqttClientTap(Client &inner)
+    : _inner(inner), _onPuback(nullptr), _sessionPresent(false)
+{
+    resetParser();
+}
+
+void MqttClientTap::resetParser()
+{
+    _state = PARSE_HEADER;
+    _header = 0;
+    _remaining = 0;
+    _multiplier = 1;
+    _bodyLength = 0;
+}
+
+void MqttClientTap::parseByte(uint8_t b)
+{
+    switch (_state)
+    {
+    case PARSE_HEADER:
+        _header = b;
+        _remaining = 0;
+        _multiplier = 1;
+        _bodyLength = 0;
+        _state = PARSE_LENGTH;
+        break;
+
+    case PARSE_LENGTH:
+        _remaining += (uint32_t)(b & 0x7F) * _multiplier;
+        _multiplier <<= 7;
+        if ((b & 0x80) == 0)
+        {
+            if (_remaining == 0)
+            {
+                packetComplete();
+            }
+            else
+            {
+                _state = PARSE_BODY;
+            }
+        }
+        else if (_multiplier > (1UL << 21))
+        {
+            // Malformed length; resynchronise on the next byte
+            resetParser();
+        }
+        break;
+
+    case PARSE_BODY:
+        if (_bodyLength < sizeof(_body))
+        {
+            _body[_bodyLength++] = b;
+        }
+        if (--_remaining == 0)
+        {
+            packetComplete();
+        }
+        break;
+    }
+}
+
+void MqttClientTap::packetComplete()
+{
+    uint8_t type = _header >> 4;
+    if (type == MQTT_PACKET_PUBACK && _bodyLength >= 2 && _onPuback)
+    {
+        _onPuback(((uint16_t)_body[0] << 8) | _body[1]);
+    }
+    else if (type == MQTT_PACKET_CONNACK && _bodyLength >= 2)
+    {
+        _sessionPresent = (_body[1] == 0) && (_body[0] & 0x01);
+    }
+    _state = PARSE_HEADER;
+}
+
+int MqttClientTap::connect(IPAddress ip, uint16_t port)
+{
+    resetParser();
+    _sessionPresent = false;
+    return _inner.connect(ip, port);
+}
+
+int MqttClientTap::connect(const char *host, uint16_t port)
+{
+    resetParser();
+    _sessionPresent = false;
+    return _inner.connect(host, port);
+}
+
+size_t MqttClientTap::write(uint8_t b)
+{
+    return _inner.write(b);
+}
+
+size_t MqttClientTap::write(const uint8_t *buf, size_t size)
+{
+    return _inner.write(buf, size);
+}
+
+int MqttClientTap::available()
+{
+    return _inner.available();
+}
+
+int MqttClientTap::read()
+{
+    int b = _inner.read();
+    if (b >= 0)
+    {
+        parseByte((uint8_t)b);
+    }
+    return b;
+}
+
+int MqttClientTap::read(uint8_t *buf, size_t size)
+{
+    int count = _inner.read(buf, size);
+    for (int i = 0; i < count; i++)
+    {
+        parseByte(buf[i]);
+    }
+    return count;
+}
+
+int MqttClientTap::peek()
+{
+    return _inner.peek();
+}
+
+void MqttClientTap::flush()
+{
+    _inner.flush();
+}
+
+void MqttClientTap::stop()
+{
+    _inner.stop();
+    resetParser();
+}
+
+uint8_t MqttClientTap::connected()
+{
+    return _inner.connected();
+}
+
+MqttClientTap::operator bool()
+{
+    return (bool)_inner;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <Arduino.h>
+#include <Client.h>
+
+// Transparent Client wrapper between PubSubClient and the network transport.
+// PubSubClient ignores PUBACK and hides the CONNACK flags, so the tap parses
+// the inbound MQTT byte stream as PubSubClient reads it and reports them.
+class MqttClientTap : public Client
+{
+public:
+    typedef void (*PubackCallback)(uint16_t packetId);
+
+    explicit MqttClientTap(Client &inner);
+
+    void setPubackCallback(PubackCallback callback) { _onPuback = callback; }
+    bool sessionPresent() const { return _sessionPresent; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+private:
+    enum ParseState
+    {
+        PARSE_HEADER,
+        PARSE_LENGTH,
+        PARSE_BODY
+    };
+
+    void resetParser();
+    void parseByte(uint8_t b);
+    void packetComplete();
+
+    Client &_inner;
+    PubackCallback _onPuback;
+    bool _sessionPresent;
+
+    ParseState _state;
+    uint8_t _header;
+    uint32_t _remaining;
+    uint32_t _multiplier;
+    uint8_t _body[4]; // Only the variable header prefix is needed
+    uint8_t _bodyLength;
+};
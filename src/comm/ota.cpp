@@ -4,6 +4,7 @@
 #include <ESP8266HTTPUpdateServer.h>
 #include <ArduinoOTA.h>
 #include "config.h"
+#include "debug/crash_diag.h"
 
 ESP8266HTTPUpdateServer httpUpdater;
 
@@ -36,7 +37,11 @@ void setupArduinoOTA()
             type = "sketch";
         else // U_FS
             type = "filesystem";
-        Serial.println("[OTA] Start updating " + type); });
+        Serial.println("[OTA] Start updating " + type);
+#if ENABLE_CRASH_DIAG
+        crashDiagEvent(DIAG_EVENT_OTA_START);
+#endif
+    });
     ArduinoOTA.onEnd([]()
                      { Serial.println("[OTA] End"); });
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
@@ -0,0 +1,723 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESP8266WiFi.h>
+#include <PubSubClient.h>
+
+extern "C"
+{
+#include "user_interface.h"
+}
+
+#include "config.h"
+#include "comm/payloads.h"
+#include "comm/publish_filter.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_qos.h"
+#include "comm/mqtt_router.h"
+#include "comm/wifi_manager.h"
+#include "model/data_structs.h"
+#include "model/config_store.h"
+#include "actuators/relay.h"
+#include "power/deep_sleep.h"
+#include "power/power_manager.h"
+#include "sensors/sensor_manager.h"
+#include "sensors/sensor_sampling.h"
+#include "sensors/sensor_health.h"
+#include "sensors/ld2410_capture.h"
+#include "debug/debug_macros.h"
+
+static const char *const payloadNames[PAYLOAD_COUNT] = {
+    "sensors", "config", "all", "relay_state", "diag_reset", "diag_perf", "sleep_batch",
+    "sensor_config", "sensor_metrics", "debug_sensors", "health", "config_full", "config_export",
+    "boot", "perf", "heap", "log_entry", "log_entry_raw", "diag", "ld2410_capture", "power",
+    "mqtt", "payloads", "relay"};
+
+static const size_t payloadCapacities[PAYLOAD_COUNT] = {
+    JSON_CAPACITY_SENSORS, JSON_CAPACITY_CONFIG, JSON_CAPACITY_ALL,
+    JSON_CAPACITY_RELAY_STATE, JSON_CAPACITY_DIAG_RESET, JSON_CAPACITY_DIAG_PERF,
+    JSON_CAPACITY_SLEEP_BATCH, JSON_CAPACITY_SENSOR_CONFIG, JSON_CAPACITY_SENSOR_METRICS,
+    JSON_CAPACITY_DEBUG_SENSORS, JSON_CAPACITY_HEALTH, JSON_CAPACITY_CONFIG_FULL,
+    JSON_CAPACITY_CONFIG_EXPORT, JSON_CAPACITY_BOOT, JSON_CAPACITY_PERF, JSON_CAPACITY_HEAP,
+    JSON_CAPACITY_LOG_ENTRY, JSON_CAPACITY_LOG_ENTRY, JSON_CAPACITY_DIAG,
+    JSON_CAPACITY_LD2410_CAPTURE, JSON_CAPACITY_POWER, JSON_CAPACITY_MQTT,
+    JSON_CAPACITY_PAYLOADS, JSON_CAPACITY_RELAY};
+
+static PayloadStats payloadStats[PAYLOAD_COUNT];
+
+void buildSensorsPayload(JsonDocument &doc)
+{
+    const char *motionSource = "none";
+    if (config.use_ld2410 && sensorData.radar_available)
+    {
+        motionSource = "radar";
+    }
+    else if (config.use_pir && sensorData.pir_available)
+    {
+        motionSource = "pir";
+    }
+
+    doc["temperature"] = sensorData.temperature;
+    doc["humidity"] = sensorData.humidity;
+    doc["motion"] = strcmp(motionSource, "radar") == 0 ? sensorData.radar_presence : sensorData.presence;
+    doc["luminescence"] = sensorData.lux;
+    doc["timestamp"] = sensorData.timestamp;
+    doc["uptime"] = millis();
+    doc["wifi_rssi"] = WiFi.RSSI();
+    doc["free_heap"] = ESP.getFreeHeap();
+    doc["sensorless_mode"] = config.sensorless_mode;
+    doc["firmware_version"] = FIRMWARE_VERSION;
+    doc["motion_source"] = motionSource;
+
+    // Simple sensor status (avoid nested objects for now)
+    doc["dht11_available"] = sensorData.dht_available;
+    doc["dht11_errors"] = sensorData.dht_error_count;
+    doc["tsl2561_available"] = sensorData.tsl_available;
+    doc["tsl2561_errors"] = sensorData.tsl_error_count;
+    doc["pir_available"] = sensorData.pir_available;
+    doc["pir_errors"] = sensorData.pir_error_count;
+    doc["radar_presence"] = sensorData.radar_presence;
+    doc["relay_state"] = getRelayState();
+    doc["relay_pin"] = getRelayPin();
+}
+
+void buildAllPayload(JsonDocument &doc)
+{
+    doc["temperature"] = sensorData.temperature;
+    doc["humidity"] = sensorData.humidity;
+    doc["motion"] = sensorData.presence;
+    doc["luminescence"] = sensorData.lux;
+    doc["radar_presence"] = sensorData.radar_presence;
+    doc["relay_state"] = getRelayState();
+    doc["relay_pin"] = getRelayPin();
+    doc["timestamp"] = sensorData.timestamp;
+    doc["location"] = config.location;
+    doc["uptime"] = millis();
+    doc["free_heap"] = ESP.getFreeHeap();
+    doc["wifi_rssi"] = WiFi.RSSI();
+    doc["firmware_version"] = FIRMWARE_VERSION;
+}
+
+void buildRelayStatePayload(JsonDocument &doc)
+{
+    doc["state"] = getRelayState();
+    doc["pin"] = getRelayPin();
+    doc["timestamp"] = millis();
+    doc["location"] = config.location;
+}
+
+void buildConfigPayload(JsonDocument &doc, const SleepRing *ring)
+{
+    doc["mqtt_broker"] = config.mqtt_broker;
+    doc["mqtt_port"] = config.mqtt_port;
+    doc["mqtt_username"] = config.mqtt_username;
+    doc["location"] = config.location;
+    doc["mqtt_enabled"] = config.mqtt_enabled;
+    doc["sensorless_mode"] = config.sensorless_mode;
+
+    // Sensor enable flags
+    doc["use_dht"] = config.use_dht;
+    doc["use_tsl2561"] = config.use_tsl2561;
+    doc["use_pir"] = config.use_pir;
+    doc["use_ld2410"] = config.use_ld2410;
+    doc["use_relay"] = config.use_relay;
+
+    // Publish suppression thresholds
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        JsonObject metric = doc["publish"].createNestedObject(getPublishMetricName((PublishMetric)i));
+        metric["deadband"] = config.publish[i].deadband;
+        metric["rate_threshold"] = config.publish[i].rate_threshold;
+        metric["min_interval"] = config.publish[i].min_interval;
+        metric["max_interval"] = config.publish[i].max_interval;
+    }
+
+    // Per-sensor sampling periods
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        JsonObject sampling = doc["sampling"].createNestedObject(getSensorName((SensorId)i));
+        sampling["min_ms"] = config.sampling[i].min_ms;
+        sampling["max_ms"] = config.sampling[i].max_ms;
+        sampling["change"] = config.sampling[i].change;
+    }
+
+    // Battery mode settings, plus the last battery run if RTC memory has one
+    JsonObject deepSleep = doc.createNestedObject("deep_sleep");
+    deepSleep["enabled"] = config.deep_sleep_enabled;
+    deepSleep["interval_s"] = config.deep_sleep_interval_s;
+    deepSleep["flush_every"] = config.deep_sleep_flush_every;
+    if (ring)
+    {
+        deepSleep["wake_count"] = ring->wake_count;
+        deepSleep["buffered"] = ring->count;
+        deepSleep["dropped"] = ring->dropped;
+        deepSleep["energy_uj_per_sample"] = estimateEnergyPerSampleUj(*ring, config.deep_sleep_interval_s);
+    }
+}
+
+void buildSleepBatchPayload(JsonDocument &doc, const SleepRing &ring, uint16_t count, uint32_t epoch)
+{
+    doc["wake_count"] = ring.wake_count;
+    doc["dropped"] = ring.dropped;
+    doc["energy_uj_per_sample"] = estimateEnergyPerSampleUj(ring, config.deep_sleep_interval_s);
+    JsonArray samples = doc.createNestedArray("samples");
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const SleepSample &s = sleepRingAt(ring, i);
+        JsonObject o = samples.createNestedObject();
+        uint32_t age = ring.clock_s - s.t_s;
+        o["age_s"] = age;
+        if (epoch != 0)
+        {
+            o["t"] = epoch - age;
+        }
+        if (s.temperature_c10 != SLEEP_SAMPLE_INVALID)
+        {
+            o["temperature"] = s.temperature_c10 / 10.0f;
+            o["humidity"] = s.humidity_c10 / 10.0f;
+        }
+        if (config.use_tsl2561)
+        {
+            o["luminescence"] = s.lux_c10 / 10.0f;
+        }
+    }
+}
+
+void buildSensorConfigPayload(JsonDocument &doc)
+{
+    doc["use_dht"] = config.use_dht;
+    doc["use_tsl2561"] = config.use_tsl2561;
+    doc["use_pir"] = config.use_pir;
+    doc["use_ld2410"] = config.use_ld2410;
+    doc["use_relay"] = config.use_relay;
+}
+
+// Per-driver state, poll counters, sampling rate and health from the sensor registry
+void buildSensorMetricsPayload(JsonDocument &doc)
+{
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        SensorStatus status = getSensorStatus((SensorId)i);
+        const SensorMetrics &metrics = getSensorMetrics((SensorId)i);
+        const SensorSampling &sampling = getSensorSampling((SensorId)i);
+        const SensorHealthState &health = getSensorHealth((SensorId)i);
+        JsonObject entry = doc.createNestedObject(status.name);
+        entry["enabled"] = status.enabled;
+        entry["ready"] = status.ready;
+        entry["available"] = status.available;
+        entry["error_count"] = status.error_count;
+        entry["polls"] = metrics.polls;
+        entry["readings"] = metrics.readings;
+        entry["failures"] = metrics.failures;
+        entry["last_reading_ms"] = metrics.last_reading_ms;
+        entry["max_poll_us"] = metrics.max_poll_us;
+        entry["period_ms"] = sampling.period_ms;
+        entry["achieved_hz"] = sampling.achieved_hz;
+        entry["lag_max_ms"] = sampling.lag_max_ms;
+        entry["health"] = getSensorHealthName(health.state);
+        entry["outages"] = health.outages;
+        entry["recoveries"] = health.recoveries;
+        entry["recovery_attempts"] = health.recovery_attempts;
+        entry["mtbf_ms"] = sensorMtbfMs((SensorId)i);
+        entry["mttr_ms"] = sensorMttrMs((SensorId)i);
+        if (health.state == SENSOR_FAILED)
+        {
+            entry["retry_in_ms"] = (long)(health.retry_at - millis()) > 0 ? health.retry_at - millis() : 0;
+        }
+    }
+}
+
+void buildDebugSensorsPayload(JsonDocument &doc)
+{
+    doc["test"] = "sensor_data";
+    doc["free_heap"] = ESP.getFreeHeap();
+    doc["uptime"] = millis();
+
+    doc["temperature"] = sensorData.temperature;
+    doc["humidity"] = sensorData.humidity;
+    doc["motion"] = sensorData.presence;
+    doc["luminescence"] = sensorData.lux;
+    doc["timestamp"] = sensorData.timestamp;
+    doc["radar_presence"] = sensorData.radar_presence;
+
+    doc["dht_available"] = sensorData.dht_available;
+    doc["tsl_available"] = sensorData.tsl_available;
+    doc["pir_available"] = sensorData.pir_available;
+    doc["radar_available"] = sensorData.radar_available;
+}
+
+void buildHealthPayload(JsonDocument &doc)
+{
+    doc["status"] = "ok";
+    doc["uptime"] = millis();
+    doc["free_heap"] = ESP.getFreeHeap();
+    doc["wifi_rssi"] = WiFi.RSSI();
+    doc["ip"] = WiFi.localIP().toString();
+    doc["reset_reason"] = ESP.getResetReason();
+}
+
+// Pins, system, timing and topics, common to /api/config/full and the export
+static void addFixedConfig(JsonDocument &doc)
+{
+    doc["mqtt_broker"] = config.mqtt_broker;
+    doc["mqtt_port"] = config.mqtt_port;
+    doc["mqtt_username"] = config.mqtt_username;
+    doc["location"] = config.location;
+    doc["mqtt_enabled"] = config.mqtt_enabled;
+    doc["sensorless_mode"] = config.sensorless_mode;
+
+    doc["pins"]["dht11"] = DHT_PIN;
+    doc["pins"]["pir"] = PIR_PIN;
+    doc["pins"]["led"] = LED_PIN;
+    doc["pins"]["sda"] = SDA_PIN;
+    doc["pins"]["scl"] = SCL_PIN;
+
+    doc["system"]["device_hostname"] = deviceHostname; // Use MDNS.hostname() for the actual hostname
+    doc["system"]["wifi_ssid"] = WIFI_SSID;
+    doc["system"]["wifi_password"] = WIFI_PASSWORD;
+    doc["system"]["ap_ip"] = AP_IP;
+
+    doc["timing"]["sensor_read_interval"] = SENSOR_READ_INTERVAL;
+    doc["timing"]["mqtt_publish_interval"] = MQTT_PUBLISH_INTERVAL;
+    doc["timing"]["pir_cooldown"] = PIR_COOLDOWN;
+    doc["timing"]["ota_check_interval"] = OTA_CHECK_INTERVAL;
+
+    doc["mqtt_topics"]["temperature"] = MQTT_TOPIC_TEMPERATURE;
+    doc["mqtt_topics"]["humidity"] = MQTT_TOPIC_HUMIDITY;
+    doc["mqtt_topics"]["motion"] = MQTT_TOPIC_MOTION;
+    doc["mqtt_topics"]["luminescence"] = MQTT_TOPIC_LUMINESCENCE;
+    doc["mqtt_topics"]["status"] = MQTT_TOPIC_STATUS;
+    doc["mqtt_topics"]["all"] = MQTT_TOPIC_ALL;
+}
+
+void buildConfigFullPayload(JsonDocument &doc)
+{
+    addFixedConfig(doc);
+
+    const ConfigStoreStats &store = getConfigStoreStats();
+    doc["storage"]["backend"] = store.backend;
+    doc["storage"]["version"] = CONFIG_VERSION;
+    doc["storage"]["loaded_version"] = store.loaded_version;
+    doc["storage"]["size"] = sizeof(ConfigData) + sizeof(ConfigRecordHeader);
+    doc["storage"]["erases"] = store.sequence;
+    doc["storage"]["writes"] = store.writes;
+    doc["storage"]["skipped_writes"] = store.skipped;
+}
+
+void buildConfigExportPayload(JsonDocument &doc)
+{
+    addFixedConfig(doc);
+    doc["mqtt_password"] = config.mqtt_password;
+    doc["export_timestamp"] = millis();
+    doc["export_uptime"] = millis();
+}
+
+// Boot phase timings
+void buildBootPayload(JsonDocument &doc)
+{
+    doc["reset_reason"] = ESP.getResetReason();
+    doc["setup_ms"] = getBootSetupMs();
+
+    JsonArray phases = doc.createNestedArray("phases");
+    for (uint8_t i = 0; i < getBootPhaseCount(); i++)
+    {
+        const BootPhase &phase = getBootPhase(i);
+        JsonObject entry = phases.createNestedObject();
+        entry["name"] = phase.name;
+        entry["start_ms"] = phase.start_ms;
+        entry["duration_ms"] = phase.duration_ms;
+    }
+
+    const WifiConnectStats &wifi = getWifiConnectStats();
+    doc["wifi"]["fast_path"] = wifi.fast_path;
+    doc["wifi"]["fast_path_attempted"] = wifi.fast_path_attempted;
+    doc["wifi"]["connect_ms"] = wifi.connect_ms;
+    doc["wifi"]["fast_fail_ms"] = wifi.fast_fail_ms;
+    doc["wifi"]["channel"] = WiFi.channel();
+    doc["wifi"]["bssid"] = WiFi.BSSIDstr();
+
+    for (uint8_t i = 0; i < getBootEventCount(); i++)
+    {
+        const BootEvent &event = getBootEvent(i);
+        doc["events"][event.name] = event.at_ms;
+    }
+}
+
+// Idle scheduling and duty cycle
+void buildPowerPayload(JsonDocument &doc)
+{
+    const PowerStats &stats = getPowerStats();
+    doc["enabled"] = (bool)ENABLE_POWER_MANAGER;
+    doc["duty_cycle"] = powerDutyCycle();
+    doc["busy_ms"] = stats.busy_ms;
+    doc["modem_sleep_ms"] = stats.modem_sleep_ms;
+    doc["light_sleep_ms"] = stats.light_sleep_ms;
+    doc["idle_calls"] = stats.idle_calls;
+    doc["early_wakes"] = stats.early_wakes;
+    doc["capped_waits"] = stats.capped_waits;
+    doc["last_mode"] = getPowerIdleModeName(stats.last_mode);
+    doc["last_wait_ms"] = stats.last_wait_ms;
+}
+
+// MQTT connection, publish and command statistics
+void buildMqttPayload(JsonDocument &doc)
+{
+    doc["connected"] = mqttClient.connected();
+    doc["state"] = mqttClient.state();
+    doc["client_id"] = getMqttClientId();
+
+    const MqttConnectionStats &connection = getMqttConnectionStats();
+    doc["connection"]["attempts"] = connection.attempts;
+    doc["connection"]["connects"] = connection.connects;
+    doc["connection"]["resumed_sessions"] = connection.resumed_sessions;
+    doc["connection"]["session_present"] = connection.session_present;
+    doc["connection"]["last_connect_ms"] = connection.last_connect_ms;
+    doc["connection"]["dns_lookups"] = connection.dns_lookups;
+    doc["connection"]["dns_failures"] = connection.dns_failures;
+    doc["connection"]["dns_fallbacks"] = connection.dns_fallbacks;
+    doc["connection"]["first_connect_ms"] = connection.first_connect_ms;
+#if MQTT_USE_TLS
+    doc["tls"]["mfln_supported"] = connection.mfln_supported;
+    doc["tls"]["heap_bytes"] = connection.tls_heap_bytes;
+#endif
+
+    unsigned long totalPublished = 0;
+    unsigned long totalSuppressed = 0;
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        const PublishFilterState &state = getPublishFilterState((PublishMetric)i);
+        JsonObject metric = doc["metrics"].createNestedObject(getPublishMetricName((PublishMetric)i));
+        metric["published"] = state.published;
+        metric["suppressed"] = state.suppressed;
+        totalPublished += state.published;
+        totalSuppressed += state.suppressed;
+    }
+    doc["published"] = totalPublished;
+    doc["suppressed"] = totalSuppressed;
+
+    const MqttQosStats &qos = getMqttQosStats();
+    doc["qos1"]["inflight"] = mqttInflightCount();
+    doc["qos1"]["window"] = MQTT_QOS1_WINDOW;
+    doc["qos1"]["sent"] = qos.sent;
+    doc["qos1"]["acked"] = qos.acked;
+    doc["qos1"]["retransmitted"] = qos.retransmitted;
+    doc["qos1"]["deferred"] = qos.deferred;
+    doc["qos1"]["fallback_qos0"] = qos.fallback_qos0;
+    doc["qos1"]["unknown_acks"] = qos.unknown_acks;
+    doc["qos1"]["max_ack_ms"] = qos.max_ack_ms;
+
+    for (uint8_t i = 0; i < mqttRouteCount(); i++)
+    {
+        MqttRouteStats route = getMqttRouteStats(i);
+        doc["commands"]["routes"][route.filter] = route.dispatched;
+    }
+    doc["commands"]["unmatched"] = mqttUnmatchedCount();
+    doc["commands"]["dropped"] = mqttDroppedCount();
+}
+
+// Largest size and document usage of each budgeted payload since boot
+void buildPayloadsPayload(JsonDocument &doc)
+{
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        const PayloadStats &stats = payloadStats[i];
+        JsonObject entry = doc.createNestedObject(payloadNames[i]);
+        entry["capacity"] = payloadCapacities[i];
+        entry["max_used"] = stats.max_used;
+        entry["max_bytes"] = stats.max_bytes;
+        entry["overflows"] = stats.overflows;
+    }
+}
+
+void buildRelayPayload(JsonDocument &doc, const char *message)
+{
+    doc["state"] = getRelayState();
+    doc["pin"] = getRelayPin();
+    if (message)
+    {
+        doc["message"] = message;
+    }
+}
+
+#if ENABLE_CRASH_DIAG
+void buildResetDiagPayload(JsonDocument &doc)
+{
+    RtcDiagRecord previous;
+    doc["reset_reason"] = ESP.getResetReason();
+    doc["failure"] = crashDiagResetIsFailure();
+    doc["boot_count"] = getCurrentDiag().boot_count;
+    if (getPreviousDiag(previous))
+    {
+        doc["uptime_ms"] = previous.uptime_ms;
+        if (previous.last_section != DIAG_NO_SECTION)
+        {
+            doc["section"] = getPerfSectionName((PerfSectionId)previous.last_section);
+            doc["in_section"] = previous.in_section != 0;
+        }
+        doc["last_uri"] = previous.last_uri;
+        doc["loop_max_us"] = previous.loop_max_us;
+        doc["heap_min"] = previous.heap_min;
+        doc["frag_max"] = previous.frag_max;
+        doc["stack_min"] = previous.stack_min;
+    }
+}
+
+// What the previous run was doing when it reset, plus the RTC event ring
+void buildDiagPayload(JsonDocument &doc)
+{
+    const RtcDiagRecord &current = getCurrentDiag();
+    const rst_info *info = ESP.getResetInfoPtr();
+    doc["boot_count"] = current.boot_count;
+    doc["reset_reason"] = ESP.getResetReason();
+    doc["failure"] = crashDiagResetIsFailure();
+    if (info->reason == REASON_EXCEPTION_RST)
+    {
+        char hex[11];
+        doc["exception"]["cause"] = info->exccause;
+        snprintf(hex, sizeof(hex), "0x%08x", info->epc1);
+        doc["exception"]["epc1"] = hex;
+        snprintf(hex, sizeof(hex), "0x%08x", info->excvaddr);
+        doc["exception"]["excvaddr"] = hex;
+    }
+
+    RtcDiagRecord previous;
+    if (getPreviousDiag(previous))
+    {
+        JsonObject prev = doc.createNestedObject("previous");
+        prev["uptime_ms"] = previous.uptime_ms;
+        if (previous.last_section != DIAG_NO_SECTION)
+        {
+            prev["section"] = getPerfSectionName((PerfSectionId)previous.last_section);
+            prev["in_section"] = previous.in_section != 0;
+        }
+        prev["last_uri"] = previous.last_uri;
+        prev["loop_last_us"] = previous.loop_last_us;
+        prev["loop_max_us"] = previous.loop_max_us;
+        prev["heap_min"] = previous.heap_min;
+        prev["frag_max"] = previous.frag_max;
+        prev["stack_min"] = previous.stack_min;
+    }
+
+    // Oldest first; a "boot" entry separates runs and carries its reset reason
+    JsonArray events = doc.createNestedArray("events");
+    for (uint8_t i = 0; i < current.event_count; i++)
+    {
+        const DiagEvent &event = current.events[(current.event_head + i) % DIAG_EVENT_CAPACITY];
+        JsonObject entry = events.createNestedObject();
+        entry["t"] = event.t_ms;
+        entry["event"] = getDiagEventName(event.code);
+        entry["arg"] = event.arg;
+    }
+}
+#endif
+
+#if ENABLE_PROFILER
+// Per section: [count, mean_us, max_us]; no histograms to stay within the MQTT buffer
+void buildPerfDiagPayload(JsonDocument &doc)
+{
+    const PerfLoopStats &loopStats = getPerfLoopStats();
+    doc["loop"]["mean_us"] = (uint32_t)loopStats.mean_us;
+    doc["loop"]["jitter_us"] = (uint32_t)perfLoopJitterUs();
+    doc["loop"]["max_us"] = (uint32_t)perfCyclesToUs(loopStats.max_cycles);
+    for (int i = 0; i < PERF_SECTION_COUNT; i++)
+    {
+        const PerfSection &section = getPerfSection((PerfSectionId)i);
+        if (section.count == 0)
+        {
+            continue;
+        }
+        JsonArray entry = doc["sections"].createNestedArray(getPerfSectionName((PerfSectionId)i));
+        entry.add(section.count);
+        entry.add((uint32_t)(perfCyclesToUs(section.total_cycles) / section.count));
+        entry.add((uint32_t)perfCyclesToUs(section.max_cycles));
+    }
+}
+
+// loop() section timings. Histogram bucket i counts durations in
+// [2^i, 2^(i+1)) us; trailing zeros trimmed
+void buildPerfPayload(JsonDocument &doc)
+{
+    doc["cpu_mhz"] = ESP.getCpuFreqMHz();
+
+    const PerfLoopStats &loopStats = getPerfLoopStats();
+    JsonObject loopObj = doc.createNestedObject("loop");
+    loopObj["count"] = loopStats.count;
+    loopObj["mean_us"] = loopStats.mean_us;
+    loopObj["jitter_us"] = perfLoopJitterUs();
+    loopObj["min_us"] = perfCyclesToUs(loopStats.min_cycles);
+    loopObj["max_us"] = perfCyclesToUs(loopStats.max_cycles);
+
+    JsonObject sectionsObj = doc.createNestedObject("sections");
+    for (int i = 0; i < PERF_SECTION_COUNT; i++)
+    {
+        const PerfSection &section = getPerfSection((PerfSectionId)i);
+        JsonObject entry = sectionsObj.createNestedObject(getPerfSectionName((PerfSectionId)i));
+        entry["count"] = section.count;
+        entry["total_us"] = perfCyclesToUs(section.total_cycles);
+        entry["max_us"] = perfCyclesToUs(section.max_cycles);
+        entry["mean_us"] = section.count > 0 ? perfCyclesToUs(section.total_cycles) / section.count : 0.0f;
+        int last = PERF_HISTOGRAM_BUCKETS - 1;
+        while (last >= 0 && section.histogram[last] == 0)
+        {
+            last--;
+        }
+        JsonArray histogram = entry.createNestedArray("histogram");
+        for (int b = 0; b <= last; b++)
+        {
+            histogram.add(section.histogram[b]);
+        }
+    }
+}
+#endif
+
+#if ENABLE_HEAP_MONITOR
+// Heap history, low-water marks and (tracking builds) allocation sites
+void buildHeapPayload(JsonDocument &doc)
+{
+    doc["free"] = ESP.getFreeHeap();
+    doc["max_block"] = ESP.getMaxFreeBlockSize();
+    doc["fragmentation"] = ESP.getHeapFragmentation();
+    doc["free_cont_stack"] = ESP.getFreeContStack();
+
+    const HeapStats &stats = getHeapStats();
+    JsonObject low = doc.createNestedObject("low_water");
+    low["free"] = stats.min_free;
+    low["max_block"] = stats.min_max_block;
+    low["fragmentation"] = stats.max_fragmentation;
+    low["free_cont_stack"] = stats.min_free_cont_stack;
+
+    // Columns keep the history compact: [t_s, free, max_block, fragmentation]
+    JsonArray history = doc.createNestedArray("history");
+    for (uint8_t i = 0; i < getHeapHistoryCount(); i++)
+    {
+        const HeapSample &sample = getHeapHistory(i);
+        JsonArray row = history.createNestedArray();
+        row.add(sample.t_s);
+        row.add(sample.free_bytes);
+        row.add(sample.max_block);
+        row.add(sample.fragmentation);
+    }
+
+    doc["tracking"] = (bool)HEAP_TRACK_ALLOCATIONS;
+    if (HEAP_TRACK_ALLOCATIONS)
+    {
+        const HeapTrackStats &track = getHeapTrackStats();
+        doc["tracked"] = track.tracked;
+        doc["untracked"] = track.untracked;
+        doc["site_overflow"] = track.site_overflow;
+        JsonArray sites = doc.createNestedArray("sites");
+        for (uint8_t i = 0; i < getHeapSiteCount(); i++)
+        {
+            const HeapSite &site = getHeapSite(i);
+            JsonObject entry = sites.createNestedObject();
+            char address[11];
+            snprintf(address, sizeof(address), "0x%08x", site.address);
+            entry["address"] = address;
+            entry["live_bytes"] = site.live_bytes;
+            entry["live_count"] = site.live_count;
+            entry["peak_bytes"] = site.peak_bytes;
+            entry["allocations"] = site.allocations;
+        }
+    }
+}
+#endif
+
+#if ENABLE_LOG_RING
+void buildLogEntryPayload(JsonDocument &doc, const LogEntry &entry, bool raw)
+{
+    doc["seq"] = entry.seq;
+    doc["t"] = entry.t_ms;
+    doc["category"] = getLogCategoryName(entry.category);
+    doc["level"] = getLogLevelName(entry.level);
+    if (raw)
+    {
+        char fmt[11];
+        snprintf(fmt, sizeof(fmt), "0x%08x", (uint32_t)(uintptr_t)entry.fmt);
+        doc["fmt"] = fmt;
+        JsonArray args = doc.createNestedArray("args");
+        for (uint8_t a = 0; a < entry.argc; a++)
+        {
+            JsonArray arg = args.createNestedArray();
+            arg.add(entry.types[a]);
+            if (entry.types[a] == LOG_ARG_TEXT)
+            {
+                arg.add(entry.text + entry.args[a].raw);
+            }
+            else if (entry.types[a] == LOG_ARG_LITERAL)
+            {
+                arg.add((uint32_t)(uintptr_t)entry.args[a].literal);
+            }
+            else
+            {
+                arg.add(entry.args[a].raw);
+            }
+        }
+    }
+    else
+    {
+        char message[LOG_ENTRY_MESSAGE_BYTES];
+        logFormat(entry, message, sizeof(message));
+        doc["message"] = message;
+    }
+}
+#endif
+
+#if ENABLE_LD2410_CAPTURE
+void buildLd2410CapturePayload(JsonDocument &doc)
+{
+    const Ld2410CaptureStats &stats = getLd2410CaptureStats();
+    doc["active"] = ld2410CaptureActive();
+    doc["sink"] = getLd2410CaptureSinkName(stats.sink);
+    doc["duration_ms"] = stats.sink == LD2410_CAPTURE_NONE ? 0 : millis() - stats.started_ms;
+    doc["bytes_rx"] = stats.bytes_rx;
+    doc["bytes_tx"] = stats.bytes_tx;
+    doc["records"] = stats.records;
+    doc["written"] = stats.written;
+    doc["dropped"] = stats.dropped;
+    doc["limit_reached"] = stats.limit_reached;
+    doc["max_bytes"] = LD2410_CAPTURE_MAX_BYTES;
+}
+#endif
+
+void serializePayload(PayloadId id, const JsonDocument &doc, String &output, bool pretty)
+{
+    size_t start = output.length();
+    if (pretty)
+    {
+        serializeJsonPretty(doc, output);
+    }
+    else
+    {
+        serializeJson(doc, output);
+    }
+    size_t bytes = output.length() - start;
+
+    PayloadStats &stats = payloadStats[id];
+    if (bytes > stats.max_bytes)
+    {
+        stats.max_bytes = bytes;
+    }
+    if (doc.memoryUsage() > stats.max_used)
+    {
+        stats.max_used = doc.memoryUsage();
+    }
+    if (doc.overflowed())
+    {
+        stats.overflows++;
+        DEBUG_PRINTF("Payload %s overflowed its %u byte document\n", payloadNames[id], (unsigned)doc.capacity());
+    }
+}
+
+const char *getPayloadName(PayloadId id)
+{
+    return payloadNames[id];
+}
+
+size_t getPayloadCapacity(PayloadId id)
+{
+    return payloadCapacities[id];
+}
+
+const PayloadStats &getPayloadStats(PayloadId id)
+{
+    return payloadStats[id];
+}
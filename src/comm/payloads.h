@@ -0,0 +1,182 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "model/data_structs.h"
+#include "power/rtc_ring.h"
+#include "debug/boot_timing.h"
+#include "debug/crash_diag.h"
+#include "debug/heap_monitor.h"
+#include "debug/log_ring.h"
+#include "debug/profiler.h"
+
+// Builders for the JSON documents served over HTTP and published over MQTT,
+// with capacities derived from the fields they hold rather than guessed.
+// Keys, FIRMWARE_VERSION and the metric/section names are string literals that
+// ArduinoJson stores by pointer; only char arrays and Strings take pool space.
+// host/PayloadBudget builds each one with worst-case values and checks the
+// results against checked-in budgets.
+
+#define JSON_CONFIG_STRING_SIZE JSON_STRING_SIZE(sizeof(ConfigData::location))
+// ESP.getResetReason() is a String; the longest is "Software/System restart"
+#define JSON_RESET_REASON_SIZE JSON_STRING_SIZE(32)
+// "0x%08x" formatted addresses
+#define JSON_HEX32_SIZE JSON_STRING_SIZE(10)
+
+#define JSON_CAPACITY_SENSORS JSON_OBJECT_SIZE(20)
+#define JSON_CAPACITY_ALL (JSON_OBJECT_SIZE(13) + JSON_CONFIG_STRING_SIZE)
+#define JSON_CAPACITY_RELAY_STATE (JSON_OBJECT_SIZE(4) + JSON_CONFIG_STRING_SIZE)
+#define JSON_CAPACITY_CONFIG (JSON_OBJECT_SIZE(14) + JSON_OBJECT_SIZE(PUBLISH_METRIC_COUNT) + \
+                              PUBLISH_METRIC_COUNT * JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(7) + \
+                              JSON_OBJECT_SIZE(SENSOR_COUNT) + SENSOR_COUNT * JSON_OBJECT_SIZE(3) + \
+                              3 * JSON_CONFIG_STRING_SIZE)
+#define JSON_CAPACITY_DIAG_RESET (JSON_OBJECT_SIZE(11) + JSON_RESET_REASON_SIZE + JSON_STRING_SIZE(DIAG_URI_BYTES))
+#define JSON_CAPACITY_DIAG_PERF (JSON_OBJECT_SIZE(2) + JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(PERF_SECTION_COUNT) + \
+                                 PERF_SECTION_COUNT * JSON_ARRAY_SIZE(3))
+// One {location}/batch message: an object per sample with age_s, t,
+// temperature, humidity and luminescence
+#define JSON_CAPACITY_SLEEP_BATCH (JSON_OBJECT_SIZE(4) + JSON_ARRAY_SIZE(DEEP_SLEEP_SAMPLES_PER_MESSAGE) + \
+                                   DEEP_SLEEP_SAMPLES_PER_MESSAGE * JSON_OBJECT_SIZE(5))
+
+// HTTP status documents
+#define JSON_CAPACITY_SENSOR_CONFIG JSON_OBJECT_SIZE(5)
+#define JSON_CAPACITY_SENSOR_METRICS (JSON_OBJECT_SIZE(SENSOR_COUNT) + SENSOR_COUNT * JSON_OBJECT_SIZE(19))
+#define JSON_CAPACITY_DEBUG_SENSORS JSON_OBJECT_SIZE(14)
+// WiFi.localIP().toString() is a String
+#define JSON_CAPACITY_HEALTH (JSON_OBJECT_SIZE(6) + JSON_STRING_SIZE(15) + JSON_RESET_REASON_SIZE)
+// deviceHostname is "esp8266-" and the sanitized location
+#define JSON_HOSTNAME_SIZE JSON_STRING_SIZE(8 + sizeof(ConfigData::location) - 1)
+#define JSON_CONFIG_FIXED_SIZE (JSON_OBJECT_SIZE(5) + JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(4) + \
+                                JSON_OBJECT_SIZE(6) + JSON_HOSTNAME_SIZE + 3 * JSON_CONFIG_STRING_SIZE)
+#define JSON_CAPACITY_CONFIG_FULL (JSON_OBJECT_SIZE(11) + JSON_CONFIG_FIXED_SIZE + JSON_OBJECT_SIZE(7))
+#define JSON_CAPACITY_CONFIG_EXPORT (JSON_OBJECT_SIZE(13) + JSON_CONFIG_FIXED_SIZE + \
+                                     JSON_STRING_SIZE(sizeof(ConfigData::mqtt_password)))
+// WiFi.BSSIDstr() is a String of 17 characters
+#define JSON_CAPACITY_BOOT (JSON_OBJECT_SIZE(5) + JSON_RESET_REASON_SIZE + JSON_ARRAY_SIZE(BOOT_MAX_PHASES) + \
+                            BOOT_MAX_PHASES * JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(6) + JSON_STRING_SIZE(17) + \
+                            JSON_OBJECT_SIZE(BOOT_MAX_EVENTS))
+#define JSON_CAPACITY_PERF (JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(5) + JSON_OBJECT_SIZE(PERF_SECTION_COUNT) + \
+                            PERF_SECTION_COUNT * (JSON_OBJECT_SIZE(5) + JSON_ARRAY_SIZE(PERF_HISTOGRAM_BUCKETS)))
+// Allocation sites and their counters only in HEAP_TRACK_ALLOCATIONS builds
+#define JSON_CAPACITY_HEAP (JSON_OBJECT_SIZE(7 + 4 * HEAP_TRACK_ALLOCATIONS) + JSON_OBJECT_SIZE(4) + \
+                            JSON_ARRAY_SIZE(HEAP_HISTORY_SIZE) + HEAP_HISTORY_SIZE * JSON_ARRAY_SIZE(4) + \
+                            HEAP_TRACK_ALLOCATIONS * (JSON_ARRAY_SIZE(HEAP_TRACK_SITES) + \
+                                                      HEAP_TRACK_SITES * (JSON_OBJECT_SIZE(5) + JSON_HEX32_SIZE)))
+// One /api/logs entry, formatted or raw; both share the document
+#define LOG_ENTRY_MESSAGE_BYTES 128
+#define JSON_CAPACITY_LOG_ENTRY (JSON_OBJECT_SIZE(6) + JSON_STRING_SIZE(LOG_ENTRY_MESSAGE_BYTES) + JSON_HEX32_SIZE + \
+                                 JSON_ARRAY_SIZE(LOG_MAX_ARGS) + LOG_MAX_ARGS * JSON_ARRAY_SIZE(2))
+#define JSON_CAPACITY_DIAG (JSON_OBJECT_SIZE(6) + JSON_RESET_REASON_SIZE + JSON_OBJECT_SIZE(3) + 2 * JSON_HEX32_SIZE + \
+                            JSON_OBJECT_SIZE(9) + JSON_STRING_SIZE(DIAG_URI_BYTES) + \
+                            JSON_ARRAY_SIZE(DIAG_EVENT_CAPACITY) + DIAG_EVENT_CAPACITY * JSON_OBJECT_SIZE(3))
+#define JSON_CAPACITY_LD2410_CAPTURE JSON_OBJECT_SIZE(10)
+#define JSON_CAPACITY_POWER JSON_OBJECT_SIZE(10)
+// getMqttClientId() is a String: MQTT_CLIENT_ID, '-' and the chip ID in hex
+#define JSON_CAPACITY_MQTT (JSON_OBJECT_SIZE(9 + MQTT_USE_TLS) + JSON_STRING_SIZE(sizeof(MQTT_CLIENT_ID) + 8) + \
+                            JSON_OBJECT_SIZE(9) + MQTT_USE_TLS * JSON_OBJECT_SIZE(2) + \
+                            JSON_OBJECT_SIZE(PUBLISH_METRIC_COUNT) + PUBLISH_METRIC_COUNT * JSON_OBJECT_SIZE(2) + \
+                            JSON_OBJECT_SIZE(9) + JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(MQTT_MAX_ROUTES))
+#define JSON_CAPACITY_PAYLOADS (JSON_OBJECT_SIZE(PAYLOAD_COUNT) + PAYLOAD_COUNT * JSON_OBJECT_SIZE(4))
+#define JSON_CAPACITY_RELAY JSON_OBJECT_SIZE(3)
+
+// Request bodies. The web server hands over a String, so deserializeJson()
+// copies every key and string value into the document; test_payload_budget
+// parses the largest valid body of each
+// POST /api/logs: "serial" and a level for each category, names of 7 characters at most
+#define JSON_LOG_NAME_SIZE JSON_STRING_SIZE(7)
+#define JSON_CAPACITY_LOG_SETTINGS (JSON_OBJECT_SIZE(2) + 2 * JSON_STRING_SIZE(6) + \
+                                    JSON_OBJECT_SIZE(LOG_CAT_COUNT) + 2 * LOG_CAT_COUNT * JSON_LOG_NAME_SIZE)
+// POST /api/ld2410/capture: action, host and port; the keys and the action
+// are 6 characters at most
+#define LD2410_CAPTURE_HOST_BYTES 64
+#define JSON_CAPACITY_LD2410_CAPTURE_REQUEST (JSON_OBJECT_SIZE(3) + 4 * JSON_STRING_SIZE(6) + \
+                                              JSON_STRING_SIZE(LD2410_CAPTURE_HOST_BYTES))
+
+// Replies that hold only literals and scalars: fixed size, so no budget
+#define JSON_CAPACITY_REPLY JSON_OBJECT_SIZE(3)
+#define JSON_CAPACITY_SENSORS_RESET (JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(4) + 4 * JSON_OBJECT_SIZE(2))
+
+enum PayloadId
+{
+    PAYLOAD_SENSORS,     // GET /api/sensors
+    PAYLOAD_CONFIG,      // GET /api/config
+    PAYLOAD_ALL,         // {location}/all
+    PAYLOAD_RELAY_STATE, // {location}/relay/state
+    PAYLOAD_DIAG_RESET,  // {location}/diag/reset
+    PAYLOAD_DIAG_PERF,   // {location}/diag/perf
+    PAYLOAD_SLEEP_BATCH, // {location}/batch
+    PAYLOAD_SENSOR_CONFIG,  // GET /api/sensor-config
+    PAYLOAD_SENSOR_METRICS, // GET /api/sensors/metrics
+    PAYLOAD_DEBUG_SENSORS,  // GET /debug/sensors
+    PAYLOAD_HEALTH,         // GET /health
+    PAYLOAD_CONFIG_FULL,    // GET /api/config/full
+    PAYLOAD_CONFIG_EXPORT,  // GET /api/config/export
+    PAYLOAD_BOOT,           // GET /api/boot
+    PAYLOAD_PERF,           // GET /api/perf
+    PAYLOAD_HEAP,           // GET /api/heap
+    PAYLOAD_LOG_ENTRY,      // One GET /api/logs entry
+    PAYLOAD_LOG_ENTRY_RAW,  // One GET /api/logs?raw=1 entry
+    PAYLOAD_DIAG,           // GET /api/diag
+    PAYLOAD_LD2410_CAPTURE, // GET /api/ld2410/capture
+    PAYLOAD_POWER,          // GET /api/power
+    PAYLOAD_MQTT,           // GET /api/mqtt
+    PAYLOAD_PAYLOADS,       // GET /api/payloads
+    PAYLOAD_RELAY,          // GET and POST /api/relay
+    PAYLOAD_COUNT
+};
+
+// Largest seen since boot; overflows count documents that ran out of capacity
+// and so went out with fields missing
+struct PayloadStats
+{
+    uint16_t max_bytes;
+    uint16_t max_used;
+    uint16_t overflows;
+};
+
+void buildSensorsPayload(JsonDocument &doc);
+void buildAllPayload(JsonDocument &doc);
+void buildRelayStatePayload(JsonDocument &doc);
+// ring: the last battery run, or nullptr if RTC memory holds none
+void buildConfigPayload(JsonDocument &doc, const SleepRing *ring);
+// The oldest 'count' samples of the ring; epoch 0 if NTP did not answer
+void buildSleepBatchPayload(JsonDocument &doc, const SleepRing &ring, uint16_t count, uint32_t epoch);
+void buildSensorConfigPayload(JsonDocument &doc);
+void buildSensorMetricsPayload(JsonDocument &doc);
+void buildDebugSensorsPayload(JsonDocument &doc);
+void buildHealthPayload(JsonDocument &doc);
+void buildConfigFullPayload(JsonDocument &doc);
+// Includes the MQTT password, for saving to a file
+void buildConfigExportPayload(JsonDocument &doc);
+void buildBootPayload(JsonDocument &doc);
+void buildPowerPayload(JsonDocument &doc);
+void buildMqttPayload(JsonDocument &doc);
+void buildPayloadsPayload(JsonDocument &doc);
+// message: what a POST did, nullptr for GET
+void buildRelayPayload(JsonDocument &doc, const char *message);
+#if ENABLE_CRASH_DIAG
+void buildResetDiagPayload(JsonDocument &doc);
+void buildDiagPayload(JsonDocument &doc);
+#endif
+#if ENABLE_PROFILER
+void buildPerfDiagPayload(JsonDocument &doc);
+void buildPerfPayload(JsonDocument &doc);
+#endif
+#if ENABLE_HEAP_MONITOR
+void buildHeapPayload(JsonDocument &doc);
+#endif
+#if ENABLE_LOG_RING
+// raw: format address and arguments instead of the formatted message
+void buildLogEntryPayload(JsonDocument &doc, const LogEntry &entry, bool raw);
+#endif
+#if ENABLE_LD2410_CAPTURE
+void buildLd2410CapturePayload(JsonDocument &doc);
+#endif
+
+// serializeJson() (or serializeJsonPretty()) plus the size and overflow
+// bookkeeping above; appends to output, and only the appended bytes count
+void serializePayload(PayloadId id, const JsonDocument &doc, String &output, bool pretty = false);
+
+const char *getPayloadName(PayloadId id);
+size_t getPayloadCapacity(PayloadId id);
+const PayloadStats &getPayloadStats(PayloadId id);
@@ -0,0 +1,143 @@
+#include <Arduino.h>
+#include <math.h>
+#include "config.h"
+#include "comm/publish_filter.h"
+#include "model/data_structs.h"
+#include "debug/debug_macros.h"
+
+static PublishFilterState publishState[PUBLISH_METRIC_COUNT];
+
+static const char *const publishMetricNames[PUBLISH_METRIC_COUNT] = {
+    "temperature",
+    "humidity",
+    "luminescence",
+    "motion",
+    "radar",
+    "relay",
+    "all"};
+
+// Common gate: min interval first, then forced heartbeat, then the caller's verdict
+static bool gatePublish(PublishMetric metric, bool changed, unsigned long now)
+{
+    PublishFilterState &state = publishState[metric];
+    const PublishThreshold &threshold = config.publish[metric];
+
+    if (!state.has_value)
+    {
+        return true;
+    }
+
+    unsigned long elapsed = now - state.last_publish;
+    if (elapsed < threshold.min_interval)
+    {
+        state.suppressed++;
+        return false;
+    }
+    if (elapsed >= threshold.max_interval || changed)
+    {
+        return true;
+    }
+
+    state.suppressed++;
+    return false;
+}
+
+bool shouldPublish(PublishMetric metric, float value, unsigned long now)
+{
+    PublishFilterState &state = publishState[metric];
+    const PublishThreshold &threshold = config.publish[metric];
+
+    bool changed = fabsf(value - state.last_value) >= threshold.deadband;
+
+    // Rate of change is measured between consecutive samples, not publishes,
+    // so a fast ramp is reported even while it is still inside the deadband
+    if (!changed && threshold.rate_threshold > 0 && state.prev_sample_time != 0 && now != state.prev_sample_time)
+    {
+        float rate = fabsf(value - state.prev_sample) * 1000.0f / (float)(now - state.prev_sample_time);
+        changed = rate >= threshold.rate_threshold;
+    }
+    state.prev_sample = value;
+    state.prev_sample_time = now;
+
+    return gatePublish(metric, changed, now);
+}
+
+bool shouldPublishEvent(PublishMetric metric, bool changed, unsigned long now)
+{
+    return gatePublish(metric, changed, now);
+}
+
+void markPublished(PublishMetric metric, float value, unsigned long now)
+{
+    PublishFilterState &state = publishState[metric];
+    state.last_value = value;
+    state.last_publish = now;
+    state.has_value = true;
+    state.published++;
+}
+
+void resetPublishFilters()
+{
+    // Force a full publish on the next cycle; counters are kept
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        publishState[i].has_value = false;
+    }
+}
+
+const PublishFilterState &getPublishFilterState(PublishMetric metric)
+{
+    return publishState[metric];
+}
+
+const char *getPublishMetricName(PublishMetric metric)
+{
+    return publishMetricNames[metric];
+}
+
+int findPublishMetric(const char *name)
+{
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        if (strcmp(publishMetricNames[i], name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void applyDefaultPublishThresholds()
+{
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        config.publish[i].deadband = PUBLISH_BINARY_DEADBAND;
+        config.publish[i].rate_threshold = 0;
+        config.publish[i].min_interval = 0;
+        config.publish[i].max_interval = PUBLISH_HEARTBEAT_INTERVAL;
+    }
+    config.publish[PUBLISH_TEMPERATURE].deadband = PUBLISH_TEMPERATURE_DEADBAND;
+    config.publish[PUBLISH_HUMIDITY].deadband = PUBLISH_HUMIDITY_DEADBAND;
+    config.publish[PUBLISH_LUMINESCENCE].deadband = PUBLISH_LUMINESCENCE_DEADBAND;
+}
+
+bool validatePublishThresholds()
+{
+    return validatePublishThresholds(config.publish);
+}
+
+bool validatePublishThresholds(const PublishThreshold *thresholds)
+{
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        const PublishThreshold &threshold = thresholds[i];
+        if (isnan(threshold.deadband) || threshold.deadband < 0 ||
+            isnan(threshold.rate_threshold) || threshold.rate_threshold < 0 ||
+            threshold.max_interval == 0 || threshold.min_interval > threshold.max_interval)
+        {
+            MQTT_DEBUG_PRINTF("Invalid publish thresholds for %s\n", publishMetricNames[i]);
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "model/data_structs.h"
+
+// Per-metric publish bookkeeping and counters
+struct PublishFilterState
+{
+    float last_value;           // Value sent in the last publish
+    unsigned long last_publish; // millis() of the last publish
+    float prev_sample;          // Previous sample, used for rate of change
+    unsigned long prev_sample_time;
+    bool has_value;             // False until the first publish (or after reset)
+    unsigned long published;
+    unsigned long suppressed;
+};
+
+bool shouldPublish(PublishMetric metric, float value, unsigned long now);
+bool shouldPublishEvent(PublishMetric metric, bool changed, unsigned long now);
+void markPublished(PublishMetric metric, float value, unsigned long now);
+void resetPublishFilters();
+const PublishFilterState &getPublishFilterState(PublishMetric metric);
+const char *getPublishMetricName(PublishMetric metric);
+int findPublishMetric(const char *name);
+void applyDefaultPublishThresholds();
+bool validatePublishThresholds();
+bool validatePublishThresholds(const PublishThreshold *thresholds); // PUBLISH_METRIC_COUNT entries
@@ -2,19 +2,131 @@
 #include "comm/wifi_manager.h"
 #include "debug/debug_macros.h"
 #include "model/config_manager.h"
+#include "debug/boot_timing.h"
+#include "model/config_store.h"
+#include "debug/crash_diag.h"
 
 String deviceHostname = "";
 WiFiManager wifiManager;
 WiFiUDP ntpUDP;
 NTPClient timeClient(ntpUDP);
+static WifiConnectStats connectStats;
+
+// RTC copy of the cache survives soft and deep-sleep resets without touching
+// flash; the ConfigData copy covers power loss
+struct RtcWifiCache
+{
+    uint32_t crc;
+    WifiFastConnectCache cache;
+};
+
+static uint32_t wifiCacheCrc(const WifiFastConnectCache &cache)
+{
+    return crc32Update(0, (const uint8_t *)&cache, sizeof(cache));
+}
+
+static bool loadWifiCache(WifiFastConnectCache &cache)
+{
+    RtcWifiCache rtc;
+    if (ESP.rtcUserMemoryRead(RTC_WIFI_CACHE_BLOCK, (uint32_t *)&rtc, sizeof(rtc)) &&
+        rtc.crc == wifiCacheCrc(rtc.cache) && rtc.cache.valid)
+    {
+        cache = rtc.cache;
+        return true;
+    }
+    if (config.wifi_cache.valid)
+    {
+        cache = config.wifi_cache;
+        return true;
+    }
+    return false;
+}
+
+static void storeWifiCache(const WifiFastConnectCache &cache)
+{
+    RtcWifiCache rtc;
+    rtc.cache = cache;
+    rtc.crc = wifiCacheCrc(cache);
+    ESP.rtcUserMemoryWrite(RTC_WIFI_CACHE_BLOCK, (uint32_t *)&rtc, sizeof(rtc));
+    // Persisted by the saveConfig() in setupWiFi(); unchanged caches cost no write
+    config.wifi_cache = cache;
+}
+
+static void invalidateWifiCache()
+{
+    WifiFastConnectCache cache;
+    memset(&cache, 0, sizeof(cache));
+    storeWifiCache(cache);
+}
+
+static void captureWifiCache()
+{
+    WifiFastConnectCache cache;
+    memset(&cache, 0, sizeof(cache));
+    cache.ip = (uint32_t)WiFi.localIP();
+    cache.gateway = (uint32_t)WiFi.gatewayIP();
+    cache.subnet = (uint32_t)WiFi.subnetMask();
+    cache.dns = (uint32_t)WiFi.dnsIP();
+    memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+    cache.channel = WiFi.channel();
+    cache.valid = 1;
+    storeWifiCache(cache);
+}
+
+static bool fastConnect()
+{
+    WifiFastConnectCache cache;
+    String ssid = WiFi.SSID(); // Credentials saved by WiFiManager
+    String psk = WiFi.psk();
+    if (!loadWifiCache(cache) || ssid.length() == 0)
+    {
+        return false;
+    }
+
+    connectStats.fast_path_attempted = true;
+    unsigned long start = millis();
+
+    // Do not rewrite the SDK's flash config just because BSSID/channel are set
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+#if WIFI_FAST_CONNECT_STATIC_IP
+    WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet), IPAddress(cache.dns));
+#endif
+    WiFi.begin(ssid.c_str(), psk.c_str(), cache.channel, cache.bssid, true);
+
+    while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_FAST_CONNECT_TIMEOUT)
+    {
+        delay(10);
+        ESP.wdtFeed();
+    }
+    WiFi.persistent(true);
+
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        connectStats.fast_path = true;
+        connectStats.connect_ms = millis() - start;
+        DEBUG_PRINTF("WiFi fast connect in %lu ms (channel %u)\n", connectStats.connect_ms, cache.channel);
+        return true;
+    }
+
+    // AP moved or lease no longer valid: back to DHCP and a full scan
+    DEBUG_PRINTLN(LOG_LITERAL("WiFi fast connect failed, falling back to WiFiManager"));
+    connectStats.fast_fail_ms = millis() - start;
+    WiFi.disconnect();
+#if WIFI_FAST_CONNECT_STATIC_IP
+    WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+#endif
+    invalidateWifiCache();
+    return false;
+}
 
 void setupWiFi(bool forceConfigPortal)
 {
-    DEBUG_PRINTLN("Setting up WiFi...");
+    DEBUG_PRINTLN(LOG_LITERAL("Setting up WiFi..."));
 
     wifiManager.setAPCallback([](WiFiManager *myWiFiManager)
                               {
-        DEBUG_PRINTLN("Entered config mode");
+        DEBUG_PRINTLN(LOG_LITERAL("Entered config mode"));
         DEBUG_PRINTLN(WiFi.softAPIP());
         DEBUG_PRINTLN(myWiFiManager->getConfigPortalSSID()); });
 
@@ -39,18 +151,31 @@ void setupWiFi(bool forceConfigPortal)
     bool connected = false;
     if (forceConfigPortal)
     {
-        DEBUG_PRINTLN("Forcing WiFiManager config portal...");
+        DEBUG_PRINTLN(LOG_LITERAL("Forcing WiFiManager config portal..."));
         connected = wifiManager.startConfigPortal(WIFI_SSID, WIFI_PASSWORD);
     }
+#if WIFI_FAST_CONNECT
+    else if (fastConnect())
+    {
+        connected = true;
+    }
+#endif
     else
     {
+        unsigned long start = millis();
         connected = wifiManager.autoConnect(WIFI_SSID, WIFI_PASSWORD);
+        connectStats.connect_ms = millis() - start;
     }
     if (!connected)
     {
-        DEBUG_PRINTLN("Failed to connect and hit timeout");
+        DEBUG_PRINTLN(LOG_LITERAL("Failed to connect and hit timeout"));
         ESP.restart();
     }
+    bootEvent("wifi_connected");
+#if ENABLE_CRASH_DIAG
+    crashDiagEvent(DIAG_EVENT_WIFI_CONNECTED);
+#endif
+    captureWifiCache();
 
     strcpy(config.mqtt_broker, custom_mqtt_broker.getValue());
     config.mqtt_port = atoi(custom_mqtt_port.getValue());
@@ -62,13 +187,13 @@ void setupWiFi(bool forceConfigPortal)
 
     saveConfig();
 
-    DEBUG_PRINTLN("WiFi connected!");
-    DEBUG_PRINT("IP address: ");
+    DEBUG_PRINTLN(LOG_LITERAL("WiFi connected!"));
+    DEBUG_PRINT(LOG_LITERAL("IP address: "));
     DEBUG_PRINTLN(WiFi.localIP());
 
     if (config.mqtt_enabled)
     {
-        DEBUG_PRINTLN("MQTT Configuration:");
+        DEBUG_PRINTLN(LOG_LITERAL("MQTT Configuration:"));
         DEBUG_PRINTF("  Broker: %s:%d\n", config.mqtt_broker, config.mqtt_port);
         DEBUG_PRINTF("  Location: %s\n", config.location);
         DEBUG_PRINTF("  Username: %s\n", config.mqtt_username);
@@ -76,11 +201,11 @@ void setupWiFi(bool forceConfigPortal)
 
     if (config.sensorless_mode)
     {
-        DEBUG_PRINTLN("Sensorless Mode: ENABLED - No sensors will be used");
+        DEBUG_PRINTLN(LOG_LITERAL("Sensorless Mode: ENABLED - No sensors will be used"));
     }
     else
     {
-        DEBUG_PRINTLN("Sensorless Mode: DISABLED - All sensors will be used");
+        DEBUG_PRINTLN(LOG_LITERAL("Sensorless Mode: DISABLED - All sensors will be used"));
     }
 
     // Initialize NTP
@@ -100,9 +225,42 @@ void setupWiFi(bool forceConfigPortal)
     }
     else
     {
-        DEBUG_PRINTLN("mDNS responder failed to start");
+        DEBUG_PRINTLN(LOG_LITERAL("mDNS responder failed to start"));
     }
 }
+// Joins the saved network without WiFiManager: no portal, no parameters and no
+// mDNS. Used by battery wakes, which must give up quickly rather than block.
+bool connectWiFiStation(unsigned long timeoutMs)
+{
+#if WIFI_FAST_CONNECT
+    if (fastConnect())
+    {
+        captureWifiCache();
+        return true;
+    }
+#endif
+    unsigned long start = millis();
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(); // Credentials saved by WiFiManager
+    while (WiFi.status() != WL_CONNECTED && millis() - start < timeoutMs)
+    {
+        delay(10);
+        ESP.wdtFeed();
+    }
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        return false;
+    }
+    connectStats.connect_ms = millis() - start;
+    captureWifiCache();
+    return true;
+}
+
+const WifiConnectStats &getWifiConnectStats()
+{
+    return connectStats;
+}
+
 String sanitizeLocation(const String &location)
 {
     String sanitized = location;
@@ -12,7 +12,18 @@ extern String deviceHostname;
 extern WiFiManager wifiManager;
 extern NTPClient timeClient;
 
+// How the last WiFi connection was made
+struct WifiConnectStats
+{
+    bool fast_path;            // Joined the cached BSSID/channel directly
+    bool fast_path_attempted;
+    unsigned long connect_ms;  // WiFi.begin/autoConnect until an IP was assigned
+    unsigned long fast_fail_ms; // Time lost on a failed fast attempt
+};
+
 void setupWiFi(bool forceConfigPortal);
+bool connectWiFiStation(unsigned long timeoutMs);
 String sanitizeLocation(const String &location);
+const WifiConnectStats &getWifiConnectStats();
 
 #endif // WIFI_MANAGER_H 
\ No newline at end of file
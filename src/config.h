@@ -7,11 +7,32 @@
 // ============================================================================
 // SENSOR ENABLE FLAGS
 // ============================================================================
+// Hardware built into the firmware. 0 compiles the driver, its library, its
+// HTTP routes and MQTT topics out; the profile_* environments in
+// platformio.ini set these with -D (python build.py footprint compares them)
+#ifndef USE_DHT
 #define USE_DHT 1
+#endif
+#ifndef USE_TSL2561
 #define USE_TSL2561 1
-#define USE_PIR 0
+#endif
+#ifndef USE_PIR
+#define USE_PIR 1
+#endif
+#ifndef USE_LD2410
 #define USE_LD2410 1
-#define USE_RELAY 0
+#endif
+#ifndef USE_RELAY
+#define USE_RELAY 1
+#endif
+
+// Runtime defaults for config.use_* (/api/config); only hardware built in
+// above can be enabled
+#define DEFAULT_USE_DHT true
+#define DEFAULT_USE_TSL2561 true
+#define DEFAULT_USE_PIR false
+#define DEFAULT_USE_LD2410 true
+#define DEFAULT_USE_RELAY false
 
 // ============================================================================
 // PIN CONFIGURATION
@@ -50,17 +71,35 @@
 // WiFi configuration portal timeout (seconds)
 #define WIFI_CONFIG_TIMEOUT 180
 
+// Fast connect: rejoin the cached BSSID/channel directly before falling back
+// to WiFiManager. With static IP the cached lease is reused, skipping DHCP;
+// nothing renews it, so only enable it where the router reserves the address.
+#define WIFI_FAST_CONNECT 1
+#define WIFI_FAST_CONNECT_STATIC_IP 0
+#define WIFI_FAST_CONNECT_TIMEOUT 5000 // ms before falling back to the full scan
+
 // ============================================================================
 // TIMING CONFIGURATION
 // ============================================================================
 
-// Sensor reading intervals (milliseconds)
+// Sensor data log interval (milliseconds); each sensor is read on its own
+// period, see SENSOR SAMPLING below
 #define SENSOR_READ_INTERVAL 5000 // 5 seconds
 #define OTA_CHECK_INTERVAL 300000 // 5 minutes
 #define PIR_COOLDOWN 10000        // 10 seconds
 
+// Sensor settle times, handled as deferred readiness instead of delay()
+#define DHT_WARMUP_MS 1000
+#define LD2410_WARMUP_MS 2000
+
 // Sensor error handling
-#define SENSOR_ERROR_THRESHOLD 3 // Number of consecutive errors before switching to sensorless mode
+#define SENSOR_ERROR_THRESHOLD 3 // Consecutive failed reads before a sensor is marked failed
+
+// Automatic recovery (sensors/sensor_health.h): a failed sensor is not polled
+// for the backoff, then re-initialised; each failed attempt doubles the backoff
+#define SENSOR_RECOVERY_BACKOFF_MS 5000
+#define SENSOR_RECOVERY_BACKOFF_MAX_MS 600000 // 10 minutes
+#define LD2410_FRAME_TIMEOUT_MS 5000          // No report frame for this long is a failed read
 
 // ============================================================================
 // SENSOR CONFIGURATION
@@ -76,6 +115,30 @@
 #define LUMINESCENCE_DARK_THRESHOLD 200   // Below this = dark
 #define LUMINESCENCE_BRIGHT_THRESHOLD 800 // Above this = bright
 
+// ============================================================================
+// SENSOR SAMPLING
+// ============================================================================
+
+// Defaults for config.sampling (/api/config "sampling"). A sensor is read every
+// min_ms while its value moves by at least "change" between reads; while it is
+// stable the period doubles on each read, up to max_ms
+#define DHT_SAMPLE_MIN_MS 2000 // The DHT11 measures at most once per second
+#define DHT_SAMPLE_MAX_MS 30000
+#define DHT_SAMPLE_CHANGE 0.2f // °C
+#define TSL2561_SAMPLE_MIN_MS 1000
+#define TSL2561_SAMPLE_MAX_MS 60000
+#define TSL2561_SAMPLE_CHANGE 10.0f // lux
+#define PIR_SAMPLE_MIN_MS 500 // Edges are caught by the interrupt in between
+#define PIR_SAMPLE_MAX_MS 500
+#define PIR_SAMPLE_CHANGE 0.5f
+#define LD2410_SAMPLE_MIN_MS 100 // Report frames arrive at about 10 Hz
+#define LD2410_SAMPLE_MAX_MS 1000
+#define LD2410_SAMPLE_CHANGE 0.5f
+
+#define SAMPLE_MIN_PERIOD_MS 50        // Lowest min_ms the API accepts
+#define SAMPLE_MAX_PERIOD_MS 3600000UL // Highest max_ms the API accepts
+#define SAMPLE_RATE_WINDOW_MS 10000    // Achieved-rate measurement window
+
 // ============================================================================
 // DEBUG CONFIGURATION
 // ============================================================================
@@ -91,6 +154,40 @@
 // #define DEBUG_WIFI false        // Turn on/off WiFi logs
 #define DEBUG_OTA false // Turn on/off OTA logs
 
+// loop() section profiler served at /api/perf; false compiles it out entirely
+#define ENABLE_PROFILER true
+
+// Heap/fragmentation history served at /api/heap
+#define ENABLE_HEAP_MONITOR true
+#define HEAP_SAMPLE_INTERVAL 10000 // 10 seconds
+
+// Allocation-site tracking; set by the nodemcuv2_heaptrack environment, which
+// also links with the malloc/free wrappers
+#ifndef HEAP_TRACK_ALLOCATIONS
+#define HEAP_TRACK_ALLOCATIONS 0
+#endif
+
+// Crash-persistent diagnostics in RTC memory, served at /api/diag
+#define ENABLE_CRASH_DIAG true
+#define DIAG_STALL_MS 2000 // Loop periods at least this long are logged as stalls
+#define DIAG_HEAP_LOW 8000 // Free heap below this is logged once per boot
+
+// Interval for {location}/diag/... MQTT publishes (0 = off)
+#define DIAG_PUBLISH_INTERVAL 0
+
+// Debug macros record into a RAM ring that is formatted later (/api/logs,
+// Serial drain in loop()); the flags above become the initial runtime levels.
+// false restores synchronous Serial printing gated by the flags.
+#define ENABLE_LOG_RING true
+#define LOG_SERIAL_DEFAULT DEBUG_MODE // Drain the ring to Serial at boot
+
+// Raw LD2410 UART capture (/api/ld2410/capture) to LittleFS or a TCP listener,
+// replayed on the host by env:ld2410_replay
+#define ENABLE_LD2410_CAPTURE USE_LD2410
+#define LD2410_CAPTURE_FILE "/ld2410.rec"
+#define LD2410_CAPTURE_MAX_BYTES 262144 // File captures stop here to leave room in LittleFS
+#define LD2410_CAPTURE_FLUSH_MS 1000
+
 // Serial monitor baud rate
 #define SERIAL_BAUD 115200
 
@@ -126,12 +223,97 @@
 #define MQTT_TOPIC_RELAY_COMMAND "relay/command"
 #define MQTT_TOPIC_RELAY_STATUS "relay/status"
 #define MQTT_TOPIC_ALL "all"
+#define MQTT_TOPIC_COMMAND_PUBLISH "command/publish" // Any payload forces a full publish
+#define MQTT_TOPIC_COMMAND_DEEP_SLEEP "command/deep_sleep" // "on"/"off"
+#define MQTT_TOPIC_DIAG "diag" // Diagnostics, published every DIAG_PUBLISH_INTERVAL
 #define DEFAULT_USE_RADAR true
 // MQTT Settings
 #define MQTT_KEEPALIVE 60            // Keep alive interval in seconds
 #define MQTT_RECONNECT_INTERVAL 5000 // Reconnect interval in milliseconds
+#define MQTT_DNS_CACHE_TTL 3600000    // Re-resolve the broker hostname after 1 hour
 #define MQTT_PUBLISH_INTERVAL 10000  // Publish interval in milliseconds (10 seconds)
 
+// TLS transport (BearSSL). Set MQTT_PORT / the configured port to 8883 when enabled.
+#define MQTT_USE_TLS 0
+#define MQTT_TLS_FINGERPRINT ""   // Broker certificate SHA-1, "AA:BB:..."; empty = no verification
+#define MQTT_TLS_BUFFER_SIZE 512  // TLS record buffers when the broker supports MFLN
+
+// Inbound command routing
+#define MQTT_MAX_ROUTES 8              // Registered command topics
+#define MQTT_COMMAND_MAX_PAYLOAD 256   // Larger command payloads are dropped
+
+// QoS 1 publishing (0 = plain QoS 0 publishes)
+#define MQTT_PUBLISH_QOS 1
+#define MQTT_QOS1_WINDOW 4        // Unacknowledged publishes kept for retransmit
+#define MQTT_QOS1_MAX_PACKET 512  // Matches the PubSubClient buffer set in setupMQTT()
+
+// Publish suppression defaults (runtime configurable via /api/config "publish")
+#define PUBLISH_HEARTBEAT_INTERVAL 300000 // Always republish after 5 minutes
+#define PUBLISH_TEMPERATURE_DEADBAND 0.5  // Degrees C
+#define PUBLISH_HUMIDITY_DEADBAND 2.0     // Percent RH
+#define PUBLISH_LUMINESCENCE_DEADBAND 5.0 // Lux
+#define PUBLISH_BINARY_DEADBAND 0.5       // Motion/radar/relay: publish on every change
+
+// ============================================================================
+// POWER MANAGEMENT (MAINS)
+// ============================================================================
+
+// Replaces the fixed delay at the end of loop() with a wait until the next
+// deadline, using the WiFi modem-sleep/light-sleep modes while idle
+#define ENABLE_POWER_MANAGER true
+#define POWER_ALLOW_LIGHT_SLEEP true // Off: modem sleep only
+#define POWER_LISTEN_INTERVAL 3      // DTIM periods between beacon wakes in light sleep
+#define POWER_MAX_IDLE_MS 250        // Longest wait; bounds HTTP response latency
+#define POWER_WEB_ACTIVE_MS 2000     // Modem sleep only this long after an HTTP request
+#define POWER_RADAR_MAX_IDLE_MS 100  // LD2410 SoftwareSerial needs the CPU awake
+#define POWER_POLL_MS 10             // Wake-source polling during modem sleep
+#define POWER_LIGHT_POLL_MS 50       // Wake-source polling during light sleep
+#define POWER_WAKE_PIN -1            // Extra wake GPIO (e.g. LD2410 OUT), active HIGH; -1 for none
+
+// ============================================================================
+// BATTERY (DEEP SLEEP) MODE
+// ============================================================================
+
+// Runtime switch is config.deep_sleep_enabled (/api/config "deep_sleep" or the
+// command/deep_sleep MQTT topic). Timer wake needs D0 (GPIO16) wired to RST,
+// so battery nodes cannot use the PIR on D0.
+#define ENABLE_DEEP_SLEEP true
+#define DEEP_SLEEP_DEFAULT_INTERVAL_S 300
+#define DEEP_SLEEP_DEFAULT_FLUSH_EVERY 6
+#define DEEP_SLEEP_WIFI_TIMEOUT 8000    // Give up on a flush after this long
+#define DEEP_SLEEP_ACK_TIMEOUT 3000     // Wait for PUBACKs before sleeping
+#define DEEP_SLEEP_SAMPLES_PER_MESSAGE 3 // Keeps each batch under the 512-byte MQTT buffer
+#define MQTT_TOPIC_BATCH "batch"
+
+// Energy model for the per-sample estimate (bare module; dev boards draw more)
+#define ENERGY_SUPPLY_VOLTAGE 3.3
+#define ENERGY_AWAKE_MA 17.0  // CPU on, radio off
+#define ENERGY_RADIO_MA 75.0  // CPU on, WiFi associated/transmitting
+#define ENERGY_SLEEP_UA 20.0  // Deep sleep
+
+// ============================================================================
+// RTC MEMORY LAYOUT
+// ============================================================================
+
+// RTC user memory is 128 blocks of 4 bytes. Blocks 0-31 are used by the core
+// for OTA (eboot command), so application data starts at block 32.
+#define RTC_WIFI_CACHE_BLOCK 32 // 8 blocks
+#define RTC_SLEEP_RING_BLOCK 40 // 44 blocks (power/rtc_ring.h)
+#define RTC_SLEEP_RING_CAPACITY 12
+#define RTC_DIAG_BLOCK 84       // 44 blocks (debug/crash_diag.h), to the end
+
+// ============================================================================
+// CONFIG STORAGE
+// ============================================================================
+
+// Bump CONFIG_VERSION whenever ConfigData changes and add a migration hook in
+// model/config_manager.cpp. Always append new fields at the end.
+#define CONFIG_VERSION 5
+#define CONFIG_STORE_MAGIC 0x43464731UL // "CFG1"
+#define CONFIG_EEPROM_SIZE 512
+#define CONFIG_STORE_USE_LITTLEFS 0      // 1 = /config.bin on LittleFS instead of EEPROM
+#define CONFIG_STORE_FILE "/config.bin"
+
 // ============================================================================
 // OTA CONFIGURATION
 // ============================================================================
@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include "debug/boot_timing.h"
+
+static BootPhase phases[BOOT_MAX_PHASES];
+static uint8_t phaseCount = 0;
+static bool phaseOpen = false;
+static BootEvent events[BOOT_MAX_EVENTS];
+static uint8_t eventCount = 0;
+static unsigned long setupMs = 0;
+
+static void closePhase(unsigned long now)
+{
+    if (phaseOpen)
+    {
+        phases[phaseCount - 1].duration_ms = now - phases[phaseCount - 1].start_ms;
+        phaseOpen = false;
+    }
+}
+
+void bootPhase(const char *name)
+{
+    unsigned long now = millis();
+    closePhase(now);
+    if (phaseCount >= BOOT_MAX_PHASES)
+    {
+        return;
+    }
+    phases[phaseCount].name = name;
+    phases[phaseCount].start_ms = now;
+    phases[phaseCount].duration_ms = 0;
+    phaseCount++;
+    phaseOpen = true;
+}
+
+void bootFinished()
+{
+    setupMs = millis();
+    closePhase(setupMs);
+}
+
+void bootEvent(const char *name)
+{
+    // Only the first occurrence of each milestone is interesting
+    for (uint8_t i = 0; i < eventCount; i++)
+    {
+        if (strcmp(events[i].name, name) == 0)
+        {
+            return;
+        }
+    }
+    if (eventCount < BOOT_MAX_EVENTS)
+    {
+        events[eventCount].name = name;
+        events[eventCount].at_ms = millis();
+        eventCount++;
+    }
+}
+
+uint8_t getBootPhaseCount()
+{
+    return phaseCount;
+}
+
+const BootPhase &getBootPhase(uint8_t index)
+{
+    return phases[index];
+}
+
+uint8_t getBootEventCount()
+{
+    return eventCount;
+}
+
+const BootEvent &getBootEvent(uint8_t index)
+{
+    return events[index];
+}
+
+unsigned long getBootSetupMs()
+{
+    return setupMs;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+#define BOOT_MAX_PHASES 12
+#define BOOT_MAX_EVENTS 12
+
+// A timed section of setup(); phases run back to back
+struct BootPhase
+{
+    const char *name;
+    unsigned long start_ms;
+    unsigned long duration_ms;
+};
+
+// A one-off milestone (sensor ready, first publish, ...)
+struct BootEvent
+{
+    const char *name;
+    unsigned long at_ms;
+};
+
+void bootPhase(const char *name);
+void bootFinished();
+void bootEvent(const char *name);
+
+uint8_t getBootPhaseCount();
+const BootPhase &getBootPhase(uint8_t index);
+uint8_t getBootEventCount();
+const BootEvent &getBootEvent(uint8_t index);
+unsigned long getBootSetupMs();
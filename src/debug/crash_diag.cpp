@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include <stddef.h>
+#include "config.h"
+#include "debug/crash_diag.h"
+
+extern "C"
+{
+#include "user_interface.h"
+}
+
+#if ENABLE_CRASH_DIAG
+
+#define RTC_DIAG_MAGIC 0x44494147UL // "DIAG"
+
+static_assert(sizeof(RtcDiagRecord) % 4 == 0, "RTC record must be whole blocks");
+static_assert(RTC_DIAG_BLOCK + sizeof(RtcDiagRecord) / 4 <= 128, "RTC diag record overruns RTC user memory");
+
+static RtcDiagRecord current;
+static RtcDiagRecord previous;
+static bool previousValid = false;
+
+// Rewrites the 4-byte blocks covering [offset, offset + size) of the record
+static void flush(size_t offset, size_t size)
+{
+    size_t first = offset / 4;
+    size_t last = (offset + size + 3) / 4;
+    ESP.rtcUserMemoryWrite(RTC_DIAG_BLOCK + first, (uint32_t *)&current + first, (last - first) * 4);
+}
+
+#define FLUSH_FIELD(field) flush(offsetof(RtcDiagRecord, field), sizeof(current.field))
+
+void crashDiagBegin()
+{
+    RtcDiagRecord stored;
+    bool valid = ESP.rtcUserMemoryRead(RTC_DIAG_BLOCK, (uint32_t *)&stored, sizeof(stored)) &&
+                 stored.magic == RTC_DIAG_MAGIC && stored.event_count <= DIAG_EVENT_CAPACITY &&
+                 stored.event_head < DIAG_EVENT_CAPACITY;
+    const rst_info *info = ESP.getResetInfoPtr();
+
+    memset(&current, 0, sizeof(current));
+    current.magic = RTC_DIAG_MAGIC;
+    current.last_section = DIAG_NO_SECTION;
+    current.reset_reason = info->reason;
+    current.heap_min = UINT32_MAX;
+    current.stack_min = UINT16_MAX;
+    if (valid)
+    {
+        previous = stored;
+        previous.last_uri[DIAG_URI_BYTES - 1] = '\0';
+        previousValid = info->reason != REASON_DEFAULT_RST;
+        // The event ring carries on across resets, so the lead-up stays visible
+        current.boot_count = stored.boot_count + 1;
+        current.event_head = stored.event_head;
+        current.event_count = stored.event_count;
+        memcpy(current.events, stored.events, sizeof(current.events));
+    }
+    flush(0, sizeof(current));
+    // Battery-mode timer wakes would otherwise flood the ring
+    if (info->reason != REASON_DEEP_SLEEP_AWAKE)
+    {
+        crashDiagEvent(DIAG_EVENT_BOOT, info->reason);
+    }
+}
+
+void crashDiagEnter(uint8_t section)
+{
+    current.last_section = section;
+    current.in_section = 1;
+    flush(offsetof(RtcDiagRecord, last_section), 2); // last_section and in_section
+}
+
+void crashDiagExit()
+{
+    current.in_section = 0;
+    FLUSH_FIELD(in_section);
+}
+
+void crashDiagLoop(uint32_t periodUs)
+{
+    current.uptime_ms = millis();
+    current.loop_last_us = periodUs;
+    if (periodUs > current.loop_max_us)
+    {
+        current.loop_max_us = periodUs;
+    }
+    flush(offsetof(RtcDiagRecord, uptime_ms), 12); // uptime, last and max are adjacent
+    if (periodUs >= DIAG_STALL_MS * 1000UL)
+    {
+        crashDiagEvent(DIAG_EVENT_LOOP_STALL, min(periodUs / 1000, (uint32_t)UINT16_MAX));
+    }
+}
+
+void crashDiagHeap(uint32_t minFree, uint8_t maxFragmentation, uint32_t minStack)
+{
+    if (minFree < DIAG_HEAP_LOW && current.heap_min >= DIAG_HEAP_LOW)
+    {
+        crashDiagEvent(DIAG_EVENT_HEAP_LOW, min(minFree, (uint32_t)UINT16_MAX));
+    }
+    current.heap_min = minFree;
+    current.frag_max = maxFragmentation;
+    current.stack_min = min(minStack, (uint32_t)UINT16_MAX);
+    flush(offsetof(RtcDiagRecord, heap_min), 8); // heap_min, stack_min, frag_max
+}
+
+void crashDiagUri(const char *uri)
+{
+    strlcpy(current.last_uri, uri, sizeof(current.last_uri));
+    FLUSH_FIELD(last_uri);
+}
+
+void crashDiagEvent(DiagEventCode code, uint16_t arg)
+{
+    uint8_t slot = (current.event_head + current.event_count) % DIAG_EVENT_CAPACITY;
+    if (current.event_count < DIAG_EVENT_CAPACITY)
+    {
+        current.event_count++;
+    }
+    else
+    {
+        current.event_head = (current.event_head + 1) % DIAG_EVENT_CAPACITY;
+    }
+    current.events[slot].t_ms = millis();
+    current.events[slot].code = code;
+    current.events[slot].arg = arg;
+    flush(offsetof(RtcDiagRecord, event_head), 2); // event_head and event_count
+    flush(offsetof(RtcDiagRecord, events) + slot * sizeof(DiagEvent), sizeof(DiagEvent));
+}
+
+bool getPreviousDiag(RtcDiagRecord &record)
+{
+    if (previousValid)
+    {
+        record = previous;
+    }
+    return previousValid;
+}
+
+const RtcDiagRecord &getCurrentDiag()
+{
+    return current;
+}
+
+bool crashDiagResetIsFailure()
+{
+    uint8_t reason = current.reset_reason;
+    return reason == REASON_WDT_RST || reason == REASON_EXCEPTION_RST || reason == REASON_SOFT_WDT_RST;
+}
+
+#endif // ENABLE_CRASH_DIAG
+
+const char *getDiagEventName(uint16_t code)
+{
+    static const char *const names[DIAG_EVENT_COUNT] = {
+        "boot",
+        "wifi_connected",
+        "mqtt_connected",
+        "mqtt_failed",
+        "loop_stall",
+        "heap_low",
+        "ota_start",
+        "restart",
+    };
+    return code < DIAG_EVENT_COUNT ? names[code] : "unknown";
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+
+// Diagnostics kept in RTC user memory so they survive soft, exception and
+// watchdog resets: the section/handler being run, loop timing, heap
+// low-water marks and a small event ring. The previous run's record is
+// captured at boot and reported via /api/diag and {location}/diag/reset.
+
+#define DIAG_EVENT_CAPACITY 16
+#define DIAG_URI_BYTES 16
+#define DIAG_NO_SECTION 0xFF
+
+enum DiagEventCode : uint16_t
+{
+    DIAG_EVENT_BOOT,           // arg: reset reason
+    DIAG_EVENT_WIFI_CONNECTED,
+    DIAG_EVENT_MQTT_CONNECTED,
+    DIAG_EVENT_MQTT_FAILED,    // arg: PubSubClient state
+    DIAG_EVENT_LOOP_STALL,     // arg: loop period in ms
+    DIAG_EVENT_HEAP_LOW,       // arg: free heap in bytes
+    DIAG_EVENT_OTA_START,
+    DIAG_EVENT_RESTART,        // Deliberate ESP.restart()
+    DIAG_EVENT_COUNT
+};
+
+struct DiagEvent
+{
+    uint32_t t_ms;
+    uint16_t code;
+    uint16_t arg;
+};
+
+// Exactly 44 RTC blocks; fields are grouped so each update rewrites few words
+struct RtcDiagRecord
+{
+    uint32_t magic;
+    uint32_t boot_count;
+    uint32_t uptime_ms;    // Last loop heartbeat
+    uint32_t loop_last_us;
+    uint32_t loop_max_us;
+    uint32_t heap_min;
+    uint16_t stack_min;
+    uint8_t frag_max;
+    uint8_t last_section;  // PerfSectionId last entered
+    uint8_t in_section;    // Still inside last_section when the record was written
+    uint8_t event_head;
+    uint8_t event_count;
+    uint8_t reset_reason;  // Why this run started
+    char last_uri[DIAG_URI_BYTES]; // Last HTTP request, truncated
+    DiagEvent events[DIAG_EVENT_CAPACITY];
+};
+
+void crashDiagBegin();
+void crashDiagEnter(uint8_t section);
+void crashDiagExit();
+void crashDiagLoop(uint32_t periodUs);
+void crashDiagHeap(uint32_t minFree, uint8_t maxFragmentation, uint32_t minStack);
+void crashDiagUri(const char *uri);
+void crashDiagEvent(DiagEventCode code, uint16_t arg = 0);
+
+// The previous run, as found at boot; false after a power-on reset
+bool getPreviousDiag(RtcDiagRecord &record);
+const RtcDiagRecord &getCurrentDiag();
+const char *getDiagEventName(uint16_t code);
+bool crashDiagResetIsFailure(); // Exception or watchdog reset
+
+class CrashDiagScope
+{
+public:
+    explicit CrashDiagScope(uint8_t section) { crashDiagEnter(section); }
+    ~CrashDiagScope() { crashDiagExit(); }
+};
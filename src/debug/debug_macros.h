@@ -1,6 +1,78 @@
 #pragma once
+#include "config.h"
+
+// With ENABLE_LOG_RING the macros capture into the deferred log ring and the
+// DEBUG_* flags only set the initial runtime thresholds (see log_ring.h).
+// Without it they print synchronously when their compile-time flag is set.
+//
+// *_ERROR_* and *_WARN_* are for faults an operator should see: they pass the
+// default thresholds with the category's debug flag off, and print
+// unconditionally without the log ring.
+//
+// Wrap string literal arguments in LOG_LITERAL() so the ring keeps them by
+// pointer instead of copying them into the entry's 24 text bytes.
+
+#if ENABLE_LOG_RING
+#include "debug/log_ring.h"
+
+// Arguments are only evaluated when the category/level is enabled
+#define LOG_CAPTURE(category, level, fmt, ...)                        \
+    do                                                                \
+    {                                                                 \
+        if (logEnabled(category, level))                              \
+            logCapture(category, level, fmt, ##__VA_ARGS__);          \
+        else                                                          \
+            logFiltered();                                            \
+    } while (0)
+
+#define DEBUG_PRINT(x) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_DEBUG, "%v", x)
+#define DEBUG_PRINTLN(x) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_DEBUG, "%v\n", x)
+#define DEBUG_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#define SENSOR_DEBUG_PRINT(x) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_DEBUG, "%v", x)
+#define SENSOR_DEBUG_PRINTLN(x) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_DEBUG, "%v\n", x)
+#define SENSOR_DEBUG_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#define WEB_DEBUG_PRINT(x) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_DEBUG, "%v", x)
+#define WEB_DEBUG_PRINTLN(x) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_DEBUG, "%v\n", x)
+#define WEB_DEBUG_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#define MQTT_DEBUG_PRINT(x) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_DEBUG, "%v", x)
+#define MQTT_DEBUG_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_DEBUG, "%v\n", x)
+#define MQTT_DEBUG_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#define MEMORY_DEBUG_PRINT(x) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_DEBUG, "%v", x)
+#define MEMORY_DEBUG_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_DEBUG, "%v\n", x)
+#define MEMORY_DEBUG_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+
+#define ERROR_PRINTLN(x) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_ERROR, "%v\n", x)
+#define ERROR_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define WARN_PRINTLN(x) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_WARN, "%v\n", x)
+#define WARN_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_GENERAL, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+#define SENSOR_ERROR_PRINTLN(x) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_ERROR, "%v\n", x)
+#define SENSOR_ERROR_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define SENSOR_WARN_PRINTLN(x) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_WARN, "%v\n", x)
+#define SENSOR_WARN_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_SENSOR, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+#define WEB_ERROR_PRINTLN(x) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_ERROR, "%v\n", x)
+#define WEB_ERROR_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define WEB_WARN_PRINTLN(x) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_WARN, "%v\n", x)
+#define WEB_WARN_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_WEB, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+#define MQTT_ERROR_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_ERROR, "%v\n", x)
+#define MQTT_ERROR_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define MQTT_WARN_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_WARN, "%v\n", x)
+#define MQTT_WARN_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MQTT, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+#define MEMORY_ERROR_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_ERROR, "%v\n", x)
+#define MEMORY_ERROR_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define MEMORY_WARN_PRINTLN(x) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_WARN, "%v\n", x)
+#define MEMORY_WARN_PRINTF(fmt, ...) LOG_CAPTURE(LOG_CAT_MEMORY, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+
+#else
 
-// Debug macros
 #if DEBUG_MODE
 #define DEBUG_PRINT(x) Serial.print(x)
 #define DEBUG_PRINTLN(x) Serial.println(x)
@@ -11,7 +83,6 @@
 #define DEBUG_PRINTF(fmt, ...)
 #endif
 
-// Category-specific debug macros
 #if DEBUG_SENSORS
 #define SENSOR_DEBUG_PRINT(x) Serial.print(x)
 #define SENSOR_DEBUG_PRINTLN(x) Serial.println(x)
@@ -50,4 +121,37 @@
 #define MEMORY_DEBUG_PRINT(x)
 #define MEMORY_DEBUG_PRINTLN(x)
 #define MEMORY_DEBUG_PRINTF(fmt, ...)
-#endif 
\ No newline at end of file
+#endif 
+
+#define LOG_LITERAL(s) s
+
+// Faults print whatever the debug flags say
+#define LOG_PRINTLN(x) Serial.println(x)
+#define LOG_PRINTF(fmt, ...) Serial.printf(fmt, ##__VA_ARGS__)
+
+#define ERROR_PRINTLN(x) LOG_PRINTLN(x)
+#define ERROR_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+#define WARN_PRINTLN(x) LOG_PRINTLN(x)
+#define WARN_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+
+#define SENSOR_ERROR_PRINTLN(x) LOG_PRINTLN(x)
+#define SENSOR_ERROR_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+#define SENSOR_WARN_PRINTLN(x) LOG_PRINTLN(x)
+#define SENSOR_WARN_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+
+#define WEB_ERROR_PRINTLN(x) LOG_PRINTLN(x)
+#define WEB_ERROR_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+#define WEB_WARN_PRINTLN(x) LOG_PRINTLN(x)
+#define WEB_WARN_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+
+#define MQTT_ERROR_PRINTLN(x) LOG_PRINTLN(x)
+#define MQTT_ERROR_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+#define MQTT_WARN_PRINTLN(x) LOG_PRINTLN(x)
+#define MQTT_WARN_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+
+#define MEMORY_ERROR_PRINTLN(x) LOG_PRINTLN(x)
+#define MEMORY_ERROR_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+#define MEMORY_WARN_PRINTLN(x) LOG_PRINTLN(x)
+#define MEMORY_WARN_PRINTF(fmt, ...) LOG_PRINTF(fmt, ##__VA_ARGS__)
+
+#endif // ENABLE_LOG_RING
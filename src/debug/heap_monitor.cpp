@@ -0,0 +1,245 @@
+#include <Arduino.h>
+#include "config.h"
+#include "debug/heap_monitor.h"
+
+static HeapSample history[HEAP_HISTORY_SIZE];
+static uint8_t historyHead = 0;
+static uint8_t historyCount = 0;
+static HeapStats heapStats;
+static bool statsValid = false;
+
+void heapMonitorSample()
+{
+    uint32_t freeBytes = ESP.getFreeHeap();
+    uint32_t maxBlock = ESP.getMaxFreeBlockSize();
+    uint8_t fragmentation = ESP.getHeapFragmentation();
+    uint32_t freeStack = ESP.getFreeContStack(); // Already a high-water mark
+
+    if (!statsValid)
+    {
+        heapStats.min_free = freeBytes;
+        heapStats.min_max_block = maxBlock;
+        heapStats.max_fragmentation = fragmentation;
+        heapStats.min_free_cont_stack = freeStack;
+        statsValid = true;
+    }
+    heapStats.min_free = min(heapStats.min_free, freeBytes);
+    heapStats.min_max_block = min(heapStats.min_max_block, maxBlock);
+    heapStats.max_fragmentation = max(heapStats.max_fragmentation, fragmentation);
+    heapStats.min_free_cont_stack = min(heapStats.min_free_cont_stack, freeStack);
+    heapStats.samples++;
+
+    uint8_t slot = (historyHead + historyCount) % HEAP_HISTORY_SIZE;
+    if (historyCount < HEAP_HISTORY_SIZE)
+    {
+        historyCount++;
+    }
+    else
+    {
+        historyHead = (historyHead + 1) % HEAP_HISTORY_SIZE;
+    }
+    history[slot].t_s = millis() / 1000;
+    history[slot].free_bytes = freeBytes;
+    history[slot].max_block = maxBlock;
+    history[slot].fragmentation = fragmentation;
+}
+
+void heapMonitorReset()
+{
+    statsValid = false;
+    memset(&heapStats, 0, sizeof(heapStats));
+    historyHead = 0;
+    historyCount = 0;
+    ESP.resetFreeContStack();
+    heapMonitorSample();
+}
+
+const HeapStats &getHeapStats()
+{
+    return heapStats;
+}
+
+uint8_t getHeapHistoryCount()
+{
+    return historyCount;
+}
+
+const HeapSample &getHeapHistory(uint8_t index)
+{
+    return history[(historyHead + index) % HEAP_HISTORY_SIZE];
+}
+
+// ============================================================================
+// Allocation-site tracking (link with -Wl,--wrap=malloc,... )
+// ============================================================================
+
+static HeapSite sites[HEAP_TRACK_SITES];
+static uint8_t siteCount = 0;
+static HeapTrackStats trackStats;
+
+#if HEAP_TRACK_ALLOCATIONS
+
+struct LiveAllocation
+{
+    void *ptr;
+    uint16_t size;
+    uint8_t site;
+};
+
+#define HEAP_SITE_NONE 0xFF
+
+static LiveAllocation slots[HEAP_TRACK_SLOTS];
+static uint16_t freeHint = 0;
+static uint8_t trackDepth = 0; // Set while operator new calls the wrapped malloc
+
+static uint8_t findSite(uint32_t address)
+{
+    for (uint8_t i = 0; i < siteCount; i++)
+    {
+        if (sites[i].address == address)
+        {
+            return i;
+        }
+    }
+    if (siteCount >= HEAP_TRACK_SITES)
+    {
+        return HEAP_SITE_NONE;
+    }
+    sites[siteCount].address = address;
+    return siteCount++;
+}
+
+static void trackAlloc(void *ptr, size_t size, void *caller)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    uint8_t site = findSite((uint32_t)(uintptr_t)caller);
+    if (site == HEAP_SITE_NONE)
+    {
+        trackStats.site_overflow++;
+    }
+    else
+    {
+        HeapSite &s = sites[site];
+        s.allocations++;
+        s.live_count++;
+        s.live_bytes += size;
+        if (s.live_bytes > s.peak_bytes)
+        {
+            s.peak_bytes = s.live_bytes;
+        }
+    }
+
+    for (uint16_t n = 0; n < HEAP_TRACK_SLOTS; n++)
+    {
+        uint16_t i = (freeHint + n) % HEAP_TRACK_SLOTS;
+        if (slots[i].ptr == nullptr)
+        {
+            slots[i].ptr = ptr;
+            slots[i].size = size > UINT16_MAX ? UINT16_MAX : size;
+            slots[i].site = site;
+            freeHint = (i + 1) % HEAP_TRACK_SLOTS;
+            trackStats.tracked++;
+            return;
+        }
+    }
+    trackStats.untracked++;
+}
+
+static void trackFree(void *ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    // Pointers allocated before tracking started or outside the wrappers
+    // (e.g. newlib internals) are simply not found
+    for (uint16_t i = 0; i < HEAP_TRACK_SLOTS; i++)
+    {
+        if (slots[i].ptr == ptr)
+        {
+            if (slots[i].site != HEAP_SITE_NONE)
+            {
+                HeapSite &s = sites[slots[i].site];
+                s.live_count--;
+                s.live_bytes -= slots[i].size;
+            }
+            slots[i].ptr = nullptr;
+            freeHint = i;
+            trackStats.tracked--;
+            return;
+        }
+    }
+}
+
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void __real_free(void *ptr);
+    void *__real__Znwj(size_t size);
+
+    void *__wrap_malloc(size_t size)
+    {
+        void *ptr = __real_malloc(size);
+        if (trackDepth == 0)
+        {
+            trackAlloc(ptr, size, __builtin_return_address(0));
+        }
+        return ptr;
+    }
+
+    void *__wrap_calloc(size_t count, size_t size)
+    {
+        void *ptr = __real_calloc(count, size);
+        trackAlloc(ptr, count * size, __builtin_return_address(0));
+        return ptr;
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        void *moved = __real_realloc(ptr, size);
+        if (moved != nullptr || size == 0)
+        {
+            trackFree(ptr);
+            trackAlloc(moved, size, __builtin_return_address(0));
+        }
+        return moved;
+    }
+
+    void __wrap_free(void *ptr)
+    {
+        trackFree(ptr);
+        __real_free(ptr);
+    }
+
+    // operator new(unsigned int): attribute to the caller of new, not to new itself
+    void *__wrap__Znwj(size_t size)
+    {
+        trackDepth++;
+        void *ptr = __real__Znwj(size);
+        trackDepth--;
+        trackAlloc(ptr, size, __builtin_return_address(0));
+        return ptr;
+    }
+}
+
+#endif // HEAP_TRACK_ALLOCATIONS
+
+uint8_t getHeapSiteCount()
+{
+    return siteCount;
+}
+
+const HeapSite &getHeapSite(uint8_t index)
+{
+    return sites[index];
+}
+
+const HeapTrackStats &getHeapTrackStats()
+{
+    return trackStats;
+}
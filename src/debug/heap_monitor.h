@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+
+// Periodic heap/fragmentation sampling with low-water marks, served at
+// /api/heap. Builds with HEAP_TRACK_ALLOCATIONS (env:nodemcuv2_heaptrack)
+// also attribute live allocations to their call sites.
+
+#define HEAP_HISTORY_SIZE 32
+#define HEAP_TRACK_SITES 32
+#define HEAP_TRACK_SLOTS 256
+
+struct HeapSample
+{
+    uint32_t t_s;
+    uint16_t free_bytes;
+    uint16_t max_block;
+    uint8_t fragmentation; // Percent, as reported by the core
+};
+
+struct HeapStats
+{
+    uint32_t min_free;          // Low-water marks since boot (or reset)
+    uint32_t min_max_block;
+    uint8_t max_fragmentation;
+    uint32_t min_free_cont_stack; // Cont stack high-water mark (bytes never used)
+    uint32_t samples;
+};
+
+// Live allocations grouped by return address (HEAP_TRACK_ALLOCATIONS only)
+struct HeapSite
+{
+    uint32_t address;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t allocations;
+    uint16_t live_count;
+};
+
+struct HeapTrackStats
+{
+    uint32_t tracked;       // Allocations currently in the slot table
+    uint32_t untracked;     // Allocations missed because the slot table was full
+    uint32_t site_overflow; // Allocations from sites beyond HEAP_TRACK_SITES
+};
+
+void heapMonitorSample();
+void heapMonitorReset();
+const HeapStats &getHeapStats();
+uint8_t getHeapHistoryCount();
+const HeapSample &getHeapHistory(uint8_t index); // Oldest first
+
+uint8_t getHeapSiteCount();
+const HeapSite &getHeapSite(uint8_t index);
+const HeapTrackStats &getHeapTrackStats();
@@ -0,0 +1,349 @@
+#include <Arduino.h>
+#include "config.h"
+#include "debug/log_ring.h"
+
+#if ENABLE_LOG_RING
+
+#define LOG_THRESHOLD(flag) ((flag) ? LOG_LEVEL_DEBUG : LOG_LEVEL_WARN)
+
+uint8_t logThresholds[LOG_CAT_COUNT] = {
+    LOG_THRESHOLD(DEBUG_MODE),
+    LOG_THRESHOLD(DEBUG_SENSORS),
+    LOG_THRESHOLD(DEBUG_WEB_SERVER),
+    LOG_THRESHOLD(DEBUG_MQTT),
+    LOG_THRESHOLD(DEBUG_MEMORY),
+};
+bool logSerialEnabled = LOG_SERIAL_DEFAULT;
+
+#define LOG_SERIAL_FIFO_BYTES 128 // UART hardware TX FIFO
+
+static LogEntry ring[LOG_RING_ENTRIES];
+static uint16_t ringHead = 0;
+static uint16_t ringCount = 0;
+static uint16_t nextSeq = 0;
+static uint16_t nextDrainSeq = 0;
+static LogStats logStats;
+
+static const char *const categoryNames[LOG_CAT_COUNT] = {
+    "general",
+    "sensor",
+    "web",
+    "mqtt",
+    "memory",
+};
+
+static const char *const levelNames[] = {
+    "error",
+    "warn",
+    "info",
+    "debug",
+};
+
+LogEntry *logBegin(uint8_t category, uint8_t level, const char *fmt)
+{
+    uint16_t slot = (ringHead + ringCount) % LOG_RING_ENTRIES;
+    if (ringCount < LOG_RING_ENTRIES)
+    {
+        ringCount++;
+    }
+    else
+    {
+        // Overwriting the oldest entry; count it if the drain never saw it
+        uint16_t lostSeq = ring[ringHead].seq;
+        if (logSerialEnabled && (int16_t)(lostSeq - nextDrainSeq) >= 0)
+        {
+            logStats.overwritten++;
+            nextDrainSeq = lostSeq + 1;
+        }
+        ringHead = (ringHead + 1) % LOG_RING_ENTRIES;
+    }
+
+    LogEntry &entry = ring[slot];
+    entry.t_ms = millis();
+    entry.fmt = fmt;
+    entry.seq = nextSeq++;
+    entry.category = category;
+    entry.level = level;
+    entry.argc = 0;
+    entry.text_used = 0;
+    logStats.captured++;
+    return &entry;
+}
+
+void logArgNumber(LogEntry &entry, LogArgType type, uint32_t raw)
+{
+    if (entry.argc >= LOG_MAX_ARGS)
+    {
+        logStats.truncated++;
+        return;
+    }
+    entry.types[entry.argc] = type;
+    entry.args[entry.argc++].raw = raw;
+}
+
+void logArgLiteral(LogEntry &entry, const char *literal)
+{
+    if (entry.argc >= LOG_MAX_ARGS)
+    {
+        logStats.truncated++;
+        return;
+    }
+    entry.types[entry.argc] = LOG_ARG_LITERAL;
+    entry.args[entry.argc++].literal = literal;
+}
+
+void logArgText(LogEntry &entry, const char *text)
+{
+    if (text == nullptr)
+    {
+        logArgLiteral(entry, "(null)");
+        return;
+    }
+    size_t room = LOG_TEXT_BYTES - entry.text_used;
+    if (room == 0)
+    {
+        logStats.truncated++;
+        logArgLiteral(entry, "...");
+        return;
+    }
+    size_t length = strnlen(text, room - 1);
+    if (text[length] != '\0')
+    {
+        logStats.truncated++;
+    }
+    if (entry.argc >= LOG_MAX_ARGS)
+    {
+        logStats.truncated++;
+        return;
+    }
+    memcpy(entry.text + entry.text_used, text, length);
+    entry.text[entry.text_used + length] = '\0';
+    logArgNumber(entry, LOG_ARG_TEXT, entry.text_used);
+    entry.text_used += length + 1;
+}
+
+void logFiltered()
+{
+    logStats.filtered++;
+}
+
+static const char *argString(const LogEntry &entry, uint8_t index)
+{
+    if (entry.types[index] == LOG_ARG_TEXT)
+    {
+        return entry.text + entry.args[index].raw;
+    }
+    return entry.args[index].literal;
+}
+
+static double argDouble(const LogEntry &entry, uint8_t index)
+{
+    uint32_t raw = entry.args[index].raw;
+    switch (entry.types[index])
+    {
+    case LOG_ARG_FLOAT:
+    {
+        float f;
+        memcpy(&f, &raw, sizeof(f));
+        return f;
+    }
+    case LOG_ARG_INT:
+        return (int32_t)raw;
+    default:
+        return raw;
+    }
+}
+
+// Re-runs printf one conversion at a time with the stored values. Length
+// modifiers are dropped since every number was stored as 32 bits.
+size_t logFormat(const LogEntry &entry, char *out, size_t capacity)
+{
+    size_t n = 0;
+    uint8_t arg = 0;
+    const char *p = entry.fmt;
+    while (*p && n + 1 < capacity)
+    {
+        if (*p != '%')
+        {
+            out[n++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[n++] = '%';
+            p += 2;
+            continue;
+        }
+
+        char spec[16];
+        size_t s = 0;
+        spec[s++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && s < sizeof(spec) - 4)
+        {
+            spec[s++] = *p++;
+        }
+        while (*p && strchr("hlLqjzt", *p))
+        {
+            p++;
+        }
+        char conversion = *p;
+        if (conversion == '\0')
+        {
+            break;
+        }
+        p++;
+
+        size_t room = capacity - n;
+        int written;
+        if (arg >= entry.argc)
+        {
+            written = snprintf(out + n, room, "?");
+        }
+        else
+        {
+            uint8_t type = entry.types[arg];
+            bool isString = type == LOG_ARG_TEXT || type == LOG_ARG_LITERAL;
+            if (conversion == 'v')
+            {
+                // Print-style output: strings as-is, floats with two decimals
+                if (isString)
+                {
+                    conversion = 's';
+                }
+                else if (type == LOG_ARG_FLOAT)
+                {
+                    spec[s++] = '.';
+                    spec[s++] = '2';
+                    conversion = 'f';
+                }
+                else
+                {
+                    conversion = type == LOG_ARG_INT ? 'd' : 'u';
+                }
+            }
+            spec[s++] = conversion;
+            spec[s] = '\0';
+
+            if (conversion == 's')
+            {
+                written = isString ? snprintf(out + n, room, spec, argString(entry, arg)) : snprintf(out + n, room, "?");
+            }
+            else if (isString)
+            {
+                written = snprintf(out + n, room, "?");
+            }
+            else if (strchr("fFeEgGaA", conversion))
+            {
+                written = snprintf(out + n, room, spec, argDouble(entry, arg));
+            }
+            else if (conversion == 'p')
+            {
+                written = snprintf(out + n, room, "0x%08x", entry.args[arg].raw);
+            }
+            else if (type == LOG_ARG_FLOAT)
+            {
+                written = snprintf(out + n, room, spec, (int)argDouble(entry, arg));
+            }
+            else
+            {
+                written = snprintf(out + n, room, spec, entry.args[arg].raw);
+            }
+            arg++;
+        }
+        if (written > 0)
+        {
+            n += min((size_t)written, room - 1);
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// Writes pending entries to Serial while the TX FIFO has room, so logging
+// never blocks the loop on the UART
+void logDrain()
+{
+    if (!logSerialEnabled)
+    {
+        nextDrainSeq = nextSeq;
+        return;
+    }
+    char line[128];
+    while (nextDrainSeq != nextSeq)
+    {
+        uint16_t age = nextSeq - nextDrainSeq;
+        if (age > ringCount)
+        {
+            nextDrainSeq = nextSeq - ringCount;
+            continue;
+        }
+        const LogEntry &entry = logAt(ringCount - age);
+        size_t length = logFormat(entry, line, sizeof(line));
+        int space = Serial.availableForWrite();
+        if ((int)length > space && space < LOG_SERIAL_FIFO_BYTES)
+        {
+            return; // FIFO still busy; continue on the next pass
+        }
+        Serial.write((const uint8_t *)line, length);
+        nextDrainSeq++;
+    }
+}
+
+const LogStats &getLogStats()
+{
+    return logStats;
+}
+
+uint16_t logCount()
+{
+    return ringCount;
+}
+
+const LogEntry &logAt(uint16_t index)
+{
+    return ring[(ringHead + index) % LOG_RING_ENTRIES];
+}
+
+const char *getLogCategoryName(uint8_t category)
+{
+    return category < LOG_CAT_COUNT ? categoryNames[category] : "unknown";
+}
+
+int findLogCategory(const char *name)
+{
+    for (uint8_t i = 0; i < LOG_CAT_COUNT; i++)
+    {
+        if (strcmp(name, categoryNames[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char *getLogLevelName(uint8_t level)
+{
+    if (level == LOG_LEVEL_NONE)
+    {
+        return "off";
+    }
+    return level <= LOG_LEVEL_DEBUG ? levelNames[level] : "unknown";
+}
+
+int findLogLevel(const char *name)
+{
+    if (strcmp(name, "off") == 0)
+    {
+        return LOG_LEVEL_NONE;
+    }
+    for (uint8_t i = 0; i <= LOG_LEVEL_DEBUG; i++)
+    {
+        if (strcmp(name, levelNames[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif // ENABLE_LOG_RING
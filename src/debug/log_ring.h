@@ -0,0 +1,165 @@
+#pragma once
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <type_traits>
+
+// Deferred logging: the debug macros record the format string pointer, a
+// timestamp and the raw arguments into a fixed ring. Formatting happens later,
+// from logDrain() in loop(), /api/logs, or on the host (examples/log_decoder.py).
+//
+// String arguments are copied into the entry and may be truncated: char
+// arrays (const or not), const char * and String. Only literals wrapped in
+// LOG_LITERAL() are kept by pointer; the type alone cannot tell a literal
+// from a local const buffer that is gone by the time the entry is formatted.
+
+#define LOG_RING_ENTRIES 32
+#define LOG_MAX_ARGS 6
+#define LOG_TEXT_BYTES 24 // Copied string arguments per entry, NUL separated
+
+enum LogCategory : uint8_t
+{
+    LOG_CAT_GENERAL,
+    LOG_CAT_SENSOR,
+    LOG_CAT_WEB,
+    LOG_CAT_MQTT,
+    LOG_CAT_MEMORY,
+    LOG_CAT_COUNT
+};
+
+enum LogLevel : uint8_t
+{
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_NONE = 0xFF // Threshold only: category off
+};
+
+enum LogArgType : uint8_t
+{
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_FLOAT,
+    LOG_ARG_TEXT,    // Offset into LogEntry::text
+    LOG_ARG_LITERAL, // Pointer to a string literal
+};
+
+// A string literal argument kept by pointer. The "" concatenation rejects
+// anything but a literal at compile time
+struct LogLiteral
+{
+    const char *text;
+};
+#define LOG_LITERAL(s) (LogLiteral{"" s})
+
+// 4 bytes on the device; pointer-sized on host builds
+union LogArgValue
+{
+    uint32_t raw;
+    const char *literal;
+};
+
+struct LogEntry
+{
+    uint32_t t_ms;
+    const char *fmt; // Also the format-string ID for host-side decoding
+    uint16_t seq;
+    uint8_t category : 4;
+    uint8_t level : 4;
+    uint8_t argc;
+    uint8_t types[LOG_MAX_ARGS];
+    uint8_t text_used;
+    LogArgValue args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+struct LogStats
+{
+    uint32_t captured;
+    uint32_t overwritten; // Entries lost before they were drained
+    uint32_t filtered;    // Rejected by the runtime level thresholds
+    uint32_t truncated;   // Arguments dropped or cut short
+};
+
+// Runtime selection, defaults from the DEBUG_* flags in config.h
+extern uint8_t logThresholds[LOG_CAT_COUNT];
+extern bool logSerialEnabled;
+
+inline bool logEnabled(uint8_t category, uint8_t level)
+{
+    return logThresholds[category] != LOG_LEVEL_NONE && level <= logThresholds[category];
+}
+
+LogEntry *logBegin(uint8_t category, uint8_t level, const char *fmt);
+void logArgNumber(LogEntry &entry, LogArgType type, uint32_t raw);
+void logArgText(LogEntry &entry, const char *text);
+void logArgLiteral(LogEntry &entry, const char *literal);
+void logFiltered();
+
+// Classifies one argument at compile time, dispatching on the deduced type
+template <typename T>
+inline void logArg(LogEntry &entry, T &&value)
+{
+    typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type V;
+    if constexpr (std::is_same<V, LogLiteral>::value)
+    {
+        logArgLiteral(entry, value.text);
+    }
+    else if constexpr (std::is_array<V>::value)
+    {
+        logArgText(entry, value);
+    }
+    else if constexpr (std::is_floating_point<V>::value)
+    {
+        float f = value;
+        uint32_t raw;
+        memcpy(&raw, &f, sizeof(raw));
+        logArgNumber(entry, LOG_ARG_FLOAT, raw);
+    }
+    else if constexpr (std::is_integral<V>::value || std::is_enum<V>::value)
+    {
+        logArgNumber(entry, std::is_signed<V>::value ? LOG_ARG_INT : LOG_ARG_UINT, (uint32_t)value);
+    }
+    else if constexpr (std::is_pointer<V>::value)
+    {
+        typedef typename std::remove_cv<typename std::remove_pointer<V>::type>::type P;
+        if constexpr (std::is_same<P, char>::value)
+        {
+            logArgText(entry, value);
+        }
+        else
+        {
+            logArgNumber(entry, LOG_ARG_UINT, (uint32_t)(uintptr_t)value);
+        }
+    }
+    else if constexpr (std::is_same<V, String>::value)
+    {
+        logArgText(entry, value.c_str());
+    }
+    else if constexpr (std::is_same<V, IPAddress>::value)
+    {
+        logArgText(entry, value.toString().c_str());
+    }
+    else
+    {
+        static_assert(sizeof(V) == 0, "Unsupported log argument type");
+    }
+}
+
+// Callers check logEnabled() first (see LOG_CAPTURE in debug_macros.h)
+template <typename... Args>
+inline void logCapture(uint8_t category, uint8_t level, const char *fmt, Args &&...args)
+{
+    [[maybe_unused]] LogEntry *entry = logBegin(category, level, fmt);
+    (logArg(*entry, args), ...);
+}
+
+void logDrain();
+size_t logFormat(const LogEntry &entry, char *out, size_t capacity);
+const LogStats &getLogStats();
+uint16_t logCount();
+const LogEntry &logAt(uint16_t index); // Oldest first
+const char *getLogCategoryName(uint8_t category);
+int findLogCategory(const char *name);
+const char *getLogLevelName(uint8_t level);
+int findLogLevel(const char *name);
@@ -0,0 +1,106 @@
+#include "debug/profiler.h"
+
+#if ENABLE_PROFILER
+
+static PerfSection sections[PERF_SECTION_COUNT];
+static PerfLoopStats loopStats;
+static uint32_t lastLoopCycles = 0;
+static bool loopStarted = false;
+
+float perfCyclesToUs(uint64_t cycles)
+{
+    return (float)cycles / ESP.getCpuFreqMHz();
+}
+
+static uint8_t histogramBucket(uint32_t cycles)
+{
+    uint32_t us = cycles / ESP.getCpuFreqMHz();
+    if (us < 2)
+    {
+        return 0;
+    }
+    uint8_t bucket = 31 - __builtin_clz(us); // floor(log2(us))
+    return bucket < PERF_HISTOGRAM_BUCKETS ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+}
+
+void perfRecord(PerfSectionId id, uint32_t cycles)
+{
+    PerfSection &section = sections[id];
+    section.count++;
+    section.total_cycles += cycles;
+    if (cycles > section.max_cycles)
+    {
+        section.max_cycles = cycles;
+    }
+    uint16_t &bucket = section.histogram[histogramBucket(cycles)];
+    if (bucket < UINT16_MAX)
+    {
+        bucket++;
+    }
+}
+
+void perfLoopTick()
+{
+    uint32_t now = ESP.getCycleCount();
+    if (loopStarted)
+    {
+        // The cycle counter wraps every ~53 s at 80 MHz; a single loop never takes that long
+        uint32_t period = now - lastLoopCycles;
+        if (loopStats.count == 0 || period < loopStats.min_cycles)
+        {
+            loopStats.min_cycles = period;
+        }
+        if (period > loopStats.max_cycles)
+        {
+            loopStats.max_cycles = period;
+        }
+        loopStats.count++;
+        float us = perfCyclesToUs(period);
+        float delta = us - loopStats.mean_us;
+        loopStats.mean_us += delta / loopStats.count;
+        loopStats.m2_us += delta * (us - loopStats.mean_us);
+    }
+    lastLoopCycles = now;
+    loopStarted = true;
+}
+
+void perfReset()
+{
+    memset(sections, 0, sizeof(sections));
+    memset(&loopStats, 0, sizeof(loopStats));
+    loopStarted = false;
+}
+
+float perfLoopJitterUs()
+{
+    return loopStats.count > 1 ? sqrtf(loopStats.m2_us / (loopStats.count - 1)) : 0.0f;
+}
+
+const PerfSection &getPerfSection(PerfSectionId id)
+{
+    return sections[id];
+}
+
+const PerfLoopStats &getPerfLoopStats()
+{
+    return loopStats;
+}
+
+#endif // ENABLE_PROFILER
+
+// Also used by crash diagnostics, which can be enabled without the profiler
+static const char *const sectionNames[PERF_SECTION_COUNT] = {
+    "ota_handle",
+    "sensors",
+    "ota_check",
+    "publish",
+    "mqtt",
+    "web",
+    "mdns",
+    "idle",
+};
+
+const char *getPerfSectionName(PerfSectionId id)
+{
+    return id < PERF_SECTION_COUNT ? sectionNames[id] : "unknown";
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "debug/crash_diag.h"
+
+// Cycle-accurate timing of the loop() sections, served at /api/perf.
+// With ENABLE_PROFILER false the macros expand to nothing.
+
+#define PERF_HISTOGRAM_BUCKETS 16 // log2(us): <2us, <4us, ... >=32ms
+
+enum PerfSectionId
+{
+    PERF_OTA_HANDLE,
+    PERF_SENSORS,
+    PERF_OTA_CHECK,
+    PERF_PUBLISH,
+    PERF_MQTT,
+    PERF_WEB,
+    PERF_MDNS,
+    PERF_IDLE,
+    PERF_SECTION_COUNT
+};
+
+struct PerfSection
+{
+    uint32_t count;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    uint16_t histogram[PERF_HISTOGRAM_BUCKETS]; // Saturates at 65535
+};
+
+// loop() period: time between successive perfLoopTick() calls
+struct PerfLoopStats
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    float mean_us;
+    float m2_us; // Welford sum of squared deviations
+};
+
+void perfRecord(PerfSectionId id, uint32_t cycles);
+void perfLoopTick();
+void perfReset();
+const PerfSection &getPerfSection(PerfSectionId id);
+const PerfLoopStats &getPerfLoopStats();
+const char *getPerfSectionName(PerfSectionId id);
+float perfLoopJitterUs();
+float perfCyclesToUs(uint64_t cycles);
+
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfSectionId id) : id(id), start(ESP.getCycleCount())
+    {
+#if ENABLE_CRASH_DIAG
+        crashDiagEnter(id);
+#endif
+    }
+    ~PerfScope()
+    {
+        perfRecord(id, ESP.getCycleCount() - start);
+#if ENABLE_CRASH_DIAG
+        crashDiagExit();
+#endif
+    }
+
+private:
+    PerfSectionId id;
+    uint32_t start;
+};
+
+#if ENABLE_PROFILER
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PROFILE_SECTION(id) PerfScope PERF_CONCAT(perfScope, __LINE__)(id)
+#define PROFILE_LOOP() perfLoopTick()
+#elif ENABLE_CRASH_DIAG
+// Sections still mark the last code entered for crash diagnostics
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PROFILE_SECTION(id) CrashDiagScope PERF_CONCAT(diagScope, __LINE__)(id)
+#define PROFILE_LOOP()
+#else
+#define PROFILE_SECTION(id)
+#define PROFILE_LOOP()
+#endif
@@ -1,4 +1,7 @@
 unsigned long lastSensorRead = 0;
 unsigned long lastOtaCheck = 0;
 bool pirTriggered = false;
-unsigned long lastPirTrigger = 0; 
\ No newline at end of file
+unsigned long lastPirTrigger = 0;
+unsigned long currentTime = 0;
+bool ledBlink = false;
+unsigned long ledBlinkStart = 0;
@@ -3,4 +3,7 @@
 extern unsigned long lastSensorRead;
 extern unsigned long lastOtaCheck;
 extern bool pirTriggered;
-extern unsigned long lastPirTrigger; 
\ No newline at end of file
+extern unsigned long lastPirTrigger;
+extern unsigned long currentTime;
+extern bool ledBlink;
+extern unsigned long ledBlinkStart;
@@ -13,11 +13,14 @@
 #include "comm/wifi_manager.h"
 #include "actuators/relay.h"
 #include "globals.h"
-
-// Global variables
-unsigned long currentTime = 0;
-bool ledBlink = false;
-unsigned long ledBlinkStart = 0;
+#include "debug/boot_timing.h"
+#include "power/deep_sleep.h"
+#include "power/power_manager.h"
+#include "debug/profiler.h"
+#include "debug/heap_monitor.h"
+#include "debug/log_ring.h"
+#include "debug/crash_diag.h"
+#include "sensors/ld2410_capture.h"
 
 void ledInit()
 {
@@ -45,16 +48,18 @@ BootMode getBootMode()
 
 bool isConfigUninitialized()
 {
-    EEPROM.get(0, config);
     return (config.mqtt_port <= 0 || strlen(config.mqtt_broker) == 0);
 }
 
 void setup()
 {
-    // Initialize serial with a delay to let boot messages clear
+    // Initialize serial; no settle delay, boot timing matters more than the
+    // first few log lines
+    bootPhase("serial");
     Serial.begin(115200);
-
-    delay(2000); // Wait longer for serial to stabilize
+#if ENABLE_CRASH_DIAG
+    crashDiagBegin();
+#endif
 
     // Clear any garbage data
     while (Serial.available())
@@ -62,8 +67,8 @@ void setup()
         Serial.read();
     }
 
-    DEBUG_PRINTLN("\n=== ESP8266 Sensor Network ===");
-    DEBUG_PRINTLN("Starting setup...");
+    DEBUG_PRINTLN(LOG_LITERAL("\n=== ESP8266 Sensor Network ==="));
+    DEBUG_PRINTLN(LOG_LITERAL("Starting setup..."));
 
     // Enable watchdog with longer timeout
     ESP.wdtEnable(WATCHDOG_TIMEOUT);
@@ -72,16 +77,22 @@ void setup()
     MEMORY_DEBUG_PRINTF("Free heap at start: %d bytes\n", ESP.getFreeHeap());
 
     // Initialize EEPROM
-    DEBUG_PRINTLN("Initializing EEPROM...");
-    EEPROM.begin(512);
+    bootPhase("config");
+    DEBUG_PRINTLN(LOG_LITERAL("Initializing EEPROM..."));
+    EEPROM.begin(CONFIG_EEPROM_SIZE);
+    ESP.wdtFeed();
+    DEBUG_PRINTLN(LOG_LITERAL("EEPROM initialized"));
+
+    // Load configuration (also pre-fills the config portal)
+    DEBUG_PRINTLN(LOG_LITERAL("Loading configuration..."));
+    loadConfig();
     ESP.wdtFeed();
-    DEBUG_PRINTLN("EEPROM initialized");
 
     // Check button for force config mode
     BootMode bootMode = getBootMode();
     if (bootMode == FORCE_CONFIG_MODE)
     {
-        DEBUG_PRINTLN("Force config button pressed! Starting WiFiManager config portal...");
+        DEBUG_PRINTLN(LOG_LITERAL("Force config button pressed! Starting WiFiManager config portal..."));
         // Initialize pins
         ledInit();
         if (config.use_relay)
@@ -91,51 +102,58 @@ void setup()
         // Start WiFiManager config portal only
         setupWiFi(true); // Pass a flag to force config portal
         // After config, restart
-        DEBUG_PRINTLN("Config completed, restarting...");
+        DEBUG_PRINTLN(LOG_LITERAL("Config completed, restarting..."));
         delay(1000);
         ESP.restart();
         return;
     }
 
-    // Load configuration
-    DEBUG_PRINTLN("Loading configuration...");
-    loadConfig();
-    ESP.wdtFeed();
-
     // Check if config is uninitialized
     if (isConfigUninitialized())
     {
-        DEBUG_PRINTLN("No valid config found! Forcing WiFiManager config portal...");
+        DEBUG_PRINTLN(LOG_LITERAL("No valid config found! Forcing WiFiManager config portal..."));
         ledInit();
         if (config.use_relay)
         {
             relayInit();
         }
         setupWiFi(true); // Force config portal
-        DEBUG_PRINTLN("Config completed, restarting...");
+        DEBUG_PRINTLN(LOG_LITERAL("Config completed, restarting..."));
         delay(1000);
         ESP.restart();
         return;
     }
 
+#if ENABLE_DEEP_SLEEP
+    // Battery mode: sample, maybe flush, and sleep again without the rest of
+    // setup(). Hold the config button while resetting to get back to the portal.
+    if (config.deep_sleep_enabled)
+    {
+        bootPhase("deep_sleep");
+        runDeepSleepCycle();
+    }
+#endif
+
     // Initialize LittleFS
-    DEBUG_PRINTLN("Initializing LittleFS...");
+    bootPhase("littlefs");
+    DEBUG_PRINTLN(LOG_LITERAL("Initializing LittleFS..."));
     if (!LittleFS.begin())
     {
-        DEBUG_PRINTLN("LittleFS mount failed. Formatting...");
+        DEBUG_PRINTLN(LOG_LITERAL("LittleFS mount failed. Formatting..."));
         LittleFS.format();
         if (LittleFS.begin())
         {
-            DEBUG_PRINTLN("LittleFS successfully formatted and mounted");
+            DEBUG_PRINTLN(LOG_LITERAL("LittleFS successfully formatted and mounted"));
         }
         else
         {
-            DEBUG_PRINTLN("LittleFS still failed after formatting");
+            DEBUG_PRINTLN(LOG_LITERAL("LittleFS still failed after formatting"));
         }
     }
 
     // Initialize pins
-    DEBUG_PRINTLN("Initializing pins...");
+    bootPhase("pins");
+    DEBUG_PRINTLN(LOG_LITERAL("Initializing pins..."));
     ledInit();
     if (config.use_relay)
     {
@@ -144,45 +162,51 @@ void setup()
 
     // relayInit();
     ESP.wdtFeed();
-    DEBUG_PRINTLN("Pins initialized");
+    DEBUG_PRINTLN(LOG_LITERAL("Pins initialized"));
 
-    // Setup sensors (skip if in sensorless mode)
+    // Setup sensors (skip if in sensorless mode). Sensors with a settle time
+    // only record when they become ready, so their warm-up overlaps WiFi
+    bootPhase("sensors");
     if (!config.sensorless_mode)
     {
-        DEBUG_PRINTLN("Setting up sensors...");
+        DEBUG_PRINTLN(LOG_LITERAL("Setting up sensors..."));
         setupAllSensors();
         ESP.wdtFeed();
     }
     else
     {
-        DEBUG_PRINTLN("Skipping sensor setup (sensorless mode)");
+        DEBUG_PRINTLN(LOG_LITERAL("Skipping sensor setup (sensorless mode)"));
         ESP.wdtFeed();
     }
 
     // Setup WiFi
-    DEBUG_PRINTLN("Setting up WiFi...");
+    bootPhase("wifi");
+    DEBUG_PRINTLN(LOG_LITERAL("Setting up WiFi..."));
     setupWiFi(false);
     ESP.wdtFeed();
 
     // Setup web server
-    DEBUG_PRINTLN("Setting up web server...");
+    bootPhase("webserver");
+    DEBUG_PRINTLN(LOG_LITERAL("Setting up web server..."));
     setupWebServer();
     ESP.wdtFeed();
 
-    // Setup MQTT
-    DEBUG_PRINTLN("Setting up MQTT...");
+    // Setup MQTT (the connection itself is made from loop())
+    bootPhase("mqtt");
+    DEBUG_PRINTLN(LOG_LITERAL("Setting up MQTT..."));
     setupMQTT();
     ESP.wdtFeed();
 
     // Setup OTA
-    DEBUG_PRINTLN("Setting up OTA...");
+    bootPhase("ota");
+    DEBUG_PRINTLN(LOG_LITERAL("Setting up OTA..."));
     setupOTA();
     ESP.wdtFeed();
     setupArduinoOTA();
     ESP.wdtFeed();
 
     // PIR interrupt will be managed by updatePirInterrupt() based on sensor availability
-    DEBUG_PRINTLN("PIR interrupt management enabled");
+    DEBUG_PRINTLN(LOG_LITERAL("PIR interrupt management enabled"));
     ESP.wdtFeed();
 
     // Connect to MQTT topic
@@ -191,26 +215,61 @@ void setup()
         relaySetup();
     }
 
-    DEBUG_PRINTLN("Setup complete!");
+#if ENABLE_POWER_MANAGER
+    setupPowerManager();
+#endif
+#if ENABLE_HEAP_MONITOR
+    heapMonitorSample();
+#endif
+
+    bootFinished();
+    DEBUG_PRINTLN(LOG_LITERAL("Setup complete!"));
 }
 
 void loop()
 {
+    PROFILE_LOOP();
     currentTime = millis();
-    handleArduinoOTA();
+#if ENABLE_CRASH_DIAG
+    static uint32_t lastLoopMicros = micros();
+    uint32_t nowMicros = micros();
+    crashDiagLoop(nowMicros - lastLoopMicros);
+    lastLoopMicros = nowMicros;
+#endif
+    {
+        PROFILE_SECTION(PERF_OTA_HANDLE);
+        handleArduinoOTA();
+    }
 
-    // Read sensors periodically (skip if in sensorless mode)
-    if (!config.sensorless_mode && currentTime - lastSensorRead >= SENSOR_READ_INTERVAL)
+    // Read each sensor on its own sampling period (skip if in sensorless mode)
+    // Also read all of them as soon as a sensor finishes its warm-up
+    if (!config.sensorless_mode)
     {
-        readAllSensors();
-        printSensorData();
-        lastSensorRead = currentTime;
+        bool warmedUp = sensorWarmupDue(currentTime);
+        if (warmedUp || sensorsDue(currentTime))
+        {
+            PROFILE_SECTION(PERF_SENSORS);
+            if (warmedUp)
+            {
+                readAllSensors();
+            }
+            else
+            {
+                readDueSensors(currentTime);
+            }
+        }
+        if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL)
+        {
+            printSensorData();
+            lastSensorRead = currentTime;
+        }
     }
 
     // Check for OTA updates
     if (currentTime - lastOtaCheck >= OTA_CHECK_INTERVAL)
     {
-        DEBUG_PRINTLN("Checking for OTA updates...");
+        PROFILE_SECTION(PERF_OTA_CHECK);
+        DEBUG_PRINTLN(LOG_LITERAL("Checking for OTA updates..."));
         checkForOTA();
         lastOtaCheck = currentTime;
     }
@@ -218,17 +277,26 @@ void loop()
     // Publish data to MQTT
     if (currentTime - lastMqttPublish >= MQTT_PUBLISH_INTERVAL)
     {
-        MQTT_DEBUG_PRINTLN("Publishing data to MQTT...");
+        PROFILE_SECTION(PERF_PUBLISH);
+        MQTT_DEBUG_PRINTLN(LOG_LITERAL("Publishing data to MQTT..."));
         publishData();
         lastMqttPublish = currentTime;
     }
 
-    // Handle MQTT connection
-    if (config.mqtt_enabled && !mqttClient.connected())
+#if DIAG_PUBLISH_INTERVAL > 0
+    static unsigned long lastDiagPublish = 0;
+    if (currentTime - lastDiagPublish >= DIAG_PUBLISH_INTERVAL)
     {
-        connectMQTT();
+        publishDiagnostics();
+        lastDiagPublish = currentTime;
+    }
+#endif
+
+    // Handle MQTT connection (reconnects are throttled)
+    {
+        PROFILE_SECTION(PERF_MQTT);
+        maintainMQTT();
     }
-    mqttClient.loop();
 
     // Handle PIR cooldown (skip if in sensorless mode)
     if (!config.sensorless_mode && pirTriggered && (currentTime - lastPirTrigger >= PIR_COOLDOWN))
@@ -245,7 +313,7 @@ void loop()
         {
             digitalWrite(LED_PIN, LOW);
             ledBlink = false;
-            DEBUG_PRINTLN("Motion detected!");
+            DEBUG_PRINTLN(LOG_LITERAL("Motion detected!"));
         }
     }
 
@@ -256,10 +324,16 @@ void loop()
         MEMORY_DEBUG_PRINTF("Web server check - Free heap: %d bytes\n", ESP.getFreeHeap());
         lastWebCheck = currentTime;
     }
-    server.handleClient();
+    {
+        PROFILE_SECTION(PERF_WEB);
+        server.handleClient();
+    }
 
     // Handle mDNS
-    MDNS.update();
+    {
+        PROFILE_SECTION(PERF_MDNS);
+        MDNS.update();
+    }
 
     // Feed watchdog and small delay to prevent watchdog issues
     ESP.wdtFeed();
@@ -272,5 +346,51 @@ void loop()
         lastMemoryCheck = currentTime;
     }
 
+#if ENABLE_HEAP_MONITOR
+    static unsigned long lastHeapSample = 0;
+    if (currentTime - lastHeapSample >= HEAP_SAMPLE_INTERVAL)
+    {
+        heapMonitorSample();
+        lastHeapSample = currentTime;
+#if ENABLE_CRASH_DIAG
+        const HeapStats &heap = getHeapStats();
+        crashDiagHeap(heap.min_free, heap.max_fragmentation, heap.min_free_cont_stack);
+#endif
+    }
+#endif
+
+#if ENABLE_LOG_RING
+    // Deferred formatting of debug output, bounded by the UART FIFO
+    logDrain();
+#endif
+
+#if ENABLE_LD2410_CAPTURE
+    ld2410CaptureLoop();
+#endif
+
+#if ENABLE_POWER_MANAGER
+    // Sleep until the next scheduled work item. MQTT keepalive/reconnects and
+    // web polling are covered by the POWER_MAX_IDLE_MS ceiling
+    powerDeadline(nextSensorPollAt(lastSensorRead + SENSOR_READ_INTERVAL));
+    powerDeadline(lastMqttPublish + MQTT_PUBLISH_INTERVAL);
+    powerDeadline(lastOtaCheck + OTA_CHECK_INTERVAL);
+    unsigned long warmupAt;
+    if (nextSensorWarmup(warmupAt))
+    {
+        powerDeadline(warmupAt);
+    }
+    if (ledBlink)
+    {
+        powerDeadline(ledBlinkStart + 100);
+    }
+    if (pirTriggered)
+    {
+        powerDeadline(lastPirTrigger + PIR_COOLDOWN);
+    }
+    PROFILE_SECTION(PERF_IDLE);
+    powerIdle();
+#else
+    PROFILE_SECTION(PERF_IDLE);
     delay(100);
+#endif
 }
@@ -1,36 +1,101 @@
 #include "config_manager.h"
 #include "config.h"
-#include <EEPROM.h>
 #include <Arduino.h>
 #include "debug/debug_macros.h"
 #include "data_structs.h"
+#include "model/config_store.h"
+#include "comm/publish_filter.h"
+#include "sensors/sensor_sampling.h"
+#include "power/deep_sleep.h"
+
+// Headerless records are the baseline layout, which ended with use_relay.
+// Fields are only ever appended and hold defaults before the stored prefix is
+// copied over them; out-of-range values are caught by the validation every
+// load runs.
+static const uint16_t legacyConfigLength = offsetof(ConfigData, publish);
+
+static void applyDefaultConfig()
+{
+    memset(&config, 0, sizeof(config));
+    strcpy(config.mqtt_broker, MQTT_BROKER);
+    config.mqtt_port = MQTT_PORT;
+    strcpy(config.mqtt_username, MQTT_USERNAME);
+    strcpy(config.mqtt_password, MQTT_PASSWORD);
+    strcpy(config.location, "sensors");
+    config.mqtt_enabled = ENABLE_MQTT;
+    config.sensorless_mode = DEFAULT_SENSORLESS_MODE;
+    // config.use_radar = DEFAULT_USE_RADAR;
+
+    // Initialize sensor enable flags from compile-time defines
+    config.use_dht = DEFAULT_USE_DHT;
+    config.use_tsl2561 = DEFAULT_USE_TSL2561;
+    config.use_pir = DEFAULT_USE_PIR;
+    config.use_ld2410 = DEFAULT_USE_LD2410;
+    config.use_relay = DEFAULT_USE_RELAY;
+    applyBuildProfile(config);
+
+    applyDefaultPublishThresholds();
+    applyDefaultSampling();
+
+    applyDefaultDeepSleep();
+}
+
+static bool hasBrokerSettings()
+{
+    size_t brokerLength = strnlen(config.mqtt_broker, sizeof(config.mqtt_broker));
+    return config.mqtt_port > 0 && brokerLength > 0 && brokerLength < sizeof(config.mqtt_broker);
+}
 
 void loadConfig()
 {
-    EEPROM.get(0, config);
-    if (config.mqtt_port == 0 || strlen(config.mqtt_broker) == 0)
-    {
-        DEBUG_PRINTLN("Loading default configuration...");
-        strcpy(config.mqtt_broker, MQTT_BROKER);
-        config.mqtt_port = MQTT_PORT;
-        strcpy(config.mqtt_username, MQTT_USERNAME);
-        strcpy(config.mqtt_password, MQTT_PASSWORD);
-        strcpy(config.location, "sensors");
-        config.mqtt_enabled = ENABLE_MQTT;
-        config.sensorless_mode = DEFAULT_SENSORLESS_MODE;
-        // config.use_radar = DEFAULT_USE_RADAR;
+    configStoreBegin();
 
-        // Initialize sensor enable flags from compile-time defines
-        config.use_dht = USE_DHT;
-        config.use_tsl2561 = USE_TSL2561;
-        config.use_pir = USE_PIR;
-        config.use_ld2410 = USE_LD2410;
-        config.use_relay = USE_RELAY;
+    // Fields the stored record does not cover keep their defaults
+    applyDefaultConfig();
+    uint16_t version = 0;
+    uint16_t length = 0;
+    ConfigLoadResult result = configStoreLoad(&config, sizeof(config), legacyConfigLength, version, length);
 
+    bool valid = (result == CONFIG_LOAD_OK || result == CONFIG_LOAD_LEGACY) && hasBrokerSettings();
+    bool dirty = false;
+    if (!valid)
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Loading default configuration..."));
+        applyDefaultConfig();
+        dirty = true;
+    }
+    else if (version < CONFIG_VERSION)
+    {
+        DEBUG_PRINTF("Migrating configuration from version %u to %u\n", version, CONFIG_VERSION);
+        dirty = true;
+    }
+
+    // Checked whatever path got us here; each group falls back on its own
+    if (!validatePublishThresholds())
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Loading default publish thresholds..."));
+        applyDefaultPublishThresholds();
+        dirty = true;
+    }
+    if (!validateSampling())
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Loading default sampling periods..."));
+        applyDefaultSampling();
+        dirty = true;
+    }
+    if (!validateDeepSleep())
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Loading default deep sleep settings..."));
+        applyDefaultDeepSleep();
+        dirty = true;
+    }
+    if (dirty)
+    {
         saveConfig();
     }
+    applyBuildProfile(config); // A stored config may come from a fuller build
     config.sensorless_mode = DEFAULT_SENSORLESS_MODE;
-    DEBUG_PRINTLN("Configuration loaded:");
+    DEBUG_PRINTLN(LOG_LITERAL("Configuration loaded:"));
     DEBUG_PRINTF("  MQTT Broker: %s:%d\n", config.mqtt_broker, config.mqtt_port);
     DEBUG_PRINTF("  Location: %s\n", config.location);
     DEBUG_PRINTF("  MQTT Enabled: %s\n", config.mqtt_enabled ? "Yes" : "No");
@@ -43,17 +108,28 @@ void loadConfig()
                  config.use_relay ? "Yes" : "No");
 }
 
+void applyBuildProfile(ConfigData &data)
+{
+    data.use_dht = data.use_dht && USE_DHT;
+    data.use_tsl2561 = data.use_tsl2561 && USE_TSL2561;
+    data.use_pir = data.use_pir && USE_PIR;
+    data.use_ld2410 = data.use_ld2410 && USE_LD2410;
+    data.use_relay = data.use_relay && USE_RELAY;
+}
+
 void saveConfig()
 {
-    EEPROM.put(0, config);
-    EEPROM.commit();
-    DEBUG_PRINTLN("Configuration saved to EEPROM");
+    // Unchanged configs are not rewritten, so calling this freely is cheap
+    if (configStoreSave(&config, sizeof(config), CONFIG_VERSION))
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Configuration saved"));
+    }
 }
 
 void printFullConfig()
 {
-    DEBUG_PRINTLN("\n=== FULL CONFIGURATION ===");
-    DEBUG_PRINTLN("MQTT Configuration:");
+    DEBUG_PRINTLN(LOG_LITERAL("\n=== FULL CONFIGURATION ==="));
+    DEBUG_PRINTLN(LOG_LITERAL("MQTT Configuration:"));
     DEBUG_PRINTF("  Broker: %s:%d\n", config.mqtt_broker, config.mqtt_port);
     DEBUG_PRINTF("  Username: %s\n", config.mqtt_username);
     DEBUG_PRINTF("  Location: %s\n", config.location);
@@ -66,5 +142,5 @@ void printFullConfig()
                  config.use_ld2410 ? "Yes" : "No",
                  config.use_relay ? "Yes" : "No");
     // ... (add more as needed) ...
-    DEBUG_PRINTLN("==========================\n");
+    DEBUG_PRINTLN(LOG_LITERAL("==========================\n"));
 }
\ No newline at end of file
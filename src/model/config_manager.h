@@ -2,5 +2,7 @@
 #include "model/data_structs.h"
 
 void loadConfig();
+// Clears use_* flags for hardware compiled out of this build (USE_* in config.h)
+void applyBuildProfile(ConfigData &data);
 void saveConfig();
 void printFullConfig();
\ No newline at end of file
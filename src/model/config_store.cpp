@@ -0,0 +1,220 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include "config.h"
+#include "model/config_store.h"
+#include "debug/debug_macros.h"
+
+// EEPROM emulation erases and rewrites its whole flash sector on every
+// commit, so rotating slots inside it would not spread wear. Wear is kept
+// down by skipping identical writes; the LittleFS backend additionally gets
+// the filesystem's wear levelling.
+static ConfigStoreStats storeStats = {
+#if CONFIG_STORE_USE_LITTLEFS
+    "littlefs",
+#else
+    "eeprom",
+#endif
+    0, 0, 0, 0, CONFIG_LOAD_EMPTY};
+
+// CRC of the record currently in storage, to detect no-op saves
+static uint32_t storedCrc = 0;
+static bool storedValid = false;
+
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    crc = ~crc;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t headerCrc(const ConfigRecordHeader &header)
+{
+    uint32_t crc = crc32Update(0, (const uint8_t *)&header.version, sizeof(header.version));
+    crc = crc32Update(crc, (const uint8_t *)&header.length, sizeof(header.length));
+    return crc32Update(crc, (const uint8_t *)&header.sequence, sizeof(header.sequence));
+}
+
+#if CONFIG_STORE_USE_LITTLEFS
+#define CONFIG_STORE_TEMP_FILE CONFIG_STORE_FILE ".tmp"
+
+static bool readRecord(ConfigRecordHeader &header, void *payload, uint16_t capacity)
+{
+    File file = LittleFS.open(CONFIG_STORE_FILE, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) && header.magic == CONFIG_STORE_MAGIC;
+    if (ok)
+    {
+        // CRC covers the full stored payload even if we keep only a prefix
+        uint32_t crc = headerCrc(header);
+        uint8_t chunk[32];
+        uint16_t offset = 0;
+        while (ok && offset < header.length)
+        {
+            size_t n = min((size_t)(header.length - offset), sizeof(chunk));
+            ok = file.read(chunk, n) == n;
+            crc = crc32Update(crc, chunk, n);
+            if (offset < capacity)
+            {
+                memcpy((uint8_t *)payload + offset, chunk, min(n, (size_t)(capacity - offset)));
+            }
+            offset += n;
+        }
+        ok = ok && crc == header.crc;
+    }
+    file.close();
+    return ok;
+}
+
+static bool writeRecord(const ConfigRecordHeader &header, const void *payload)
+{
+    // Write a temporary file and rename it, so a power cut leaves the old record
+    File file = LittleFS.open(CONFIG_STORE_TEMP_FILE, "w");
+    if (!file)
+    {
+        return false;
+    }
+    bool ok = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t *)payload, header.length) == header.length;
+    file.close();
+    return ok && LittleFS.rename(CONFIG_STORE_TEMP_FILE, CONFIG_STORE_FILE);
+}
+#else
+static bool readRecord(ConfigRecordHeader &header, void *payload, uint16_t capacity)
+{
+    EEPROM.get(0, header);
+    if (header.magic != CONFIG_STORE_MAGIC || sizeof(header) + header.length > EEPROM.length())
+    {
+        return false;
+    }
+
+    const uint8_t *stored = EEPROM.getConstDataPtr() + sizeof(header);
+    if (crc32Update(headerCrc(header), stored, header.length) != header.crc)
+    {
+        return false;
+    }
+    memcpy(payload, stored, min(header.length, capacity));
+    return true;
+}
+
+static bool writeRecord(const ConfigRecordHeader &header, const void *payload)
+{
+    if (sizeof(header) + header.length > EEPROM.length())
+    {
+        return false;
+    }
+    EEPROM.put(0, header);
+    for (uint16_t i = 0; i < header.length; i++)
+    {
+        EEPROM.write(sizeof(header) + i, ((const uint8_t *)payload)[i]);
+    }
+    return EEPROM.commit();
+}
+#endif
+
+void configStoreBegin()
+{
+#if CONFIG_STORE_USE_LITTLEFS
+    if (!LittleFS.begin())
+    {
+        ERROR_PRINTLN(LOG_LITERAL("LittleFS mount failed, config store unavailable"));
+    }
+#endif
+}
+
+ConfigLoadResult configStoreLoad(void *payload, uint16_t capacity, uint16_t legacyLength, uint16_t &version, uint16_t &length)
+{
+    ConfigRecordHeader header;
+    header.magic = 0;
+    if (readRecord(header, payload, capacity))
+    {
+        storeStats.sequence = header.sequence;
+        storeStats.loaded_version = header.version;
+        storedCrc = header.crc;
+        storedValid = true;
+        storeStats.load_result = CONFIG_LOAD_OK;
+        version = header.version;
+        length = header.length;
+        return CONFIG_LOAD_OK;
+    }
+
+    storeStats.load_result = CONFIG_LOAD_EMPTY;
+    if (header.magic == CONFIG_STORE_MAGIC)
+    {
+        ERROR_PRINTLN(LOG_LITERAL("Config record failed CRC check"));
+        storeStats.load_result = CONFIG_LOAD_CORRUPT;
+        return CONFIG_LOAD_CORRUPT;
+    }
+
+    // Firmware before the config store wrote ConfigData raw at EEPROM offset 0.
+    // Only its fields are copied; fields appended since keep their defaults
+    legacyLength = min(legacyLength, capacity);
+    for (uint16_t i = 0; i < legacyLength && i < EEPROM.length(); i++)
+    {
+        ((uint8_t *)payload)[i] = EEPROM.read(i);
+    }
+    version = 1;
+    length = legacyLength;
+    storeStats.loaded_version = version;
+    storeStats.load_result = CONFIG_LOAD_LEGACY;
+    return CONFIG_LOAD_LEGACY;
+}
+
+bool configStoreSave(const void *payload, uint16_t length, uint16_t version)
+{
+    ConfigRecordHeader header;
+    header.magic = CONFIG_STORE_MAGIC;
+    header.version = version;
+    header.length = length;
+
+    // Same content under the current sequence gives the stored CRC: skip the erase
+    header.sequence = storeStats.sequence;
+    if (storedValid && crc32Update(headerCrc(header), (const uint8_t *)payload, length) == storedCrc)
+    {
+        storeStats.skipped++;
+        return true;
+    }
+
+    header.sequence = storeStats.sequence + 1;
+    header.crc = crc32Update(headerCrc(header), (const uint8_t *)payload, length);
+    if (!writeRecord(header, payload))
+    {
+        ERROR_PRINTLN(LOG_LITERAL("Config write failed"));
+        return false;
+    }
+
+    storeStats.sequence = header.sequence;
+    storeStats.writes++;
+    storedCrc = header.crc;
+    storedValid = true;
+    return true;
+}
+
+void configStoreErase()
+{
+#if CONFIG_STORE_USE_LITTLEFS
+    LittleFS.remove(CONFIG_STORE_FILE);
+#endif
+    for (size_t i = 0; i < EEPROM.length(); i++)
+    {
+        EEPROM.write(i, 0);
+    }
+    EEPROM.commit();
+    storedValid = false;
+}
+
+const ConfigStoreStats &getConfigStoreStats()
+{
+    return storeStats;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+
+// Header stored in front of every config record
+struct ConfigRecordHeader
+{
+    uint32_t magic;    // CONFIG_STORE_MAGIC
+    uint16_t version;  // Layout version of the payload
+    uint16_t length;   // Payload length in bytes
+    uint32_t sequence; // Lifetime write count, i.e. flash sector erases
+    uint32_t crc;      // CRC32 over version, length, sequence and payload
+};
+
+enum ConfigLoadResult
+{
+    CONFIG_LOAD_OK,
+    CONFIG_LOAD_LEGACY, // Headerless record from older firmware
+    CONFIG_LOAD_EMPTY,
+    CONFIG_LOAD_CORRUPT
+};
+
+struct ConfigStoreStats
+{
+    const char *backend;
+    uint32_t sequence;      // Lifetime erases of the config sector/file
+    unsigned long writes;   // Writes since boot
+    unsigned long skipped;  // Saves skipped because nothing changed
+    uint16_t loaded_version;
+    ConfigLoadResult load_result;
+};
+
+void configStoreBegin();
+// legacyLength: bytes of a headerless record that belong to the payload; the
+// rest of the payload keeps what the caller put there
+ConfigLoadResult configStoreLoad(void *payload, uint16_t capacity, uint16_t legacyLength, uint16_t &version, uint16_t &length);
+bool configStoreSave(const void *payload, uint16_t length, uint16_t version);
+void configStoreErase();
+const ConfigStoreStats &getConfigStoreStats();
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length);
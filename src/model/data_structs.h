@@ -1,4 +1,57 @@
 #pragma once
+#include <stdint.h>
+
+// Metrics that go through publish suppression (see comm/publish_filter.h)
+enum PublishMetric
+{
+    PUBLISH_TEMPERATURE,
+    PUBLISH_HUMIDITY,
+    PUBLISH_LUMINESCENCE,
+    PUBLISH_MOTION,
+    PUBLISH_RADAR,
+    PUBLISH_RELAY,
+    PUBLISH_ALL,
+    PUBLISH_METRIC_COUNT
+};
+
+// Sensor drivers, in SensorList order (sensors/sensor_registry.h)
+enum SensorId : uint8_t
+{
+    SENSOR_DHT,
+    SENSOR_TSL2561,
+    SENSOR_PIR,
+    SENSOR_LD2410,
+    SENSOR_COUNT
+};
+
+// Sampling period of one sensor (runtime configurable, see sensors/sensor_sampling.h)
+struct SamplingConfig
+{
+    uint32_t min_ms; // Period while the value is changing
+    uint32_t max_ms; // Longest period the sensor backs off to while it is stable
+    float change;    // Change between samples that counts as changing
+};
+
+// Publish suppression thresholds for one metric (runtime configurable)
+struct PublishThreshold
+{
+    float deadband;             // Minimum change since last publish (0 = every sample)
+    float rate_threshold;       // Change per second that forces a publish (0 = off)
+    unsigned long min_interval; // Never publish more often than this (ms)
+    unsigned long max_interval; // Heartbeat: always publish after this long (ms)
+};
+
+// Last good WiFi association, used to skip the scan and DHCP on reconnect
+struct WifiFastConnectCache
+{
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t valid;
+};
 
 struct ConfigData
 {
@@ -17,6 +70,20 @@ struct ConfigData
     bool use_pir;
     bool use_ld2410;
     bool use_relay;
+
+    // Publish suppression thresholds, indexed by PublishMetric
+    PublishThreshold publish[PUBLISH_METRIC_COUNT];
+
+    // Copy of the RTC WiFi cache that survives power loss (version 3)
+    WifiFastConnectCache wifi_cache;
+
+    // Battery operation (version 4)
+    bool deep_sleep_enabled;
+    uint8_t deep_sleep_flush_every; // Wakes per WiFi/MQTT flush
+    uint16_t deep_sleep_interval_s; // Timer wake period
+
+    // Per-sensor sampling periods, indexed by SensorId (version 5)
+    SamplingConfig sampling[SENSOR_COUNT];
 };
 
 struct SensorData
@@ -0,0 +1,252 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESP8266WiFi.h>
+#include "config.h"
+#include "power/deep_sleep.h"
+#include "model/data_structs.h"
+#include "model/config_manager.h"
+#include "model/config_store.h"
+#include "sensors/dht_sensor.h"
+#include "sensors/tsl2561_sensor.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_qos.h"
+#include "comm/payloads.h"
+#include "comm/wifi_manager.h"
+#include "debug/debug_macros.h"
+
+static uint32_t sleepRingCrc(const SleepRing &ring)
+{
+    const uint8_t *start = (const uint8_t *)&ring + sizeof(ring.crc);
+    return crc32Update(0, start, sizeof(ring) - sizeof(ring.crc));
+}
+
+bool readSleepRing(SleepRing &ring)
+{
+    return ESP.rtcUserMemoryRead(RTC_SLEEP_RING_BLOCK, (uint32_t *)&ring, sizeof(ring)) &&
+           ring.crc == sleepRingCrc(ring) && ring.count <= RTC_SLEEP_RING_CAPACITY &&
+           ring.head < RTC_SLEEP_RING_CAPACITY;
+}
+
+static void writeSleepRing(SleepRing &ring)
+{
+    ring.crc = sleepRingCrc(ring);
+    ESP.rtcUserMemoryWrite(RTC_SLEEP_RING_BLOCK, (uint32_t *)&ring, sizeof(ring));
+}
+
+void applyDefaultDeepSleep()
+{
+    config.deep_sleep_enabled = false;
+    config.deep_sleep_flush_every = DEEP_SLEEP_DEFAULT_FLUSH_EVERY;
+    config.deep_sleep_interval_s = DEEP_SLEEP_DEFAULT_INTERVAL_S;
+}
+
+bool validateDeepSleep()
+{
+    return validateDeepSleep(config);
+}
+
+bool validateDeepSleep(const ConfigData &data)
+{
+    // A record from flash can hold any byte where a bool is expected
+    uint8_t enabled;
+    memcpy(&enabled, &data.deep_sleep_enabled, sizeof(enabled));
+    if (enabled > 1 || data.deep_sleep_flush_every < 1 || data.deep_sleep_flush_every > RTC_SLEEP_RING_CAPACITY ||
+        data.deep_sleep_interval_s < 1 || data.deep_sleep_interval_s * 1000000ULL > ESP.deepSleepMax())
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Invalid deep sleep settings"));
+        return false;
+    }
+    return true;
+}
+
+float estimateEnergyPerSampleUj(const SleepRing &ring, uint16_t intervalS)
+{
+    if (ring.samples == 0)
+    {
+        return 0.0f;
+    }
+    // mA * ms and uA * s are both microcoulombs; times volts gives microjoules
+    float awakeUc = ENERGY_AWAKE_MA * ring.awake_ms + ENERGY_RADIO_MA * ring.radio_ms;
+    float sleepUc = ENERGY_SLEEP_UA * (float)ring.wake_count * intervalS;
+    return ENERGY_SUPPLY_VOLTAGE * (awakeUc + sleepUc) / ring.samples;
+}
+
+static SleepSample takeSleepSample(uint32_t clockS)
+{
+    SleepSample sample;
+    sample.t_s = clockS;
+    sample.temperature_c10 = SLEEP_SAMPLE_INVALID;
+    sample.humidity_c10 = SLEEP_SAMPLE_INVALID;
+    sample.lux_c10 = 0;
+
+    if (config.sensorless_mode)
+    {
+        return sample;
+    }
+#if USE_DHT
+    if (config.use_dht)
+    {
+        // The DHT stays powered through deep sleep, so there is no warm-up wait
+        dht.begin();
+        float temp = dht.readTemperature();
+        float hum = dht.readHumidity();
+        if (!isnan(temp) && !isnan(hum))
+        {
+            sample.temperature_c10 = (int16_t)lroundf(temp * 10.0f);
+            sample.humidity_c10 = (int16_t)lroundf(hum * 10.0f);
+        }
+    }
+#endif
+#if USE_TSL2561
+    if (config.use_tsl2561)
+    {
+        setupTSL2561();
+        if (sensorData.tsl_available)
+        {
+            sensors_event_t event;
+            tsl.getEvent(&event);
+            sample.lux_c10 = (uint32_t)lroundf(event.light * 10.0f);
+        }
+    }
+#endif
+    return sample;
+}
+
+static bool waitForAcks(unsigned long timeoutMs)
+{
+    unsigned long start = millis();
+    while (mqttInflightCount() > 0 && millis() - start < timeoutMs)
+    {
+        mqttClient.loop();
+        delay(10);
+        ESP.wdtFeed();
+    }
+    return mqttInflightCount() == 0;
+}
+
+// Publishes the ring oldest-first in small batches and drops what the broker
+// acknowledged. Anything left stays in RTC memory for the next flush; returns
+// false if anything is left.
+static bool flushSleepRing(SleepRing &ring)
+{
+    if (!config.mqtt_enabled || !connectWiFiStation(DEEP_SLEEP_WIFI_TIMEOUT))
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Deep sleep flush skipped: no network"));
+        return false;
+    }
+    saveConfig(); // Persists a changed WiFi cache; no-op otherwise
+
+    timeClient.begin();
+    bool timeValid = timeClient.forceUpdate();
+    uint32_t epoch = timeValid ? timeClient.getEpochTime() : 0;
+
+    setupMQTT();
+    if (!connectMQTT())
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Deep sleep flush skipped: MQTT connect failed"));
+        return false;
+    }
+    // Picks up commands (e.g. command/deep_sleep) queued by the persistent session
+    mqttClient.loop();
+
+    String topic = getTopicWithLocation(MQTT_TOPIC_BATCH);
+    while (ring.count > 0)
+    {
+        uint16_t n = min((uint16_t)DEEP_SLEEP_SAMPLES_PER_MESSAGE, ring.count);
+        DynamicJsonDocument doc(JSON_CAPACITY_SLEEP_BATCH);
+        buildSleepBatchPayload(doc, ring, n, epoch);
+        String payload;
+        serializePayload(PAYLOAD_SLEEP_BATCH, doc, payload);
+        if (!mqttPublish(topic.c_str(), payload.c_str()) || !waitForAcks(DEEP_SLEEP_ACK_TIMEOUT))
+        {
+            DEBUG_PRINTLN(LOG_LITERAL("Deep sleep flush incomplete, keeping samples"));
+            break;
+        }
+        sleepRingConsume(ring, n);
+    }
+
+    // A clean disconnect suppresses the "offline" will; "sleeping" says why
+    mqttClient.publish(getTopicWithLocation(MQTT_TOPIC_STATUS).c_str(), "sleeping", true);
+    mqttClient.loop();
+    mqttClient.disconnect();
+    WiFi.disconnect(true);
+    return ring.count == 0;
+}
+
+void runDeepSleepCycle()
+{
+    unsigned long wakeStart = millis();
+    SleepRing ring;
+    if (!readSleepRing(ring))
+    {
+        DEBUG_PRINTLN(LOG_LITERAL("Deep sleep ring invalid, resetting"));
+        sleepRingReset(ring);
+    }
+    ring.wake_count++;
+
+    uint8_t flushEvery = constrain(config.deep_sleep_flush_every, 1, RTC_SLEEP_RING_CAPACITY);
+    uint16_t intervalS = max((uint16_t)1, config.deep_sleep_interval_s);
+
+    sleepRingPush(ring, takeSleepSample(ring.clock_s));
+
+    // The radio state was chosen when going to sleep: RF can only be enabled
+    // on wakes that were scheduled with WAKE_RF_DEFAULT
+    bool radioWake = ring.radio_wake != 0;
+    if (radioWake)
+    {
+        sleepRingFlushed(ring, flushSleepRing(ring));
+    }
+    else
+    {
+        WiFi.forceSleepBegin();
+    }
+
+    unsigned long awake = millis() - wakeStart;
+    if (radioWake)
+    {
+        ring.radio_ms += awake;
+    }
+    else
+    {
+        ring.awake_ms += awake;
+    }
+    ring.clock_s += intervalS + (awake + 500) / 1000;
+
+    bool nextRadio = sleepRingFlushDue(ring, flushEvery);
+    if (!config.deep_sleep_enabled)
+    {
+        // Disabled by command during the flush; reboot into normal operation
+        ring.radio_wake = 1;
+        writeSleepRing(ring);
+        ESP.restart();
+    }
+    ring.radio_wake = nextRadio ? 1 : 0;
+    writeSleepRing(ring);
+
+    DEBUG_PRINTF("Deep sleep: %u samples buffered, next wake in %u s (radio %s, %u failed flushes)\n",
+                 ring.count, intervalS, nextRadio ? "on" : "off", ring.flush_failures);
+    ESP.deepSleep((uint64_t)intervalS * 1000000ULL, nextRadio ? WAKE_RF_DEFAULT : WAKE_RF_DISABLED);
+    // Not reached; deepSleep() does not return
+}
+
+// The router hands over a NUL-terminated copy, so the length is not needed
+void handleDeepSleepCommand(const char *payload, unsigned int)
+{
+    bool enable;
+    if (strcasecmp(payload, "on") == 0 || strcmp(payload, "1") == 0)
+    {
+        enable = true;
+    }
+    else if (strcasecmp(payload, "off") == 0 || strcmp(payload, "0") == 0)
+    {
+        enable = false;
+    }
+    else
+    {
+        MQTT_DEBUG_PRINTF("Unknown deep sleep command: %s\n", payload);
+        return;
+    }
+    config.deep_sleep_enabled = enable;
+    saveConfig();
+    MQTT_DEBUG_PRINTF("Deep sleep %s\n", enable ? "enabled" : "disabled");
+}
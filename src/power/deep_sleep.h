@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+#include "model/data_structs.h"
+#include "power/rtc_ring.h"
+
+// Battery mode: wake on the RTC timer, sample into RTC memory with the radio
+// off, and only bring up WiFi/MQTT every config.deep_sleep_flush_every wakes
+// (or when the ring is about to overflow) to publish the batch.
+
+// Runs one wake cycle and goes back to deep sleep; does not return
+void runDeepSleepCycle();
+
+// Battery settings in config: enabled a real bool, flush_every between 1 and
+// the ring capacity, interval_s no longer than the chip can sleep
+void applyDefaultDeepSleep();
+bool validateDeepSleep();
+bool validateDeepSleep(const ConfigData &data);
+
+// Estimated energy per stored sample from the ring's time accounting
+float estimateEnergyPerSampleUj(const SleepRing &ring, uint16_t intervalS);
+
+// Copy of the RTC ring for reporting; false if it holds no valid data
+bool readSleepRing(SleepRing &ring);
+
+// MQTT command: "off"/"0" leaves battery mode, "on"/"1" enters it on next boot
+void handleDeepSleepCommand(const char *payload, unsigned int length);
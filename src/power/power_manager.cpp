@@ -0,0 +1,231 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+#include "config.h"
+#include "power/power_manager.h"
+#include "model/data_structs.h"
+#include "comm/mqtt.h"
+#include "debug/debug_macros.h"
+
+extern "C"
+{
+#include "user_interface.h"
+#include "gpio.h"
+}
+
+static PowerStats powerStats;
+static unsigned long nextDeadline = 0;
+static bool deadlineSet = false;
+static unsigned long lastActivity = 0;
+static bool activitySeen = false;
+static unsigned long busySince = 0;
+static WiFiSleepType_t currentSleepType = WIFI_NONE_SLEEP;
+static volatile bool wakeRequested = false;
+
+// Wake GPIOs are sampled at the start of each wait and any level change ends it
+static int8_t wakePins[2];
+static uint8_t wakePinLevels[2];
+static uint8_t wakePinCount = 0;
+
+static bool pirWakeActive()
+{
+    return config.use_pir && !config.sensorless_mode;
+}
+
+static bool radarActive()
+{
+    return config.use_ld2410 && !config.sensorless_mode;
+}
+
+#if POWER_WAKE_PIN >= 0 && POWER_WAKE_PIN < 16
+static void IRAM_ATTR handleWakePin()
+{
+    powerWake();
+}
+#endif
+
+void setupPowerManager()
+{
+    busySince = millis();
+#if POWER_WAKE_PIN >= 0
+    pinMode(POWER_WAKE_PIN, INPUT);
+#if POWER_WAKE_PIN < 16
+    attachInterrupt(digitalPinToInterrupt(POWER_WAKE_PIN), handleWakePin, RISING);
+    gpio_pin_wakeup_enable(GPIO_ID_PIN(POWER_WAKE_PIN), GPIO_PIN_INTR_HILEVEL);
+#endif
+#endif
+#if PIR_PIN < 16
+    // GPIO16 has no interrupt or light-sleep wake; it is polled instead
+    gpio_pin_wakeup_enable(GPIO_ID_PIN(PIR_PIN), GPIO_PIN_INTR_HILEVEL);
+#endif
+    DEBUG_PRINTF("Power manager: light sleep %s, max idle %d ms\n",
+                 POWER_ALLOW_LIGHT_SLEEP ? "allowed" : "disabled", POWER_MAX_IDLE_MS);
+}
+
+void powerDeadline(unsigned long at)
+{
+    if (!deadlineSet || (long)(at - nextDeadline) < 0)
+    {
+        nextDeadline = at;
+        deadlineSet = true;
+    }
+}
+
+void powerNoteActivity()
+{
+    lastActivity = millis();
+    activitySeen = true;
+}
+
+void IRAM_ATTR powerWake()
+{
+    wakeRequested = true;
+}
+
+static bool wakePending()
+{
+    if (wakeRequested || mqttInboundPending())
+    {
+        return true;
+    }
+    for (uint8_t i = 0; i < wakePinCount; i++)
+    {
+        if (digitalRead(wakePins[i]) != wakePinLevels[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sampleWakePins()
+{
+    wakePinCount = 0;
+    if (pirWakeActive())
+    {
+        wakePins[wakePinCount++] = PIR_PIN;
+    }
+#if POWER_WAKE_PIN >= 0
+    wakePins[wakePinCount++] = POWER_WAKE_PIN;
+#endif
+    for (uint8_t i = 0; i < wakePinCount; i++)
+    {
+        wakePinLevels[i] = digitalRead(wakePins[i]);
+    }
+}
+
+// Light sleep suspends the CPU, which SoftwareSerial (radar) and a polled
+// GPIO16 PIR cannot tolerate, and adds beacon-interval latency to HTTP
+static bool lightSleepAllowed(unsigned long now)
+{
+#if POWER_ALLOW_LIGHT_SLEEP
+    if (radarActive() || (pirWakeActive() && PIR_PIN >= 16))
+    {
+        return false;
+    }
+    if (activitySeen && now - lastActivity < POWER_WEB_ACTIVE_MS)
+    {
+        return false;
+    }
+    return WiFi.status() == WL_CONNECTED;
+#else
+    return false;
+#endif
+}
+
+static void setSleepType(WiFiSleepType_t type)
+{
+    if (type != currentSleepType)
+    {
+        WiFi.setSleepMode(type, type == WIFI_LIGHT_SLEEP ? POWER_LISTEN_INTERVAL : 0);
+        currentSleepType = type;
+    }
+}
+
+void powerIdle()
+{
+    unsigned long now = millis();
+    powerStats.busy_ms += now - busySince;
+    powerStats.idle_calls++;
+
+    unsigned long wait = POWER_MAX_IDLE_MS;
+    if (deadlineSet)
+    {
+        long remaining = (long)(nextDeadline - now);
+        wait = remaining <= 0 ? 0 : min((unsigned long)remaining, wait);
+    }
+    deadlineSet = false;
+
+    unsigned long cap = wait;
+    if (radarActive())
+    {
+        cap = min(cap, (unsigned long)POWER_RADAR_MAX_IDLE_MS);
+    }
+    if (cap < wait)
+    {
+        powerStats.capped_waits++;
+        wait = cap;
+    }
+
+    if (wait == 0)
+    {
+        // Still give the WiFi stack a turn
+        yield();
+        powerStats.last_mode = POWER_IDLE_NONE;
+        powerStats.last_wait_ms = 0;
+        busySince = millis();
+        return;
+    }
+
+    bool light = lightSleepAllowed(now);
+    setSleepType(light ? WIFI_LIGHT_SLEEP : WIFI_MODEM_SLEEP);
+
+    wakeRequested = false;
+    sampleWakePins();
+    esp_delay(wait, []()
+              { return !wakePending(); },
+              light ? POWER_LIGHT_POLL_MS : POWER_POLL_MS);
+
+    unsigned long end = millis();
+    unsigned long slept = end - now;
+    if (slept < wait)
+    {
+        powerStats.early_wakes++;
+    }
+    if (light)
+    {
+        powerStats.light_sleep_ms += slept;
+    }
+    else
+    {
+        powerStats.modem_sleep_ms += slept;
+    }
+    powerStats.last_mode = light ? POWER_IDLE_LIGHT : POWER_IDLE_MODEM;
+    powerStats.last_wait_ms = slept;
+    busySince = end;
+}
+
+float powerDutyCycle()
+{
+    unsigned long idle = powerStats.modem_sleep_ms + powerStats.light_sleep_ms;
+    unsigned long total = powerStats.busy_ms + idle;
+    return total > 0 ? (float)powerStats.busy_ms / total : 1.0f;
+}
+
+const PowerStats &getPowerStats()
+{
+    return powerStats;
+}
+
+const char *getPowerIdleModeName(PowerIdleMode mode)
+{
+    switch (mode)
+    {
+    case POWER_IDLE_MODEM:
+        return "modem";
+    case POWER_IDLE_LIGHT:
+        return "light";
+    default:
+        return "none";
+    }
+}
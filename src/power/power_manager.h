@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+
+// Idle scheduling for mains-powered operation. loop() reports when it next
+// has work via powerDeadline(), then powerIdle() waits until the earliest one
+// in modem sleep or light sleep, returning early on GPIO or MQTT traffic.
+
+enum PowerIdleMode
+{
+    POWER_IDLE_NONE,  // No wait (deadline already due)
+    POWER_IDLE_MODEM, // CPU on, radio sleeps between beacons
+    POWER_IDLE_LIGHT  // CPU and radio suspended between beacons
+};
+
+struct PowerStats
+{
+    unsigned long idle_calls;
+    unsigned long busy_ms;        // Time spent doing loop() work
+    unsigned long modem_sleep_ms; // Idle time with the CPU running
+    unsigned long light_sleep_ms; // Idle time with light sleep allowed
+    unsigned long early_wakes;    // Waits cut short by GPIO or network activity
+    unsigned long capped_waits;   // Waits shortened for radar polling
+    PowerIdleMode last_mode;
+    unsigned long last_wait_ms;
+};
+
+void setupPowerManager();
+void powerDeadline(unsigned long at);
+void powerNoteActivity();
+void powerWake();
+void powerIdle();
+float powerDutyCycle();
+const PowerStats &getPowerStats();
+const char *getPowerIdleModeName(PowerIdleMode mode);
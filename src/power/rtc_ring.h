@@ -0,0 +1,116 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+// Sample ring kept in RTC user memory across deep sleep. Deliberately free of
+// Arduino dependencies so the ring logic can be exercised on the host.
+
+#ifndef RTC_SLEEP_RING_CAPACITY
+#define RTC_SLEEP_RING_CAPACITY 12
+#endif
+
+// Radio wakes back off to every flushEvery << n wakes after n failed flushes
+// in a row, up to this n
+#ifndef RTC_SLEEP_FLUSH_BACKOFF_MAX
+#define RTC_SLEEP_FLUSH_BACKOFF_MAX 4
+#endif
+
+#define SLEEP_SAMPLE_INVALID INT16_MIN
+
+struct SleepSample
+{
+    uint32_t t_s;            // Virtual clock (seconds) when sampled
+    int16_t temperature_c10; // 0.1 degC, SLEEP_SAMPLE_INVALID if the read failed
+    int16_t humidity_c10;    // 0.1 %RH, SLEEP_SAMPLE_INVALID if the read failed
+    uint32_t lux_c10;        // 0.1 lux
+};
+
+struct SleepRing
+{
+    uint32_t crc;        // Over everything after this field
+    uint32_t wake_count; // Timer wakes since the ring was reset
+    uint32_t clock_s;    // Virtual clock: sleep + awake time since reset
+    uint32_t awake_ms;   // Accumulated awake time with the radio off
+    uint32_t radio_ms;   // Accumulated awake time with the radio on
+    uint32_t samples;    // Samples taken since reset
+    uint16_t head;       // Index of the oldest sample
+    uint16_t count;
+    uint16_t dropped;       // Samples overwritten before they were flushed
+    uint8_t radio_wake;     // This wake started with the radio enabled
+    uint8_t flush_failures; // Radio wakes in a row that left samples unflushed
+    SleepSample data[RTC_SLEEP_RING_CAPACITY];
+};
+
+inline void sleepRingReset(SleepRing &ring)
+{
+    memset(&ring, 0, sizeof(ring));
+    ring.radio_wake = 1; // Power-on and external resets always have RF enabled
+}
+
+// Appends a sample, overwriting the oldest one when the ring is full
+inline void sleepRingPush(SleepRing &ring, const SleepSample &sample)
+{
+    uint16_t tail = (ring.head + ring.count) % RTC_SLEEP_RING_CAPACITY;
+    ring.data[tail] = sample;
+    if (ring.count < RTC_SLEEP_RING_CAPACITY)
+    {
+        ring.count++;
+    }
+    else
+    {
+        ring.head = (ring.head + 1) % RTC_SLEEP_RING_CAPACITY;
+        ring.dropped++;
+    }
+    ring.samples++;
+}
+
+// Oldest-first access
+inline const SleepSample &sleepRingAt(const SleepRing &ring, uint16_t index)
+{
+    return ring.data[(ring.head + index) % RTC_SLEEP_RING_CAPACITY];
+}
+
+// Removes the oldest 'n' samples once they have been delivered
+inline void sleepRingConsume(SleepRing &ring, uint16_t n)
+{
+    if (n > ring.count)
+    {
+        n = ring.count;
+    }
+    ring.head = (ring.head + n) % RTC_SLEEP_RING_CAPACITY;
+    ring.count -= n;
+}
+
+inline bool sleepRingFull(const SleepRing &ring)
+{
+    return ring.count >= RTC_SLEEP_RING_CAPACITY;
+}
+
+// Records how a radio wake's flush went; a clean one ends the backoff
+inline void sleepRingFlushed(SleepRing &ring, bool delivered)
+{
+    if (delivered)
+    {
+        ring.flush_failures = 0;
+    }
+    else if (ring.flush_failures < UINT8_MAX)
+    {
+        ring.flush_failures++;
+    }
+}
+
+// Whether the next wake should have the radio on: every flushEvery wakes, or
+// before the next sample would overwrite one that was never flushed. While
+// flushes fail (no network, broker down) the radio wakes back off instead,
+// letting the ring overwrite its oldest samples rather than spend a WiFi
+// timeout on every wake
+inline bool sleepRingFlushDue(const SleepRing &ring, uint8_t flushEvery)
+{
+    if (ring.flush_failures > 0)
+    {
+        uint8_t shift = ring.flush_failures < RTC_SLEEP_FLUSH_BACKOFF_MAX ? ring.flush_failures
+                                                                          : RTC_SLEEP_FLUSH_BACKOFF_MAX;
+        return (ring.wake_count + 1) % ((uint32_t)flushEvery << shift) == 0;
+    }
+    return (ring.wake_count + 1) % flushEvery == 0 || ring.count + 1 >= RTC_SLEEP_RING_CAPACITY;
+}
@@ -1,26 +1,44 @@
-#include <DHT.h>
 #include "config.h"
+#if USE_DHT
+#include <DHT.h>
 #include "model/data_structs.h"
 #include "sensors/dht_sensor.h"
 #include "debug/debug_macros.h"
+#include "debug/boot_timing.h"
+#include "sensors/sensor_manager.h"
+#include "globals.h"
 
-extern long currentTime;
 int dhtErrorCount = 0;
 unsigned long lastDhtError = 0;
 DHT dht(DHT_PIN, DHT11);
+static unsigned long dhtReadyAt = 0;
+static bool dhtReady = false;
 
 void setupDHT()
 {
     SENSOR_DEBUG_PRINTF("Initializing DHT11 on pin %d...\n", DHT_PIN);
     dht.begin();
-    delay(1000); // Give DHT sensor time to stabilize
+    // The DHT needs time to stabilize; reads are deferred instead of blocking boot
+    dhtReadyAt = millis() + DHT_WARMUP_MS;
+    dhtReady = false;
+    scheduleSensorWarmup(dhtReadyAt);
     ESP.wdtFeed();
-    SENSOR_DEBUG_PRINTLN("DHT11 sensor initialized");
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("DHT11 sensor initialized"));
     sensorData.dht_available = true; // Mark as available after initialization
 }
 
-void readDHT()
+SensorPollResult readDHT()
 {
+    if (!dhtReady)
+    {
+        if ((long)(millis() - dhtReadyAt) < 0)
+        {
+            return SENSOR_POLL_PENDING; // Still warming up; not an error
+        }
+        dhtReady = true;
+        bootEvent("dht_ready");
+    }
+
     float temp = dht.readTemperature();
     float hum = dht.readHumidity();
 
@@ -36,10 +54,11 @@ void readDHT()
             dhtErrorCount = 0;
             sensorData.dht_error_count = 0; // Also update the struct
         }
+        return SENSOR_POLL_OK;
     }
     else
     {
-        SENSOR_DEBUG_PRINTLN("DHT11 sensor read failed");
+        SENSOR_DEBUG_PRINTLN(LOG_LITERAL("DHT11 sensor read failed"));
         dhtErrorCount++;
         sensorData.dht_error_count = dhtErrorCount; // Update the struct
         lastDhtError = currentTime;
@@ -51,5 +70,35 @@ void readDHT()
             sensorData.temperature = 0.0;
             sensorData.humidity = 0.0;
         }
+        return SENSOR_POLL_FAILED;
     }
-}
\ No newline at end of file
+}
+
+bool DhtSensor::ready()
+{
+    return dhtReady || (long)(millis() - dhtReadyAt) >= 0;
+}
+
+void DhtSensor::reset()
+{
+    dhtErrorCount = 0;
+    sensorData.dht_error_count = 0;
+    sensorData.dht_available = true;
+}
+
+void DhtSensor::recover()
+{
+    // Re-initialise the data line and wait out the warm-up again
+    dht.begin();
+    dhtReadyAt = millis() + DHT_WARMUP_MS;
+    dhtReady = false;
+    scheduleSensorWarmup(dhtReadyAt);
+}
+
+void DhtSensor::printReading()
+{
+    SENSOR_DEBUG_PRINTF("Temperature: %.2f°C %s\n", sensorData.temperature, sensorData.dht_available ? "" : "(DHT11 not available)");
+    SENSOR_DEBUG_PRINTF("Humidity: %.2f%% %s\n", sensorData.humidity, sensorData.dht_available ? "" : "(DHT11 not available)");
+}
+
+#endif
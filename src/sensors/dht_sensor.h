@@ -1,7 +1,35 @@
 #pragma once
+#include "config.h"
+#include "sensors/sensor.h"
+#if USE_DHT
 #include <DHT.h>
+#include "model/data_structs.h"
 extern int dhtErrorCount;
 extern unsigned long lastDhtError;
 extern DHT dht ;
 void setupDHT();
-void readDHT(); 
\ No newline at end of file
+SensorPollResult readDHT();
+
+struct DhtSensor
+{
+    static constexpr SensorId id = SENSOR_DHT;
+    static constexpr const char *name = "dht11";
+    static constexpr const char *label = "DHT11 (Temp/Humidity)";
+    static bool enabled() { return config.use_dht; }
+    static void begin() { setupDHT(); }
+    static SensorPollResult poll() { return readDHT(); }
+    static float value() { return sensorData.temperature; }
+    static bool ready();
+    static bool available() { return sensorData.dht_available; }
+    static int errorCount() { return dhtErrorCount; }
+    static void reset();
+    static void recover();
+    static void printReading();
+};
+#else
+struct DhtSensor : AbsentSensor<SENSOR_DHT>
+{
+    static constexpr const char *name = "dht11";
+    static constexpr const char *label = "DHT11 (Temp/Humidity)";
+};
+#endif
@@ -0,0 +1,264 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include "config.h"
+#include "debug/debug_macros.h"
+#include "sensors/ld2410_capture.h"
+
+#if ENABLE_LD2410_CAPTURE
+
+#define RECORD_HEADER_BYTES 6
+#define NO_RECORD 0xFFFF
+
+static Ld2410CaptureStats stats = {};
+static bool capturing = false;
+static File captureFile;
+static WiFiClient captureClient;
+static unsigned long lastFlush = 0;
+
+// Records are assembled here and handed to the sink whole, so flash sees few
+// large writes and the TCP peer few small packets
+static uint8_t buffer[LD2410_CAPTURE_BUFFER];
+static uint16_t fill = 0;
+static uint16_t openRecord = NO_RECORD; // Offset of the record being extended
+static uint32_t openTime = 0;
+static bool openTx = false;
+
+static void put32(uint8_t *out, uint32_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static void finish(const char *reason)
+{
+    if (stats.sink == LD2410_CAPTURE_TO_FILE)
+    {
+        captureFile.close();
+    }
+    else if (stats.sink == LD2410_CAPTURE_TO_TCP)
+    {
+        captureClient.stop();
+    }
+    capturing = false;
+    fill = 0;
+    openRecord = NO_RECORD;
+    SENSOR_DEBUG_PRINTF("LD2410 capture stopped (%s): %u bytes, %u records\n", reason, stats.written, stats.records);
+}
+
+// A short write would leave a torn record, so any failure ends the capture
+static void flushBuffer()
+{
+    if (fill == 0)
+    {
+        return;
+    }
+    if (stats.sink == LD2410_CAPTURE_TO_FILE && stats.written + fill > LD2410_CAPTURE_MAX_BYTES)
+    {
+        stats.dropped += fill;
+        stats.limit_reached = true;
+        finish("size limit");
+        return;
+    }
+
+    size_t sent = stats.sink == LD2410_CAPTURE_TO_FILE ? captureFile.write(buffer, fill)
+                                                       : captureClient.write(buffer, fill);
+    stats.written += sent;
+    if (sent != fill)
+    {
+        stats.dropped += fill - sent;
+        finish("write failed");
+        return;
+    }
+    fill = 0;
+    openRecord = NO_RECORD;
+}
+
+static void record(bool tx, const uint8_t *data, size_t length)
+{
+    if (!capturing || length == 0)
+    {
+        return;
+    }
+    if (tx)
+    {
+        stats.bytes_tx += length;
+    }
+    else
+    {
+        stats.bytes_rx += length;
+    }
+
+    uint32_t now = millis();
+    while (length > 0 && capturing)
+    {
+        if (openRecord == NO_RECORD || openTime != now || openTx != tx)
+        {
+            if (fill + RECORD_HEADER_BYTES >= LD2410_CAPTURE_BUFFER)
+            {
+                flushBuffer();
+                continue;
+            }
+            openRecord = fill;
+            openTime = now;
+            openTx = tx;
+            put32(buffer + fill, now);
+            buffer[fill + 4] = 0;
+            buffer[fill + 5] = 0;
+            fill += RECORD_HEADER_BYTES;
+            stats.records++;
+        }
+
+        size_t room = sizeof(buffer) - fill;
+        if (room == 0)
+        {
+            flushBuffer();
+            continue;
+        }
+        size_t chunk = length < room ? length : room;
+        memcpy(buffer + fill, data, chunk);
+        fill += chunk;
+        data += chunk;
+        length -= chunk;
+
+        // The buffer is far smaller than LD2410_REC_MAX_LENGTH
+        uint16_t recordLength = fill - openRecord - RECORD_HEADER_BYTES;
+        if (tx)
+        {
+            recordLength |= LD2410_REC_TX;
+        }
+        buffer[openRecord + 4] = recordLength;
+        buffer[openRecord + 5] = recordLength >> 8;
+    }
+}
+
+static bool startCapture(Ld2410CaptureSink sink)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.sink = sink;
+    stats.started_ms = millis();
+    capturing = true;
+    lastFlush = millis();
+
+    memcpy(buffer, LD2410_REC_MAGIC, 4);
+    put32(buffer + 4, LD2410_BAUD_RATE_2);
+    put32(buffer + 8, ESP.getChipId());
+    fill = 12;
+    openRecord = NO_RECORD;
+    flushBuffer();
+    return capturing;
+}
+
+int Ld2410Tap::read()
+{
+    int c = _serial.read();
+    if (c >= 0)
+    {
+        uint8_t byte = c;
+        record(false, &byte, 1);
+    }
+    return c;
+}
+
+int Ld2410Tap::read(uint8_t *data, size_t size)
+{
+    int n = _serial.read(data, size);
+    if (n > 0)
+    {
+        record(false, data, n);
+    }
+    return n;
+}
+
+size_t Ld2410Tap::write(const uint8_t *data, size_t size)
+{
+    size_t n = _serial.write(data, size);
+    record(true, data, n);
+    return n;
+}
+
+bool ld2410CaptureStartFile()
+{
+    ld2410CaptureStop();
+    captureFile = LittleFS.open(LD2410_CAPTURE_FILE, "w");
+    if (!captureFile)
+    {
+        SENSOR_DEBUG_PRINTLN(LOG_LITERAL("LD2410 capture: cannot create " LD2410_CAPTURE_FILE));
+        return false;
+    }
+    return startCapture(LD2410_CAPTURE_TO_FILE);
+}
+
+bool ld2410CaptureStartTcp(const char *host, uint16_t port)
+{
+    ld2410CaptureStop();
+    if (!captureClient.connect(host, port))
+    {
+        SENSOR_DEBUG_PRINTF("LD2410 capture: cannot connect to %s:%u\n", host, port);
+        return false;
+    }
+    captureClient.setNoDelay(true);
+    return startCapture(LD2410_CAPTURE_TO_TCP);
+}
+
+void ld2410CaptureStop()
+{
+    if (!capturing)
+    {
+        return;
+    }
+    flushBuffer();
+    if (capturing)
+    {
+        finish("stopped");
+    }
+}
+
+void ld2410CaptureLoop()
+{
+    if (!capturing)
+    {
+        return;
+    }
+    if (stats.sink == LD2410_CAPTURE_TO_TCP && !captureClient.connected())
+    {
+        finish("peer closed");
+        return;
+    }
+    if (millis() - lastFlush >= LD2410_CAPTURE_FLUSH_MS)
+    {
+        lastFlush = millis();
+        flushBuffer();
+        if (capturing && stats.sink == LD2410_CAPTURE_TO_FILE)
+        {
+            captureFile.flush(); // So /api/ld2410/recording sees everything so far
+        }
+    }
+}
+
+bool ld2410CaptureActive()
+{
+    return capturing;
+}
+
+const Ld2410CaptureStats &getLd2410CaptureStats()
+{
+    return stats;
+}
+
+const char *getLd2410CaptureSinkName(Ld2410CaptureSink sink)
+{
+    switch (sink)
+    {
+    case LD2410_CAPTURE_TO_FILE:
+        return "file";
+    case LD2410_CAPTURE_TO_TCP:
+        return "tcp";
+    default:
+        return "none";
+    }
+}
+
+#endif
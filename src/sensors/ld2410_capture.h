@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+
+// Raw LD2410 UART capture. The radar driver reads through Ld2410Tap, which
+// records every byte the firmware reads (and any command it writes) with its
+// millis() timestamp, so a recording replays into the parser exactly as the
+// device saw it (host/LD2410Replay).
+//
+// Recording format, little endian:
+//   "LDR1", u32 baud, u32 chip id
+//   records: u32 t_ms, u16 length (| LD2410_REC_TX for written bytes), bytes
+// Bytes read at the same millisecond in the same direction share a record.
+
+#define LD2410_REC_MAGIC "LDR1"
+#define LD2410_REC_TX 0x8000
+#define LD2410_REC_MAX_LENGTH 0x7FFF
+#define LD2410_CAPTURE_BUFFER 256
+
+enum Ld2410CaptureSink : uint8_t
+{
+    LD2410_CAPTURE_NONE,
+    LD2410_CAPTURE_TO_FILE,
+    LD2410_CAPTURE_TO_TCP
+};
+
+struct Ld2410CaptureStats
+{
+    Ld2410CaptureSink sink;
+    uint32_t started_ms;
+    uint32_t bytes_rx;
+    uint32_t bytes_tx;
+    uint32_t records;
+    uint32_t written;  // Recording bytes handed to the sink, header included
+    uint32_t dropped;  // Bytes lost to a full or failed sink
+    bool limit_reached; // File capture stopped at LD2410_CAPTURE_MAX_BYTES
+};
+
+class Ld2410Tap : public Stream
+{
+public:
+    explicit Ld2410Tap(Stream &serial) : _serial(serial) {}
+
+    int available() override { return _serial.available(); }
+    int read() override;
+    int read(uint8_t *data, size_t size) override;
+    using Stream::read;
+    int peek() override { return _serial.peek(); }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t size) override;
+    using Print::write;
+    int availableForWrite() override { return _serial.availableForWrite(); }
+    void flush() override { _serial.flush(); }
+
+private:
+    Stream &_serial;
+};
+
+bool ld2410CaptureStartFile();
+bool ld2410CaptureStartTcp(const char *host, uint16_t port);
+void ld2410CaptureStop();
+void ld2410CaptureLoop(); // Flushes buffered records and notices a dropped TCP peer
+bool ld2410CaptureActive();
+const Ld2410CaptureStats &getLd2410CaptureStats();
+const char *getLd2410CaptureSinkName(Ld2410CaptureSink sink);
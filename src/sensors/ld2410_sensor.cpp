@@ -1,43 +1,113 @@
+#include "config.h"
+#if USE_LD2410
 #include <SoftwareSerial.h>
 #include <MyLD2410.h>
-#include "config.h"
 #include "debug/debug_macros.h"
 #include "model/data_structs.h"
 #include "sensors/ld2410_sensor.h"
+#include "sensors/ld2410_capture.h"
+#include "sensors/sensor_manager.h"
+#include "debug/boot_timing.h"
+#include "globals.h"
 
 SoftwareSerial ld2410Serial(LD2410_RX_PIN, LD2410_TX_PIN);
+#if ENABLE_LD2410_CAPTURE
+// The driver reads through the tap so /api/ld2410/capture can record the UART
+static Ld2410Tap ld2410Tap(ld2410Serial);
+MyLD2410 radar(ld2410Tap);
+#else
 MyLD2410 radar(ld2410Serial);
+#endif
+static unsigned long ld2410ReadyAt = 0;
+static unsigned long ld2410LastFrame = 0;
+static bool ld2410Started = false;
 
 void setupLD2410()
 {
-    delay(2000);
+    // The radar boots slower than the ESP; start talking to it once it is up
+    // instead of blocking setup()
+    ld2410ReadyAt = millis() + LD2410_WARMUP_MS;
+    ld2410Started = false;
+    scheduleSensorWarmup(ld2410ReadyAt);
+    sensorData.radar_available = true;
+}
+
+static bool startLD2410()
+{
+    if ((long)(millis() - ld2410ReadyAt) < 0)
+    {
+        return false;
+    }
     ld2410Serial.begin(LD2410_BAUD_RATE_2);
     radar.begin();
-    sensorData.radar_available = true;
+    ld2410Started = true;
+    ld2410LastFrame = millis();
+    bootEvent("ld2410_ready");
+    return true;
 }
 
-void readLD2410()
+SensorPollResult readLD2410()
 {
+    if (!ld2410Started && !startLD2410())
+    {
+        return SENSOR_POLL_PENDING;
+    }
+
     if (radar.check() == MyLD2410::Response::DATA)
     {
         sensorData.radar_presence = radar.presenceDetected();
         sensorData.presence = sensorData.radar_presence;
         sensorData.radar_available = true;
+        sensorData.radar_error_count = 0;
+        ld2410LastFrame = millis();
         if (sensorData.radar_presence)
         {
-            SENSOR_DEBUG_PRINTLN("LD2410C: Presence detected!");
+            SENSOR_DEBUG_PRINTLN(LOG_LITERAL("LD2410C: Presence detected!"));
             ledBlink = true;
             ledBlinkStart = millis();
-            DEBUG_PRINTLN("Motion detected!");
+            DEBUG_PRINTLN(LOG_LITERAL("Motion detected!"));
         }
         else
         {
-            SENSOR_DEBUG_PRINTLN("LD2410C: No presence.");
+            SENSOR_DEBUG_PRINTLN(LOG_LITERAL("LD2410C: No presence."));
         }
+        return SENSOR_POLL_OK;
     }
-    else
+    // No report frame since the last poll, which can come between frames:
+    // keep the last state. A radar that has gone quiet for longer than it
+    // ever should has failed
+    if (millis() - ld2410LastFrame < LD2410_FRAME_TIMEOUT_MS)
     {
-        sensorData.radar_presence = false;
-        sensorData.radar_available = false;
+        return SENSOR_POLL_PENDING;
     }
-}
\ No newline at end of file
+    sensorData.radar_presence = false;
+    sensorData.radar_available = false;
+    sensorData.radar_error_count++;
+    return SENSOR_POLL_FAILED;
+}
+
+bool Ld2410Sensor::ready()
+{
+    return ld2410Started;
+}
+
+void Ld2410Sensor::reset()
+{
+    sensorData.radar_error_count = 0;
+    sensorData.radar_available = true;
+}
+
+void Ld2410Sensor::recover()
+{
+    // Reopen the UART once the radar has had its warm-up again
+    ld2410Serial.end();
+    setupLD2410();
+}
+
+void Ld2410Sensor::printReading()
+{
+    SENSOR_DEBUG_PRINTF("Radar Presence: %s\n", sensorData.radar_presence ? "YES" : "NO");
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("Motion Source: Radar (LD2410)"));
+}
+
+#endif
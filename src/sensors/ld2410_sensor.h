@@ -1,10 +1,36 @@
 #pragma once
+#include "config.h"
+#include "sensors/sensor.h"
+#if USE_LD2410
 #include <SoftwareSerial.h>
 #include <MyLD2410.h>
+#include "model/data_structs.h"
 extern SoftwareSerial ld2410Serial;
 extern MyLD2410 radar;
-extern bool ledBlink;
-extern long ledBlinkStart;
 
 void setupLD2410();
-void readLD2410();
\ No newline at end of file
+SensorPollResult readLD2410();
+
+struct Ld2410Sensor
+{
+    static constexpr SensorId id = SENSOR_LD2410;
+    static constexpr const char *name = "ld2410";
+    static constexpr const char *label = "LD2410 (Motion)";
+    static bool enabled() { return config.use_ld2410; }
+    static void begin() { setupLD2410(); }
+    static SensorPollResult poll() { return readLD2410(); }
+    static float value() { return sensorData.radar_presence ? 1 : 0; }
+    static bool ready();
+    static bool available() { return sensorData.radar_available; }
+    static int errorCount() { return sensorData.radar_error_count; } // Polls past the frame timeout
+    static void reset();
+    static void recover();
+    static void printReading();
+};
+#else
+struct Ld2410Sensor : AbsentSensor<SENSOR_LD2410>
+{
+    static constexpr const char *name = "ld2410";
+    static constexpr const char *label = "LD2410 (Motion)";
+};
+#endif
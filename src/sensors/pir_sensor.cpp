@@ -1,18 +1,16 @@
-#include <Arduino.h>
 #include "config.h"
+#if USE_PIR
+#include <Arduino.h>
 #include "model/data_structs.h"
 #include "sensors/pir_sensor.h"
 #include "debug/debug_macros.h"
+#include "power/power_manager.h"
+#include "globals.h"
 
 static bool lastMotion = false;
 
 unsigned long lastPirError = 0;
 
-extern bool pirTriggered;
-extern unsigned long lastPirTrigger;
-extern bool ledBlink;
-extern unsigned long ledBlinkStart;
-
 
 void setupPIR()
 {
@@ -29,6 +27,9 @@ void IRAM_ATTR handlePirInterrupt()
         return;
     }
 
+    // End any idle wait so the event is handled immediately
+    powerWake();
+
     if (!pirTriggered)
     {
         pirTriggered = true;
@@ -39,12 +40,12 @@ void IRAM_ATTR handlePirInterrupt()
         // Set LED blink flag (will be handled in main loop)
         ledBlink = true;
         ledBlinkStart = millis();
-        DEBUG_PRINTLN("Motion detected!");
+        // Logged from loop() when the LED blink ends; no logging in an ISR
     }
 }
 
 
-void readPIR()
+SensorPollResult readPIR()
 {
     int val = digitalRead(PIR_PIN);
     sensorData.motion = (val == HIGH);
@@ -55,7 +56,21 @@ void readPIR()
         lastMotion = sensorData.motion;
         sensorData.pir_error_count = 0;
     }
+    return SENSOR_POLL_OK;
+}
+
+void PirSensor::reset()
+{
+    sensorData.pir_error_count = 0;
+    sensorData.pir_available = true;
 }
+
+void PirSensor::printReading()
+{
+    SENSOR_DEBUG_PRINTF("Motion: %s\n", sensorData.motion ? "YES" : "NO");
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("Motion Source: PIR"));
+}
+
 void updatePirInterrupt()
 {
     static bool interruptAttached = false;
@@ -67,7 +82,7 @@ void updatePirInterrupt()
         {
             detachInterrupt(digitalPinToInterrupt(PIR_PIN));
             interruptAttached = false;
-            DEBUG_PRINTLN("PIR interrupt detached (sensorless mode)");
+            DEBUG_PRINTLN(LOG_LITERAL("PIR interrupt detached (sensorless mode)"));
         }
         return;
     }
@@ -77,13 +92,15 @@ void updatePirInterrupt()
     {
         attachInterrupt(digitalPinToInterrupt(PIR_PIN), handlePirInterrupt, RISING);
         interruptAttached = true;
-        DEBUG_PRINTLN("PIR interrupt attached");
+        DEBUG_PRINTLN(LOG_LITERAL("PIR interrupt attached"));
     }
     // Detach interrupt if PIR is not available and currently attached
     else if (!sensorData.pir_available && interruptAttached)
     {
         detachInterrupt(digitalPinToInterrupt(PIR_PIN));
         interruptAttached = false;
-        DEBUG_PRINTLN("PIR interrupt detached (sensor not available)");
+        DEBUG_PRINTLN(LOG_LITERAL("PIR interrupt detached (sensor not available)"));
     }
-}
\ No newline at end of file
+}
+
+#endif
@@ -1,6 +1,35 @@
 #pragma once
+#include "config.h"
+#include "sensors/sensor.h"
+#if USE_PIR
+#include <Arduino.h>
+#include "model/data_structs.h"
 
 void setupPIR();
-void readPIR();
+SensorPollResult readPIR();
 void IRAM_ATTR handlePirInterrupt();
-void updatePirInterrupt();
\ No newline at end of file
+void updatePirInterrupt();
+
+struct PirSensor
+{
+    static constexpr SensorId id = SENSOR_PIR;
+    static constexpr const char *name = "pir";
+    static constexpr const char *label = "PIR (Motion)";
+    static bool enabled() { return config.use_pir; }
+    static void begin() { setupPIR(); }
+    static SensorPollResult poll() { return readPIR(); }
+    static float value() { return sensorData.motion ? 1 : 0; }
+    static bool ready() { return true; }
+    static bool available() { return sensorData.pir_available; }
+    static int errorCount() { return sensorData.pir_error_count; }
+    static void reset();
+    static void recover() {} // A digital input has nothing to re-initialise
+    static void printReading();
+};
+#else
+struct PirSensor : AbsentSensor<SENSOR_PIR>
+{
+    static constexpr const char *name = "pir";
+    static constexpr const char *label = "PIR (Motion)";
+};
+#endif
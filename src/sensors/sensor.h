@@ -0,0 +1,71 @@
+#pragma once
+#include <Arduino.h>
+#include "model/data_structs.h"
+
+// The interface every sensor driver implements. Drivers are structs of static
+// functions listed in SensorRegistry (sensor_registry.h), which calls them
+// through templates: dispatch is resolved at compile time, with no vtables.
+//
+//   struct ExampleSensor
+//   {
+//       static constexpr SensorId id = SENSOR_EXAMPLE;
+//       static constexpr const char *name = "example";     // API key
+//       static constexpr const char *label = "Example";    // Log text
+//       static bool enabled();          // Configured in (config.use_*)
+//       static void begin();
+//       static SensorPollResult poll(); // Stores a reading in sensorData
+//       static float value();           // Last reading, for adaptive sampling
+//       static bool ready();            // Warm-up over
+//       static bool available();        // Not in its error state
+//       static int errorCount();        // Consecutive failed reads
+//       static void reset();            // Clear the error state and retry
+//       static void recover();          // Re-initialise after a failure (bus recovery, begin())
+//       static void printReading();
+//   };
+//
+// Adding a sensor: a SensorId (model/data_structs.h), the driver, a USE_*
+// flag and sampling defaults in config.h, and an entry in SensorList.
+
+enum SensorPollResult : uint8_t
+{
+    SENSOR_POLL_OK,      // New reading stored
+    SENSOR_POLL_PENDING, // Warming up, or no new data yet
+    SENSOR_POLL_FAILED
+};
+
+// Kept by the registry for every driver, whatever it does internally
+struct SensorMetrics
+{
+    uint32_t polls;
+    uint32_t readings; // SENSOR_POLL_OK
+    uint32_t failures; // SENSOR_POLL_FAILED
+    uint32_t last_reading_ms;
+    uint32_t max_poll_us;
+};
+
+struct SensorStatus
+{
+    const char *name;
+    bool enabled;
+    bool ready;
+    bool available;
+    int error_count;
+};
+
+// Stands in for a driver compiled out with USE_*=0. enabled() is constexpr, so
+// the registry's per-sensor branch folds away and no driver code is linked
+template <SensorId Id>
+struct AbsentSensor
+{
+    static constexpr SensorId id = Id;
+    static constexpr bool enabled() { return false; }
+    static void begin() {}
+    static SensorPollResult poll() { return SENSOR_POLL_PENDING; }
+    static float value() { return 0; }
+    static bool ready() { return false; }
+    static bool available() { return false; }
+    static int errorCount() { return 0; }
+    static void reset() {}
+    static void recover() {}
+    static void printReading() {}
+};
@@ -0,0 +1,128 @@
+#include <Arduino.h>
+#include "config.h"
+#include "sensors/sensor_health.h"
+#include "sensors/sensor_manager.h"
+#include "debug/debug_macros.h"
+
+static SensorHealthState healthState[SENSOR_COUNT];
+
+static const char *const healthNames[] = {"healthy", "degraded", "failed", "reinitialising"};
+
+static void scheduleRecovery(SensorHealthState &health, unsigned long now)
+{
+    health.state = SENSOR_FAILED;
+    health.retry_at = now + health.backoff_ms;
+}
+
+void recordSensorHealth(SensorId id, SensorPollResult result, unsigned long now)
+{
+    SensorHealthState &health = healthState[id];
+
+    if (result == SENSOR_POLL_OK)
+    {
+        if (health.state == SENSOR_REINITIALISING)
+        {
+            SENSOR_DEBUG_PRINTF("%s recovered after %lu ms\n", getSensorName(id), now - health.down_since);
+            health.down_total_ms += now - health.down_since;
+            health.recoveries++;
+            health.up_since = now;
+        }
+        health.state = SENSOR_HEALTHY;
+        health.failures_in_row = 0;
+        health.backoff_ms = 0;
+        return;
+    }
+    if (result != SENSOR_POLL_FAILED)
+    {
+        return;
+    }
+
+    if (health.failures_in_row < UINT8_MAX)
+    {
+        health.failures_in_row++;
+    }
+    switch (health.state)
+    {
+    case SENSOR_HEALTHY:
+    case SENSOR_DEGRADED:
+        health.state = SENSOR_DEGRADED;
+        if (health.failures_in_row >= SENSOR_ERROR_THRESHOLD)
+        {
+            health.up_total_ms += now - health.up_since;
+            health.down_since = now;
+            health.outages++;
+            health.backoff_ms = SENSOR_RECOVERY_BACKOFF_MS;
+            scheduleRecovery(health, now);
+            SENSOR_ERROR_PRINTF("%s failed, recovery in %lu ms\n", getSensorName(id), health.backoff_ms);
+        }
+        break;
+    case SENSOR_REINITIALISING:
+        // The re-initialised sensor still fails: wait twice as long
+        health.backoff_ms = min(health.backoff_ms * 2, (unsigned long)SENSOR_RECOVERY_BACKOFF_MAX_MS);
+        scheduleRecovery(health, now);
+        SENSOR_WARN_PRINTF("%s recovery failed, next in %lu ms\n", getSensorName(id), health.backoff_ms);
+        break;
+    case SENSOR_FAILED:
+        break;
+    }
+}
+
+bool sensorFailed(SensorId id)
+{
+    return healthState[id].state == SENSOR_FAILED;
+}
+
+bool sensorRecoveryDue(SensorId id, unsigned long now)
+{
+    return sensorFailed(id) && (long)(now - healthState[id].retry_at) >= 0;
+}
+
+unsigned long sensorRecoveryAt(SensorId id)
+{
+    return healthState[id].retry_at;
+}
+
+void sensorRecoveryStarted(SensorId id)
+{
+    SensorHealthState &health = healthState[id];
+    health.state = SENSOR_REINITIALISING;
+    health.recovery_attempts++;
+}
+
+void resetSensorHealth(SensorId id)
+{
+    SensorHealthState &health = healthState[id];
+    health.failures_in_row = 0;
+    if (health.state == SENSOR_FAILED || health.state == SENSOR_REINITIALISING)
+    {
+        // Still down until a good read; a failed one restarts the backoff
+        health.state = SENSOR_REINITIALISING;
+        health.backoff_ms = SENSOR_RECOVERY_BACKOFF_MS / 2;
+    }
+    else
+    {
+        health.state = SENSOR_HEALTHY;
+    }
+}
+
+const SensorHealthState &getSensorHealth(SensorId id)
+{
+    return healthState[id];
+}
+
+const char *getSensorHealthName(SensorHealth health)
+{
+    return healthNames[health];
+}
+
+uint32_t sensorMtbfMs(SensorId id)
+{
+    const SensorHealthState &health = healthState[id];
+    return health.outages == 0 ? 0 : health.up_total_ms / health.outages;
+}
+
+uint32_t sensorMttrMs(SensorId id)
+{
+    const SensorHealthState &health = healthState[id];
+    return health.recoveries == 0 ? 0 : health.down_total_ms / health.recoveries;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "model/data_structs.h"
+#include "sensors/sensor.h"
+
+// Per-sensor health, driven by poll results:
+//   HEALTHY -> DEGRADED       a failed read
+//   DEGRADED -> FAILED        SENSOR_ERROR_THRESHOLD failed reads in a row
+//   FAILED -> REINITIALISING  the backoff ran out and the driver's recover() ran
+//   REINITIALISING -> HEALTHY a good read; a failed one goes back to FAILED
+//                             with the backoff doubled
+// FAILED sensors are not polled, so a dead sensor does not cost read time.
+
+enum SensorHealth : uint8_t
+{
+    SENSOR_HEALTHY,
+    SENSOR_DEGRADED,
+    SENSOR_FAILED,
+    SENSOR_REINITIALISING
+};
+
+struct SensorHealthState
+{
+    SensorHealth state;
+    uint8_t failures_in_row;
+    unsigned long backoff_ms;    // Wait before the next recovery attempt
+    unsigned long retry_at;      // millis() of the next recovery attempt
+    unsigned long up_since;      // Start of the current up period
+    unsigned long down_since;    // Start of the current outage
+    uint32_t outages;            // Times the sensor went FAILED
+    uint32_t recoveries;         // Outages ended by a good read
+    uint32_t recovery_attempts;  // recover() calls
+    unsigned long up_total_ms;   // Completed up periods, for MTBF
+    unsigned long down_total_ms; // Completed outages, for MTTR
+};
+
+void recordSensorHealth(SensorId id, SensorPollResult result, unsigned long now);
+bool sensorFailed(SensorId id); // Not polled until recovery
+bool sensorRecoveryDue(SensorId id, unsigned long now);
+unsigned long sensorRecoveryAt(SensorId id);
+void sensorRecoveryStarted(SensorId id);
+void resetSensorHealth(SensorId id); // Manual reset: probe on the next poll
+const SensorHealthState &getSensorHealth(SensorId id);
+const char *getSensorHealthName(SensorHealth health);
+uint32_t sensorMtbfMs(SensorId id); // 0 until the first outage
+uint32_t sensorMttrMs(SensorId id); // 0 until the first recovery
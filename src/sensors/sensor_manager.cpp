@@ -1,106 +1,150 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "config.h"
-#include "sensors/sensors.h"
+#include "sensors/sensor_registry.h"
 #include "debug/debug_macros.h"
 #include "comm/wifi_manager.h"
 #include "sensors/sensor_manager.h"
 #include "model/data_structs.h"
-#include "debug/debug_macros.h"
 
-void setupAllSensors()
+// Earliest pending warm-up deadline, so loop() reads a sensor as soon as it is usable
+static unsigned long warmupDeadlines[4];
+static uint8_t warmupCount = 0;
+
+static SensorMetrics sensorMetrics[SENSOR_COUNT];
+
+void scheduleSensorWarmup(unsigned long readyAt)
 {
-    if (config.use_dht)
-    {
-        setupDHT();
-    }
-    if (config.use_tsl2561)
-    {
-        setupTSL2561();
-    }
-    if (config.use_pir)
-    {
-        setupPIR();
-    }
-    if (config.use_ld2410)
+    if (warmupCount < sizeof(warmupDeadlines) / sizeof(warmupDeadlines[0]))
     {
-        setupLD2410();
+        warmupDeadlines[warmupCount++] = readyAt;
     }
-    // Initial sensor read and availability check
-    SENSOR_DEBUG_PRINTLN("Performing initial sensor read...");
-    readAllSensors();
-    printSensorData();
-
-    ESP.wdtFeed();
 }
 
-void readAllSensors()
+bool sensorWarmupDue(unsigned long now)
 {
-    if (config.use_dht)
-    {
-        readDHT();
-    }
-    if (config.use_tsl2561)
+    for (uint8_t i = 0; i < warmupCount; i++)
     {
-        readTSL2561();
+        if ((long)(now - warmupDeadlines[i]) >= 0)
+        {
+            warmupDeadlines[i] = warmupDeadlines[--warmupCount];
+            return true;
+        }
     }
-    if (config.use_pir)
+    return false;
+}
+
+bool nextSensorWarmup(unsigned long &readyAt)
+{
+    if (warmupCount == 0)
     {
-        readPIR();
+        return false;
     }
-    if (config.use_ld2410)
+    readyAt = warmupDeadlines[0];
+    for (uint8_t i = 1; i < warmupCount; i++)
     {
-        readLD2410();
+        if ((long)(warmupDeadlines[i] - readyAt) < 0)
+        {
+            readyAt = warmupDeadlines[i];
+        }
     }
+    return true;
 }
-void printInitialSensorData()
+
+void recordSensorPoll(SensorId id, SensorPollResult result, uint32_t elapsedUs, float value)
 {
-    // Print initial sensor status
-    SENSOR_DEBUG_PRINTLN("=== Initial Sensor Status ===");
-    if (config.use_dht)
+    SensorMetrics &metrics = sensorMetrics[id];
+    metrics.polls++;
+    if (result == SENSOR_POLL_OK)
     {
-        SENSOR_DEBUG_PRINTF("DHT11 (Temp/Humidity): %s\n", sensorData.dht_available ? "Available" : "Not Available");
+        metrics.readings++;
+        metrics.last_reading_ms = millis();
     }
-    if (config.use_tsl2561)
+    else if (result == SENSOR_POLL_FAILED)
     {
-        SENSOR_DEBUG_PRINTF("TSL2561 (Light): %s (requires manual reset if connected)\n", sensorData.tsl_available ? "Available" : "Not Available");
+        metrics.failures++;
     }
-    if (config.use_ld2410)
+    if (elapsedUs > metrics.max_poll_us)
     {
-        SENSOR_DEBUG_PRINTF("LD2410 (Motion): %s (requires manual reset if connected)\n", sensorData.radar_available ? "Available" : "Not Available");
+        metrics.max_poll_us = elapsedUs;
     }
+    recordSensorSample(id, result, value, millis());
+    recordSensorHealth(id, result, millis());
+}
 
-    if (config.use_pir)
-    {
-        SENSOR_DEBUG_PRINTF("PIR (Motion): %s (requires manual reset if connected)\n", sensorData.pir_available ? "Available" : "Not Available");
-    }
+void setupAllSensors()
+{
+    SensorList::beginEnabled();
+    // Initial sensor read and availability check
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("Performing initial sensor read..."));
+    readAllSensors();
+    printSensorData();
+
+    ESP.wdtFeed();
+}
+
+void readAllSensors()
+{
+    SensorList::pollEnabled();
+}
 
-    SENSOR_DEBUG_PRINTLN("=============================");
+bool sensorsDue(unsigned long now)
+{
+    return SensorList::anyDue(now);
+}
+
+void readDueSensors(unsigned long now)
+{
+    SensorList::pollDue(now);
+}
+
+unsigned long nextSensorPollAt(unsigned long fallback)
+{
+    return SensorList::nextPollAt(fallback);
+}
+
+void printInitialSensorData()
+{
+    // Print initial sensor status
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("=== Initial Sensor Status ==="));
+    SensorList::printAvailability();
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("============================="));
 }
+
 void printSensorData()
 {
     SENSOR_DEBUG_PRINTF("=== Sensor Data === [%s] ===\n", deviceHostname.c_str());
-    if (config.use_dht)
-    {
-        SENSOR_DEBUG_PRINTF("Temperature: %.2f°C %s\n", sensorData.temperature, sensorData.dht_available ? "" : "(DHT11 not available)");
-        SENSOR_DEBUG_PRINTF("Humidity: %.2f%% %s\n", sensorData.humidity, sensorData.dht_available ? "" : "(DHT11 not available)");
-    }
-    if (config.use_tsl2561)
-    {
-        SENSOR_DEBUG_PRINTF("Luminescence: %.2f lux %s\n", sensorData.lux, sensorData.tsl_available ? "" : "(TSL2561 not available)");
-    }
-    if (config.use_ld2410)
-    {
-        SENSOR_DEBUG_PRINTF("Radar Presence: %s\n", sensorData.radar_presence ? "YES" : "NO");
-        SENSOR_DEBUG_PRINTLN("Motion Source: Radar (LD2410)");
-    }
+    SensorList::printReadings();
+    MEMORY_DEBUG_PRINTF("Free Heap: %d bytes\n", ESP.getFreeHeap());
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("=================="));
+}
 
-    if (config.use_pir)
-    {
-        SENSOR_DEBUG_PRINTF("Motion: %s\n", sensorData.motion ? "YES" : "NO");
-        SENSOR_DEBUG_PRINTLN("Motion Source: PIR");
-    }
+void resetSensor(SensorId id)
+{
+    SensorList::reset(id);
+}
 
-    MEMORY_DEBUG_PRINTF("Free Heap: %d bytes\n", ESP.getFreeHeap());
-    SENSOR_DEBUG_PRINTLN("==================");
+void resetAllSensors()
+{
+    SensorList::resetAll();
+}
+
+SensorStatus getSensorStatus(SensorId id)
+{
+    return SensorList::status(id);
+}
+
+const SensorMetrics &getSensorMetrics(SensorId id)
+{
+    return sensorMetrics[id];
+}
+
+const char *getSensorName(SensorId id)
+{
+    return SensorList::name(id);
+}
+
+int findSensor(const char *name)
+{
+    return SensorList::find(name);
 }
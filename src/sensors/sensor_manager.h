@@ -1,7 +1,22 @@
 #pragma once
 #include "config.h"
+#include "sensors/sensor.h"
 
 void setupAllSensors();
-void readAllSensors();
+void readAllSensors(); // Every enabled sensor, now
+bool sensorsDue(unsigned long now);
+void readDueSensors(unsigned long now); // Sensors whose sampling period has run out
+unsigned long nextSensorPollAt(unsigned long fallback);
 void printInitialSensorData();
 void printSensorData();
+void scheduleSensorWarmup(unsigned long readyAt);
+bool sensorWarmupDue(unsigned long now);
+bool nextSensorWarmup(unsigned long &readyAt);
+
+// Per-driver access for the API; drivers are listed in sensor_registry.h
+void resetSensor(SensorId id);
+void resetAllSensors();
+SensorStatus getSensorStatus(SensorId id);
+const SensorMetrics &getSensorMetrics(SensorId id);
+const char *getSensorName(SensorId id);
+int findSensor(const char *name); // SensorId, or -1
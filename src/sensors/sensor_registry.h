@@ -0,0 +1,189 @@
+#pragma once
+#include <Arduino.h>
+#include "sensors/sensor.h"
+#include "sensors/sensor_sampling.h"
+#include "sensors/sensor_health.h"
+#include "debug/debug_macros.h"
+#include "sensors/dht_sensor.h"
+#include "sensors/tsl2561_sensor.h"
+#include "sensors/pir_sensor.h"
+#include "sensors/ld2410_sensor.h"
+
+// Bookkeeping shared by every driver (sensor_manager.cpp)
+void recordSensorPoll(SensorId id, SensorPollResult result, uint32_t elapsedUs, float value);
+
+// Every operation is a fold over the driver list, so each driver call is a
+// direct (inlinable) call and the enabled check is the only branch per sensor
+template <typename... Drivers>
+class SensorRegistry
+{
+public:
+    static constexpr size_t count = sizeof...(Drivers);
+
+    static void beginEnabled()
+    {
+        (beginIfEnabled<Drivers>(), ...);
+    }
+
+    static void pollEnabled()
+    {
+        (pollIfEnabled<Drivers>(), ...);
+    }
+
+    // Only the drivers whose sampling period has run out (sensor_sampling.h),
+    // and the recovery of failed drivers whose backoff has (sensor_health.h)
+    static void pollDue(unsigned long now)
+    {
+        (pollIfDue<Drivers>(now), ...);
+    }
+
+    static bool anyDue(unsigned long now)
+    {
+        return ((Drivers::enabled() && isDue<Drivers>(now)) || ...);
+    }
+
+    // Earliest scheduled poll or recovery, or fallback if no driver is enabled
+    static unsigned long nextPollAt(unsigned long fallback)
+    {
+        unsigned long next = fallback;
+        ((Drivers::enabled() && (long)(dueAt<Drivers>() - next) < 0 ? (void)(next = dueAt<Drivers>()) : void()), ...);
+        return next;
+    }
+
+    static void printReadings()
+    {
+        (printIfEnabled<Drivers>(), ...);
+    }
+
+    static void printAvailability()
+    {
+        (printAvailabilityIfEnabled<Drivers>(), ...);
+    }
+
+    static void reset(SensorId id)
+    {
+        ((Drivers::id == id ? resetDriver<Drivers>() : void()), ...);
+    }
+
+    static void resetAll()
+    {
+        (resetDriver<Drivers>(), ...);
+    }
+
+    static SensorStatus status(SensorId id)
+    {
+        SensorStatus result = {};
+        ((Drivers::id == id ? (void)(result = statusOf<Drivers>()) : void()), ...);
+        return result;
+    }
+
+    static const char *name(SensorId id)
+    {
+        const char *result = "";
+        ((Drivers::id == id ? (void)(result = Drivers::name) : void()), ...);
+        return result;
+    }
+
+    // SensorId for a driver name, or -1
+    static int find(const char *name)
+    {
+        int result = -1;
+        ((strcmp(Drivers::name, name) == 0 ? (void)(result = Drivers::id) : void()), ...);
+        return result;
+    }
+
+private:
+    static_assert(((Drivers::id < SENSOR_COUNT) && ...), "driver id out of range");
+
+    template <typename Driver>
+    static void beginIfEnabled()
+    {
+        if (Driver::enabled())
+        {
+            Driver::begin();
+        }
+    }
+
+    // Failed drivers are left alone until their recovery is due
+    template <typename Driver>
+    static void pollIfEnabled()
+    {
+        if (Driver::enabled() && !sensorFailed(Driver::id))
+        {
+            pollDriver<Driver>();
+        }
+    }
+
+    template <typename Driver>
+    static void pollIfDue(unsigned long now)
+    {
+        if (!Driver::enabled())
+        {
+            return;
+        }
+        if (sensorRecoveryDue(Driver::id, now))
+        {
+            SENSOR_DEBUG_PRINTF("Re-initialising %s\n", Driver::label);
+            Driver::recover();
+            sensorRecoveryStarted(Driver::id); // The next poll decides
+        }
+        else if (!sensorFailed(Driver::id) && sensorPollDue(Driver::id, now))
+        {
+            pollDriver<Driver>();
+        }
+    }
+
+    template <typename Driver>
+    static bool isDue(unsigned long now)
+    {
+        return sensorFailed(Driver::id) ? sensorRecoveryDue(Driver::id, now) : sensorPollDue(Driver::id, now);
+    }
+
+    template <typename Driver>
+    static unsigned long dueAt()
+    {
+        return sensorFailed(Driver::id) ? sensorRecoveryAt(Driver::id) : sensorNextPollAt(Driver::id);
+    }
+
+    template <typename Driver>
+    static void resetDriver()
+    {
+        Driver::reset();
+        resetSensorHealth(Driver::id);
+    }
+
+    template <typename Driver>
+    static void pollDriver()
+    {
+        uint32_t start = micros();
+        SensorPollResult result = Driver::poll();
+        recordSensorPoll(Driver::id, result, micros() - start, Driver::value());
+    }
+
+    template <typename Driver>
+    static void printIfEnabled()
+    {
+        if (Driver::enabled())
+        {
+            Driver::printReading();
+        }
+    }
+
+    template <typename Driver>
+    static void printAvailabilityIfEnabled()
+    {
+        if (Driver::enabled())
+        {
+            SENSOR_DEBUG_PRINTF("%s: %s\n", Driver::label, Driver::available() ? "Available" : "Not Available");
+        }
+    }
+
+    template <typename Driver>
+    static SensorStatus statusOf()
+    {
+        return {Driver::name, Driver::enabled(), Driver::ready(), Driver::available(), Driver::errorCount()};
+    }
+};
+
+using SensorList = SensorRegistry<DhtSensor, Tsl2561Sensor, PirSensor, Ld2410Sensor>;
+static_assert(SensorList::count == SENSOR_COUNT, "every SensorId needs a driver in SensorList");
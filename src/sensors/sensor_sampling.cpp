@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <math.h>
+#include "config.h"
+#include "sensors/sensor_sampling.h"
+#include "model/data_structs.h"
+#include "debug/debug_macros.h"
+
+static SensorSampling samplingState[SENSOR_COUNT];
+
+// The API may change the range between polls
+static unsigned long currentPeriod(SensorId id)
+{
+    const SamplingConfig &sampling = config.sampling[id];
+    return constrain(samplingState[id].period_ms, sampling.min_ms, sampling.max_ms);
+}
+
+bool sensorPollDue(SensorId id, unsigned long now)
+{
+    const SensorSampling &state = samplingState[id];
+    return !state.polled || now - state.last_poll >= currentPeriod(id);
+}
+
+unsigned long sensorNextPollAt(SensorId id)
+{
+    const SensorSampling &state = samplingState[id];
+    return state.last_poll + currentPeriod(id);
+}
+
+void recordSensorSample(SensorId id, SensorPollResult result, float value, unsigned long now)
+{
+    SensorSampling &state = samplingState[id];
+    const SamplingConfig &sampling = config.sampling[id];
+
+    if (state.polled)
+    {
+        // Forced reads (readAllSensors) come early and do not count as lag
+        long lag = (long)(now - sensorNextPollAt(id));
+        if (lag > 0 && (unsigned long)lag > state.lag_max_ms)
+        {
+            state.lag_max_ms = lag;
+        }
+    }
+    else
+    {
+        state.window_start = now;
+    }
+    state.polled = true;
+    state.last_poll = now;
+
+    if (result == SENSOR_POLL_OK)
+    {
+        bool changing = !state.has_value || fabsf(value - state.last_value) >= sampling.change;
+        state.period_ms = changing ? sampling.min_ms : min(currentPeriod(id) * 2, (unsigned long)sampling.max_ms);
+        state.last_value = value;
+        state.has_value = true;
+    }
+    else if (result == SENSOR_POLL_PENDING)
+    {
+        state.period_ms = sampling.min_ms;
+    }
+
+    state.window_polls++;
+    unsigned long windowLength = now - state.window_start;
+    if (windowLength >= SAMPLE_RATE_WINDOW_MS)
+    {
+        state.achieved_hz = state.window_polls * 1000.0f / windowLength;
+        state.window_start = now;
+        state.window_polls = 0;
+    }
+}
+
+void resetSensorSampling()
+{
+    memset(samplingState, 0, sizeof(samplingState));
+}
+
+const SensorSampling &getSensorSampling(SensorId id)
+{
+    return samplingState[id];
+}
+
+void applyDefaultSampling()
+{
+    config.sampling[SENSOR_DHT] = {DHT_SAMPLE_MIN_MS, DHT_SAMPLE_MAX_MS, DHT_SAMPLE_CHANGE};
+    config.sampling[SENSOR_TSL2561] = {TSL2561_SAMPLE_MIN_MS, TSL2561_SAMPLE_MAX_MS, TSL2561_SAMPLE_CHANGE};
+    config.sampling[SENSOR_PIR] = {PIR_SAMPLE_MIN_MS, PIR_SAMPLE_MAX_MS, PIR_SAMPLE_CHANGE};
+    config.sampling[SENSOR_LD2410] = {LD2410_SAMPLE_MIN_MS, LD2410_SAMPLE_MAX_MS, LD2410_SAMPLE_CHANGE};
+}
+
+bool validateSampling()
+{
+    return validateSampling(config.sampling);
+}
+
+bool validateSampling(const SamplingConfig *sampling)
+{
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        const SamplingConfig &entry = sampling[i];
+        if (entry.min_ms < SAMPLE_MIN_PERIOD_MS || entry.max_ms > SAMPLE_MAX_PERIOD_MS ||
+            entry.min_ms > entry.max_ms || isnan(entry.change) || entry.change < 0)
+        {
+            SENSOR_DEBUG_PRINTF("Invalid sampling settings for sensor %d\n", i);
+            return false;
+        }
+    }
+    return true;
+}
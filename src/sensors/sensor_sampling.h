@@ -0,0 +1,31 @@
+#pragma once
+#include "model/data_structs.h"
+#include "sensors/sensor.h"
+
+// Per-sensor adaptive sampling. Each driver is polled on its own period from
+// config.sampling: min_ms while its value() is changing, doubling on each
+// stable reading up to max_ms. A warming-up or silent sensor (PENDING) is
+// retried at min_ms; a failed read keeps the current period.
+
+// Scheduler state and achieved-rate counters for one sensor
+struct SensorSampling
+{
+    unsigned long period_ms;    // Current period, between min_ms and max_ms
+    unsigned long last_poll;    // millis() of the last poll
+    unsigned long lag_max_ms;   // Latest a scheduled poll ran after it was due
+    float last_value;           // value() at the last good reading
+    bool has_value;
+    bool polled;                // False until the first poll
+    unsigned long window_start; // Start of the current achieved-rate window
+    uint16_t window_polls;
+    float achieved_hz;          // Polls per second over the last full window
+};
+
+bool sensorPollDue(SensorId id, unsigned long now);
+unsigned long sensorNextPollAt(SensorId id);
+void recordSensorSample(SensorId id, SensorPollResult result, float value, unsigned long now);
+void resetSensorSampling();
+const SensorSampling &getSensorSampling(SensorId id);
+void applyDefaultSampling();
+bool validateSampling();
+bool validateSampling(const SamplingConfig *sampling); // SENSOR_COUNT entries
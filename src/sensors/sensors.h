@@ -1,5 +0,0 @@
-#include "config.h"
-#include "sensors/dht_sensor.h"
-#include "sensors/tsl2561_sensor.h"
-#include "sensors/pir_sensor.h"
-#include "sensors/ld2410_sensor.h"
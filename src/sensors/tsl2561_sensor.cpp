@@ -1,12 +1,13 @@
+#include "config.h"
+#if USE_TSL2561
 #include <Wire.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_TSL2561_U.h>
-#include "config.h"
 #include "model/data_structs.h"
 #include "sensors/tsl2561_sensor.h"
 #include "debug/debug_macros.h"
+#include "globals.h"
 
-extern long currentTime;
 Adafruit_TSL2561_Unified tsl(TSL2561_ADDR_FLOAT, 12345);
 int tslErrorCount = 0;
 unsigned long lastTslError = 0;
@@ -17,10 +18,10 @@ void setupTSL2561()
     SENSOR_DEBUG_PRINTF("I2C initialized on SDA:%d, SCL:%d\n", SDA_PIN, SCL_PIN);
     ESP.wdtFeed();
     // Initialize TSL2561 light sensor
-    SENSOR_DEBUG_PRINTLN("Initializing TSL2561 light sensor...");
+    SENSOR_DEBUG_PRINTLN(LOG_LITERAL("Initializing TSL2561 light sensor..."));
     if (tsl.begin())
     {
-        SENSOR_DEBUG_PRINTLN("TSL2561 light sensor initialized");
+        SENSOR_DEBUG_PRINTLN(LOG_LITERAL("TSL2561 light sensor initialized"));
 
         // Configure TSL2561
         tsl.enableAutoRange(true);
@@ -40,17 +41,45 @@ void setupTSL2561()
     }
     else
     {
-        SENSOR_DEBUG_PRINTLN("TSL2561 light sensor not found! Check wiring.");
+        SENSOR_DEBUG_PRINTLN(LOG_LITERAL("TSL2561 light sensor not found! Check wiring."));
         sensorData.tsl_available = false; // Mark as unavailable
     }
 }
 
-void readTSL2561()
+// A slave reset mid-transfer can hold SDA low forever: clock it out of the
+// byte it is sending, then send a STOP
+static void recoverI2cBus()
 {
-    sensors_event_t event;
-    tsl.getEvent(&event);
+    // On boards where SCL doubles as the relay pin, clocking it would chatter
+    // the relay and whatever it switches
+    if (config.use_relay && SCL_PIN == RELAY_PIN)
+    {
+        SENSOR_WARN_PRINTF("I2C bus recovery skipped: SCL is the relay pin (GPIO%d)\n", SCL_PIN);
+        return;
+    }
+    pinMode(SDA_PIN, INPUT_PULLUP);
+    pinMode(SCL_PIN, OUTPUT_OPEN_DRAIN);
+    for (int i = 0; i < 9 && digitalRead(SDA_PIN) == LOW; i++)
+    {
+        digitalWrite(SCL_PIN, LOW);
+        delayMicroseconds(5);
+        digitalWrite(SCL_PIN, HIGH);
+        delayMicroseconds(5);
+    }
+    pinMode(SDA_PIN, OUTPUT_OPEN_DRAIN);
+    digitalWrite(SDA_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(SCL_PIN, HIGH);
+    delayMicroseconds(5);
+    digitalWrite(SDA_PIN, HIGH);
+}
 
-    if (event.light)
+SensorPollResult readTSL2561()
+{
+    // 0 lux is a dark room, not a failure. The driver returns false for a
+    // saturated reading, which is also what a dead bus gives: 0xFFFF counts
+    sensors_event_t event;
+    if (tsl.getEvent(&event))
     {
         sensorData.lux = event.light;
         sensorData.tsl_available = true; // Mark as available on successful read
@@ -61,10 +90,11 @@ void readTSL2561()
             tslErrorCount = 0;
             sensorData.tsl_error_count = 0; // Also update the struct
         }
+        return SENSOR_POLL_OK;
     }
     else
     {
-        SENSOR_DEBUG_PRINTLN("TSL2561 sensor read failed");
+        SENSOR_DEBUG_PRINTLN(LOG_LITERAL("TSL2561 sensor read failed"));
         tslErrorCount++;
         sensorData.tsl_error_count = tslErrorCount; // Update the struct
         lastTslError = currentTime;
@@ -75,5 +105,26 @@ void readTSL2561()
             sensorData.tsl_available = false; // Mark as unavailable
             sensorData.lux = 0.0;
         }
+        return SENSOR_POLL_FAILED;
     }
-}
\ No newline at end of file
+}
+
+void Tsl2561Sensor::reset()
+{
+    tslErrorCount = 0;
+    sensorData.tsl_error_count = 0;
+    sensorData.tsl_available = true;
+}
+
+void Tsl2561Sensor::recover()
+{
+    recoverI2cBus();
+    setupTSL2561(); // Wire.begin() takes the pins back
+}
+
+void Tsl2561Sensor::printReading()
+{
+    SENSOR_DEBUG_PRINTF("Luminescence: %.2f lux %s\n", sensorData.lux, sensorData.tsl_available ? "" : "(TSL2561 not available)");
+}
+
+#endif
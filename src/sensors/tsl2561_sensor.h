@@ -1,8 +1,36 @@
 #pragma once
+#include "config.h"
+#include "sensors/sensor.h"
+#if USE_TSL2561
 #include <Adafruit_Sensor.h>
 #include <Adafruit_TSL2561_U.h>
+#include "model/data_structs.h"
 extern int tslErrorCount;
 extern unsigned long lastTslError;
 extern Adafruit_TSL2561_Unified tsl;
 void setupTSL2561();
-void readTSL2561();
\ No newline at end of file
+SensorPollResult readTSL2561();
+
+struct Tsl2561Sensor
+{
+    static constexpr SensorId id = SENSOR_TSL2561;
+    static constexpr const char *name = "tsl2561";
+    static constexpr const char *label = "TSL2561 (Light)";
+    static bool enabled() { return config.use_tsl2561; }
+    static void begin() { setupTSL2561(); }
+    static SensorPollResult poll() { return readTSL2561(); }
+    static float value() { return sensorData.lux; }
+    static bool ready() { return true; }
+    static bool available() { return sensorData.tsl_available; }
+    static int errorCount() { return tslErrorCount; }
+    static void reset();
+    static void recover();
+    static void printReading();
+};
+#else
+struct Tsl2561Sensor : AbsentSensor<SENSOR_TSL2561>
+{
+    static constexpr const char *name = "tsl2561";
+    static constexpr const char *label = "TSL2561 (Light)";
+};
+#endif
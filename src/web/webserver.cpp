@@ -5,6 +5,12 @@
 #include <EEPROM.h>
 #include <WiFiManager.h>
 #include <PubSubClient.h>
+
+extern "C"
+{
+#include "user_interface.h"
+}
+
 #include "config.h"
 #include "comm/wifi_manager.h"
 #include "web/webserver.h"
@@ -12,22 +18,48 @@
 #include "model/data_structs.h"
 #include "debug/debug_macros.h"
 #include "sensors/sensor_manager.h"
+#include "sensors/sensor_sampling.h"
+#include "sensors/sensor_health.h"
 #include "model/config_manager.h"
+#include "model/config_store.h"
 #include "actuators/relay.h"
 #include "comm/ota.h"
+#include "comm/publish_filter.h"
+#include "comm/mqtt_qos.h"
+#include "comm/mqtt_router.h"
+#include "comm/command_parser.h"
+#include "comm/payloads.h"
+#include "debug/boot_timing.h"
+#include "power/deep_sleep.h"
+#include "power/power_manager.h"
+#include "debug/profiler.h"
+#include "debug/heap_monitor.h"
+#include "debug/log_ring.h"
+#include "debug/crash_diag.h"
+#include "sensors/ld2410_capture.h"
 
 
 ESP8266WebServer server;
 
 void setupWebServer()
 {
-    WEB_DEBUG_PRINTLN("Setting up web server...");
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("Setting up web server..."));
     MEMORY_DEBUG_PRINTF("Free heap before web server setup: %d bytes\n", ESP.getFreeHeap());
 
+    // Keep the power manager out of light sleep while a client is active, and
+    // remember the request in case its handler never returns
+    server.addHook([](const String &, const String &url, WiFiClient *, ESP8266WebServer::ContentTypeFunction)
+                   {
+        powerNoteActivity();
+#if ENABLE_CRASH_DIAG
+        crashDiagUri(url.c_str());
+#endif
+        return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE; });
+
     // Check if LittleFS is available
     if (LittleFS.begin())
     {
-        WEB_DEBUG_PRINTLN("LittleFS available - setting up static file serving");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("LittleFS available - setting up static file serving"));
         // Serve static files from LittleFS, but don't override API endpoints
         server.serveStatic("/static", LittleFS, "/", "max-age=86400");
         server.onNotFound([]()
@@ -42,7 +74,7 @@ void setupWebServer()
     }
     else
     {
-        WEB_DEBUG_PRINTLN("LittleFS not available - setting up basic API endpoints only");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("LittleFS not available - setting up basic API endpoints only"));
     }
 
     // Set up a basic response for the root path (works with or without LittleFS)
@@ -59,9 +91,9 @@ void setupWebServer()
     // API endpoints
     server.on("/api/sensors", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("=== API /api/sensors requested ===");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("=== API /api/sensors requested ==="));
         MEMORY_DEBUG_PRINTF("Free heap before API call: %d bytes\n", ESP.getFreeHeap());
-        WEB_DEBUG_PRINTLN("Starting sensor data collection...");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Starting sensor data collection..."));
         
         // Add CORS headers
         server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -70,45 +102,11 @@ void setupWebServer()
         
         readAllSensors(); // Get fresh data
         
-        // Create a simpler JSON structure first
-        DynamicJsonDocument doc(512);
-        
-        // Basic sensor data
-        doc["temperature"] = sensorData.temperature;
-        doc["humidity"] = sensorData.humidity;
-        doc["motion"] = sensorData.presence;
-        doc["luminescence"] = sensorData.lux;
-        doc["timestamp"] = sensorData.timestamp;
-        doc["uptime"] = millis();
-        doc["wifi_rssi"] = WiFi.RSSI();
-        doc["free_heap"] = ESP.getFreeHeap();
-        doc["sensorless_mode"] = config.sensorless_mode;
-        doc["firmware_version"] = FIRMWARE_VERSION;
-        
-        String actualMotionSource = "none";
-        if (config.use_ld2410 && sensorData.radar_available) {
-            actualMotionSource = "radar";
-        }
-        else if (config.use_pir && sensorData.pir_available)
-        {
-            actualMotionSource = "pir";
-        }
-        doc["motion_source"] = actualMotionSource;
-        doc["motion"] = (actualMotionSource == "radar") ? sensorData.radar_presence : sensorData.presence;
-        
-        // Simple sensor status (avoid nested objects for now)
-        doc["dht11_available"] = sensorData.dht_available;
-        doc["dht11_errors"] = sensorData.dht_error_count;
-        doc["tsl2561_available"] = sensorData.tsl_available;
-        doc["tsl2561_errors"] = sensorData.tsl_error_count;
-        doc["pir_available"] = sensorData.pir_available;
-        doc["pir_errors"] = sensorData.pir_error_count;
-        doc["radar_presence"] = sensorData.radar_presence;
-        doc["relay_state"] = getRelayState();
-        doc["relay_pin"] = getRelayPin();
+        DynamicJsonDocument doc(JSON_CAPACITY_SENSORS);
+        buildSensorsPayload(doc);
 
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_SENSORS, doc, response);
         
         WEB_DEBUG_PRINTF("API response length: %d bytes\n", response.length());
         WEB_DEBUG_PRINTF("API response: %s\n", response.c_str());
@@ -119,6 +117,9 @@ void setupWebServer()
     server.on("/api/restart", HTTP_POST, []()
               {
         server.send(200, "text/plain", "Restarting...");
+#if ENABLE_CRASH_DIAG
+        crashDiagEvent(DIAG_EVENT_RESTART);
+#endif
         delay(1000);
         ESP.restart(); });
 
@@ -131,11 +132,8 @@ void setupWebServer()
     server.on("/api/factory-reset", HTTP_POST, []()
               {
         server.send(200, "text/plain", "Performing factory reset...");
-        // Clear EEPROM
-        for (int i = 0; i < 512; i++) {
-            EEPROM.write(i, 0);
-        }
-        EEPROM.commit();
+        // Clear stored configuration
+        configStoreErase();
         wifiManager.resetSettings();
         ESP.restart(); });
 
@@ -146,24 +144,12 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
-        DynamicJsonDocument doc(512);
-        doc["mqtt_broker"] = config.mqtt_broker;
-        doc["mqtt_port"] = config.mqtt_port;
-        doc["mqtt_username"] = config.mqtt_username;
-        doc["location"] = config.location;
-        doc["mqtt_enabled"] = config.mqtt_enabled;
-        doc["sensorless_mode"] = config.sensorless_mode;
+        DynamicJsonDocument doc(JSON_CAPACITY_CONFIG);
+        SleepRing ring;
+        buildConfigPayload(doc, readSleepRing(ring) ? &ring : nullptr);
 
-        
-        // Add sensor enable flags
-        doc["use_dht"] = config.use_dht;
-        doc["use_tsl2561"] = config.use_tsl2561;
-        doc["use_pir"] = config.use_pir;
-        doc["use_ld2410"] = config.use_ld2410;
-        doc["use_relay"] = config.use_relay;
-        
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_CONFIG, doc, response);
         
         server.send(200, "application/json", response); });
 
@@ -174,181 +160,44 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
+        // Parsed and validated by comm/command_parser, which host/Fuzz covers
         String body = server.arg("plain");
-        DynamicJsonDocument doc(512);
-        DeserializationError error = deserializeJson(doc, body);
-        
-        if (error) {
-            server.send(400, "application/json", "{\"error\": \"Invalid JSON\"}");
+        ConfigPatchStatus status = applyConfigPatch(body.c_str(), body.length(), config);
+        if (status != CONFIG_PATCH_APPLIED) {
+            char response[96];
+            snprintf(response, sizeof(response), "{\"error\": \"%s\"}", getConfigPatchError(status));
+            server.send(400, "application/json", response);
             return;
         }
+
+        saveConfig();
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_REPLY);
+        responseDoc["message"] = "Configuration updated successfully";
+        responseDoc["timestamp"] = millis();
         
-        bool configChanged = false;
-        
-        // Update MQTT settings
-        if (doc.containsKey("mqtt_broker")) {
-            strlcpy(config.mqtt_broker, doc["mqtt_broker"], sizeof(config.mqtt_broker));
-            configChanged = true;
-        }
-        if (doc.containsKey("mqtt_port")) {
-            config.mqtt_port = doc["mqtt_port"];
-            configChanged = true;
-        }
-        if (doc.containsKey("mqtt_username")) {
-            strlcpy(config.mqtt_username, doc["mqtt_username"], sizeof(config.mqtt_username));
-            configChanged = true;
-        }
-        if (doc.containsKey("mqtt_password")) {
-            strlcpy(config.mqtt_password, doc["mqtt_password"], sizeof(config.mqtt_password));
-            configChanged = true;
-        }
-        if (doc.containsKey("mqtt_enabled")) {
-            config.mqtt_enabled = doc["mqtt_enabled"];
-            configChanged = true;
-        }
-        
-        // Update device settings
-        if (doc.containsKey("location")) {
-            strlcpy(config.location, doc["location"], sizeof(config.location));
-            configChanged = true;
-        }
-        if (doc.containsKey("sensorless_mode")) {
-            config.sensorless_mode = doc["sensorless_mode"];
-            configChanged = true;
-        }
-        
-        // Handle sensor enable flags
-        if (doc.containsKey("use_dht")) {
-            config.use_dht = doc["use_dht"];
-            configChanged = true;
-        }
-        
-        if (doc.containsKey("use_tsl2561")) {
-            config.use_tsl2561 = doc["use_tsl2561"];
-            configChanged = true;
-        }
-        
-        if (doc.containsKey("use_pir")) {
-            config.use_pir = doc["use_pir"];
-            configChanged = true;
-        }
-        
-        if (doc.containsKey("use_ld2410")) {
-            config.use_ld2410 = doc["use_ld2410"];
-            configChanged = true;
-        }
-        
-        if (doc.containsKey("use_relay")) {
-            config.use_relay = doc["use_relay"];
-            configChanged = true;
-        }
-        
-        if (configChanged) {
-            saveConfig();
-            DynamicJsonDocument responseDoc(128);
-            responseDoc["message"] = "Configuration updated successfully";
-            responseDoc["timestamp"] = millis();
-            
-            String response;
-            serializeJson(responseDoc, response);
-            server.send(200, "application/json", response);
-        } else {
-            server.send(400, "application/json", "{\"error\": \"No valid configuration parameters provided\"}");
-        } });
+        String response;
+        serializeJson(responseDoc, response);
+        server.send(200, "application/json", response); });
 
     // Export full configuration including pin assignments
     server.on("/api/config/full", HTTP_GET, []()
               {
-        DynamicJsonDocument doc(2048);
-        
-        // Current configuration
-        doc["mqtt_broker"] = config.mqtt_broker;
-        doc["mqtt_port"] = config.mqtt_port;
-        doc["mqtt_username"] = config.mqtt_username;
-        doc["location"] = config.location;
-        doc["mqtt_enabled"] = config.mqtt_enabled;
-        doc["sensorless_mode"] = config.sensorless_mode;
-        
-        // Pin assignments
-        doc["pins"]["dht11"] = DHT_PIN;
-        doc["pins"]["pir"] = PIR_PIN;
-        doc["pins"]["led"] = LED_PIN;
-        doc["pins"]["sda"] = SDA_PIN;
-        doc["pins"]["scl"] = SCL_PIN;
-        
-        // System information
-        doc["system"]["device_hostname"] = deviceHostname; // Use MDNS.hostname() for the actual hostname
-        doc["system"]["wifi_ssid"] = WIFI_SSID;
-        doc["system"]["wifi_password"] = WIFI_PASSWORD;
-        doc["system"]["ap_ip"] = AP_IP;
-        
-        // Timing configuration
-        doc["timing"]["sensor_read_interval"] = SENSOR_READ_INTERVAL;
-        doc["timing"]["mqtt_publish_interval"] = MQTT_PUBLISH_INTERVAL;
-        doc["timing"]["pir_cooldown"] = PIR_COOLDOWN;
-        doc["timing"]["ota_check_interval"] = OTA_CHECK_INTERVAL;
-        
-        // MQTT topics
-        doc["mqtt_topics"]["temperature"] = MQTT_TOPIC_TEMPERATURE;
-        doc["mqtt_topics"]["humidity"] = MQTT_TOPIC_HUMIDITY;
-        doc["mqtt_topics"]["motion"] = MQTT_TOPIC_MOTION;
-        doc["mqtt_topics"]["luminescence"] = MQTT_TOPIC_LUMINESCENCE;
-        doc["mqtt_topics"]["status"] = MQTT_TOPIC_STATUS;
-        doc["mqtt_topics"]["all"] = MQTT_TOPIC_ALL;
-        
+        DynamicJsonDocument doc(JSON_CAPACITY_CONFIG_FULL);
+        buildConfigFullPayload(doc);
+
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_CONFIG_FULL, doc, response);
         
         server.send(200, "application/json", response); });
 
     // Export configuration to file
     server.on("/api/config/export", HTTP_GET, []()
               {
-        DynamicJsonDocument doc(2048);
-        
-        // Current configuration
-        doc["mqtt_broker"] = config.mqtt_broker;
-        doc["mqtt_port"] = config.mqtt_port;
-        doc["mqtt_username"] = config.mqtt_username;
-        doc["mqtt_password"] = config.mqtt_password;
-        doc["location"] = config.location;
-        doc["mqtt_enabled"] = config.mqtt_enabled;
-        doc["sensorless_mode"] = config.sensorless_mode;
-
-        
-        // Pin assignments
-        doc["pins"]["dht11"] = DHT_PIN;
-        doc["pins"]["pir"] = PIR_PIN;
-        doc["pins"]["led"] = LED_PIN;
-        doc["pins"]["sda"] = SDA_PIN;
-        doc["pins"]["scl"] = SCL_PIN;
-        
-        // System information
-        doc["system"]["device_hostname"] = deviceHostname; // Use MDNS.hostname() for the actual hostname
-        doc["system"]["wifi_ssid"] = WIFI_SSID;
-        doc["system"]["wifi_password"] = WIFI_PASSWORD;
-        doc["system"]["ap_ip"] = AP_IP;
-        
-        // Timing configuration
-        doc["timing"]["sensor_read_interval"] = SENSOR_READ_INTERVAL;
-        doc["timing"]["mqtt_publish_interval"] = MQTT_PUBLISH_INTERVAL;
-        doc["timing"]["pir_cooldown"] = PIR_COOLDOWN;
-        doc["timing"]["ota_check_interval"] = OTA_CHECK_INTERVAL;
-        
-        // MQTT topics
-        doc["mqtt_topics"]["temperature"] = MQTT_TOPIC_TEMPERATURE;
-        doc["mqtt_topics"]["humidity"] = MQTT_TOPIC_HUMIDITY;
-        doc["mqtt_topics"]["motion"] = MQTT_TOPIC_MOTION;
-        doc["mqtt_topics"]["luminescence"] = MQTT_TOPIC_LUMINESCENCE;
-        doc["mqtt_topics"]["status"] = MQTT_TOPIC_STATUS;
-        doc["mqtt_topics"]["all"] = MQTT_TOPIC_ALL;
-        
-        // Export timestamp
-        doc["export_timestamp"] = millis();
-        doc["export_uptime"] = millis();
-        
+        DynamicJsonDocument doc(JSON_CAPACITY_CONFIG_EXPORT);
+        buildConfigExportPayload(doc);
+
         String response;
-        serializeJsonPretty(doc, response);
+        serializePayload(PAYLOAD_CONFIG_EXPORT, doc, response, true);
         
         server.sendHeader("Content-Disposition", "attachment; filename=esp8266_config.json");
         server.send(200, "application/json", response); });
@@ -356,10 +205,10 @@ void setupWebServer()
     // Print full configuration to serial monitor
     server.on("/api/config/print", HTTP_POST, []()
               {
-        DEBUG_PRINTLN("Full configuration requested via API...");
+        DEBUG_PRINTLN(LOG_LITERAL("Full configuration requested via API..."));
         printFullConfig();
         
-        DynamicJsonDocument responseDoc(128);
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_REPLY);
         responseDoc["message"] = "Configuration printed to serial monitor";
         responseDoc["timestamp"] = millis();
         
@@ -370,15 +219,13 @@ void setupWebServer()
     server.on("/api/sensorless", HTTP_POST, []()
               {
         String body = server.arg("plain");
-        DynamicJsonDocument doc(256);
-        deserializeJson(doc, body);
-        
-        if (doc.containsKey("enabled"))
+        bool enabled;
+        if (parseEnabledFlag(body.c_str(), body.length(), enabled))
         {
-            config.sensorless_mode = doc["enabled"];
+            config.sensorless_mode = enabled;
             saveConfig();
             
-            DynamicJsonDocument responseDoc(128);
+            DynamicJsonDocument responseDoc(JSON_CAPACITY_REPLY);
             responseDoc["sensorless_mode"] = config.sensorless_mode;
             responseDoc["message"] = config.sensorless_mode ? "Sensorless mode enabled" : "Sensorless mode disabled";
             
@@ -388,47 +235,43 @@ void setupWebServer()
         }
         else
         {
-            server.send(400, "application/json", "{\"error\": \"Missing 'enabled' parameter\"}");
+            server.send(400, "application/json", "{\"error\": \"Missing or invalid 'enabled' parameter\"}");
         } });
 
     // Simple test endpoint
     server.on("/test", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("Test endpoint requested");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Test endpoint requested"));
         MEMORY_DEBUG_PRINTF("Free heap: %d bytes\n", ESP.getFreeHeap());
         server.send(200, "text/plain", "ESP8266 is working! Free heap: " + String(ESP.getFreeHeap()) + " bytes"); });
 
     // Very simple API test endpoint
     server.on("/api/test", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("API test endpoint requested");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("API test endpoint requested"));
         server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"API is working\"}"); });
 
     // Ultra simple test endpoint
     server.on("/simple", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("Simple endpoint requested");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Simple endpoint requested"));
         server.send(200, "text/plain", "Simple endpoint works!"); });
 
     // Health check endpoint
     server.on("/health", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("Health check requested");
-        DynamicJsonDocument doc(256);
-        doc["status"] = "ok";
-        doc["uptime"] = millis();
-        doc["free_heap"] = ESP.getFreeHeap();
-        doc["wifi_rssi"] = WiFi.RSSI();
-        doc["ip"] = WiFi.localIP().toString();
-        
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Health check requested"));
+        DynamicJsonDocument doc(JSON_CAPACITY_HEALTH);
+        buildHealthPayload(doc);
+
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_HEALTH, doc, response);
         server.send(200, "application/json", response); });
 
     // Debug endpoint for sensor data
     server.on("/debug/sensors", HTTP_GET, []()
               {
-        WEB_DEBUG_PRINTLN("Debug sensors endpoint requested");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Debug sensors endpoint requested"));
         
         // Add CORS headers
         server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -436,27 +279,11 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
         // Create a simple response first
-        DynamicJsonDocument doc(256);
-        doc["test"] = "sensor_data";
-        doc["free_heap"] = ESP.getFreeHeap();
-        doc["uptime"] = millis();
-        
-        // Add sensor data step by step
-        doc["temperature"] = sensorData.temperature;
-        doc["humidity"] = sensorData.humidity;
-        doc["motion"] = sensorData.presence;
-        doc["luminescence"] = sensorData.lux;
-        doc["timestamp"] = sensorData.timestamp;
-        doc["radar_presence"] = sensorData.radar_presence;
-        
-        // Add sensor status
-        doc["dht_available"] = sensorData.dht_available;
-        doc["tsl_available"] = sensorData.tsl_available;
-        doc["pir_available"] = sensorData.pir_available;
-        doc["radar_available"] = sensorData.radar_available;
-        
+        DynamicJsonDocument doc(JSON_CAPACITY_DEBUG_SENSORS);
+        buildDebugSensorsPayload(doc);
+
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_DEBUG_SENSORS, doc, response);
         
         WEB_DEBUG_PRINTF("Debug response length: %d bytes\n", response.length());
         WEB_DEBUG_PRINTF("Debug response: %s\n", response.c_str());
@@ -466,23 +293,15 @@ void setupWebServer()
     // Reset sensor status endpoint
     server.on("/api/sensors/reset", HTTP_POST, []()
               {
-        WEB_DEBUG_PRINTLN("Resetting sensor status...");
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Resetting sensor status..."));
         
-        // Reset all error counters
-        sensorData.dht_error_count = 0;
-        sensorData.tsl_error_count = 0;
-        sensorData.pir_error_count = 0;
-        
-        // Mark all sensors as available for retry
-        sensorData.dht_available = true;
-        sensorData.tsl_available = true;
-        sensorData.pir_available = true;
-        sensorData.radar_available = true;
+        // Clear every driver's error state and mark it available for retry
+        resetAllSensors();
         
         config.sensorless_mode = false;
         saveConfig();
         
-        DynamicJsonDocument responseDoc(256);
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_SENSORS_RESET);
         responseDoc["message"] = "Sensor status reset - all sensors marked as available";
         responseDoc["sensorless_mode"] = false;
         responseDoc["sensors"]["dht11"]["available"] = true;
@@ -499,13 +318,13 @@ void setupWebServer()
         server.send(200, "application/json", response); });
 
     // Individual sensor reset endpoints
+#if USE_DHT
     server.on("/api/sensors/dht11/reset", HTTP_POST, []()
               {
-        WEB_DEBUG_PRINTLN("Resetting DHT11 sensor status...");
-        sensorData.dht_error_count = 0;
-        sensorData.dht_available = true;
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Resetting DHT11 sensor status..."));
+        resetSensor(SENSOR_DHT);
         
-        DynamicJsonDocument responseDoc(128);
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_SENSORS_RESET);
         responseDoc["message"] = "DHT11 sensor reset";
         responseDoc["sensors"]["dht11"]["available"] = true;
         responseDoc["sensors"]["dht11"]["error_count"] = 0;
@@ -513,14 +332,15 @@ void setupWebServer()
         String response;
         serializeJson(responseDoc, response);
         server.send(200, "application/json", response); });
+#endif
 
+#if USE_TSL2561
     server.on("/api/sensors/tsl2561/reset", HTTP_POST, []()
               {
-        WEB_DEBUG_PRINTLN("Resetting TSL2561 sensor status...");
-        sensorData.tsl_error_count = 0;
-        sensorData.tsl_available = true;
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Resetting TSL2561 sensor status..."));
+        resetSensor(SENSOR_TSL2561);
         
-        DynamicJsonDocument responseDoc(128);
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_SENSORS_RESET);
         responseDoc["message"] = "TSL2561 sensor reset";
         responseDoc["sensors"]["tsl2561"]["available"] = true;
         responseDoc["sensors"]["tsl2561"]["error_count"] = 0;
@@ -528,14 +348,15 @@ void setupWebServer()
         String response;
         serializeJson(responseDoc, response);
         server.send(200, "application/json", response); });
+#endif
 
+#if USE_PIR
     server.on("/api/sensors/pir/reset", HTTP_POST, []()
               {
-        WEB_DEBUG_PRINTLN("Resetting PIR sensor status...");
-        sensorData.pir_error_count = 0;
-        sensorData.pir_available = true;
+        WEB_DEBUG_PRINTLN(LOG_LITERAL("Resetting PIR sensor status..."));
+        resetSensor(SENSOR_PIR);
         
-        DynamicJsonDocument responseDoc(128);
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_SENSORS_RESET);
         responseDoc["message"] = "PIR sensor reset";
         responseDoc["sensors"]["pir"]["available"] = true;
         responseDoc["sensors"]["pir"]["error_count"] = 0;
@@ -543,6 +364,19 @@ void setupWebServer()
         String response;
         serializeJson(responseDoc, response);
         server.send(200, "application/json", response); });
+#endif
+
+    // Per-driver state, poll counters, sampling rate and health from the sensor registry
+    server.on("/api/sensors/metrics", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_SENSOR_METRICS);
+        buildSensorMetricsPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_SENSOR_METRICS, doc, response);
+        server.send(200, "application/json", response); });
 
     // Handle CORS preflight requests
     server.on("/api/sensors", HTTP_OPTIONS, []()
@@ -556,27 +390,33 @@ void setupWebServer()
     server.on("/api/debug", HTTP_POST, []()
               {
         String body = server.arg("plain");
-        DynamicJsonDocument doc(256);
-        deserializeJson(doc, body);
-        
-        if (doc.containsKey("enabled"))
+        bool debugEnabled;
+        if (parseEnabledFlag(body.c_str(), body.length(), debugEnabled))
         {
-            bool debugEnabled = doc["enabled"];
-            // Note: This would require recompiling to take effect
-            // For now, just return the current status
-            
-            DynamicJsonDocument responseDoc(128);
+#if ENABLE_LOG_RING
+            // All categories to debug (or back to warnings) and Serial output on/off
+            for (uint8_t i = 0; i < LOG_CAT_COUNT; i++) {
+                logThresholds[i] = debugEnabled ? LOG_LEVEL_DEBUG : LOG_LEVEL_WARN;
+            }
+            logSerialEnabled = debugEnabled;
+#endif
+
+            DynamicJsonDocument responseDoc(JSON_CAPACITY_REPLY);
             responseDoc["debug_mode"] = debugEnabled;
+#if ENABLE_LOG_RING
+            responseDoc["message"] = debugEnabled ? "Debug logging enabled" : "Debug logging disabled";
+#else
             responseDoc["message"] = debugEnabled ? "Debug mode enabled (requires restart)" : "Debug mode disabled (requires restart)";
             responseDoc["note"] = "Debug mode changes require firmware recompilation";
-            
+#endif
+
             String response;
             serializeJson(responseDoc, response);
             server.send(200, "application/json", response);
         }
         else
         {
-            server.send(400, "application/json", "{\"error\": \"Missing 'enabled' parameter\"}");
+            server.send(400, "application/json", "{\"error\": \"Missing or invalid 'enabled' parameter\"}");
         } });
 
     // Sensor configuration endpoint for frontend
@@ -587,18 +427,258 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
-        DynamicJsonDocument doc(256);
-        doc["use_dht"] = config.use_dht;
-        doc["use_tsl2561"] = config.use_tsl2561;
-        doc["use_pir"] = config.use_pir;
-        doc["use_ld2410"] = config.use_ld2410;
-        doc["use_relay"] = config.use_relay;
-        
+        DynamicJsonDocument doc(JSON_CAPACITY_SENSOR_CONFIG);
+        buildSensorConfigPayload(doc);
+
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_SENSOR_CONFIG, doc, response);
         
         server.send(200, "application/json", response); });
 
+    // Boot phase timings
+    server.on("/api/boot", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_BOOT);
+        buildBootPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_BOOT, doc, response);
+        server.send(200, "application/json", response); });
+
+#if ENABLE_PROFILER
+    // loop() section timings
+    server.on("/api/perf", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_PERF);
+        buildPerfPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_PERF, doc, response);
+        server.send(200, "application/json", response); });
+
+    server.on("/api/perf/reset", HTTP_POST, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        perfReset();
+        server.send(200, "application/json", "{\"message\": \"Profiler reset\"}"); });
+#endif
+
+#if ENABLE_HEAP_MONITOR
+    // Heap history, low-water marks and (tracking builds) allocation sites
+    server.on("/api/heap", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_HEAP);
+        buildHeapPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_HEAP, doc, response);
+        server.send(200, "application/json", response); });
+
+    server.on("/api/heap/reset", HTTP_POST, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        heapMonitorReset();
+        server.send(200, "application/json", "{\"message\": \"Heap low-water marks reset\"}"); });
+#endif
+
+#if ENABLE_LOG_RING
+    // Log ring, formatted on request. ?since=<seq> returns newer entries only;
+    // ?raw=1 returns format addresses and raw arguments for examples/log_decoder.py
+    server.on("/api/logs", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        bool raw = server.arg("raw") == "1";
+        bool hasSince = server.hasArg("since");
+        uint16_t since = server.arg("since").toInt();
+
+        // Streamed entry by entry so the response never needs a large buffer
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/json", "");
+        const LogStats &stats = getLogStats();
+        char chunk[192];
+        snprintf(chunk, sizeof(chunk),
+                 "{\"captured\":%u,\"overwritten\":%u,\"filtered\":%u,\"truncated\":%u,\"serial\":%s,\"levels\":{",
+                 stats.captured, stats.overwritten, stats.filtered, stats.truncated, logSerialEnabled ? "true" : "false");
+        server.sendContent(chunk);
+        for (uint8_t i = 0; i < LOG_CAT_COUNT; i++) {
+            snprintf(chunk, sizeof(chunk), "%s\"%s\":\"%s\"", i ? "," : "",
+                     getLogCategoryName(i), getLogLevelName(logThresholds[i]));
+            server.sendContent(chunk);
+        }
+        server.sendContent("},\"entries\":[");
+
+        bool first = true;
+        for (uint16_t i = 0; i < logCount(); i++) {
+            const LogEntry &entry = logAt(i);
+            if (hasSince && (int16_t)(entry.seq - since) <= 0) {
+                continue;
+            }
+            StaticJsonDocument<JSON_CAPACITY_LOG_ENTRY> doc;
+            buildLogEntryPayload(doc, entry, raw);
+            String line;
+            if (!first) {
+                line = ",";
+            }
+            serializePayload(raw ? PAYLOAD_LOG_ENTRY_RAW : PAYLOAD_LOG_ENTRY, doc, line);
+            server.sendContent(line);
+            first = false;
+        }
+        server.sendContent("]}");
+        server.sendContent(""); });
+
+    // Runtime log selection, e.g. {"serial": true, "levels": {"sensor": "debug", "web": "off"}}
+    server.on("/api/logs", HTTP_POST, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        DynamicJsonDocument doc(JSON_CAPACITY_LOG_SETTINGS);
+        if (deserializeJson(doc, server.arg("plain"))) {
+            server.send(400, "application/json", "{\"error\": \"Invalid JSON\"}");
+            return;
+        }
+        if (doc.containsKey("levels")) {
+            // Validate everything before applying anything
+            uint8_t thresholds[LOG_CAT_COUNT];
+            memcpy(thresholds, logThresholds, sizeof(thresholds));
+            for (JsonPair entry : doc["levels"].as<JsonObject>()) {
+                int category = findLogCategory(entry.key().c_str());
+                int level = findLogLevel(entry.value() | "");
+                if (category < 0 || level < 0) {
+                    server.send(400, "application/json", "{\"error\": \"Unknown category or level\"}");
+                    return;
+                }
+                thresholds[category] = level;
+            }
+            memcpy(logThresholds, thresholds, sizeof(thresholds));
+        }
+        if (doc.containsKey("serial")) {
+            logSerialEnabled = doc["serial"];
+        }
+        server.send(200, "application/json", "{\"message\": \"Log settings updated\"}"); });
+#endif
+
+#if ENABLE_CRASH_DIAG
+    // What the previous run was doing when it reset, plus the RTC event ring
+    server.on("/api/diag", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_DIAG);
+        buildDiagPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_DIAG, doc, response);
+        server.send(200, "application/json", response); });
+#endif
+
+#if ENABLE_LD2410_CAPTURE
+    // Raw radar UART capture for host replay (host/LD2410Replay)
+    server.on("/api/ld2410/capture", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_LD2410_CAPTURE);
+        buildLd2410CapturePayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_LD2410_CAPTURE, doc, response);
+        server.send(200, "application/json", response); });
+
+    // {"action": "start"} records to LD2410_CAPTURE_FILE;
+    // {"action": "start", "host": "192.168.1.10", "port": 9000} streams to a
+    // TCP listener instead (e.g. nc -l 9000 > office.rec); {"action": "stop"}
+    server.on("/api/ld2410/capture", HTTP_POST, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        DynamicJsonDocument doc(JSON_CAPACITY_LD2410_CAPTURE_REQUEST);
+        if (deserializeJson(doc, server.arg("plain"))) {
+            server.send(400, "application/json", "{\"error\": \"Invalid JSON\"}");
+            return;
+        }
+        const char *action = doc["action"] | "";
+        if (strcmp(action, "stop") == 0) {
+            ld2410CaptureStop();
+            server.send(200, "application/json", "{\"message\": \"LD2410 capture stopped\"}");
+            return;
+        }
+        if (strcmp(action, "start") != 0) {
+            server.send(400, "application/json", "{\"error\": \"action must be start or stop\"}");
+            return;
+        }
+
+        bool started;
+        if (doc.containsKey("host")) {
+            uint16_t port = doc["port"] | 0;
+            if (port == 0) {
+                server.send(400, "application/json", "{\"error\": \"port is required with host\"}");
+                return;
+            }
+            started = ld2410CaptureStartTcp(doc["host"] | "", port);
+        } else {
+            started = ld2410CaptureStartFile();
+        }
+        if (!started) {
+            server.send(503, "application/json", "{\"error\": \"Capture sink unavailable\"}");
+            return;
+        }
+        server.send(200, "application/json", "{\"message\": \"LD2410 capture started\"}"); });
+
+    // The last file capture; stop it first for a complete recording
+    server.on("/api/ld2410/recording", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+        File file = LittleFS.open(LD2410_CAPTURE_FILE, "r");
+        if (!file) {
+            server.send(404, "application/json", "{\"error\": \"No recording\"}");
+            return;
+        }
+        server.sendHeader("Content-Disposition", "attachment; filename=\"ld2410.rec\"");
+        server.streamFile(file, "application/octet-stream");
+        file.close(); });
+#endif
+
+    // Idle scheduling and duty cycle
+    server.on("/api/power", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_POWER);
+        buildPowerPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_POWER, doc, response);
+        server.send(200, "application/json", response); });
+
+    // MQTT publish statistics
+    server.on("/api/mqtt", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_MQTT);
+        buildMqttPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_MQTT, doc, response);
+        server.send(200, "application/json", response); });
+
+    // Largest size and document usage of each budgeted payload since boot
+    server.on("/api/payloads", HTTP_GET, []()
+              {
+        server.sendHeader("Access-Control-Allow-Origin", "*");
+
+        DynamicJsonDocument doc(JSON_CAPACITY_PAYLOADS);
+        buildPayloadsPayload(doc);
+
+        String response;
+        serializePayload(PAYLOAD_PAYLOADS, doc, response);
+        server.send(200, "application/json", response); });
+
+#if USE_RELAY
     // Relay API endpoints
     server.on("/api/relay", HTTP_GET, []()
               {
@@ -607,12 +687,11 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
-        DynamicJsonDocument doc(128);
-        doc["state"] = getRelayState();
-        doc["pin"] = getRelayPin();
-        
+        DynamicJsonDocument doc(JSON_CAPACITY_RELAY);
+        buildRelayPayload(doc, nullptr);
+
         String response;
-        serializeJson(doc, response);
+        serializePayload(PAYLOAD_RELAY, doc, response);
         
         server.send(200, "application/json", response); });
 
@@ -624,29 +703,24 @@ void setupWebServer()
         server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
         
         String body = server.arg("plain");
-        DynamicJsonDocument doc(128);
-        deserializeJson(doc, body);
-        
-        bool newState = false;
-        
-        if (doc.containsKey("state")) {
-            newState = doc["state"];
-            setRelayState(newState);
-        } else {
-            // Toggle if no state specified
-            newState = !getRelayState();
-            setRelayState(newState);
+        RelayCommand command = parseRelayRequest(body.c_str(), body.length());
+        if (command == RELAY_COMMAND_INVALID) {
+            server.send(400, "application/json", "{\"error\": \"Invalid relay state\"}");
+            return;
         }
+
+        // Toggle if no state specified
+        bool newState = command == RELAY_COMMAND_TOGGLE ? !getRelayState() : command == RELAY_COMMAND_ON;
+        setRelayState(newState);
         
-        DynamicJsonDocument responseDoc(128);
-        responseDoc["state"] = newState;
-        responseDoc["pin"] = getRelayPin();
-        responseDoc["message"] = newState ? "Relay turned ON" : "Relay turned OFF";
-        
+        DynamicJsonDocument responseDoc(JSON_CAPACITY_RELAY);
+        buildRelayPayload(responseDoc, newState ? "Relay turned ON" : "Relay turned OFF");
+
         String response;
-        serializeJson(responseDoc, response);
+        serializePayload(PAYLOAD_RELAY, responseDoc, response);
         
         server.send(200, "application/json", response); });
+#endif
 
     // Register HTTP OTA endpoint (/update)
     setupOTA_HTTP(server);
@@ -682,18 +756,18 @@ void setupWebServer()
         } });
 
     server.begin();
-    WEB_DEBUG_PRINTLN("Web server started");
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("Web server started"));
     MEMORY_DEBUG_PRINTF("Free heap after web server setup: %d bytes\n", ESP.getFreeHeap());
 
     // Debug: List all registered endpoints
-    WEB_DEBUG_PRINTLN("Registered endpoints:");
-    WEB_DEBUG_PRINTLN("- GET /");
-    WEB_DEBUG_PRINTLN("- GET /api/sensors");
-    WEB_DEBUG_PRINTLN("- GET /api/config");
-    WEB_DEBUG_PRINTLN("- GET /health");
-    WEB_DEBUG_PRINTLN("- GET /test");
-    WEB_DEBUG_PRINTLN("- GET /simple");
-    WEB_DEBUG_PRINTLN("- POST /api/restart");
-    WEB_DEBUG_PRINTLN("- POST /api/wifi/reset");
-    WEB_DEBUG_PRINTLN("- POST /api/sensors/reset");
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("Registered endpoints:"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /api/sensors"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /api/config"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /health"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /test"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- GET /simple"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- POST /api/restart"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- POST /api/wifi/reset"));
+    WEB_DEBUG_PRINTLN(LOG_LITERAL("- POST /api/sensors/reset"));
 }
\ No newline at end of file
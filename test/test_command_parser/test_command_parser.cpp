@@ -0,0 +1,196 @@
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <EEPROM.h>
+#include <string.h>
+#include <unity.h>
+#include "config.h"
+#include "comm/command_parser.h"
+#include "model/config_manager.h"
+#include "model/data_structs.h"
+
+static ConfigData defaults;
+static ConfigData target;
+
+static ConfigPatchStatus patch(const char *json)
+{
+    return applyConfigPatch(json, strlen(json), target);
+}
+
+static RelayCommand relay(const char *message)
+{
+    return parseRelayCommand(message, strlen(message));
+}
+
+void setUp()
+{
+    target = defaults;
+}
+
+void tearDown()
+{
+}
+
+static void test_patch_strings_and_flags()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED,
+                      patch("{\"mqtt_broker\": \"10.1.2.3\", \"location\": \"attic\", \"mqtt_enabled\": 0, \"use_pir\": true}"));
+    TEST_ASSERT_EQUAL_STRING("10.1.2.3", target.mqtt_broker);
+    TEST_ASSERT_EQUAL_STRING("attic", target.location);
+    TEST_ASSERT_FALSE(target.mqtt_enabled);
+    TEST_ASSERT_EQUAL(USE_PIR != 0, target.use_pir);
+}
+
+static void test_patch_truncates_long_strings()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED,
+                      patch("{\"location\": \"0123456789012345678901234567890123456789\"}"));
+    TEST_ASSERT_EQUAL(sizeof(target.location) - 1, strlen(target.location));
+}
+
+static void test_patch_port_range()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED, patch("{\"mqtt_port\": 8883}"));
+    TEST_ASSERT_EQUAL(8883, target.mqtt_port);
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"mqtt_port\": 0}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"mqtt_port\": 65536}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"mqtt_port\": \"1883\"}"));
+}
+
+static void test_rejected_patch_changes_nothing()
+{
+    // The broker is valid, the flag is not: neither is applied
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"mqtt_broker\": \"10.9.9.9\", \"use_dht\": \"yes\"}"));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &target, sizeof(target));
+
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"mqtt_broker\": 5}"));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &target, sizeof(target));
+}
+
+static void test_patch_invalid_json_and_empty()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_JSON, patch("{\"location\": "));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_JSON, patch("[1, 2]"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_EMPTY, patch("{\"unknown\": 1}"));
+    TEST_ASSERT_EQUAL_STRING("Invalid JSON", getConfigPatchError(CONFIG_PATCH_INVALID_JSON));
+}
+
+static void test_patch_input_not_terminated()
+{
+    // Only 'length' bytes are parsed
+    const char json[] = "{\"location\": \"den\"}garbage";
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED, applyConfigPatch(json, strlen(json) - 7, target));
+    TEST_ASSERT_EQUAL_STRING("den", target.location);
+}
+
+static void test_patch_publish_thresholds()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED,
+                      patch("{\"publish\": {\"temperature\": {\"deadband\": 1.25, \"min_interval\": 500}, \"pressure\": {}}}"));
+    TEST_ASSERT_EQUAL_FLOAT(1.25f, target.publish[PUBLISH_TEMPERATURE].deadband);
+    TEST_ASSERT_EQUAL(500, target.publish[PUBLISH_TEMPERATURE].min_interval);
+    TEST_ASSERT_EQUAL(defaults.publish[PUBLISH_TEMPERATURE].max_interval, target.publish[PUBLISH_TEMPERATURE].max_interval);
+
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_PUBLISH, patch("{\"publish\": {\"humidity\": {\"deadband\": -1}}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"publish\": 3}"));
+}
+
+static void test_patch_sampling()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED, patch("{\"sampling\": {\"ld2410\": {\"min_ms\": 200, \"max_ms\": 2000}}}"));
+    TEST_ASSERT_EQUAL(200, target.sampling[SENSOR_LD2410].min_ms);
+    TEST_ASSERT_EQUAL(2000, target.sampling[SENSOR_LD2410].max_ms);
+
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_SAMPLING, patch("{\"sampling\": {\"pir\": {\"min_ms\": 10}}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_SAMPLING, patch("{\"sampling\": {\"pir\": {\"min_ms\": 900, \"max_ms\": 600}}}"));
+}
+
+static void test_patch_deep_sleep_bounds()
+{
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_APPLIED,
+                      patch("{\"deep_sleep\": {\"enabled\": true, \"interval_s\": 600, \"flush_every\": 4}}"));
+    TEST_ASSERT_TRUE(target.deep_sleep_enabled);
+    TEST_ASSERT_EQUAL(600, target.deep_sleep_interval_s);
+    TEST_ASSERT_EQUAL(4, target.deep_sleep_flush_every);
+
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_DEEP_SLEEP, patch("{\"deep_sleep\": {\"flush_every\": 0}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_DEEP_SLEEP, patch("{\"deep_sleep\": {\"flush_every\": 200}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_DEEP_SLEEP, patch("{\"deep_sleep\": {\"interval_s\": 0}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_DEEP_SLEEP, patch("{\"deep_sleep\": {\"interval_s\": 70000}}"));
+    TEST_ASSERT_EQUAL(CONFIG_PATCH_INVALID_VALUE, patch("{\"deep_sleep\": {\"enabled\": \"on\"}}"));
+    TEST_ASSERT_EQUAL(4, target.deep_sleep_flush_every);
+}
+
+static void test_enabled_flag()
+{
+    bool enabled = false;
+    TEST_ASSERT_TRUE(parseEnabledFlag("{\"enabled\": true}", 17, enabled));
+    TEST_ASSERT_TRUE(enabled);
+    TEST_ASSERT_TRUE(parseEnabledFlag("{\"enabled\": 0}", 14, enabled));
+    TEST_ASSERT_FALSE(enabled);
+    TEST_ASSERT_FALSE(parseEnabledFlag("{}", 2, enabled));
+    TEST_ASSERT_FALSE(parseEnabledFlag("{\"enabled\": \"x\"}", 16, enabled));
+    TEST_ASSERT_FALSE(parseEnabledFlag("not json", 8, enabled));
+}
+
+static void test_relay_words()
+{
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, relay("ON"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, relay("1"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, relay("true"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_OFF, relay("off"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_OFF, relay("0"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_OFF, relay("False"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_TOGGLE, relay("Toggle"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay("onn"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay(""));
+
+    // Matched on the given length, not up to a terminator
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, parseRelayCommand("onward", 2));
+}
+
+static void test_relay_json()
+{
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_TOGGLE, relay("{\"command\": \"toggle\"}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, relay("{\"command\": \"set\", \"state\": true}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_OFF, relay("{\"command\": \"set\", \"state\": 0}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay("{\"command\": \"set\"}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay("{\"command\": \"explode\", \"state\": true}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, relay("{\"state\": true}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay("{\"state\": \"on\"}"));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, relay("{}"));
+}
+
+static void test_relay_request()
+{
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_TOGGLE, parseRelayRequest("", 0));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_TOGGLE, parseRelayRequest("{}", 2));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_ON, parseRelayRequest("{\"state\": true}", 15));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_OFF, parseRelayRequest("{\"state\": 0}", 12));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, parseRelayRequest("{\"state\": []}", 13));
+    TEST_ASSERT_EQUAL(RELAY_COMMAND_INVALID, parseRelayRequest("{", 1));
+}
+
+int main()
+{
+    host::reset();
+    host::serialEcho(false);
+    EEPROM.begin(CONFIG_EEPROM_SIZE);
+    loadConfig();
+    defaults = config;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_patch_strings_and_flags);
+    RUN_TEST(test_patch_truncates_long_strings);
+    RUN_TEST(test_patch_port_range);
+    RUN_TEST(test_rejected_patch_changes_nothing);
+    RUN_TEST(test_patch_invalid_json_and_empty);
+    RUN_TEST(test_patch_input_not_terminated);
+    RUN_TEST(test_patch_publish_thresholds);
+    RUN_TEST(test_patch_sampling);
+    RUN_TEST(test_patch_deep_sleep_bounds);
+    RUN_TEST(test_enabled_flag);
+    RUN_TEST(test_relay_words);
+    RUN_TEST(test_relay_json);
+    RUN_TEST(test_relay_request);
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <EEPROM.h>
+#include <stddef.h>
+#include <unity.h>
+#include "config.h"
+#include "model/config_manager.h"
+#include "model/config_store.h"
+#include "model/data_structs.h"
+
+struct TestPayload
+{
+    uint32_t a;
+    char name[12];
+    uint16_t b;
+};
+
+static const TestPayload sample = {0x12345678, "kitchen", 42};
+
+// Config with every field at its default, from a load of an empty store
+static ConfigData defaults;
+
+// Headerless image as firmware before the config store left it
+static void writeLegacyImage(const void *data, size_t length, uint8_t fill)
+{
+    for (size_t i = 0; i < EEPROM.length(); i++)
+    {
+        EEPROM.write(i, i < length ? ((const uint8_t *)data)[i] : fill);
+    }
+    EEPROM.commit();
+}
+
+void setUp()
+{
+    host::reset();
+    host::serialEcho(false);
+    EEPROM.begin(CONFIG_EEPROM_SIZE);
+    configStoreErase();
+}
+
+void tearDown()
+{
+}
+
+static void test_crc32_check_value()
+{
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(0, (const uint8_t *)"123456789", 9));
+    // Incremental updates give the same result
+    uint32_t crc = crc32Update(0, (const uint8_t *)"1234", 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update(crc, (const uint8_t *)"56789", 5));
+}
+
+static void test_save_and_load()
+{
+    uint32_t sequence = getConfigStoreStats().sequence;
+    TEST_ASSERT_TRUE(configStoreSave(&sample, sizeof(sample), 7));
+    TEST_ASSERT_EQUAL(sequence + 1, getConfigStoreStats().sequence);
+
+    ConfigRecordHeader header;
+    EEPROM.get(0, header);
+    TEST_ASSERT_EQUAL_HEX32(CONFIG_STORE_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL(7, header.version);
+    TEST_ASSERT_EQUAL(sizeof(sample), header.length);
+    TEST_ASSERT_EQUAL(sequence + 1, header.sequence);
+
+    TestPayload loaded = {};
+    uint16_t version = 0;
+    uint16_t length = 0;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_OK, configStoreLoad(&loaded, sizeof(loaded), 0, version, length));
+    TEST_ASSERT_EQUAL(7, version);
+    TEST_ASSERT_EQUAL(sizeof(sample), length);
+    TEST_ASSERT_EQUAL_MEMORY(&sample, &loaded, sizeof(sample));
+}
+
+static void test_identical_save_skipped()
+{
+    TEST_ASSERT_TRUE(configStoreSave(&sample, sizeof(sample), 7));
+    uint32_t sequence = getConfigStoreStats().sequence;
+    unsigned long skipped = getConfigStoreStats().skipped;
+
+    TEST_ASSERT_TRUE(configStoreSave(&sample, sizeof(sample), 7));
+    TEST_ASSERT_EQUAL(sequence, getConfigStoreStats().sequence);
+    TEST_ASSERT_EQUAL(skipped + 1, getConfigStoreStats().skipped);
+
+    // A new layout version is a change even with the same bytes
+    TEST_ASSERT_TRUE(configStoreSave(&sample, sizeof(sample), 8));
+    TEST_ASSERT_EQUAL(sequence + 1, getConfigStoreStats().sequence);
+}
+
+static void test_corrupt_payload_rejected()
+{
+    configStoreSave(&sample, sizeof(sample), 7);
+    EEPROM.write(sizeof(ConfigRecordHeader) + offsetof(TestPayload, b), 0x00);
+    EEPROM.commit();
+
+    TestPayload loaded;
+    uint16_t version, length;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_CORRUPT, configStoreLoad(&loaded, sizeof(loaded), 0, version, length));
+}
+
+static void test_corrupt_header_rejected()
+{
+    // The CRC covers version, length and sequence as well as the payload
+    configStoreSave(&sample, sizeof(sample), 7);
+    ConfigRecordHeader header;
+    EEPROM.get(0, header);
+    header.version = 6;
+    EEPROM.put(0, header);
+    EEPROM.commit();
+
+    TestPayload loaded;
+    uint16_t version, length;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_CORRUPT, configStoreLoad(&loaded, sizeof(loaded), 0, version, length));
+}
+
+static void test_longer_record_loads_prefix()
+{
+    // A record from a build with a longer payload: keep what fits
+    configStoreSave(&sample, sizeof(sample), 9);
+    uint8_t prefix[offsetof(TestPayload, name)];
+    uint16_t version, length;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_OK, configStoreLoad(prefix, sizeof(prefix), 0, version, length));
+    TEST_ASSERT_EQUAL(sizeof(sample), length);
+    TEST_ASSERT_EQUAL_MEMORY(&sample, prefix, sizeof(prefix));
+}
+
+static void test_legacy_copies_prefix_only()
+{
+    const uint16_t legacyLength = offsetof(TestPayload, b);
+    writeLegacyImage(&sample, legacyLength, 0xAB);
+
+    TestPayload loaded = {0, "", 0xBEEF};
+    uint16_t version = 0;
+    uint16_t length = 0;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_LEGACY, configStoreLoad(&loaded, sizeof(loaded), legacyLength, version, length));
+    TEST_ASSERT_EQUAL(1, version);
+    TEST_ASSERT_EQUAL(legacyLength, length);
+    TEST_ASSERT_EQUAL_MEMORY(&sample, &loaded, legacyLength);
+    // Whatever followed the legacy record in EEPROM is not taken
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, loaded.b);
+}
+
+static void test_legacy_length_clamped_to_capacity()
+{
+    writeLegacyImage(&sample, sizeof(sample), 0xAB);
+    struct
+    {
+        uint8_t payload[4];
+        uint8_t guard[4];
+    } target;
+    memset(&target, 0x5A, sizeof(target));
+    uint16_t version, length;
+    configStoreLoad(target.payload, sizeof(target.payload), 200, version, length);
+    TEST_ASSERT_EQUAL_MEMORY(&sample, target.payload, sizeof(target.payload));
+    const uint8_t untouched[4] = {0x5A, 0x5A, 0x5A, 0x5A};
+    TEST_ASSERT_EQUAL_MEMORY(untouched, target.guard, sizeof(untouched));
+}
+
+// The headerless record of the baseline firmware: 140 bytes ending with the
+// sensor flags
+struct LegacyConfigData
+{
+    char mqtt_broker[32];
+    char mqtt_username[32];
+    char mqtt_password[32];
+    char location[32];
+    int mqtt_port;
+    bool mqtt_enabled;
+    bool sensorless_mode;
+    bool use_dht;
+    bool use_tsl2561;
+    bool use_pir;
+    bool use_ld2410;
+    bool use_relay;
+};
+
+static_assert(sizeof(LegacyConfigData) == 140, "baseline record size");
+static_assert(offsetof(ConfigData, use_relay) == offsetof(LegacyConfigData, use_relay), "baseline fields moved");
+
+static void test_load_config_migrates_legacy_record()
+{
+    LegacyConfigData legacy = {};
+    strcpy(legacy.mqtt_broker, "10.0.0.5");
+    strcpy(legacy.location, "garage");
+    legacy.mqtt_port = 1884;
+    legacy.mqtt_enabled = true;
+    legacy.use_dht = true;
+    // In-range bytes after the record, as a stale sector may hold: 0x3F3F3F3F
+    // reads as a 0.75 float and a plausible interval
+    writeLegacyImage(&legacy, sizeof(legacy), 0x3F);
+
+    loadConfig();
+    TEST_ASSERT_EQUAL_STRING("10.0.0.5", config.mqtt_broker);
+    TEST_ASSERT_EQUAL_STRING("garage", config.location);
+    TEST_ASSERT_EQUAL(1884, config.mqtt_port);
+
+    // Fields added after the baseline keep their defaults, not the fill
+    TEST_ASSERT_EQUAL_MEMORY(defaults.publish, config.publish, sizeof(config.publish));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults.wifi_cache, &config.wifi_cache, sizeof(config.wifi_cache));
+    TEST_ASSERT_EQUAL(defaults.deep_sleep_enabled, config.deep_sleep_enabled);
+    TEST_ASSERT_EQUAL(defaults.deep_sleep_flush_every, config.deep_sleep_flush_every);
+    TEST_ASSERT_EQUAL(defaults.deep_sleep_interval_s, config.deep_sleep_interval_s);
+    TEST_ASSERT_EQUAL_MEMORY(defaults.sampling, config.sampling, sizeof(config.sampling));
+
+    // Written back with a header in the current layout
+    ConfigData stored;
+    uint16_t version, length;
+    TEST_ASSERT_EQUAL(CONFIG_LOAD_OK, configStoreLoad(&stored, sizeof(stored), 0, version, length));
+    TEST_ASSERT_EQUAL(CONFIG_VERSION, version);
+    TEST_ASSERT_EQUAL(sizeof(ConfigData), length);
+}
+
+static void test_load_config_extends_older_version()
+{
+    // Version 4 ended before the sampling table
+    ConfigData older = defaults;
+    strcpy(older.mqtt_broker, "10.0.0.6");
+    memset(older.sampling, 0xAB, sizeof(older.sampling));
+    configStoreSave(&older, offsetof(ConfigData, sampling), 4);
+
+    loadConfig();
+    TEST_ASSERT_EQUAL_STRING("10.0.0.6", config.mqtt_broker);
+    TEST_ASSERT_EQUAL_MEMORY(defaults.sampling, config.sampling, sizeof(config.sampling));
+}
+
+static void test_load_config_replaces_invalid_groups()
+{
+    ConfigData stored = defaults;
+    strcpy(stored.mqtt_broker, "10.0.0.7");
+    stored.deep_sleep_flush_every = 0;
+    stored.sampling[SENSOR_DHT].min_ms = 0;
+    configStoreSave(&stored, sizeof(stored), CONFIG_VERSION);
+
+    loadConfig();
+    TEST_ASSERT_EQUAL_STRING("10.0.0.7", config.mqtt_broker);
+    TEST_ASSERT_EQUAL(defaults.deep_sleep_flush_every, config.deep_sleep_flush_every);
+    TEST_ASSERT_EQUAL_MEMORY(defaults.sampling, config.sampling, sizeof(config.sampling));
+}
+
+static void test_load_config_without_broker_uses_defaults()
+{
+    // Erased flash reads as a headerless record full of 0xFF
+    writeLegacyImage(nullptr, 0, 0xFF);
+    loadConfig();
+    TEST_ASSERT_EQUAL_STRING(defaults.mqtt_broker, config.mqtt_broker);
+    TEST_ASSERT_EQUAL(defaults.mqtt_port, config.mqtt_port);
+}
+
+int main()
+{
+    setUp();
+    loadConfig();
+    defaults = config;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_save_and_load);
+    RUN_TEST(test_identical_save_skipped);
+    RUN_TEST(test_corrupt_payload_rejected);
+    RUN_TEST(test_corrupt_header_rejected);
+    RUN_TEST(test_longer_record_loads_prefix);
+    RUN_TEST(test_legacy_copies_prefix_only);
+    RUN_TEST(test_legacy_length_clamped_to_capacity);
+    RUN_TEST(test_load_config_migrates_legacy_record);
+    RUN_TEST(test_load_config_extends_older_version);
+    RUN_TEST(test_load_config_replaces_invalid_groups);
+    RUN_TEST(test_load_config_without_broker_uses_defaults);
+    return UNITY_END();
+}
@@ -0,0 +1,292 @@
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <ESP8266WiFi.h>
+#include <unity.h>
+#include <vector>
+#include "config.h"
+#include "comm/mqtt.h"
+#include "comm/mqtt_qos.h"
+#include "model/config_manager.h"
+#include "model/data_structs.h"
+
+// Broker end of the connection: records what the firmware writes and accepts
+// every CONNECT. shortWrite makes the next write take only part of the buffer
+class BrokerConnection : public HostConnection
+{
+public:
+    std::vector<uint8_t> written;
+    std::vector<uint8_t> inbound;
+    bool open = true;
+    bool shortWrite = false;
+
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        if (shortWrite)
+        {
+            shortWrite = false;
+            return size / 2;
+        }
+        if (size > 0 && (buf[0] & 0xF0) == 0x10)
+        {
+            const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+            inbound.insert(inbound.end(), connack, connack + sizeof(connack));
+        }
+        written.insert(written.end(), buf, buf + size);
+        return size;
+    }
+    int available() override { return inbound.size(); }
+    int read(uint8_t *buf, size_t size) override
+    {
+        size_t n = min(size, inbound.size());
+        memcpy(buf, inbound.data(), n);
+        inbound.erase(inbound.begin(), inbound.begin() + n);
+        return n;
+    }
+    bool connected() override { return open; }
+    void close() override { open = false; }
+};
+
+class Broker : public HostNetwork
+{
+public:
+    BrokerConnection *connection = nullptr; // Owned by the WiFiClient
+
+    HostConnection *connect(const char *, uint16_t) override
+    {
+        connection = new BrokerConnection();
+        return connection;
+    }
+    bool resolve(const char *, uint32_t &) override { return false; }
+};
+
+static Broker broker;
+
+struct Packet
+{
+    uint8_t header;
+    std::vector<uint8_t> body;
+};
+
+// Splits what the firmware wrote into MQTT packets
+static std::vector<Packet> writtenPackets()
+{
+    std::vector<Packet> packets;
+    const std::vector<uint8_t> &data = broker.connection->written;
+    size_t i = 0;
+    while (i < data.size())
+    {
+        Packet packet;
+        packet.header = data[i++];
+        size_t remaining = 0;
+        int shift = 0;
+        uint8_t digit;
+        do
+        {
+            digit = data[i++];
+            remaining |= (size_t)(digit & 0x7F) << shift;
+            shift += 7;
+        } while (digit & 0x80);
+        packet.body.assign(data.begin() + i, data.begin() + i + remaining);
+        i += remaining;
+        packets.push_back(packet);
+    }
+    return packets;
+}
+
+static uint16_t publishPacketId(const Packet &packet)
+{
+    size_t topicLength = (packet.body[0] << 8) | packet.body[1];
+    return (packet.body[2 + topicLength] << 8) | packet.body[3 + topicLength];
+}
+
+static void injectPuback(uint16_t packetId)
+{
+    const uint8_t puback[] = {0x40, 0x02, (uint8_t)(packetId >> 8), (uint8_t)(packetId & 0xFF)};
+    broker.connection->inbound.insert(broker.connection->inbound.end(), puback, puback + sizeof(puback));
+}
+
+void setUp()
+{
+    broker.connection->written.clear();
+}
+
+// Acknowledge whatever a test left in flight, so every test starts with an
+// empty window
+void tearDown()
+{
+    for (const Packet &packet : writtenPackets())
+    {
+        if ((packet.header & 0xF6) == 0x32)
+        {
+            mqttHandlePuback(publishPacketId(packet));
+        }
+    }
+}
+
+static void test_packet_size()
+{
+    // Header byte, one length byte, topic length, topic, packet ID, payload
+    TEST_ASSERT_EQUAL(1 + 1 + 2 + 4 + 2 + 10, mqttQos1PacketSize(4, 10));
+    // The remaining length takes a second byte from 128
+    TEST_ASSERT_EQUAL(1 + 1 + 127, mqttQos1PacketSize(1, 122));
+    TEST_ASSERT_EQUAL(1 + 2 + 128, mqttQos1PacketSize(1, 123));
+}
+
+static void test_publish_encoding()
+{
+    TEST_ASSERT_TRUE(mqttPublishQos1("a/b", "hi", false));
+    std::vector<Packet> packets = writtenPackets();
+    TEST_ASSERT_EQUAL(1, packets.size());
+    TEST_ASSERT_EQUAL_HEX8(0x32, packets[0].header);
+
+    const uint8_t expected[] = {0x00, 0x03, 'a', '/', 'b'};
+    TEST_ASSERT_EQUAL(sizeof(expected) + 2 + 2, packets[0].body.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, packets[0].body.data(), sizeof(expected));
+    TEST_ASSERT_NOT_EQUAL(0, publishPacketId(packets[0]));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY("hi", packets[0].body.data() + 7, 2);
+    TEST_ASSERT_EQUAL(1, mqttInflightCount());
+}
+
+static void test_publish_retained_flag()
+{
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "1", true));
+    TEST_ASSERT_EQUAL_HEX8(0x33, broker.connection->written[0]);
+}
+
+static void test_long_remaining_length()
+{
+    char payload[201];
+    memset(payload, 'x', 200);
+    payload[200] = '\0';
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", payload, false));
+
+    // 2 + 1 + 2 + 200 = 205 = 0x4D | 0x80, then 1
+    const std::vector<uint8_t> &written = broker.connection->written;
+    TEST_ASSERT_EQUAL_HEX8(0xCD, written[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, written[2]);
+    TEST_ASSERT_EQUAL(mqttQos1PacketSize(1, 200), written.size());
+}
+
+static void test_packet_ids_distinct()
+{
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "1", false));
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "2", false));
+    std::vector<Packet> packets = writtenPackets();
+    TEST_ASSERT_EQUAL(2, packets.size());
+    TEST_ASSERT_NOT_EQUAL(publishPacketId(packets[0]), publishPacketId(packets[1]));
+}
+
+static void test_full_window_defers()
+{
+    for (int i = 0; i < MQTT_QOS1_WINDOW; i++)
+    {
+        TEST_ASSERT_TRUE(mqttPublishQos1("t", "x", false));
+    }
+    TEST_ASSERT_EQUAL(MQTT_QOS1_WINDOW, mqttInflightCount());
+
+    unsigned long deferred = getMqttQosStats().deferred;
+    size_t written = broker.connection->written.size();
+    TEST_ASSERT_FALSE(mqttPublishQos1("t", "late", false));
+    TEST_ASSERT_EQUAL(deferred + 1, getMqttQosStats().deferred);
+    TEST_ASSERT_EQUAL(written, broker.connection->written.size());
+
+    // One acknowledgement frees a slot for the deferred publish
+    mqttHandlePuback(publishPacketId(writtenPackets()[0]));
+    TEST_ASSERT_EQUAL(MQTT_QOS1_WINDOW - 1, mqttInflightCount());
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "late", false));
+}
+
+static void test_puback_from_transport()
+{
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "x", false));
+    unsigned long acked = getMqttQosStats().acked;
+
+    // The tap sees the PUBACK as PubSubClient reads past it
+    injectPuback(publishPacketId(writtenPackets()[0]));
+    mqttClient.loop();
+    TEST_ASSERT_EQUAL(acked + 1, getMqttQosStats().acked);
+    TEST_ASSERT_EQUAL(0, mqttInflightCount());
+}
+
+static void test_unknown_puback()
+{
+    unsigned long unknown = getMqttQosStats().unknown_acks;
+    mqttHandlePuback(0xFFFF);
+    TEST_ASSERT_EQUAL(unknown + 1, getMqttQosStats().unknown_acks);
+}
+
+static void test_retransmit_in_order_with_dup()
+{
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "1", false));
+    TEST_ASSERT_TRUE(mqttPublishQos1("t", "2", true));
+    std::vector<Packet> sent = writtenPackets();
+
+    broker.connection->written.clear();
+    mqttRetransmitInflight();
+    std::vector<Packet> resent = writtenPackets();
+    TEST_ASSERT_EQUAL(2, resent.size());
+    TEST_ASSERT_EQUAL_HEX8(0x3A, resent[0].header);
+    TEST_ASSERT_EQUAL_HEX8(0x3B, resent[1].header);
+    for (int i = 0; i < 2; i++)
+    {
+        TEST_ASSERT_EQUAL(publishPacketId(sent[i]), publishPacketId(resent[i]));
+        TEST_ASSERT_TRUE(sent[i].body == resent[i].body);
+    }
+    TEST_ASSERT_EQUAL(2, mqttInflightCount());
+}
+
+static void test_failed_write_frees_slot()
+{
+    unsigned long sent = getMqttQosStats().sent;
+    broker.connection->shortWrite = true;
+    TEST_ASSERT_FALSE(mqttPublishQos1("t", "lost", false));
+    TEST_ASSERT_EQUAL(0, mqttInflightCount());
+    TEST_ASSERT_EQUAL(sent, getMqttQosStats().sent);
+
+    // The caller's retry is the only copy: nothing is queued to resend
+    mqttRetransmitInflight();
+    TEST_ASSERT_EQUAL(0, broker.connection->written.size());
+}
+
+static void test_oversize_falls_back_to_qos0()
+{
+    static char payload[MQTT_QOS1_MAX_PACKET];
+    memset(payload, 'x', sizeof(payload) - 1);
+    payload[sizeof(payload) - 1] = '\0';
+
+    unsigned long fallback = getMqttQosStats().fallback_qos0;
+    mqttPublishQos1("t", payload, false);
+    TEST_ASSERT_EQUAL(fallback + 1, getMqttQosStats().fallback_qos0);
+    TEST_ASSERT_EQUAL(0, mqttInflightCount());
+}
+
+int main()
+{
+    host::reset();
+    host::serialEcho(false);
+    host::setNetwork(&broker);
+    WiFi.begin("test", "test");
+
+    loadConfig();
+    config.mqtt_enabled = true;
+    strcpy(config.mqtt_broker, "192.0.2.10");
+    setupMQTT();
+    if (!connectMQTT())
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_packet_size);
+    RUN_TEST(test_publish_encoding);
+    RUN_TEST(test_publish_retained_flag);
+    RUN_TEST(test_long_remaining_length);
+    RUN_TEST(test_packet_ids_distinct);
+    RUN_TEST(test_full_window_defers);
+    RUN_TEST(test_puback_from_transport);
+    RUN_TEST(test_unknown_puback);
+    RUN_TEST(test_retransmit_in_order_with_dup);
+    RUN_TEST(test_failed_write_frees_slot);
+    RUN_TEST(test_oversize_falls_back_to_qos0);
+    return UNITY_END();
+}
@@ -0,0 +1,71 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "comm/payloads.h"
+#include "payload_budget.h"
+
+// Every payload is measured once from the worst-case state set up by the
+// payload_budget program
+static PayloadMeasurement results[PAYLOAD_COUNT];
+static std::vector<PayloadBudget> budgets;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_documents_fit()
+{
+    bool ok = true;
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        ok &= checkPayloadLimits((PayloadId)i, results[i]);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(ok, "a payload overflowed its document or the MQTT packet");
+}
+
+static void test_every_payload_budgeted()
+{
+    TEST_ASSERT_FALSE_MESSAGE(budgets.empty(), "cannot read " PAYLOAD_BUDGET_FILE);
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        TEST_ASSERT_NOT_NULL_MESSAGE(findPayloadBudget(budgets, getPayloadName((PayloadId)i)),
+                                     getPayloadName((PayloadId)i));
+    }
+}
+
+static void test_within_budgets()
+{
+    bool ok = true;
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        const char *name = getPayloadName((PayloadId)i);
+        ok &= checkPayloadBudget((PayloadId)i, results[i], findPayloadBudget(budgets, name));
+    }
+    TEST_ASSERT_TRUE_MESSAGE(ok, "a payload is over its budget in " PAYLOAD_BUDGET_FILE);
+}
+
+static void test_requests_fit()
+{
+    TEST_ASSERT_TRUE_MESSAGE(checkRequestCapacities(), "a request body does not fit its document");
+}
+
+int main()
+{
+    setupWorstCase();
+    for (int i = 0; i < PAYLOAD_COUNT; i++)
+    {
+        results[i] = measurePayload((PayloadId)i);
+    }
+    budgets = loadPayloadBudgets(PAYLOAD_BUDGET_FILE);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_documents_fit);
+    RUN_TEST(test_every_payload_budgeted);
+    RUN_TEST(test_within_budgets);
+    RUN_TEST(test_requests_fit);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+#include <Arduino.h>
+#include <math.h>
+#include <unity.h>
+#include "config.h"
+#include "comm/publish_filter.h"
+#include "model/data_structs.h"
+
+// Filter state outlives resetPublishFilters(), so each test starts far from
+// the previous one's samples
+static unsigned long base = 0;
+
+// What the publish paths do: ask, and mark only what went out
+static bool publishIfDue(PublishMetric metric, float value, unsigned long now)
+{
+    if (!shouldPublish(metric, value, now))
+    {
+        return false;
+    }
+    markPublished(metric, value, now);
+    return true;
+}
+
+void setUp()
+{
+    base += 10000000;
+    applyDefaultPublishThresholds();
+    resetPublishFilters();
+}
+
+void tearDown()
+{
+}
+
+static void test_first_sample_publishes()
+{
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_TEMPERATURE, 21.0f, base));
+}
+
+static void test_deadband_against_last_published()
+{
+    publishIfDue(PUBLISH_TEMPERATURE, 20.0f, base);
+    unsigned long suppressed = getPublishFilterState(PUBLISH_TEMPERATURE).suppressed;
+
+    // A slow drift is published once it is a deadband away from the last
+    // published value, not from the previous sample
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_TEMPERATURE, 20.25f, base + 60000));
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_TEMPERATURE, 20.375f, base + 120000));
+    TEST_ASSERT_EQUAL(suppressed + 2, getPublishFilterState(PUBLISH_TEMPERATURE).suppressed);
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_TEMPERATURE, 20.5f, base + 180000));
+    TEST_ASSERT_EQUAL_FLOAT(20.5f, getPublishFilterState(PUBLISH_TEMPERATURE).last_value);
+}
+
+static void test_heartbeat_republishes()
+{
+    publishIfDue(PUBLISH_HUMIDITY, 50.0f, base);
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_HUMIDITY, 50.0f, base + PUBLISH_HEARTBEAT_INTERVAL - 1));
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_HUMIDITY, 50.0f, base + PUBLISH_HEARTBEAT_INTERVAL));
+}
+
+static void test_min_interval_holds_changes()
+{
+    config.publish[PUBLISH_LUMINESCENCE].min_interval = 1000;
+    publishIfDue(PUBLISH_LUMINESCENCE, 100.0f, base);
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_LUMINESCENCE, 500.0f, base + 999));
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_LUMINESCENCE, 500.0f, base + 1000));
+}
+
+static void test_rate_of_change_inside_deadband()
+{
+    config.publish[PUBLISH_TEMPERATURE].deadband = 10.0f;
+    config.publish[PUBLISH_TEMPERATURE].rate_threshold = 1.0f; // Per second
+    publishIfDue(PUBLISH_TEMPERATURE, 20.0f, base);
+
+    // 0.05 over 1 s is slow; 0.3 over the next 100 ms is 3 per second
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_TEMPERATURE, 20.05f, base + 1000));
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_TEMPERATURE, 20.35f, base + 1100));
+}
+
+static void test_events_gate_on_change()
+{
+    TEST_ASSERT_TRUE(shouldPublishEvent(PUBLISH_MOTION, false, base));
+    markPublished(PUBLISH_MOTION, 0, base);
+
+    TEST_ASSERT_FALSE(shouldPublishEvent(PUBLISH_MOTION, false, base + 1000));
+    TEST_ASSERT_TRUE(shouldPublishEvent(PUBLISH_MOTION, true, base + 1000));
+    TEST_ASSERT_TRUE(shouldPublishEvent(PUBLISH_MOTION, false, base + PUBLISH_HEARTBEAT_INTERVAL));
+}
+
+static void test_reset_forces_publish_and_keeps_counters()
+{
+    publishIfDue(PUBLISH_RELAY, 1.0f, base);
+    unsigned long published = getPublishFilterState(PUBLISH_RELAY).published;
+    TEST_ASSERT_FALSE(publishIfDue(PUBLISH_RELAY, 1.0f, base + 1000));
+
+    resetPublishFilters();
+    TEST_ASSERT_TRUE(publishIfDue(PUBLISH_RELAY, 1.0f, base + 2000));
+    TEST_ASSERT_EQUAL(published + 1, getPublishFilterState(PUBLISH_RELAY).published);
+}
+
+static void test_validate_thresholds()
+{
+    TEST_ASSERT_TRUE(validatePublishThresholds());
+
+    PublishThreshold thresholds[PUBLISH_METRIC_COUNT];
+    memcpy(thresholds, config.publish, sizeof(thresholds));
+    thresholds[PUBLISH_HUMIDITY].deadband = NAN;
+    TEST_ASSERT_FALSE(validatePublishThresholds(thresholds));
+
+    memcpy(thresholds, config.publish, sizeof(thresholds));
+    thresholds[PUBLISH_RADAR].rate_threshold = -1.0f;
+    TEST_ASSERT_FALSE(validatePublishThresholds(thresholds));
+
+    memcpy(thresholds, config.publish, sizeof(thresholds));
+    thresholds[PUBLISH_ALL].max_interval = 0;
+    TEST_ASSERT_FALSE(validatePublishThresholds(thresholds));
+
+    memcpy(thresholds, config.publish, sizeof(thresholds));
+    thresholds[PUBLISH_MOTION].min_interval = thresholds[PUBLISH_MOTION].max_interval + 1;
+    TEST_ASSERT_FALSE(validatePublishThresholds(thresholds));
+}
+
+static void test_metric_names()
+{
+    for (int i = 0; i < PUBLISH_METRIC_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL(i, findPublishMetric(getPublishMetricName((PublishMetric)i)));
+    }
+    TEST_ASSERT_EQUAL(-1, findPublishMetric("pressure"));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_publishes);
+    RUN_TEST(test_deadband_against_last_published);
+    RUN_TEST(test_heartbeat_republishes);
+    RUN_TEST(test_min_interval_holds_changes);
+    RUN_TEST(test_rate_of_change_inside_deadband);
+    RUN_TEST(test_events_gate_on_change);
+    RUN_TEST(test_reset_forces_publish_and_keeps_counters);
+    RUN_TEST(test_validate_thresholds);
+    RUN_TEST(test_metric_names);
+    return UNITY_END();
+}
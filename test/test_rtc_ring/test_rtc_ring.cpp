@@ -0,0 +1,245 @@
+#include <Arduino.h>
+#include <ArduinoHost.h>
+#include <unity.h>
+#include "config.h"
+#include "model/config_store.h"
+#include "power/deep_sleep.h"
+#include "power/rtc_ring.h"
+
+static SleepRing ring;
+
+static SleepSample sampleAt(uint32_t t)
+{
+    SleepSample sample = {t, (int16_t)(200 + t), (int16_t)(500 + t), t * 10};
+    return sample;
+}
+
+// What writeSleepRing() stores: CRC over everything after the crc field
+static void storeRing(SleepRing &stored)
+{
+    const uint8_t *start = (const uint8_t *)&stored + sizeof(stored.crc);
+    stored.crc = crc32Update(0, start, sizeof(stored) - sizeof(stored.crc));
+    ESP.rtcUserMemoryWrite(RTC_SLEEP_RING_BLOCK, (uint32_t *)&stored, sizeof(stored));
+}
+
+void setUp()
+{
+    host::reset();
+    host::serialEcho(false);
+    sleepRingReset(ring);
+}
+
+void tearDown()
+{
+}
+
+static void test_reset_state()
+{
+    TEST_ASSERT_EQUAL(0, ring.count);
+    TEST_ASSERT_EQUAL(0, ring.head);
+    TEST_ASSERT_EQUAL(0, ring.dropped);
+    TEST_ASSERT_EQUAL(1, ring.radio_wake);
+    TEST_ASSERT_FALSE(sleepRingFull(ring));
+}
+
+static void test_push_keeps_oldest_first()
+{
+    for (uint32_t t = 1; t <= 3; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    TEST_ASSERT_EQUAL(3, ring.count);
+    TEST_ASSERT_EQUAL(3, ring.samples);
+    for (uint16_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, sleepRingAt(ring, i).t_s);
+    }
+}
+
+static void test_consume_then_wrap()
+{
+    for (uint32_t t = 1; t <= RTC_SLEEP_RING_CAPACITY - 2; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    sleepRingConsume(ring, RTC_SLEEP_RING_CAPACITY - 4);
+    TEST_ASSERT_EQUAL(2, ring.count);
+
+    // The next pushes run past the end of data[] and land at the front
+    for (uint32_t t = RTC_SLEEP_RING_CAPACITY - 1; t <= RTC_SLEEP_RING_CAPACITY + 4; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    TEST_ASSERT_EQUAL(8, ring.count);
+    TEST_ASSERT_EQUAL(0, ring.dropped);
+    for (uint16_t i = 0; i < ring.count; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(RTC_SLEEP_RING_CAPACITY - 3 + i, sleepRingAt(ring, i).t_s);
+    }
+}
+
+static void test_consume_more_than_count()
+{
+    sleepRingPush(ring, sampleAt(1));
+    sleepRingPush(ring, sampleAt(2));
+    sleepRingConsume(ring, 5);
+    TEST_ASSERT_EQUAL(0, ring.count);
+    TEST_ASSERT_EQUAL(2, ring.head);
+
+    sleepRingPush(ring, sampleAt(3));
+    TEST_ASSERT_EQUAL_UINT32(3, sleepRingAt(ring, 0).t_s);
+}
+
+static void test_overflow_drops_oldest()
+{
+    for (uint32_t t = 1; t <= RTC_SLEEP_RING_CAPACITY + 3; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    TEST_ASSERT_TRUE(sleepRingFull(ring));
+    TEST_ASSERT_EQUAL(RTC_SLEEP_RING_CAPACITY, ring.count);
+    TEST_ASSERT_EQUAL(3, ring.dropped);
+    TEST_ASSERT_EQUAL(RTC_SLEEP_RING_CAPACITY + 3, ring.samples);
+    TEST_ASSERT_EQUAL_UINT32(4, sleepRingAt(ring, 0).t_s);
+    TEST_ASSERT_EQUAL_UINT32(RTC_SLEEP_RING_CAPACITY + 3, sleepRingAt(ring, RTC_SLEEP_RING_CAPACITY - 1).t_s);
+}
+
+static void test_flush_every_n_wakes()
+{
+    const uint8_t flushEvery = 4;
+    int flushes = 0;
+    for (uint32_t wake = 0; wake < 12; wake++)
+    {
+        ring.wake_count = wake;
+        if (sleepRingFlushDue(ring, flushEvery))
+        {
+            TEST_ASSERT_EQUAL(0, (wake + 1) % flushEvery);
+            flushes++;
+        }
+    }
+    TEST_ASSERT_EQUAL(3, flushes);
+
+    // Every wake flushes with flush_every 1
+    TEST_ASSERT_TRUE(sleepRingFlushDue(ring, 1));
+}
+
+static void test_flush_before_overflow()
+{
+    const uint8_t flushEvery = RTC_SLEEP_RING_CAPACITY;
+    for (uint32_t t = 1; t < RTC_SLEEP_RING_CAPACITY - 1; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    ring.wake_count = 0;
+    TEST_ASSERT_FALSE(sleepRingFlushDue(ring, flushEvery));
+
+    // One more sample and the wake after would overwrite an unflushed one
+    sleepRingPush(ring, sampleAt(RTC_SLEEP_RING_CAPACITY - 1));
+    TEST_ASSERT_TRUE(sleepRingFlushDue(ring, flushEvery));
+}
+
+static void test_failed_flush_backs_off()
+{
+    const uint8_t flushEvery = 2;
+    // A full ring would otherwise ask for the radio on every wake
+    for (uint32_t t = 1; t <= RTC_SLEEP_RING_CAPACITY; t++)
+    {
+        sleepRingPush(ring, sampleAt(t));
+    }
+    sleepRingFlushed(ring, false);
+    TEST_ASSERT_EQUAL(1, ring.flush_failures);
+
+    int radioWakes = 0;
+    for (uint32_t wake = 0; wake < 16; wake++)
+    {
+        ring.wake_count = wake;
+        radioWakes += sleepRingFlushDue(ring, flushEvery);
+    }
+    TEST_ASSERT_EQUAL(4, radioWakes); // Every 4th wake
+
+    // Capped at flushEvery << RTC_SLEEP_FLUSH_BACKOFF_MAX
+    for (int i = 0; i < 300; i++)
+    {
+        sleepRingFlushed(ring, false);
+    }
+    TEST_ASSERT_EQUAL(UINT8_MAX, ring.flush_failures);
+    const uint32_t period = (uint32_t)flushEvery << RTC_SLEEP_FLUSH_BACKOFF_MAX;
+    ring.wake_count = period - 1;
+    TEST_ASSERT_TRUE(sleepRingFlushDue(ring, flushEvery));
+    ring.wake_count = period;
+    TEST_ASSERT_FALSE(sleepRingFlushDue(ring, flushEvery));
+}
+
+static void test_clean_flush_ends_backoff()
+{
+    sleepRingFlushed(ring, false);
+    sleepRingFlushed(ring, false);
+    sleepRingFlushed(ring, true);
+    TEST_ASSERT_EQUAL(0, ring.flush_failures);
+    ring.wake_count = 1;
+    TEST_ASSERT_TRUE(sleepRingFlushDue(ring, 2));
+}
+
+static void test_read_accepts_stored_ring()
+{
+    sleepRingPush(ring, sampleAt(7));
+    ring.wake_count = 5;
+    storeRing(ring);
+
+    SleepRing loaded;
+    TEST_ASSERT_TRUE(readSleepRing(loaded));
+    TEST_ASSERT_EQUAL(1, loaded.count);
+    TEST_ASSERT_EQUAL(5, loaded.wake_count);
+    TEST_ASSERT_EQUAL_UINT32(7, sleepRingAt(loaded, 0).t_s);
+}
+
+static void test_read_rejects_bad_crc()
+{
+    sleepRingPush(ring, sampleAt(7));
+    storeRing(ring);
+
+    // Flip one bit of the stored sample behind the CRC's back
+    ring.data[0].lux_c10 ^= 1;
+    ESP.rtcUserMemoryWrite(RTC_SLEEP_RING_BLOCK, (uint32_t *)&ring, sizeof(ring));
+
+    SleepRing loaded;
+    TEST_ASSERT_FALSE(readSleepRing(loaded));
+}
+
+static void test_read_rejects_power_on_memory()
+{
+    SleepRing loaded;
+    TEST_ASSERT_FALSE(readSleepRing(loaded));
+}
+
+static void test_read_rejects_bad_indices()
+{
+    ring.count = RTC_SLEEP_RING_CAPACITY + 1;
+    storeRing(ring);
+    SleepRing loaded;
+    TEST_ASSERT_FALSE(readSleepRing(loaded));
+
+    sleepRingReset(ring);
+    ring.head = RTC_SLEEP_RING_CAPACITY;
+    storeRing(ring);
+    TEST_ASSERT_FALSE(readSleepRing(loaded));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_state);
+    RUN_TEST(test_push_keeps_oldest_first);
+    RUN_TEST(test_consume_then_wrap);
+    RUN_TEST(test_consume_more_than_count);
+    RUN_TEST(test_overflow_drops_oldest);
+    RUN_TEST(test_flush_every_n_wakes);
+    RUN_TEST(test_flush_before_overflow);
+    RUN_TEST(test_failed_flush_backs_off);
+    RUN_TEST(test_clean_flush_ends_backoff);
+    RUN_TEST(test_read_accepts_stored_ring);
+    RUN_TEST(test_read_rejects_bad_crc);
+    RUN_TEST(test_read_rejects_power_on_memory);
+    RUN_TEST(test_read_rejects_bad_indices);
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include <Arduino.h>
+#include <string.h>
+#include <unity.h>
+#include "config.h"
+#include "sensors/sensor_health.h"
+
+// Counters are kept for the device lifetime, so tests compare deltas and
+// start each sensor from HEALTHY
+void setUp()
+{
+    for (int i = 0; i < SENSOR_COUNT; i++)
+    {
+        if (getSensorHealth((SensorId)i).state != SENSOR_HEALTHY)
+        {
+            resetSensorHealth((SensorId)i);
+            recordSensorHealth((SensorId)i, SENSOR_POLL_OK, 0);
+        }
+    }
+}
+
+void tearDown()
+{
+}
+
+static void failSensor(SensorId id, unsigned long now)
+{
+    for (int i = 0; i < SENSOR_ERROR_THRESHOLD; i++)
+    {
+        recordSensorHealth(id, SENSOR_POLL_FAILED, now);
+    }
+}
+
+static void test_single_failure_degrades()
+{
+    recordSensorHealth(SENSOR_DHT, SENSOR_POLL_FAILED, 1000);
+    TEST_ASSERT_EQUAL(SENSOR_DEGRADED, getSensorHealth(SENSOR_DHT).state);
+    TEST_ASSERT_FALSE(sensorFailed(SENSOR_DHT));
+
+    recordSensorHealth(SENSOR_DHT, SENSOR_POLL_OK, 2000);
+    TEST_ASSERT_EQUAL(SENSOR_HEALTHY, getSensorHealth(SENSOR_DHT).state);
+    TEST_ASSERT_EQUAL(0, getSensorHealth(SENSOR_DHT).failures_in_row);
+}
+
+static void test_pending_is_not_a_failure()
+{
+    for (int i = 0; i < SENSOR_ERROR_THRESHOLD * 2; i++)
+    {
+        recordSensorHealth(SENSOR_DHT, SENSOR_POLL_PENDING, 1000);
+    }
+    TEST_ASSERT_EQUAL(SENSOR_HEALTHY, getSensorHealth(SENSOR_DHT).state);
+}
+
+static void test_threshold_fails_and_schedules_recovery()
+{
+    uint32_t outages = getSensorHealth(SENSOR_TSL2561).outages;
+    for (int i = 0; i < SENSOR_ERROR_THRESHOLD - 1; i++)
+    {
+        recordSensorHealth(SENSOR_TSL2561, SENSOR_POLL_FAILED, 5000);
+    }
+    TEST_ASSERT_EQUAL(SENSOR_DEGRADED, getSensorHealth(SENSOR_TSL2561).state);
+
+    recordSensorHealth(SENSOR_TSL2561, SENSOR_POLL_FAILED, 5000);
+    TEST_ASSERT_TRUE(sensorFailed(SENSOR_TSL2561));
+    TEST_ASSERT_EQUAL(outages + 1, getSensorHealth(SENSOR_TSL2561).outages);
+    TEST_ASSERT_EQUAL(5000 + SENSOR_RECOVERY_BACKOFF_MS, sensorRecoveryAt(SENSOR_TSL2561));
+    TEST_ASSERT_FALSE(sensorRecoveryDue(SENSOR_TSL2561, 5000 + SENSOR_RECOVERY_BACKOFF_MS - 1));
+    TEST_ASSERT_TRUE(sensorRecoveryDue(SENSOR_TSL2561, 5000 + SENSOR_RECOVERY_BACKOFF_MS));
+
+    // Further failures while FAILED change nothing
+    recordSensorHealth(SENSOR_TSL2561, SENSOR_POLL_FAILED, 6000);
+    TEST_ASSERT_EQUAL(5000 + SENSOR_RECOVERY_BACKOFF_MS, sensorRecoveryAt(SENSOR_TSL2561));
+}
+
+static void test_good_read_after_recovery()
+{
+    failSensor(SENSOR_PIR, 10000);
+    const SensorHealthState &health = getSensorHealth(SENSOR_PIR);
+    uint32_t attempts = health.recovery_attempts;
+    uint32_t recoveries = health.recoveries;
+
+    sensorRecoveryStarted(SENSOR_PIR);
+    TEST_ASSERT_EQUAL(SENSOR_REINITIALISING, health.state);
+    TEST_ASSERT_EQUAL(attempts + 1, health.recovery_attempts);
+    TEST_ASSERT_FALSE(sensorFailed(SENSOR_PIR));
+
+    recordSensorHealth(SENSOR_PIR, SENSOR_POLL_OK, 20000);
+    TEST_ASSERT_EQUAL(SENSOR_HEALTHY, health.state);
+    TEST_ASSERT_EQUAL(recoveries + 1, health.recoveries);
+    TEST_ASSERT_EQUAL(0, health.backoff_ms);
+}
+
+static void test_failed_recovery_doubles_backoff()
+{
+    failSensor(SENSOR_PIR, 0);
+    unsigned long backoff = SENSOR_RECOVERY_BACKOFF_MS;
+    unsigned long now = 0;
+    while (backoff < SENSOR_RECOVERY_BACKOFF_MAX_MS)
+    {
+        now = sensorRecoveryAt(SENSOR_PIR);
+        sensorRecoveryStarted(SENSOR_PIR);
+        recordSensorHealth(SENSOR_PIR, SENSOR_POLL_FAILED, now);
+        backoff = min(backoff * 2, (unsigned long)SENSOR_RECOVERY_BACKOFF_MAX_MS);
+        TEST_ASSERT_TRUE(sensorFailed(SENSOR_PIR));
+        TEST_ASSERT_EQUAL(backoff, getSensorHealth(SENSOR_PIR).backoff_ms);
+        TEST_ASSERT_EQUAL(now + backoff, sensorRecoveryAt(SENSOR_PIR));
+    }
+
+    // Capped
+    now = sensorRecoveryAt(SENSOR_PIR);
+    sensorRecoveryStarted(SENSOR_PIR);
+    recordSensorHealth(SENSOR_PIR, SENSOR_POLL_FAILED, now);
+    TEST_ASSERT_EQUAL(SENSOR_RECOVERY_BACKOFF_MAX_MS, getSensorHealth(SENSOR_PIR).backoff_ms);
+}
+
+static void test_manual_reset_probes_next_poll()
+{
+    failSensor(SENSOR_DHT, 0);
+    resetSensorHealth(SENSOR_DHT);
+    TEST_ASSERT_EQUAL(SENSOR_REINITIALISING, getSensorHealth(SENSOR_DHT).state);
+    TEST_ASSERT_FALSE(sensorFailed(SENSOR_DHT));
+
+    // A failed probe restarts the backoff from the beginning
+    recordSensorHealth(SENSOR_DHT, SENSOR_POLL_FAILED, 1000);
+    TEST_ASSERT_TRUE(sensorFailed(SENSOR_DHT));
+    TEST_ASSERT_EQUAL(SENSOR_RECOVERY_BACKOFF_MS, getSensorHealth(SENSOR_DHT).backoff_ms);
+}
+
+static void test_mtbf_and_mttr()
+{
+    // LD2410 is left alone by the other tests: up since 0, no outages yet
+    TEST_ASSERT_EQUAL(0, sensorMtbfMs(SENSOR_LD2410));
+    TEST_ASSERT_EQUAL(0, sensorMttrMs(SENSOR_LD2410));
+
+    failSensor(SENSOR_LD2410, 100000);
+    TEST_ASSERT_EQUAL(100000, sensorMtbfMs(SENSOR_LD2410));
+    TEST_ASSERT_EQUAL(0, sensorMttrMs(SENSOR_LD2410));
+
+    sensorRecoveryStarted(SENSOR_LD2410);
+    recordSensorHealth(SENSOR_LD2410, SENSOR_POLL_OK, 130000);
+    TEST_ASSERT_EQUAL(30000, sensorMttrMs(SENSOR_LD2410));
+
+    // Up 130 s -> 230 s, then down again
+    failSensor(SENSOR_LD2410, 230000);
+    TEST_ASSERT_EQUAL((100000 + 100000) / 2, sensorMtbfMs(SENSOR_LD2410));
+}
+
+static void test_health_names()
+{
+    TEST_ASSERT_EQUAL_STRING("healthy", getSensorHealthName(SENSOR_HEALTHY));
+    TEST_ASSERT_EQUAL_STRING("degraded", getSensorHealthName(SENSOR_DEGRADED));
+    TEST_ASSERT_EQUAL_STRING("failed", getSensorHealthName(SENSOR_FAILED));
+    TEST_ASSERT_EQUAL_STRING("reinitialising", getSensorHealthName(SENSOR_REINITIALISING));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mtbf_and_mttr);
+    RUN_TEST(test_single_failure_degrades);
+    RUN_TEST(test_pending_is_not_a_failure);
+    RUN_TEST(test_threshold_fails_and_schedules_recovery);
+    RUN_TEST(test_good_read_after_recovery);
+    RUN_TEST(test_failed_recovery_doubles_backoff);
+    RUN_TEST(test_manual_reset_probes_next_poll);
+    RUN_TEST(test_health_names);
+    return UNITY_END();
+}
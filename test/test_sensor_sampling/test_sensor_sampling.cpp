@@ -0,0 +1,139 @@
+#include <Arduino.h>
+#include <math.h>
+#include <unity.h>
+#include "config.h"
+#include "sensors/sensor_sampling.h"
+#include "model/data_structs.h"
+
+void setUp()
+{
+    applyDefaultSampling();
+    resetSensorSampling();
+}
+
+void tearDown()
+{
+}
+
+static void test_first_poll_due_at_once()
+{
+    TEST_ASSERT_TRUE(sensorPollDue(SENSOR_DHT, 0));
+    TEST_ASSERT_TRUE(sensorPollDue(SENSOR_TSL2561, 123456));
+}
+
+static void test_stable_readings_double_the_period()
+{
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 0);
+    TEST_ASSERT_EQUAL(DHT_SAMPLE_MIN_MS, getSensorSampling(SENSOR_DHT).period_ms);
+    TEST_ASSERT_FALSE(sensorPollDue(SENSOR_DHT, DHT_SAMPLE_MIN_MS - 1));
+    TEST_ASSERT_TRUE(sensorPollDue(SENSOR_DHT, DHT_SAMPLE_MIN_MS));
+
+    unsigned long now = 0;
+    unsigned long expected = DHT_SAMPLE_MIN_MS;
+    while (expected < DHT_SAMPLE_MAX_MS)
+    {
+        now = sensorNextPollAt(SENSOR_DHT);
+        recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, now);
+        expected = min(expected * 2, (unsigned long)DHT_SAMPLE_MAX_MS);
+        TEST_ASSERT_EQUAL(expected, getSensorSampling(SENSOR_DHT).period_ms);
+    }
+    TEST_ASSERT_EQUAL(now + DHT_SAMPLE_MAX_MS, sensorNextPollAt(SENSOR_DHT));
+}
+
+static void test_change_returns_to_min_period()
+{
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 0);
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 2000);
+    TEST_ASSERT_EQUAL(2 * DHT_SAMPLE_MIN_MS, getSensorSampling(SENSOR_DHT).period_ms);
+
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f + DHT_SAMPLE_CHANGE, 6000);
+    TEST_ASSERT_EQUAL(DHT_SAMPLE_MIN_MS, getSensorSampling(SENSOR_DHT).period_ms);
+}
+
+static void test_pending_retries_at_min_failed_keeps_period()
+{
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 0);
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 2000);
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_FAILED, 0, 6000);
+    TEST_ASSERT_EQUAL(2 * DHT_SAMPLE_MIN_MS, getSensorSampling(SENSOR_DHT).period_ms);
+
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_PENDING, 0, 10000);
+    TEST_ASSERT_EQUAL(DHT_SAMPLE_MIN_MS, getSensorSampling(SENSOR_DHT).period_ms);
+}
+
+static void test_range_change_applies_at_once()
+{
+    recordSensorSample(SENSOR_TSL2561, SENSOR_POLL_OK, 100.0f, 0);
+    for (unsigned long t = 1000; t <= 15000; t = sensorNextPollAt(SENSOR_TSL2561))
+    {
+        recordSensorSample(SENSOR_TSL2561, SENSOR_POLL_OK, 100.0f, t);
+    }
+    TEST_ASSERT_GREATER_THAN(5000, getSensorSampling(SENSOR_TSL2561).period_ms);
+
+    // Narrowed through the API: the current period is clamped, not waited out
+    unsigned long last = getSensorSampling(SENSOR_TSL2561).last_poll;
+    config.sampling[SENSOR_TSL2561].max_ms = 5000;
+    TEST_ASSERT_EQUAL(last + 5000, sensorNextPollAt(SENSOR_TSL2561));
+}
+
+static void test_lag_counts_late_polls_only()
+{
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 21.0f, 0);
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 25.0f, DHT_SAMPLE_MIN_MS + 300);
+    TEST_ASSERT_EQUAL(300, getSensorSampling(SENSOR_DHT).lag_max_ms);
+
+    // A forced early read is not lag
+    recordSensorSample(SENSOR_DHT, SENSOR_POLL_OK, 29.0f, DHT_SAMPLE_MIN_MS + 400);
+    TEST_ASSERT_EQUAL(300, getSensorSampling(SENSOR_DHT).lag_max_ms);
+}
+
+static void test_achieved_rate_over_window()
+{
+    for (unsigned long t = 0; t <= SAMPLE_RATE_WINDOW_MS; t += 1000)
+    {
+        recordSensorSample(SENSOR_LD2410, SENSOR_POLL_OK, 1.0f, t);
+    }
+    // Eleven polls, the first one opening the window
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.1f, getSensorSampling(SENSOR_LD2410).achieved_hz);
+    TEST_ASSERT_EQUAL(0, getSensorSampling(SENSOR_LD2410).window_polls);
+}
+
+static void test_validate_sampling()
+{
+    TEST_ASSERT_TRUE(validateSampling());
+
+    SamplingConfig sampling[SENSOR_COUNT];
+    memcpy(sampling, config.sampling, sizeof(sampling));
+    sampling[SENSOR_DHT].min_ms = SAMPLE_MIN_PERIOD_MS - 1;
+    TEST_ASSERT_FALSE(validateSampling(sampling));
+
+    memcpy(sampling, config.sampling, sizeof(sampling));
+    sampling[SENSOR_TSL2561].max_ms = SAMPLE_MAX_PERIOD_MS + 1;
+    TEST_ASSERT_FALSE(validateSampling(sampling));
+
+    memcpy(sampling, config.sampling, sizeof(sampling));
+    sampling[SENSOR_PIR].min_ms = sampling[SENSOR_PIR].max_ms + 1;
+    TEST_ASSERT_FALSE(validateSampling(sampling));
+
+    memcpy(sampling, config.sampling, sizeof(sampling));
+    sampling[SENSOR_LD2410].change = NAN;
+    TEST_ASSERT_FALSE(validateSampling(sampling));
+
+    memcpy(sampling, config.sampling, sizeof(sampling));
+    sampling[SENSOR_LD2410].change = -1.0f;
+    TEST_ASSERT_FALSE(validateSampling(sampling));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_poll_due_at_once);
+    RUN_TEST(test_stable_readings_double_the_period);
+    RUN_TEST(test_change_returns_to_min_period);
+    RUN_TEST(test_pending_retries_at_min_failed_keeps_period);
+    RUN_TEST(test_range_change_applies_at_once);
+    RUN_TEST(test_lag_counts_late_polls_only);
+    RUN_TEST(test_achieved_rate_over_window);
+    RUN_TEST(test_validate_sampling);
+    return UNITY_END();
+}